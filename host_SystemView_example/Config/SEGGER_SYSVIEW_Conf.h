@@ -0,0 +1,46 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SEGGER_SYSVIEW_Conf.h
+Purpose : SEGGER SystemView configuration file for the native POSIX
+          host build of the recorder core.
+          Set defines which deviate from the defaults (see SEGGER_SYSVIEW_ConfDefaults.h) here.
+
+Additional information:
+  On the host SEGGER_SYSVIEW_CORE is auto-detected as SEGGER_SYSVIEW_CORE_OTHER,
+  so SEGGER_SYSVIEW_GET_TIMESTAMP and SEGGER_SYSVIEW_GET_INTERRUPT_ID call
+  SEGGER_SYSVIEW_X_GetTimestamp() and SEGGER_SYSVIEW_X_GetInterruptId(),
+  which are implemented in Sample/POSIX/SEGGER_SYSVIEW_Config_POSIX.c.
+
+  SystemView locking falls back to the RTT locking mechanism.
+  The build defines SEGGER_RTT_LOCK_POSIX, which maps SEGGER_RTT_LOCK()
+  to a recursive pthread mutex (see SEGGER_RTT_Conf.h).
+*/
+
+#ifndef SEGGER_SYSVIEW_CONF_H
+#define SEGGER_SYSVIEW_CONF_H
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SEGGER_RTT_LOCK_POSIX
+  #error "The host build of SystemView requires SEGGER_RTT_LOCK_POSIX to be defined"
+#endif
+
+//
+// With SEGGER_SYSVIEW_NUM_SHARDS > 1, each thread selects its shard
+// with SEGGER_SYSVIEW_POSIX_SetShard(), standing in for a core or
+// interrupt priority group on target.
+//
+unsigned SEGGER_SYSVIEW_POSIX_GetShard(void);
+#define SEGGER_SYSVIEW_GET_SHARD()    SEGGER_SYSVIEW_POSIX_GetShard()
+
+#endif  // SEGGER_SYSVIEW_CONF_H
+
+/*************************** End of file ****************************/
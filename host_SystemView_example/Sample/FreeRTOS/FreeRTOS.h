@@ -0,0 +1,50 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : FreeRTOS.h
+Purpose : Stand-in for the FreeRTOS kernel header, with what the
+          FreeRTOS sample of SystemView needs to be built and tested
+          on the host. The kernel functions are provided by the test.
+*/
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define portTICK_PERIOD_MS                    1
+#define portSTACK_GROWTH                      (-1)
+
+#define configUSE_TRACE_FACILITY              1
+#define configMAX_TASK_NAME_LEN               16
+
+#define INCLUDE_uxTaskGetStackHighWaterMark   1
+#define INCLUDE_xTaskGetIdleTaskHandle        0
+
+//
+// The POSIX port in the host library defines SYSVIEW_X_OS_TraceAPI,
+// so the OS API of the FreeRTOS sample is renamed.
+//
+#define SYSVIEW_X_OS_TraceAPI                 SYSVIEW_FreeRTOS_TraceAPI
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef uint32_t TickType_t;
+typedef unsigned UBaseType_t;
+
+#endif
+
+/*************************** End of file ****************************/
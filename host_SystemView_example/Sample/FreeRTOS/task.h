@@ -0,0 +1,43 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : task.h
+Purpose : Stand-in for the FreeRTOS task API, see FreeRTOS.h.
+*/
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef void* TaskHandle_t;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+TickType_t  xTaskGetTickCountFromISR    (void);
+UBaseType_t uxTaskGetStackHighWaterMark (TaskHandle_t xTask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -0,0 +1,392 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SEGGER_SYSVIEW_Config_POSIX.c
+Purpose : Setup configuration of SystemView for a native POSIX host build.
+          Provides the timestamp, interrupt-ID and locking functions
+          which the recorder core expects from the target port.
+*/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+// The application name to be displayed in SystemViewer
+#define SYSVIEW_APP_NAME        "POSIX Host Application"
+
+// The target device name
+#define SYSVIEW_DEVICE_NAME     "x86-64"
+
+// Frequency of the timestamp. Must match SEGGER_SYSVIEW_X_GetTimestamp()
+#define SYSVIEW_TIMESTAMP_FREQ  (1000000000u)
+
+// System Frequency. Nominal value, only used for display in SystemViewer
+#define SYSVIEW_CPU_FREQ        (1000000000u)
+
+// The lowest RAM address used for IDs (pointers)
+#define SYSVIEW_RAM_BASE        (0)
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static pthread_mutex_t    _Lock;
+static pthread_once_t     _LockOnce = PTHREAD_ONCE_INIT;
+static __thread U32       _InterruptId;
+static __thread unsigned  _Shard;
+static SEGGER_SYSVIEW_POSIX_GET_TIMESTAMP_FUNC* _pfGetTimestamp;
+#if SEGGER_SYSVIEW_POSIX_LOCK_STATS
+static __thread unsigned  _LockNesting;
+static U64                _LockTime;
+static SEGGER_SYSVIEW_POSIX_LOCK_STATS_INFO _LockStats;
+#endif
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _InitLock()
+*
+*  Function description
+*    Creates the recursive mutex used for SEGGER_RTT_LOCK().
+*    SystemView requires a nestable lock.
+*/
+static void _InitLock(void) {
+  pthread_mutexattr_t Attr;
+
+  pthread_mutexattr_init(&Attr);
+  pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&_Lock, &Attr);
+  pthread_mutexattr_destroy(&Attr);
+}
+
+/*********************************************************************
+*
+*       _cbGetTime()
+*
+*  Function description
+*    Returns the system time in microseconds.
+*/
+static U64 _cbGetTime(void) {
+  return SEGGER_SYSVIEW_POSIX_GetTimeNs() / 1000u;
+}
+
+/*********************************************************************
+*
+*       _cbSendSystemDesc()
+*
+*  Function description
+*    Sends SystemView description strings.
+*/
+static void _cbSendSystemDesc(void) {
+  SEGGER_SYSVIEW_SendSysDesc("N="SYSVIEW_APP_NAME",D="SYSVIEW_DEVICE_NAME",O=POSIX");
+}
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+const SEGGER_SYSVIEW_OS_API SYSVIEW_X_OS_TraceAPI = {
+  _cbGetTime,
+  NULL
+};
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SEGGER_RTT_X_Lock()
+*
+*  Function description
+*    Implements SEGGER_RTT_LOCK() for SEGGER_RTT_LOCK_POSIX builds.
+*/
+void SEGGER_RTT_X_Lock(void) {
+  pthread_once(&_LockOnce, _InitLock);
+  pthread_mutex_lock(&_Lock);
+#if SEGGER_SYSVIEW_POSIX_LOCK_STATS
+  if (_LockNesting++ == 0) {
+    _LockTime = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  }
+#endif
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_X_Unlock()
+*
+*  Function description
+*    Implements SEGGER_RTT_UNLOCK() for SEGGER_RTT_LOCK_POSIX builds.
+*/
+void SEGGER_RTT_X_Unlock(void) {
+#if SEGGER_SYSVIEW_POSIX_LOCK_STATS
+  U64 t;
+
+  if (--_LockNesting == 0) {
+    t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - _LockTime;
+    _LockStats.NumLocks++;
+    _LockStats.TotalNs += t;
+    if (t > _LockStats.MaxNs) {
+      _LockStats.MaxNs = t;
+    }
+  }
+#endif
+  pthread_mutex_unlock(&_Lock);
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_X_GetTimestamp()
+*
+*  Function description
+*    Returns the current timestamp in nanoseconds of CLOCK_MONOTONIC,
+*    truncated to 32 bits. Replaces the DWT cycle counter read on Cortex-M.
+*    Returns the simulated clock if one has been set with
+*    SEGGER_SYSVIEW_POSIX_SetTimestampFunc().
+*/
+U32 SEGGER_SYSVIEW_X_GetTimestamp(void) {
+  if (_pfGetTimestamp) {
+    return _pfGetTimestamp();
+  }
+  return (U32)SEGGER_SYSVIEW_POSIX_GetTimeNs();
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_SetTimestampFunc()
+*
+*  Function description
+*    Replaces CLOCK_MONOTONIC as timestamp source, e.g. by a simulated
+*    cycle counter, so tests can record events at known times.
+*
+*  Parameters
+*    pfGetTimestamp: Function returning the timestamp, NULL for CLOCK_MONOTONIC.
+*/
+void SEGGER_SYSVIEW_POSIX_SetTimestampFunc(SEGGER_SYSVIEW_POSIX_GET_TIMESTAMP_FUNC* pfGetTimestamp) {
+  _pfGetTimestamp = pfGetTimestamp;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_X_GetInterruptId()
+*
+*  Function description
+*    Returns the simulated interrupt ID of the calling thread.
+*    0 means thread mode, as on Cortex-M.
+*/
+U32 SEGGER_SYSVIEW_X_GetInterruptId(void) {
+  return _InterruptId;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_SetInterruptId()
+*
+*  Function description
+*    Sets the interrupt ID reported for the calling thread.
+*    Used to simulate interrupt context around SEGGER_SYSVIEW_RecordEnterISR()
+*    and SEGGER_SYSVIEW_RecordExitISR().
+*
+*  Parameters
+*    InterruptId: ID to report, 0 for thread mode.
+*
+*  Return value
+*    Previously reported interrupt ID.
+*/
+U32 SEGGER_SYSVIEW_POSIX_SetInterruptId(U32 InterruptId) {
+  U32 Prev;
+
+  Prev         = _InterruptId;
+  _InterruptId = InterruptId;
+  return Prev;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_SetShard()
+*
+*  Function description
+*    Sets the shard the calling thread records to.
+*    Only used when SEGGER_SYSVIEW_NUM_SHARDS > 1.
+*
+*  Parameters
+*    Shard: Index of the shard, < SEGGER_SYSVIEW_NUM_SHARDS.
+*
+*  Return value
+*    Previously used shard.
+*/
+unsigned SEGGER_SYSVIEW_POSIX_SetShard(unsigned Shard) {
+  unsigned Prev;
+
+  Prev   = _Shard;
+  _Shard = Shard;
+  return Prev;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_GetShard()
+*
+*  Function description
+*    Implements SEGGER_SYSVIEW_GET_SHARD() for the host build.
+*    Returns the shard the calling thread records to, 0 by default.
+*/
+unsigned SEGGER_SYSVIEW_POSIX_GetShard(void) {
+  return _Shard;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_GetTimeNs()
+*
+*  Function description
+*    Returns CLOCK_MONOTONIC in nanoseconds.
+*/
+U64 SEGGER_SYSVIEW_POSIX_GetTimeNs(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (U64)ts.tv_sec * 1000000000u + (U64)ts.tv_nsec;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_GetLockStats()
+*
+*  Function description
+*    Returns how often and how long SEGGER_RTT_LOCK() has been held.
+*    On target this is the time interrupts are masked.
+*    All values are 0 unless SEGGER_SYSVIEW_POSIX_LOCK_STATS is 1.
+*
+*  Parameters
+*    pInfo: Receives the statistics.
+*/
+void SEGGER_SYSVIEW_POSIX_GetLockStats(SEGGER_SYSVIEW_POSIX_LOCK_STATS_INFO* pInfo) {
+#if SEGGER_SYSVIEW_POSIX_LOCK_STATS
+  SEGGER_RTT_X_Lock();
+  *pInfo = _LockStats;
+  SEGGER_RTT_X_Unlock();
+#else
+  memset(pInfo, 0, sizeof(*pInfo));
+#endif
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_ReserveStream()
+*
+*  Function description
+*    Makes room for NumBytes more bytes in a stream. Exits the
+*    program if the memory cannot be allocated.
+*
+*  Parameters
+*    pStream:  Stream to grow.
+*    NumBytes: Number of bytes to be appended.
+*
+*  Return value
+*    Position the next bytes are appended at.
+*/
+U8* SEGGER_SYSVIEW_POSIX_ReserveStream(SEGGER_SYSVIEW_POSIX_STREAM* pStream, size_t NumBytes) {
+  size_t Cap;
+  U8*    pData;
+
+  Cap = pStream->Cap;
+  while (Cap - pStream->Size < NumBytes) {
+    Cap = Cap ? Cap * 2u : (1u << 20);
+  }
+  if (Cap != pStream->Cap) {
+    pData = (U8*)realloc(pStream->pData, Cap);
+    if (pData == NULL) {
+      fprintf(stderr, "Out of memory: stream of %lu bytes\n", (unsigned long)Cap);
+      exit(EXIT_FAILURE);
+    }
+    pStream->pData = pData;
+    pStream->Cap   = Cap;
+  }
+  return pStream->pData + pStream->Size;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_DrainUp()
+*
+*  Function description
+*    Appends the data of an up-channel to a stream, as a J-Link
+*    would read it, until the channel is empty or MaxNumBytes
+*    have been read.
+*
+*  Parameters
+*    ChannelIndex: Index of the up-channel, e.g. SEGGER_SYSVIEW_GetChannelID().
+*    pStream:      Stream which receives the data.
+*    MaxNumBytes:  Maximum number of bytes to read, ~0u for all.
+*
+*  Return value
+*    Number of bytes read.
+*/
+unsigned SEGGER_SYSVIEW_POSIX_DrainUp(unsigned ChannelIndex, SEGGER_SYSVIEW_POSIX_STREAM* pStream, unsigned MaxNumBytes) {
+  unsigned NumBytesTotal;
+  unsigned NumBytesChunk;
+  unsigned NumBytes;
+
+  NumBytesTotal = 0;
+  while (NumBytesTotal < MaxNumBytes) {
+    NumBytesChunk = SEGGER_MIN(MaxNumBytes - NumBytesTotal, 4096u);
+    NumBytes      = SEGGER_RTT_ReadUpBuffer(ChannelIndex, SEGGER_SYSVIEW_POSIX_ReserveStream(pStream, NumBytesChunk), NumBytesChunk);
+    if (NumBytes == 0) {
+      break;
+    }
+    pStream->Size += NumBytes;
+    NumBytesTotal += NumBytes;
+  }
+  return NumBytesTotal;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_POSIX_FreeStream()
+*
+*  Function description
+*    Frees the memory of a stream and leaves it empty.
+*/
+void SEGGER_SYSVIEW_POSIX_FreeStream(SEGGER_SYSVIEW_POSIX_STREAM* pStream) {
+  free(pStream->pData);
+  memset(pStream, 0, sizeof(*pStream));
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_Conf()
+*/
+void SEGGER_SYSVIEW_Conf(void) {
+  SEGGER_SYSVIEW_Init(SYSVIEW_TIMESTAMP_FREQ, SYSVIEW_CPU_FREQ,
+                      &SYSVIEW_X_OS_TraceAPI, _cbSendSystemDesc);
+  SEGGER_SYSVIEW_SetRAMBase(SYSVIEW_RAM_BASE);
+}
+
+/*************************** End of file ****************************/
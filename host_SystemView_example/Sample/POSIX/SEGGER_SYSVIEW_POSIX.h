@@ -0,0 +1,77 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SEGGER_SYSVIEW_POSIX.h
+Purpose : Interface of the POSIX host port of SystemView.
+*/
+
+#ifndef SYSVIEW_POSIX_H
+#define SYSVIEW_POSIX_H
+
+#include <stddef.h>
+#include "SEGGER_SYSVIEW.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SEGGER_SYSVIEW_POSIX_LOCK_STATS
+  #define SEGGER_SYSVIEW_POSIX_LOCK_STATS   0   // 1: Measure how long SEGGER_RTT_LOCK() is held. Adds two clock reads per lock.
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  U64 NumLocks;       // Number of outermost lock/unlock pairs
+  U64 TotalNs;        // Sum of the time the lock was held
+  U64 MaxNs;          // Longest time the lock was held
+} SEGGER_SYSVIEW_POSIX_LOCK_STATS_INFO;
+
+typedef U32 SEGGER_SYSVIEW_POSIX_GET_TIMESTAMP_FUNC(void);
+
+//
+// Growing memory buffer which receives the data of an up-channel.
+// Zero-initialized it is empty.
+//
+typedef struct {
+  U8*    pData;
+  size_t Size;        // Number of bytes stored
+  size_t Cap;         // Number of bytes allocated
+} SEGGER_SYSVIEW_POSIX_STREAM;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+U32      SEGGER_SYSVIEW_POSIX_SetInterruptId (U32 InterruptId);
+unsigned SEGGER_SYSVIEW_POSIX_SetShard       (unsigned Shard);
+unsigned SEGGER_SYSVIEW_POSIX_GetShard       (void);
+U64      SEGGER_SYSVIEW_POSIX_GetTimeNs      (void);
+void     SEGGER_SYSVIEW_POSIX_SetTimestampFunc(SEGGER_SYSVIEW_POSIX_GET_TIMESTAMP_FUNC* pfGetTimestamp);
+void     SEGGER_SYSVIEW_POSIX_GetLockStats   (SEGGER_SYSVIEW_POSIX_LOCK_STATS_INFO* pInfo);
+U8*      SEGGER_SYSVIEW_POSIX_ReserveStream  (SEGGER_SYSVIEW_POSIX_STREAM* pStream, size_t NumBytes);
+unsigned SEGGER_SYSVIEW_POSIX_DrainUp        (unsigned ChannelIndex, SEGGER_SYSVIEW_POSIX_STREAM* pStream, unsigned MaxNumBytes);
+void     SEGGER_SYSVIEW_POSIX_FreeStream     (SEGGER_SYSVIEW_POSIX_STREAM* pStream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
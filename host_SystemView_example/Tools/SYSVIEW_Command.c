@@ -0,0 +1,337 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Command.c
+Purpose : Encodes the commands which are sent to the recorder through
+          the SystemView down channel.
+
+Additional information:
+  This is a stand-in for the command console of a host application:
+  SYSVIEW_COMMAND_Parse() translates an operator line into the bytes
+  of a command, which are written to the down channel, e.g. with
+  SEGGER_RTT_WriteDownBuffer() on the host build or through the
+  debug probe. The recorder reads the down channel when it sends
+  an event or in SEGGER_SYSVIEW_IsStarted(). Commands are:
+    start
+    stop
+    systime
+    tasklist
+    filter <word> <mask>       Set the disabled events of a word of the event filter
+    disable <first> [<count>]  Disable a range of event IDs
+    enable <first> [<count>]   Enable a range of event IDs
+    task <index> <id>          Select a task in the task filter, 0 to clear
+    sample <id> <ratio>        Record 1 of <ratio> events of an ID, 1 for all
+    sample-class <n> <ratio>   Record 1 of <ratio> events of class n, 1 for all
+    mode stream|stop-on-full   Set the buffer mode
+  Numbers are decimal or hexadecimal with the prefix 0x. Task IDs are
+  the IDs sent to the host.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_Int.h"
+#include "SYSVIEW_Command.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define MAX_WORDS                           3
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _StoreU16LE(), _StoreU32LE()
+*/
+static void _StoreU16LE(U8* p, U32 v) {
+  p[0] = (U8)v;
+  p[1] = (U8)(v >> 8);
+}
+
+static void _StoreU32LE(U8* p, U32 v) {
+  p[0] = (U8)v;
+  p[1] = (U8)(v >> 8);
+  p[2] = (U8)(v >> 16);
+  p[3] = (U8)(v >> 24);
+}
+
+/*********************************************************************
+*
+*       _ParseNumber()
+*
+*  Function description
+*    Parses a decimal or hexadecimal number.
+*
+*  Return value
+*     0: O.K.
+*    -1: No number.
+*/
+static int _ParseNumber(const char* s, U32* pValue) {
+  char*         sEnd;
+  unsigned long v;
+
+  if (s == NULL || *s == '-') {
+    return -1;
+  }
+  v = strtoul(s, &sEnd, 0);
+  if (sEnd == s || *sEnd != '\0' || v > 0xFFFFFFFFuL) {
+    return -1;
+  }
+  *pValue = (U32)v;
+  return 0;
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeSimple()
+*
+*  Function description
+*    Encodes a command without parameters, e.g.
+*    SEGGER_SYSVIEW_COMMAND_ID_START.
+*
+*  Return value
+*    Number of bytes of the command.
+*/
+int SYSVIEW_COMMAND_EncodeSimple(U8* pBuf, unsigned CommandId) {
+  pBuf[0] = (U8)CommandId;
+  return 1;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeEventFilter()
+*
+*  Function description
+*    Encodes SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER, which sets the
+*    disabled events WordIndex * 32 to WordIndex * 32 + 31.
+*
+*  Return value
+*    Number of bytes of the command.
+*/
+int SYSVIEW_COMMAND_EncodeEventFilter(U8* pBuf, unsigned WordIndex, U32 DisableMask) {
+  pBuf[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER;
+  pBuf[1] = (U8)WordIndex;
+  _StoreU32LE(&pBuf[2], DisableMask);
+  return 6;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeEventRange()
+*
+*  Function description
+*    Encodes SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_RANGE, which enables
+*    or disables NumIds events, starting at FirstId.
+*
+*  Return value
+*     6: Number of bytes of the command.
+*    -1: The range exceeds the 16-bit IDs of the command.
+*/
+int SYSVIEW_COMMAND_EncodeEventRange(U8* pBuf, U32 FirstId, U32 NumIds, int Disable) {
+  if (FirstId > 0xFFFFu || NumIds > 0xFFFFu) {
+    return -1;
+  }
+  pBuf[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_RANGE;
+  pBuf[1] = Disable ? 1u : 0u;
+  _StoreU16LE(&pBuf[2], FirstId);
+  _StoreU16LE(&pBuf[4], NumIds);
+  return 6;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeTaskFilter()
+*
+*  Function description
+*    Encodes SEGGER_SYSVIEW_COMMAND_ID_SET_TASK_FILTER, which selects
+*    the task TaskId, as sent to the host, in entry Index of the task
+*    filter. TaskId 0 clears the entry.
+*
+*  Return value
+*     6: Number of bytes of the command.
+*    -1: Index out of range.
+*/
+int SYSVIEW_COMMAND_EncodeTaskFilter(U8* pBuf, unsigned Index, U32 TaskId) {
+  if (Index > 0xFFu) {
+    return -1;
+  }
+  pBuf[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_TASK_FILTER;
+  pBuf[1] = (U8)Index;
+  _StoreU32LE(&pBuf[2], TaskId);
+  return 6;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeSampling()
+*
+*  Function description
+*    Encodes SEGGER_SYSVIEW_COMMAND_ID_SET_SAMPLING, which records
+*    one of Ratio events of EventId. Ratio 0 or 1 records all.
+*
+*  Return value
+*     4: Number of bytes of the command.
+*    -1: EventId or Ratio out of range.
+*/
+int SYSVIEW_COMMAND_EncodeSampling(U8* pBuf, U32 EventId, unsigned Ratio) {
+  if (EventId > 0xFFFFu || Ratio > 0xFFu) {
+    return -1;
+  }
+  pBuf[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_SAMPLING;
+  pBuf[1] = (U8)Ratio;
+  _StoreU16LE(&pBuf[2], EventId);
+  return 4;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeClassSampling()
+*
+*  Function description
+*    Encodes SEGGER_SYSVIEW_COMMAND_ID_SET_CLASS_SAMPLING, which records
+*    one of Ratio events of a class recorded with
+*    SEGGER_SYSVIEW_RECORD_SAMPLED(). Ratio 0 or 1 records all.
+*
+*  Return value
+*     3: Number of bytes of the command.
+*    -1: Class or Ratio out of range.
+*/
+int SYSVIEW_COMMAND_EncodeClassSampling(U8* pBuf, unsigned Class, unsigned Ratio) {
+  if (Class > 0xFFu || Ratio > 0xFFu) {
+    return -1;
+  }
+  pBuf[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_CLASS_SAMPLING;
+  pBuf[1] = (U8)Ratio;
+  pBuf[2] = (U8)Class;
+  return 3;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_EncodeBufferMode()
+*
+*  Function description
+*    Encodes SEGGER_SYSVIEW_COMMAND_ID_SET_BUFFER_MODE.
+*
+*  Return value
+*    Number of bytes of the command.
+*/
+int SYSVIEW_COMMAND_EncodeBufferMode(U8* pBuf, unsigned Mode) {
+  pBuf[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_BUFFER_MODE;
+  pBuf[1] = (U8)Mode;
+  return 2;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_COMMAND_Parse()
+*
+*  Function description
+*    Encodes the command of an operator line.
+*
+*  Parameters
+*    sLine   - Command and its parameters, separated by blanks.
+*    pBuf    - Buffer for the command.
+*    BufSize - Size of the buffer, at least SYSVIEW_COMMAND_MAX_SIZE.
+*
+*  Return value
+*    >= 0: Number of bytes of the command, 0 for an empty line.
+*      -1: Unknown command or invalid parameters.
+*/
+int SYSVIEW_COMMAND_Parse(const char* sLine, U8* pBuf, unsigned BufSize) {
+  char        acLine[80];
+  const char* asWord[MAX_WORDS + 1];
+  unsigned    NumWords;
+  char*       s;
+  U32         v0;
+  U32         v1;
+
+  if (BufSize < SYSVIEW_COMMAND_MAX_SIZE || strlen(sLine) >= sizeof(acLine)) {
+    return -1;
+  }
+  strcpy(acLine, sLine);
+  NumWords = 0;
+  for (s = strtok(acLine, " \t\r\n"); s != NULL; s = strtok(NULL, " \t\r\n")) {
+    if (NumWords == MAX_WORDS) {
+      return -1;
+    }
+    asWord[NumWords++] = s;
+  }
+  asWord[NumWords] = NULL;
+  if (NumWords == 0) {
+    return 0;
+  }
+  if (NumWords == 1) {
+    if (strcmp(asWord[0], "start") == 0) {
+      return SYSVIEW_COMMAND_EncodeSimple(pBuf, SEGGER_SYSVIEW_COMMAND_ID_START);
+    }
+    if (strcmp(asWord[0], "stop") == 0) {
+      return SYSVIEW_COMMAND_EncodeSimple(pBuf, SEGGER_SYSVIEW_COMMAND_ID_STOP);
+    }
+    if (strcmp(asWord[0], "systime") == 0) {
+      return SYSVIEW_COMMAND_EncodeSimple(pBuf, SEGGER_SYSVIEW_COMMAND_ID_GET_SYSTIME);
+    }
+    if (strcmp(asWord[0], "tasklist") == 0) {
+      return SYSVIEW_COMMAND_EncodeSimple(pBuf, SEGGER_SYSVIEW_COMMAND_ID_GET_TASKLIST);
+    }
+    return -1;
+  }
+  if (strcmp(asWord[0], "mode") == 0 && NumWords == 2) {
+    if (strcmp(asWord[1], "stream") == 0) {
+      return SYSVIEW_COMMAND_EncodeBufferMode(pBuf, SEGGER_SYSVIEW_BUFFER_MODE_STREAM);
+    }
+    if (strcmp(asWord[1], "stop-on-full") == 0) {
+      return SYSVIEW_COMMAND_EncodeBufferMode(pBuf, SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL);
+    }
+    return -1;
+  }
+  if (_ParseNumber(asWord[1], &v0) != 0) {
+    return -1;
+  }
+  v1 = 1;
+  if (NumWords == 3 && _ParseNumber(asWord[2], &v1) != 0) {
+    return -1;
+  }
+  if (strcmp(asWord[0], "disable") == 0) {
+    return SYSVIEW_COMMAND_EncodeEventRange(pBuf, v0, v1, 1);
+  }
+  if (strcmp(asWord[0], "enable") == 0) {
+    return SYSVIEW_COMMAND_EncodeEventRange(pBuf, v0, v1, 0);
+  }
+  if (NumWords != 3) {
+    return -1;
+  }
+  if (strcmp(asWord[0], "filter") == 0) {
+    return (v0 <= 0xFFu) ? SYSVIEW_COMMAND_EncodeEventFilter(pBuf, v0, v1) : -1;
+  }
+  if (strcmp(asWord[0], "task") == 0) {
+    return SYSVIEW_COMMAND_EncodeTaskFilter(pBuf, v0, v1);
+  }
+  if (strcmp(asWord[0], "sample") == 0) {
+    return SYSVIEW_COMMAND_EncodeSampling(pBuf, v0, v1);
+  }
+  if (strcmp(asWord[0], "sample-class") == 0) {
+    return SYSVIEW_COMMAND_EncodeClassSampling(pBuf, v0, v1);
+  }
+  return -1;
+}
+
+/*************************** End of file ****************************/
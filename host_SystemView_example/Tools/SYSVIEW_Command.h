@@ -0,0 +1,50 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Command.h
+Purpose : Interface of the host-side encoder of the commands which
+          are sent to the recorder through the SystemView down channel.
+*/
+
+#ifndef SYSVIEW_COMMAND_H
+#define SYSVIEW_COMMAND_H
+
+#include "SEGGER.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SYSVIEW_COMMAND_MAX_SIZE            7       // The down buffer of the recorder holds 7 bytes
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+int SYSVIEW_COMMAND_EncodeSimple        (U8* pBuf, unsigned CommandId);
+int SYSVIEW_COMMAND_EncodeEventFilter   (U8* pBuf, unsigned WordIndex, U32 DisableMask);
+int SYSVIEW_COMMAND_EncodeEventRange    (U8* pBuf, U32 FirstId, U32 NumIds, int Disable);
+int SYSVIEW_COMMAND_EncodeTaskFilter    (U8* pBuf, unsigned Index, U32 TaskId);
+int SYSVIEW_COMMAND_EncodeSampling      (U8* pBuf, U32 EventId, unsigned Ratio);
+int SYSVIEW_COMMAND_EncodeClassSampling (U8* pBuf, unsigned Class, unsigned Ratio);
+int SYSVIEW_COMMAND_EncodeBufferMode    (U8* pBuf, unsigned Mode);
+int SYSVIEW_COMMAND_Parse               (const char* sLine, U8* pBuf, unsigned BufSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
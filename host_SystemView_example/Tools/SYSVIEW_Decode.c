@@ -0,0 +1,548 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Decode.c
+Purpose : Streaming decoder of SystemView streams.
+
+Additional information:
+  The stream is fed in chunks of any size, e.g. as read from a file,
+  the RTT up-channel or a UART. Every packet is passed to the callback
+  with its absolute time stamp, the parameters of the events with
+  ID < 24, the sub-event ID of SYSVIEW_EVTID_EX and the module of
+  module events. The event and its payload are only valid during the
+  callback. Packets in the stream are decoded in place; only a packet
+  which is split between two chunks is copied, so there is no allocation.
+
+  The decoder starts at the first sync (10 * 0x00). After a corrupt
+  packet it skips to the next sync, which the recorder sends
+  periodically and after an overflow. The time stamps continue across
+  the skipped bytes, so they are off by the time of the skipped events.
+*/
+#include <stddef.h>
+#include <string.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Packet.h"
+#include "SYSVIEW_Varint.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SYNC_SIZE         10    // Number of NOP (0) bytes of a sync, see _abSync[] of the recorder
+#define MAX_VARINT_SIZE   5
+#define FAST_MARGIN       (6 * MAX_VARINT_SIZE)   // Data after the start of a packet for _ParsePacketFast(): ID, 4 parameters and time stamp delta
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _DecodeU32NoCheck()
+*
+*  Function description
+*    Decodes a variable-length encoded U32 without bounds checks, one
+*    byte per step, which ends after 1 byte for most IDs and lengths and
+*    after 2 to 3 bytes for most parameters and time stamp deltas.
+*    At least MAX_VARINT_SIZE bytes must be readable at p.
+*
+*  Return value
+*    Pointer to the byte following the value, NULL if the value has
+*    more than MAX_VARINT_SIZE bytes.
+*/
+static inline const U8* _DecodeU32NoCheck(const U8* p, U32* pValue) {
+  U32 v;
+
+  v = p[0];
+  if (v < 0x80u) {
+    *pValue = v;
+    return p + 1;
+  }
+  v = (v & 0x7Fu) | ((U32)p[1] << 7);
+  if (p[1] < 0x80u) {
+    *pValue = v;
+    return p + 2;
+  }
+  v = (v & 0x3FFFu) | ((U32)p[2] << 14);
+  if (p[2] < 0x80u) {
+    *pValue = v;
+    return p + 3;
+  }
+  v = (v & 0x1FFFFFu) | ((U32)p[3] << 21);
+  if (p[3] < 0x80u) {
+    *pValue = v;
+    return p + 4;
+  }
+  if (p[4] < 0x80u) {
+    *pValue = (v & 0x0FFFFFFFu) | ((U32)p[4] << 28);
+    return p + 5;
+  }
+  return NULL;
+}
+
+/*********************************************************************
+*
+*       _DecodeU32()
+*
+*  Function description
+*    Decodes a variable-length encoded U32, without bounds checks
+*    unless the value is at the end of the data.
+*/
+static inline const U8* _DecodeU32(const U8* p, const U8* pEnd, U32* pValue) {
+  if ((pEnd - p) < MAX_VARINT_SIZE) {
+    return SYSVIEW_PACKET_DecodeU32(p, pEnd, pValue);
+  }
+  return _DecodeU32NoCheck(p, pValue);
+}
+
+/*********************************************************************
+*
+*       _IsTruncated()
+*
+*  Function description
+*    Tells whether a value at p which could not be decoded is
+*    truncated, or has more bytes than a U32 and is corrupt.
+*/
+static inline int _IsTruncated(const U8* p, const U8* pEnd) {
+  return (pEnd - p) < MAX_VARINT_SIZE;
+}
+
+/*********************************************************************
+*
+*       _AddModule()
+*
+*  Function description
+*    Adds the event offset of a module description.
+*
+*  Additional information
+*    The module ID in the description is the position in the list of
+*    the recorder, to which new modules are prepended, so it changes
+*    with every registration. Modules are identified by their event
+*    offset instead, which ascends in the order of registration.
+*/
+static void _AddModule(SYSVIEW_DECODE_CONTEXT* pDecode, U32 EventOffset) {
+  unsigned i;
+
+  for (i = 0; i < pDecode->NumModules; i++) {
+    if (pDecode->aModuleOffset[i] == EventOffset) {
+      return;
+    }
+    if (pDecode->aModuleOffset[i] > EventOffset) {
+      break;
+    }
+  }
+  if (pDecode->NumModules < SYSVIEW_DECODE_MAX_MODULES) {
+    memmove(&pDecode->aModuleOffset[i + 1], &pDecode->aModuleOffset[i], (pDecode->NumModules - i) * sizeof(pDecode->aModuleOffset[0]));
+    pDecode->aModuleOffset[i] = EventOffset;
+    pDecode->NumModules++;
+  }
+}
+
+/*********************************************************************
+*
+*       _FindModule()
+*
+*  Function description
+*    Sets the module and the event ID within the module of a module event.
+*/
+static void _FindModule(const SYSVIEW_DECODE_CONTEXT* pDecode, SYSVIEW_DECODE_EVENT* pEvent) {
+  unsigned i;
+
+  pEvent->SubId = pEvent->Id - SYSVIEW_DECODE_MODULE_EVENT_OFFSET;
+  for (i = pDecode->NumModules; i > 0; i--) {
+    if (pEvent->Id >= pDecode->aModuleOffset[i - 1]) {
+      pEvent->ModuleIndex = (int)(i - 1);
+      pEvent->SubId       = pEvent->Id - pDecode->aModuleOffset[i - 1];
+      break;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _ParsePacket()
+*
+*  Function description
+*    Parses the packet at p, which must not be a NOP (sync) byte.
+*
+*  Parameters
+*    pDecode - Decoder context.
+*    p       - Start of the packet.
+*    pEnd    - End of the data.
+*    pEvent  - Receives the event, without time stamp.
+*    pDelta  - Receives the time stamp delta as sent.
+*
+*  Return value
+*    > 0: Size of the packet.
+*    = 0: Packet continues after pEnd.
+*    < 0: Corrupt packet.
+*/
+static int _ParsePacket(const SYSVIEW_DECODE_CONTEXT* pDecode, const U8* p, const U8* pEnd, SYSVIEW_DECODE_EVENT* pEvent, U32* pDelta) {
+  const U8* pPacket;
+  const U8* pNext;
+  U32       Len;
+  unsigned  Layout;
+  unsigned  i;
+
+  pPacket = p;
+  pNext   = _DecodeU32(p, pEnd, &pEvent->Id);
+  if (pNext == NULL) {
+    goto Fail;
+  }
+  p                   = pNext;
+  pEvent->SubId       = 0;
+  pEvent->ModuleIndex = -1;
+  pEvent->NumParams   = 0;
+  pEvent->pPayload    = p;
+  pEvent->pDataEnd    = pEnd;
+  if (pEvent->Id < SYSVIEW_PACKET_NUM_FIXED_IDS) {
+    Layout = SYSVIEW_PACKET_aFixedLayout[pEvent->Id];
+    if (Layout == SYSVIEW_PACKET_LAYOUT_INVALID) {
+      return -1;
+    }
+    for (i = 0; i < (Layout & SYSVIEW_PACKET_LAYOUT_NUM_PARAMS); i++) {
+      pNext = _DecodeU32(p, pEnd, &pEvent->aParam[i]);
+      if (pNext == NULL) {
+        goto Fail;
+      }
+      p = pNext;
+    }
+    pEvent->NumParams = i;
+    if (Layout & SYSVIEW_PACKET_LAYOUT_STR) {
+      p = SYSVIEW_PACKET_SkipString(p, pEnd);
+      if (p == NULL) {
+        return 0;
+      }
+    }
+    pEvent->PayloadSize = (unsigned)(p - pEvent->pPayload);
+  } else {
+    pNext = _DecodeU32(p, pEnd, &Len);
+    if (pNext == NULL) {
+      goto Fail;
+    }
+    p = pNext;
+    if ((U32)(pEnd - p) < Len) {
+      return 0;
+    }
+    pEvent->pPayload    = p;
+    pEvent->PayloadSize = Len;
+    p                  += Len;
+    if (pEvent->Id == SYSVIEW_EVTID_EX) {
+      if (_DecodeU32(pEvent->pPayload, p, &pEvent->SubId) == NULL) {
+        return -1;
+      }
+    } else if (pEvent->Id >= SYSVIEW_DECODE_MODULE_EVENT_OFFSET) {
+      _FindModule(pDecode, pEvent);
+    }
+  }
+  pNext = _DecodeU32(p, pEnd, pDelta);
+  if (pNext == NULL) {
+    goto Fail;
+  }
+  pEvent->PacketSize = (unsigned)(pNext - pPacket);
+  return (int)(pNext - pPacket);
+Fail:
+  return _IsTruncated(p, pEnd) ? 0 : -1;
+}
+
+/*********************************************************************
+*
+*       _ParsePacketFast()
+*
+*  Function description
+*    Parses the packet at p as _ParsePacket(), where at least
+*    FAST_MARGIN bytes are in the data. The ID, the parameters of the
+*    events with ID < 24 and the time stamp delta are decoded without
+*    bounds checks, only the payload of the other events is checked.
+*
+*  Return value
+*    > 0: Size of the packet.
+*    = 0: Packet has a string, or is corrupt or continues near pEnd.
+*         To be parsed by _ParsePacket().
+*/
+static inline int _ParsePacketFast(const SYSVIEW_DECODE_CONTEXT* pDecode, const U8* p, const U8* pEnd, SYSVIEW_DECODE_EVENT* pEvent, U32* pDelta) {
+  const U8* pPacket;
+  U32       Len;
+  unsigned  Layout;
+  unsigned  i;
+
+  pPacket = p;
+  p       = _DecodeU32NoCheck(p, &pEvent->Id);
+  if (p == NULL) {
+    return 0;
+  }
+  pEvent->SubId       = 0;
+  pEvent->ModuleIndex = -1;
+  pEvent->NumParams   = 0;
+  pEvent->pPayload    = p;
+  pEvent->pDataEnd    = pEnd;
+  if (pEvent->Id < SYSVIEW_PACKET_NUM_FIXED_IDS) {
+    Layout = SYSVIEW_PACKET_aFixedLayout[pEvent->Id];
+    if (Layout & SYSVIEW_PACKET_LAYOUT_STR) {
+      return 0;                               // String or invalid ID
+    }
+    for (i = 0; i < Layout; i++) {
+      p = _DecodeU32NoCheck(p, &pEvent->aParam[i]);
+      if (p == NULL) {
+        return 0;
+      }
+    }
+    pEvent->NumParams   = Layout;
+    pEvent->PayloadSize = (unsigned)(p - pEvent->pPayload);
+  } else {
+    p = _DecodeU32NoCheck(p, &Len);
+    if (p == NULL || (U32)(pEnd - p) - MAX_VARINT_SIZE < Len) {
+      return 0;                               // Corrupt, or the delta may continue after pEnd
+    }
+    pEvent->pPayload    = p;
+    pEvent->PayloadSize = Len;
+    p                  += Len;
+    if (pEvent->Id == SYSVIEW_EVTID_EX) {
+      if (_DecodeU32(pEvent->pPayload, p, &pEvent->SubId) == NULL) {
+        return 0;
+      }
+    } else if (pEvent->Id >= SYSVIEW_DECODE_MODULE_EVENT_OFFSET) {
+      _FindModule(pDecode, pEvent);
+    }
+  }
+  p = _DecodeU32NoCheck(p, pDelta);
+  if (p == NULL) {
+    return 0;
+  }
+  pEvent->PacketSize = (unsigned)(p - pPacket);
+  return (int)(p - pPacket);
+}
+
+/*********************************************************************
+*
+*       _OnPacket()
+*
+*  Function description
+*    Advances the time stamp, tracks module descriptions and passes
+*    the event to the callback.
+*/
+static void _OnPacket(SYSVIEW_DECODE_CONTEXT* pDecode, SYSVIEW_DECODE_EVENT* pEvent, U32 Delta) {
+  if (pDecode->Flags & SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA) {
+    if (pEvent->Id == SYSVIEW_EVTID_SHARD_SYNC) {
+      pDecode->PrevDelta = 0;
+    }
+    pDecode->PrevDelta += (Delta >> 1) ^ (0u - (Delta & 1u));   // Undo zig-zag encoding
+    Delta = pDecode->PrevDelta;
+  }
+  pDecode->Time += Delta;
+  pEvent->Time   = pDecode->Time;
+  if (pEvent->Id == SYSVIEW_EVTID_MODULEDESC) {
+    _AddModule(pDecode, pEvent->aParam[1]);
+  }
+  pDecode->NumEvents++;
+  pDecode->pfOnEvent(pDecode->pContext, pEvent);
+}
+
+/*********************************************************************
+*
+*       _Resync()
+*
+*  Function description
+*    Drops the decoder out of sync after a corrupt packet.
+*/
+static void _Resync(SYSVIEW_DECODE_CONTEXT* pDecode) {
+  pDecode->IsSynced  = 0;
+  pDecode->NumZeros  = 0;
+  pDecode->NumResyncs++;
+}
+
+/*********************************************************************
+*
+*       _SearchSync()
+*
+*  Function description
+*    Skips data up to and including the next sync.
+*
+*  Return value
+*    Pointer to the first byte after the sync, pEnd if the data ends before.
+*/
+static const U8* _SearchSync(SYSVIEW_DECODE_CONTEXT* pDecode, const U8* p, const U8* pEnd) {
+  unsigned NumZeros;
+
+  NumZeros = pDecode->NumZeros;
+  while (p < pEnd) {
+    if (*p++ == SYSVIEW_EVTID_NOP) {
+      if (++NumZeros == SYNC_SIZE) {
+        pDecode->IsSynced  = 1;
+        pDecode->PrevDelta = 0;
+        break;
+      }
+    } else {
+      pDecode->NumBytesSkipped += NumZeros + 1;
+      NumZeros = 0;
+    }
+  }
+  pDecode->NumZeros = NumZeros;
+  return p;
+}
+
+/*********************************************************************
+*
+*       _CompleteCarry()
+*
+*  Function description
+*    Completes the packet in the carry buffer with the start of the new data.
+*
+*  Return value
+*    Number of bytes of the new data consumed.
+*/
+static unsigned _CompleteCarry(SYSVIEW_DECODE_CONTEXT* pDecode, const U8* pData, unsigned NumBytes) {
+  SYSVIEW_DECODE_EVENT Event;
+  unsigned             NumBytesOld;
+  unsigned             NumBytesCopy;
+  U32                  Delta;
+  int                  r;
+
+  NumBytesOld  = pDecode->NumBytesCarry;
+  NumBytesCopy = sizeof(pDecode->aCarry) - NumBytesOld;
+  if (NumBytesCopy > NumBytes) {
+    NumBytesCopy = NumBytes;
+  }
+  memcpy(&pDecode->aCarry[NumBytesOld], pData, NumBytesCopy);
+  r = _ParsePacket(pDecode, pDecode->aCarry, pDecode->aCarry + NumBytesOld + NumBytesCopy, &Event, &Delta);
+  if (r > 0) {
+    pDecode->NumBytesCarry = 0;
+    _OnPacket(pDecode, &Event, Delta);
+    return (unsigned)r - NumBytesOld;
+  }
+  if (r == 0 && NumBytesCopy == NumBytes && NumBytesOld + NumBytesCopy < sizeof(pDecode->aCarry)) {
+    pDecode->NumBytesCarry += NumBytesCopy;       // Still incomplete, wait for more data
+    return NumBytes;
+  }
+  //
+  // Corrupt, or larger than the carry buffer. Search the next sync in the new data.
+  //
+  pDecode->NumBytesSkipped += NumBytesOld;
+  pDecode->NumBytesCarry    = 0;
+  _Resync(pDecode);
+  return 0;
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_DECODE_Init()
+*
+*  Function description
+*    Initializes a decoder for a new stream.
+*
+*  Parameters
+*    pDecode   - Decoder context, allocated by the caller.
+*    Flags     - Combination of SYSVIEW_DECODE_FLAG_*.
+*    pfOnEvent - Called for every packet of the stream.
+*    pContext  - Passed to pfOnEvent.
+*/
+void SYSVIEW_DECODE_Init(SYSVIEW_DECODE_CONTEXT* pDecode, unsigned Flags, SYSVIEW_DECODE_EVENT_FUNC* pfOnEvent, void* pContext) {
+  memset(pDecode, 0, offsetof(SYSVIEW_DECODE_CONTEXT, aCarry));
+  pDecode->pfOnEvent = pfOnEvent;
+  pDecode->pContext  = pContext;
+  pDecode->Flags     = Flags;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_DECODE_Feed()
+*
+*  Function description
+*    Decodes the next chunk of the stream.
+*
+*  Parameters
+*    pDecode  - Decoder context.
+*    pData    - Data of the stream, following the data of the previous call.
+*    NumBytes - Number of bytes in the chunk.
+*
+*  Additional information
+*    Packets are passed to the callback as soon as they are complete.
+*    A packet at the end of the chunk which continues in the next chunk
+*    is kept, if it fits into SYSVIEW_DECODE_MAX_PACKET_SIZE bytes.
+*    Otherwise the decoder skips to the next sync.
+*/
+void SYSVIEW_DECODE_Feed(SYSVIEW_DECODE_CONTEXT* pDecode, const U8* pData, unsigned NumBytes) {
+  SYSVIEW_DECODE_EVENT Event;
+  const U8*            p;
+  const U8*            pEnd;
+  U32                  Delta;
+  int                  r;
+
+  p    = pData;
+  pEnd = pData + NumBytes;
+  if (pDecode->NumBytesCarry) {
+    p += _CompleteCarry(pDecode, pData, NumBytes);
+  }
+  while (p < pEnd) {
+    if (pDecode->IsSynced == 0) {
+      p = _SearchSync(pDecode, p, pEnd);
+      continue;
+    }
+    if (*p == SYSVIEW_EVTID_NOP) {                // Sync, no time stamp
+      pDecode->PrevDelta = 0;
+      p++;
+      continue;
+    }
+    r = ((pEnd - p) >= FAST_MARGIN) ? _ParsePacketFast(pDecode, p, pEnd, &Event, &Delta) : 0;
+    if (r == 0) {
+      r = _ParsePacket(pDecode, p, pEnd, &Event, &Delta);
+    }
+    if (r > 0) {
+      _OnPacket(pDecode, &Event, Delta);
+      p += r;
+    } else if (r == 0 && (size_t)(pEnd - p) < sizeof(pDecode->aCarry)) {
+      pDecode->NumBytesCarry = (unsigned)(pEnd - p);
+      memcpy(pDecode->aCarry, p, pDecode->NumBytesCarry);
+      break;
+    } else {
+      _Resync(pDecode);
+      pDecode->NumBytesSkipped++;
+      p++;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_DECODE_GetU32s()
+*
+*  Function description
+*    Decodes the payload of an event as U32 parameters, e.g. of the
+*    events recorded by SEGGER_SYSVIEW_RecordU32x*().
+*
+*  Parameters
+*    pEvent       - Event passed to the callback.
+*    paValue      - Receives the parameters.
+*    MaxNumValues - Maximum number of parameters to decode.
+*
+*  Return value
+*    Number of parameters decoded.
+*
+*  Additional information
+*    The payload of SYSVIEW_EVTID_EX starts with the sub-event ID.
+*    Payloads which contain strings are not decoded correctly.
+*    Uses the SYSVIEW_VARINT_DecodeU32s() kernel.
+*/
+unsigned SYSVIEW_DECODE_GetU32s(const SYSVIEW_DECODE_EVENT* pEvent, U32* paValue, unsigned MaxNumValues) {
+  const U8* pNext;
+
+  return SYSVIEW_VARINT_DecodeU32sPadded(pEvent->pPayload, pEvent->pPayload + pEvent->PayloadSize, pEvent->pDataEnd, paValue, MaxNumValues, &pNext);
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,102 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Decode.h
+Purpose : Interface of the streaming decoder of SystemView streams.
+*/
+
+#ifndef SYSVIEW_DECODE_H
+#define SYSVIEW_DECODE_H
+
+#include "SEGGER.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SYSVIEW_DECODE_MAX_PACKET_SIZE
+  #define SYSVIEW_DECODE_MAX_PACKET_SIZE    1024    // Largest packet which may be split between two calls of SYSVIEW_DECODE_Feed()
+#endif
+
+#ifndef   SYSVIEW_DECODE_MAX_MODULES
+  #define SYSVIEW_DECODE_MAX_MODULES        32      // Number of module descriptions which are tracked
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SYSVIEW_DECODE_MAX_PARAMS           4       // Parameters of the events with ID < 24
+#define SYSVIEW_DECODE_MODULE_EVENT_OFFSET  512     // First event ID of modules, MODULE_EVENT_OFFSET of the recorder
+
+//
+// Flags for SYSVIEW_DECODE_Init()
+//
+#define SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA  (1u << 0)   // Stream recorded with SEGGER_SYSVIEW_USE_DELTA_OF_DELTA
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  U32       Id;                                 // Event ID as sent
+  U32       SubId;                              // SYSVIEW_EVTID_EX: Sub-event ID. Module event: Event ID within the module. Otherwise 0.
+  int       ModuleIndex;                        // Module event: Index of the module in the order of registration. Otherwise, or if not described, -1.
+  U64       Time;                               // Absolute time stamp in ticks since the first sync
+  unsigned  NumParams;                          // Events with ID < 24: Number of parameters in aParam[]. Otherwise 0.
+  U32       aParam[SYSVIEW_DECODE_MAX_PARAMS];
+  const U8* pPayload;                           // Payload after ID and length, i.e. the parameters of events with ID < 24
+  unsigned  PayloadSize;
+  unsigned  PacketSize;                         // Size of the packet in the stream, including ID and time stamp. 0 if not known.
+  const U8* pDataEnd;                           // End of the data containing the packet, for SYSVIEW_DECODE_GetU32s()
+} SYSVIEW_DECODE_EVENT;
+
+typedef void SYSVIEW_DECODE_EVENT_FUNC(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent);
+
+typedef struct {
+  SYSVIEW_DECODE_EVENT_FUNC* pfOnEvent;
+  void*                      pContext;
+  unsigned                   Flags;
+  int                        IsSynced;          // 0: Searching the next sync, events are skipped
+  unsigned                   NumZeros;          // Zero bytes of the sync seen so far, while not synced
+  U64                        Time;
+  U32                        PrevDelta;         // SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA: Time stamp delta of the previous packet
+  U64                        NumEvents;
+  U64                        NumBytesSkipped;   // Bytes skipped while searching a sync
+  U32                        NumResyncs;        // Corrupt packets after which the decoder has searched the next sync
+  unsigned                   NumModules;
+  U32                        aModuleOffset[SYSVIEW_DECODE_MAX_MODULES];   // Event offsets of the described modules, ascending
+  unsigned                   NumBytesCarry;
+  U8                         aCarry[SYSVIEW_DECODE_MAX_PACKET_SIZE];   // Start of a packet which continues in the next call
+} SYSVIEW_DECODE_CONTEXT;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+void     SYSVIEW_DECODE_Init   (SYSVIEW_DECODE_CONTEXT* pDecode, unsigned Flags, SYSVIEW_DECODE_EVENT_FUNC* pfOnEvent, void* pContext);
+void     SYSVIEW_DECODE_Feed   (SYSVIEW_DECODE_CONTEXT* pDecode, const U8* pData, unsigned NumBytes);
+unsigned SYSVIEW_DECODE_GetU32s(const SYSVIEW_DECODE_EVENT* pEvent, U32* paValue, unsigned MaxNumValues);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
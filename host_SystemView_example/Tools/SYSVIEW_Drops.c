@@ -0,0 +1,261 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Drops.c
+Purpose : Reports the packets recorded and dropped per event class in
+          streams recorded with SEGGER_SYSVIEW_USE_DROP_STATS.
+
+Additional information:
+  With SEGGER_SYSVIEW_USE_DROP_STATS, the recorder counts every packet
+  it drops as the RTT buffer is full per event class and sends the
+  counts since SEGGER_SYSVIEW_Init() after each overflow packet, in a
+  SYSVIEW_EVTID_EX packet with sub-ID SYSVIEW_EVTID_EX_DROP_STATS.
+  The events of the stream are counted per class as well, so the
+  report shows for each class how much it offered to the transport
+  and how much of it was lost. The overflow and drop statistics
+  packets themselves are not counted.
+  The counts are per shard, so streams of shards are reported one
+  by one, before they are merged.
+*/
+#include <string.h>
+#include "SYSVIEW_Drops.h"
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+//
+// Event class of the events with ID < 32, as in the recorder.
+//
+static const U8 _aClass[32] = {
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_NOP
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_OVERFLOW
+  SEGGER_SYSVIEW_DROP_CLASS_ISR,      // SYSVIEW_EVTID_ISR_ENTER
+  SEGGER_SYSVIEW_DROP_CLASS_ISR,      // SYSVIEW_EVTID_ISR_EXIT
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_START_EXEC
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_STOP_EXEC
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_START_READY
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_STOP_READY
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_TASK_CREATE
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_TASK_INFO
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_TRACE_START
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_TRACE_STOP
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SYSTIME_CYCLES
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SYSTIME_US
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SYSDESC
+  SEGGER_SYSVIEW_DROP_CLASS_MARK,     // SYSVIEW_EVTID_MARK_START
+  SEGGER_SYSVIEW_DROP_CLASS_MARK,     // SYSVIEW_EVTID_MARK_STOP
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_IDLE
+  SEGGER_SYSVIEW_DROP_CLASS_ISR,      // SYSVIEW_EVTID_ISR_TO_SCHEDULER
+  SEGGER_SYSVIEW_DROP_CLASS_TIMER,    // SYSVIEW_EVTID_TIMER_ENTER
+  SEGGER_SYSVIEW_DROP_CLASS_TIMER,    // SYSVIEW_EVTID_TIMER_EXIT
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_STACK_INFO
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_MODULEDESC
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // 23, unused
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_INIT
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_NAME_RESOURCE
+  SEGGER_SYSVIEW_DROP_CLASS_PRINT,    // SYSVIEW_EVTID_PRINT_FORMATTED
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_NUMMODULES
+  SEGGER_SYSVIEW_DROP_CLASS_API,      // SYSVIEW_EVTID_END_CALL
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_TASK_TERMINATE
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SHARD_SYNC
+  SEGGER_SYSVIEW_DROP_CLASS_MARK      // SYSVIEW_EVTID_EX
+};
+
+static const char* const _asClassName[SEGGER_SYSVIEW_NUM_DROP_CLASSES] = {
+  "System", "ISR", "Scheduler", "Task", "Timer", "Mark", "Print", "API", "Module"
+};
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_DROPS_Init()
+*
+*  Function description
+*    Initializes the statistics of a stream.
+*/
+void SYSVIEW_DROPS_Init(SYSVIEW_DROPS* pDrops) {
+  memset(pDrops, 0, sizeof(*pDrops));
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_DROPS_OnEvent()
+*
+*  Function description
+*    Counts an event of the stream. To be called from the callback
+*    of the streaming decoder.
+*
+*  Parameters
+*    pDrops - Statistics of the stream.
+*    pEvent - Decoded event.
+*/
+void SYSVIEW_DROPS_OnEvent(SYSVIEW_DROPS* pDrops, const SYSVIEW_DECODE_EVENT* pEvent) {
+  U32      aValue[1 + 1 + SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+  unsigned NumValues;
+  unsigned Class;
+  unsigned i;
+
+  if (pDrops->NumEvents++ == 0) {
+    pDrops->FirstTime = pEvent->Time;
+  }
+  pDrops->LastTime = pEvent->Time;
+  if (pEvent->Id == SYSVIEW_EVTID_OVERFLOW) {
+    pDrops->NumOverflows++;
+    return;
+  }
+  if (pEvent->Id == SYSVIEW_EVTID_EX && pEvent->SubId == SYSVIEW_EVTID_EX_DROP_STATS) {
+    NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, 1 + 1 + SEGGER_SYSVIEW_NUM_DROP_CLASSES);
+    if (NumValues >= 2) {
+      NumValues -= 2;
+      if (NumValues > aValue[1]) {
+        NumValues = aValue[1];              // Classes sent
+      }
+      for (i = 0; i < NumValues; i++) {
+        pDrops->aNumDropped[i] = aValue[2 + i];
+      }
+      pDrops->NumDropStats++;
+    }
+    return;
+  }
+  Class = SYSVIEW_DROPS_GetClass(pEvent->Id, pEvent->SubId);
+  pDrops->aNumRecorded[Class]++;
+  pDrops->aNumBytesRecorded[Class] += pEvent->PacketSize;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_DROPS_GetReport()
+*
+*  Function description
+*    Returns the statistics of all event classes and determines which
+*    classes exceed the transport budget.
+*
+*  Parameters
+*    pDrops            - Statistics of the stream.
+*    TimestampFreq     - Frequency of the time stamp units of the stream.
+*    BudgetBytesPerSec - Bandwidth of the transport, 0 to take the
+*                        bandwidth of the recorded packets.
+*    paInfo            - Receives SEGGER_SYSVIEW_NUM_DROP_CLASSES
+*                        statistics, indexed by SEGGER_SYSVIEW_DROP_CLASS_*.
+*
+*  Return value
+*    Budget used in bytes per second, 0 if the stream is too short.
+*
+*  Additional information
+*    The size of the dropped packets is estimated from the average
+*    size of the recorded packets of the class.
+*    The classes which exceed the budget are the fewest classes, taken
+*    in order of the bandwidth they offer, which have to be filtered
+*    so the bandwidth offered by the others fits into the budget.
+*/
+double SYSVIEW_DROPS_GetReport(const SYSVIEW_DROPS* pDrops, U32 TimestampFreq, double BudgetBytesPerSec, SYSVIEW_DROPS_CLASS_INFO* paInfo) {
+  SYSVIEW_DROPS_CLASS_INFO* pInfo;
+  double                    Duration;
+  double                    NumBytesOffered;
+  double                    NumBytesRecorded;
+  double                    Rate;
+  double                    Max;
+  unsigned                  Class;
+  unsigned                  i;
+
+  memset(paInfo, 0, SEGGER_SYSVIEW_NUM_DROP_CLASSES * sizeof(*paInfo));
+  Duration         = TimestampFreq ? (double)(pDrops->LastTime - pDrops->FirstTime) / TimestampFreq : 0;
+  NumBytesOffered  = 0;
+  NumBytesRecorded = 0;
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_DROP_CLASSES; i++) {
+    pInfo                   = &paInfo[i];
+    pInfo->NumRecorded      = pDrops->aNumRecorded[i];
+    pInfo->NumBytesRecorded = pDrops->aNumBytesRecorded[i];
+    pInfo->NumDropped       = pDrops->aNumDropped[i];
+    if (pInfo->NumRecorded) {
+      pInfo->NumBytesDropped = pInfo->NumBytesRecorded * pInfo->NumDropped / pInfo->NumRecorded;
+    }
+    if (pInfo->NumRecorded + pInfo->NumDropped) {
+      pInfo->DropRatio = (double)pInfo->NumDropped / (double)(pInfo->NumRecorded + pInfo->NumDropped);
+    }
+    NumBytesOffered  += (double)(pInfo->NumBytesRecorded + pInfo->NumBytesDropped);
+    NumBytesRecorded += (double)pInfo->NumBytesRecorded;
+  }
+  if (Duration <= 0) {
+    return 0;
+  }
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_DROP_CLASSES; i++) {
+    pInfo = &paInfo[i];
+    pInfo->OfferedBytesPerSec = (double)(pInfo->NumBytesRecorded + pInfo->NumBytesDropped) / Duration;
+    if (NumBytesOffered > 0) {
+      pInfo->OfferedShare = (double)(pInfo->NumBytesRecorded + pInfo->NumBytesDropped) / NumBytesOffered;
+    }
+  }
+  if (BudgetBytesPerSec <= 0) {
+    BudgetBytesPerSec = NumBytesRecorded / Duration;
+  }
+  //
+  // Take the classes offering the most bandwidth until the others fit.
+  //
+  Rate = NumBytesOffered / Duration;
+  while (Rate > BudgetBytesPerSec) {
+    Class = SEGGER_SYSVIEW_NUM_DROP_CLASSES;
+    Max   = 0;
+    for (i = 0; i < SEGGER_SYSVIEW_NUM_DROP_CLASSES; i++) {
+      if (paInfo[i].ExceedsBudget == 0 && paInfo[i].OfferedBytesPerSec > Max) {
+        Max   = paInfo[i].OfferedBytesPerSec;
+        Class = i;
+      }
+    }
+    if (Class == SEGGER_SYSVIEW_NUM_DROP_CLASSES) {
+      break;
+    }
+    paInfo[Class].ExceedsBudget = 1;
+    Rate -= Max;
+  }
+  return BudgetBytesPerSec;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_DROPS_GetClass()
+*
+*  Function description
+*    Returns the event class of an event, as counted by the recorder.
+*
+*  Parameters
+*    EventId - ID of the event.
+*    SubId   - Sub-event ID of SYSVIEW_EVTID_EX events.
+*/
+unsigned SYSVIEW_DROPS_GetClass(U32 EventId, U32 SubId) {
+  if (EventId < 32) {
+    if ((EventId == SYSVIEW_EVTID_EX) && (SubId == SYSVIEW_EVTID_EX_PRINT_DEFERRED)) {
+      return SEGGER_SYSVIEW_DROP_CLASS_PRINT;
+    }
+    return _aClass[EventId];
+  }
+  if (EventId < SYSVIEW_DECODE_MODULE_EVENT_OFFSET) {
+    return SEGGER_SYSVIEW_DROP_CLASS_API;
+  }
+  return SEGGER_SYSVIEW_DROP_CLASS_MODULE;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_DROPS_GetClassName()
+*
+*  Function description
+*    Returns the name of an event class.
+*/
+const char* SYSVIEW_DROPS_GetClassName(unsigned Class) {
+  return (Class < SEGGER_SYSVIEW_NUM_DROP_CLASSES) ? _asClassName[Class] : "?";
+}
+
+/*************************** End of file ****************************/
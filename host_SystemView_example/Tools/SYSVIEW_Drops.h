@@ -0,0 +1,72 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Drops.h
+Purpose : Interface of the per event class overflow report of streams
+          recorded with SEGGER_SYSVIEW_USE_DROP_STATS.
+*/
+
+#ifndef SYSVIEW_DROPS_H
+#define SYSVIEW_DROPS_H
+
+#include "SEGGER.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Decode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+//
+// Statistics of one stream, i.e. of one shard.
+//
+typedef struct {
+  U64 aNumRecorded[SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+  U64 aNumBytesRecorded[SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+  U32 aNumDropped[SEGGER_SYSVIEW_NUM_DROP_CLASSES];        // From the last SYSVIEW_EVTID_EX_DROP_STATS packet
+  U32 NumOverflows;                                        // Overflow packets received
+  U32 NumDropStats;                                        // SYSVIEW_EVTID_EX_DROP_STATS packets received
+  U64 FirstTime;
+  U64 LastTime;
+  U64 NumEvents;
+} SYSVIEW_DROPS;
+
+typedef struct {
+  U64    NumRecorded;
+  U64    NumBytesRecorded;
+  U32    NumDropped;
+  U64    NumBytesDropped;                // Estimated from the average packet size of the class
+  double DropRatio;                      // Dropped of recorded and dropped packets
+  double OfferedBytesPerSec;             // Recorded and dropped bytes per second
+  double OfferedShare;                   // Of the bytes offered by all classes
+  int    ExceedsBudget;                  // 1: One of the classes which have to be filtered to fit into the budget
+} SYSVIEW_DROPS_CLASS_INFO;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+void        SYSVIEW_DROPS_Init        (SYSVIEW_DROPS* pDrops);
+void        SYSVIEW_DROPS_OnEvent     (SYSVIEW_DROPS* pDrops, const SYSVIEW_DECODE_EVENT* pEvent);
+double      SYSVIEW_DROPS_GetReport   (const SYSVIEW_DROPS* pDrops, U32 TimestampFreq, double BudgetBytesPerSec, SYSVIEW_DROPS_CLASS_INFO* paInfo);
+unsigned    SYSVIEW_DROPS_GetClass    (U32 EventId, U32 SubId);
+const char* SYSVIEW_DROPS_GetClassName(unsigned Class);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -0,0 +1,100 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Expand.c
+Purpose : Converts a stream recorded with SEGGER_SYSVIEW_USE_DELTA_OF_DELTA
+          into a standard SystemView stream.
+
+Additional information:
+  With SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, each packet ends with the
+  zig-zag encoded difference of its time stamp delta to the delta of the
+  previous packet. The chain starts with a previous delta of 0 and is
+  reset by each sync and before each shard sync packet.
+  The packets are copied unchanged, only the time stamp is replaced
+  by the delta. Streams of shards are expanded one by one, before
+  they are merged.
+*/
+#include <stddef.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Expand.h"
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_EXPAND_Run()
+*
+*  Function description
+*    Expands the time stamps of a delta-of-delta coded stream.
+*
+*  Parameters
+*    pData       - Raw stream read from the RTT up-channel.
+*    NumBytes    - Number of bytes in the stream.
+*    pfWrite     - Called with the data of the expanded stream.
+*    pContext    - Passed to pfWrite.
+*    pNumPackets - Receives the number of packets expanded. May be NULL.
+*
+*  Return value
+*    == 0: O.K.
+*     < 0: Corrupt stream, the expanded stream ends before the corrupt packet.
+*/
+int SYSVIEW_EXPAND_Run(const U8* pData, unsigned NumBytes, SYSVIEW_PACKET_WRITE_FUNC* pfWrite, void* pContext, U32* pNumPackets) {
+  const U8* p;
+  const U8* pEnd;
+  const U8* pSync;
+  const U8* pDelta;
+  const U8* pNext;
+  U8        aDelta[5];
+  U32       Id;
+  U32       v;
+  U32       PrevDelta;
+  U32       NumPackets;
+  int       r;
+
+  p          = pData;
+  pEnd       = pData + NumBytes;
+  PrevDelta  = 0;
+  NumPackets = 0;
+  r          = 0;
+  while (p < pEnd) {
+    if (*p == SYSVIEW_EVTID_NOP) {              // Sync, no time stamp
+      pSync = p;
+      do {
+        p++;
+      } while (p < pEnd && *p == SYSVIEW_EVTID_NOP);
+      pfWrite(pContext, pSync, (unsigned)(p - pSync));
+      PrevDelta = 0;
+      continue;
+    }
+    pNext = NULL;
+    if (SYSVIEW_PACKET_Parse(p, pEnd, &Id, &pDelta) > 0) {
+      pNext = SYSVIEW_PACKET_DecodeU32(pDelta, pEnd, &v);
+    }
+    if (pNext == NULL) {
+      r = -1;
+      break;
+    }
+    if (Id == SYSVIEW_EVTID_SHARD_SYNC) {
+      PrevDelta = 0;
+    }
+    PrevDelta += (v >> 1) ^ (0u - (v & 1u));   // Undo zig-zag encoding
+    pfWrite(pContext, p, (unsigned)(pDelta - p));
+    pfWrite(pContext, aDelta, (unsigned)(SYSVIEW_PACKET_EncodeU32(aDelta, PrevDelta) - aDelta));
+    p = pNext;
+    NumPackets++;
+  }
+  if (pNumPackets) {
+    *pNumPackets = NumPackets;
+  }
+  return r;
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,36 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Expand.h
+Purpose : Interface of the host-side conversion of streams recorded
+          with SEGGER_SYSVIEW_USE_DELTA_OF_DELTA.
+*/
+
+#ifndef SYSVIEW_EXPAND_H
+#define SYSVIEW_EXPAND_H
+
+#include "SEGGER.h"
+#include "SYSVIEW_Packet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+int SYSVIEW_EXPAND_Run(const U8* pData, unsigned NumBytes, SYSVIEW_PACKET_WRITE_FUNC* pfWrite, void* pContext, U32* pNumPackets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -0,0 +1,502 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Index.c
+Purpose : Indexed trace file, which gives random access to a
+          SystemView stream by time and by context.
+
+Additional information:
+  A stream, e.g. a post-mortem capture, can only be decoded from the
+  start or from a sync, as time stamps are sent as deltas. The index
+  file holds the decoded stream in columns: the absolute time stamp,
+  the event ID and the payload of every event. As the time stamps
+  ascend, the event at a time is found by a binary search in the time
+  column. For every task and interrupt the file lists the events which
+  enter it, SYSVIEW_EVTID_TASK_START_EXEC and SYSVIEW_EVTID_ISR_ENTER,
+  so its activations around a time are found by a binary search, too.
+
+  The file is built in two passes over the stream, without allocation:
+  SYSVIEW_INDEX_Scan() counts events, payload bytes and entries and
+  returns the size of the file. SYSVIEW_INDEX_Write() decodes the
+  stream again and fills the file, e.g. a memory-mapped file of this
+  size. SYSVIEW_INDEX_Open() only checks the header, so opening a
+  memory-mapped file does not read the columns.
+*/
+#include <stddef.h>
+#include <string.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Index.h"
+#include "SYSVIEW_Packet.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define MAX_FEED_SIZE     (1u << 30)      // SYSVIEW_DECODE_Feed() takes an unsigned size
+
+#define ALIGN8(Off)       (((Off) + 7u) & ~(U64)7u)
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _GetContextKey()
+*
+*  Function description
+*    Returns whether an event enters a context and which one.
+*
+*  Return value
+*    1: Event enters the context of kind *pKind and ID *pId.
+*    0: Event does not enter a context.
+*/
+static int _GetContextKey(const SYSVIEW_DECODE_EVENT* pEvent, U32* pKind, U32* pId) {
+  if (pEvent->Id == SYSVIEW_EVTID_TASK_START_EXEC) {
+    *pKind = SYSVIEW_INDEX_KIND_TASK;
+  } else if (pEvent->Id == SYSVIEW_EVTID_ISR_ENTER) {
+    *pKind = SYSVIEW_INDEX_KIND_ISR;
+  } else {
+    return 0;
+  }
+  *pId = pEvent->aParam[0];
+  return 1;
+}
+
+/*********************************************************************
+*
+*       _FindContext()
+*
+*  Function description
+*    Binary search of a context in an array ascending by kind and ID.
+*
+*  Return value
+*    Position of the context, or of the first context after it if it
+*    is not in the array.
+*/
+static unsigned _FindContext(const SYSVIEW_INDEX_CONTEXT* paContext, unsigned NumContexts, U32 Kind, U32 Id) {
+  unsigned Lo;
+  unsigned Hi;
+  unsigned Mid;
+
+  Lo = 0;
+  Hi = NumContexts;
+  while (Lo < Hi) {
+    Mid = (Lo + Hi) / 2;
+    if (paContext[Mid].Kind < Kind || (paContext[Mid].Kind == Kind && paContext[Mid].Id < Id)) {
+      Lo = Mid + 1;
+    } else {
+      Hi = Mid;
+    }
+  }
+  return Lo;
+}
+
+/*********************************************************************
+*
+*       _cbScan()
+*
+*  Function description
+*    Counts an event and, if it enters a context, the entry of the context.
+*/
+static void _cbScan(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_INDEX_BUILD*   pBuild;
+  SYSVIEW_INDEX_CONTEXT* pCtx;
+  unsigned               i;
+  U32                    Kind;
+  U32                    Id;
+
+  pBuild = (SYSVIEW_INDEX_BUILD*)pContext;
+  pBuild->NumEvents++;
+  pBuild->NumBytesPayload += pEvent->PayloadSize;
+  if (_GetContextKey(pEvent, &Kind, &Id) == 0) {
+    return;
+  }
+  i = _FindContext(pBuild->aContext, pBuild->NumContexts, Kind, Id);
+  if (i == pBuild->NumContexts || pBuild->aContext[i].Kind != Kind || pBuild->aContext[i].Id != Id) {
+    if (pBuild->NumContexts == SYSVIEW_INDEX_MAX_CONTEXTS) {
+      pBuild->NumContextsSkipped++;
+      return;
+    }
+    memmove(&pBuild->aContext[i + 1], &pBuild->aContext[i], (pBuild->NumContexts - i) * sizeof(pBuild->aContext[0]));
+    pCtx             = &pBuild->aContext[i];
+    pCtx->Kind       = Kind;
+    pCtx->Id         = Id;
+    pCtx->FirstEntry = 0;
+    pCtx->NumEntries = 0;
+    pBuild->NumContexts++;
+  }
+  pBuild->aContext[i].NumEntries++;
+}
+
+/*********************************************************************
+*
+*       _cbWrite()
+*
+*  Function description
+*    Writes an event into the columns and, if it enters a context,
+*    the entry of the context.
+*/
+static void _cbWrite(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_INDEX_BUILD*  pBuild;
+  SYSVIEW_INDEX_HEADER* pHeader;
+  U64*                  paPayloadOff;
+  U64                   PayloadOff;
+  U64                   Entry;
+  unsigned              i;
+  U32                   Kind;
+  U32                   Id;
+
+  pBuild       = (SYSVIEW_INDEX_BUILD*)pContext;
+  pHeader      = &pBuild->Header;
+  paPayloadOff = (U64*)(pBuild->pIndex + pHeader->OffPayloadOff);
+  if (pBuild->NumEvents == pHeader->NumEvents) {
+    return;                                   // Stream differs from the one scanned
+  }
+  PayloadOff = paPayloadOff[pBuild->NumEvents];
+  if (PayloadOff + pEvent->PayloadSize > pHeader->NumBytesPayload) {
+    return;
+  }
+  ((U64*)(pBuild->pIndex + pHeader->OffTime))[pBuild->NumEvents] = pEvent->Time;
+  ((U32*)(pBuild->pIndex + pHeader->OffId))[pBuild->NumEvents]   = pEvent->Id;
+  memcpy(pBuild->pIndex + pHeader->OffPayload + PayloadOff, pEvent->pPayload, pEvent->PayloadSize);
+  pBuild->NumEvents++;
+  paPayloadOff[pBuild->NumEvents] = PayloadOff + pEvent->PayloadSize;
+  if (_GetContextKey(pEvent, &Kind, &Id) == 0) {
+    return;
+  }
+  i = _FindContext(pBuild->aContext, pBuild->NumContexts, Kind, Id);
+  if (i < pBuild->NumContexts && pBuild->aContext[i].Kind == Kind && pBuild->aContext[i].Id == Id
+   && pBuild->aNumWritten[i] < pBuild->aContext[i].NumEntries) {
+    Entry = pBuild->aContext[i].FirstEntry + pBuild->aNumWritten[i]++;
+    ((U64*)(pBuild->pIndex + pHeader->OffEntry))[Entry] = pBuild->NumEvents - 1;
+  }
+}
+
+/*********************************************************************
+*
+*       _Decode()
+*
+*  Function description
+*    Decodes the whole stream, in chunks SYSVIEW_DECODE_Feed() takes.
+*/
+static void _Decode(SYSVIEW_INDEX_BUILD* pBuild, const U8* pData, U64 NumBytes, unsigned DecodeFlags, SYSVIEW_DECODE_EVENT_FUNC* pfOnEvent) {
+  U64 Pos;
+  U64 NumBytesChunk;
+
+  SYSVIEW_DECODE_Init(&pBuild->Decode, DecodeFlags, pfOnEvent, pBuild);
+  for (Pos = 0; Pos < NumBytes; Pos += NumBytesChunk) {
+    NumBytesChunk = NumBytes - Pos;
+    if (NumBytesChunk > MAX_FEED_SIZE) {
+      NumBytesChunk = MAX_FEED_SIZE;
+    }
+    SYSVIEW_DECODE_Feed(&pBuild->Decode, pData + Pos, (unsigned)NumBytesChunk);
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_Scan()
+*
+*  Function description
+*    First pass of building an index file: Decodes the stream and
+*    computes the layout of the file.
+*
+*  Parameters
+*    pBuild      - Builder, allocated by the caller.
+*    pData       - Stream, e.g. as read from the RTT up-channel or a post-mortem buffer.
+*    NumBytes    - Size of the stream.
+*    DecodeFlags - Combination of SYSVIEW_DECODE_FLAG_*, as for SYSVIEW_DECODE_Init().
+*
+*  Return value
+*    Size of the index file in bytes.
+*/
+U64 SYSVIEW_INDEX_Scan(SYSVIEW_INDEX_BUILD* pBuild, const U8* pData, U64 NumBytes, unsigned DecodeFlags) {
+  SYSVIEW_INDEX_HEADER* pHeader;
+  U64                   NumEntries;
+  unsigned              i;
+
+  pBuild->NumContexts        = 0;
+  pBuild->NumContextsSkipped = 0;
+  pBuild->NumEvents          = 0;
+  pBuild->NumBytesPayload    = 0;
+  pBuild->pIndex             = NULL;
+  _Decode(pBuild, pData, NumBytes, DecodeFlags, _cbScan);
+  NumEntries = 0;
+  for (i = 0; i < pBuild->NumContexts; i++) {
+    pBuild->aContext[i].FirstEntry = NumEntries;
+    NumEntries                    += pBuild->aContext[i].NumEntries;
+  }
+  pHeader = &pBuild->Header;
+  memset(pHeader, 0, sizeof(*pHeader));
+  pHeader->Magic           = SYSVIEW_INDEX_MAGIC;
+  pHeader->Version         = SYSVIEW_INDEX_VERSION;
+  pHeader->DecodeFlags     = DecodeFlags;
+  pHeader->NumContexts     = pBuild->NumContexts;
+  pHeader->NumModules      = pBuild->Decode.NumModules;
+  pHeader->NumResyncs      = pBuild->Decode.NumResyncs;
+  pHeader->NumEvents       = pBuild->NumEvents;
+  pHeader->NumBytesStream  = NumBytes;
+  pHeader->NumBytesPayload = pBuild->NumBytesPayload;
+  pHeader->OffTime         = ALIGN8(sizeof(*pHeader));
+  pHeader->OffId           = pHeader->OffTime       + pHeader->NumEvents * sizeof(U64);
+  pHeader->OffPayloadOff   = ALIGN8(pHeader->OffId  + pHeader->NumEvents * sizeof(U32));
+  pHeader->OffPayload      = pHeader->OffPayloadOff + (pHeader->NumEvents + 1) * sizeof(U64);
+  pHeader->OffContext      = ALIGN8(pHeader->OffPayload + pHeader->NumBytesPayload);
+  pHeader->OffEntry        = pHeader->OffContext    + pHeader->NumContexts * sizeof(SYSVIEW_INDEX_CONTEXT);
+  pHeader->OffModule       = pHeader->OffEntry      + NumEntries * sizeof(U64);
+  pHeader->FileSize        = ALIGN8(pHeader->OffModule + pHeader->NumModules * sizeof(U32));
+  return pHeader->FileSize;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_Write()
+*
+*  Function description
+*    Second pass of building an index file: Decodes the stream again
+*    and writes the file.
+*
+*  Parameters
+*    pBuild   - Builder, passed to SYSVIEW_INDEX_Scan() before.
+*    pData    - Stream, the same as passed to SYSVIEW_INDEX_Scan().
+*    NumBytes - Size of the stream.
+*    pIndex   - Receives the file, 8-byte aligned, of the size returned
+*               by SYSVIEW_INDEX_Scan(), e.g. a memory-mapped file.
+*/
+void SYSVIEW_INDEX_Write(SYSVIEW_INDEX_BUILD* pBuild, const U8* pData, U64 NumBytes, void* pIndex) {
+  SYSVIEW_INDEX_HEADER* pHeader;
+  U64                   Off;
+
+  pHeader        = &pBuild->Header;
+  pBuild->pIndex = (U8*)pIndex;
+  //
+  // Clear the padding between the sections
+  //
+  Off = pHeader->OffId + pHeader->NumEvents * sizeof(U32);
+  memset(pBuild->pIndex + Off, 0, (size_t)(pHeader->OffPayloadOff - Off));
+  Off = pHeader->OffPayload + pHeader->NumBytesPayload;
+  memset(pBuild->pIndex + Off, 0, (size_t)(pHeader->OffContext - Off));
+  Off = pHeader->OffModule + pHeader->NumModules * sizeof(U32);
+  memset(pBuild->pIndex + Off, 0, (size_t)(pHeader->FileSize - Off));
+  ((U64*)(pBuild->pIndex + pHeader->OffPayloadOff))[0] = 0;
+  memcpy(pBuild->pIndex, pHeader, sizeof(*pHeader));
+  memcpy(pBuild->pIndex + pHeader->OffContext, pBuild->aContext, pBuild->NumContexts * sizeof(pBuild->aContext[0]));
+  memcpy(pBuild->pIndex + pHeader->OffModule, pBuild->Decode.aModuleOffset, pHeader->NumModules * sizeof(U32));
+  memset(pBuild->aNumWritten, 0, sizeof(pBuild->aNumWritten));
+  pBuild->NumEvents = 0;
+  _Decode(pBuild, pData, NumBytes, pHeader->DecodeFlags, _cbWrite);
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_Open()
+*
+*  Function description
+*    Opens an index file.
+*
+*  Parameters
+*    pIndex   - Receives the opened index.
+*    pData    - Data of the file, 8-byte aligned, e.g. a memory-mapped file.
+*    NumBytes - Size of the file.
+*
+*  Return value
+*    = 0: O.K.
+*    < 0: Not an index file of this version, or truncated.
+*
+*  Additional information
+*    Only the header is read, the columns are accessed on demand.
+*/
+int SYSVIEW_INDEX_Open(SYSVIEW_INDEX* pIndex, const void* pData, U64 NumBytes) {
+  const SYSVIEW_INDEX_HEADER* pHeader;
+  const U8*                   p;
+
+  p       = (const U8*)pData;
+  pHeader = (const SYSVIEW_INDEX_HEADER*)pData;
+  if (NumBytes < sizeof(*pHeader)
+   || pHeader->Magic != SYSVIEW_INDEX_MAGIC
+   || pHeader->Version != SYSVIEW_INDEX_VERSION
+   || pHeader->FileSize != NumBytes
+   || pHeader->OffModule + pHeader->NumModules * sizeof(U32) > NumBytes
+   || pHeader->OffTime + pHeader->NumEvents * sizeof(U64) > pHeader->OffId
+   || pHeader->OffPayload + pHeader->NumBytesPayload > pHeader->OffContext
+   || pHeader->OffContext + pHeader->NumContexts * sizeof(SYSVIEW_INDEX_CONTEXT) > pHeader->OffEntry) {
+    return -1;
+  }
+  pIndex->pHeader        = pHeader;
+  pIndex->paTime         = (const U64*)(p + pHeader->OffTime);
+  pIndex->paId           = (const U32*)(p + pHeader->OffId);
+  pIndex->paPayloadOff   = (const U64*)(p + pHeader->OffPayloadOff);
+  pIndex->pPayload       = p + pHeader->OffPayload;
+  pIndex->paContext      = (const SYSVIEW_INDEX_CONTEXT*)(p + pHeader->OffContext);
+  pIndex->paEntry        = (const U64*)(p + pHeader->OffEntry);
+  pIndex->paModuleOffset = (const U32*)(p + pHeader->OffModule);
+  pIndex->NumEvents      = pHeader->NumEvents;
+  pIndex->NumContexts    = pHeader->NumContexts;
+  return 0;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_FindTime()
+*
+*  Function description
+*    Finds the first event at or after a time.
+*
+*  Parameters
+*    pIndex - Opened index.
+*    Time   - Absolute time stamp.
+*
+*  Return value
+*    Index of the event, NumEvents if all events are before Time.
+*/
+U64 SYSVIEW_INDEX_FindTime(const SYSVIEW_INDEX* pIndex, U64 Time) {
+  U64 Lo;
+  U64 Hi;
+  U64 Mid;
+
+  Lo = 0;
+  Hi = pIndex->NumEvents;
+  while (Lo < Hi) {
+    Mid = Lo + (Hi - Lo) / 2;
+    if (pIndex->paTime[Mid] < Time) {
+      Lo = Mid + 1;
+    } else {
+      Hi = Mid;
+    }
+  }
+  return Lo;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_FindContext()
+*
+*  Function description
+*    Finds a task or interrupt.
+*
+*  Parameters
+*    pIndex - Opened index.
+*    Kind   - SYSVIEW_INDEX_KIND_TASK or SYSVIEW_INDEX_KIND_ISR.
+*    Id     - Task ID as sent, or interrupt ID.
+*
+*  Return value
+*    Context, NULL if it is never entered in the stream.
+*/
+const SYSVIEW_INDEX_CONTEXT* SYSVIEW_INDEX_FindContext(const SYSVIEW_INDEX* pIndex, unsigned Kind, U32 Id) {
+  unsigned i;
+
+  i = _FindContext(pIndex->paContext, pIndex->NumContexts, Kind, Id);
+  if (i < pIndex->NumContexts && pIndex->paContext[i].Kind == Kind && pIndex->paContext[i].Id == Id) {
+    return &pIndex->paContext[i];
+  }
+  return NULL;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_FindEntry()
+*
+*  Function description
+*    Finds the first entry of a context at or after a time.
+*
+*  Parameters
+*    pIndex   - Opened index.
+*    pContext - Context returned by SYSVIEW_INDEX_FindContext().
+*    Time     - Absolute time stamp.
+*
+*  Return value
+*    Position of the entry among the entries of the context, NumEntries
+*    if all entries are before Time. The entry before, if any, is the
+*    last activation which started before Time. The index of the event
+*    of entry n is paEntry[pContext->FirstEntry + n].
+*/
+U64 SYSVIEW_INDEX_FindEntry(const SYSVIEW_INDEX* pIndex, const SYSVIEW_INDEX_CONTEXT* pContext, U64 Time) {
+  const U64* paEntry;
+  U64        Lo;
+  U64        Hi;
+  U64        Mid;
+
+  paEntry = pIndex->paEntry + pContext->FirstEntry;
+  Lo      = 0;
+  Hi      = pContext->NumEntries;
+  while (Lo < Hi) {
+    Mid = Lo + (Hi - Lo) / 2;
+    if (pIndex->paTime[paEntry[Mid]] < Time) {
+      Lo = Mid + 1;
+    } else {
+      Hi = Mid;
+    }
+  }
+  return Lo;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_INDEX_GetEvent()
+*
+*  Function description
+*    Gets an event as passed to the callback of the streaming decoder.
+*
+*  Parameters
+*    pIndex     - Opened index.
+*    EventIndex - Index of the event, less than NumEvents.
+*    pEvent     - Receives the event.
+*
+*  Additional information
+*    The payload points into the file. Module events are assigned
+*    with the modules described anywhere in the stream.
+*/
+void SYSVIEW_INDEX_GetEvent(const SYSVIEW_INDEX* pIndex, U64 EventIndex, SYSVIEW_DECODE_EVENT* pEvent) {
+  const U8* p;
+  const U8* pEnd;
+  unsigned  Layout;
+  unsigned  i;
+
+  pEvent->Id          = pIndex->paId[EventIndex];
+  pEvent->SubId       = 0;
+  pEvent->ModuleIndex = -1;
+  pEvent->Time        = pIndex->paTime[EventIndex];
+  pEvent->NumParams   = 0;
+  pEvent->pPayload    = pIndex->pPayload + pIndex->paPayloadOff[EventIndex];
+  pEvent->PayloadSize = (unsigned)(pIndex->paPayloadOff[EventIndex + 1] - pIndex->paPayloadOff[EventIndex]);
+  pEvent->PacketSize  = 0;
+  pEvent->pDataEnd    = pIndex->pPayload + pIndex->pHeader->NumBytesPayload;
+  p                   = pEvent->pPayload;
+  pEnd                = p + pEvent->PayloadSize;
+  if (pEvent->Id < SYSVIEW_PACKET_NUM_FIXED_IDS) {
+    Layout = SYSVIEW_PACKET_aFixedLayout[pEvent->Id];
+    for (i = 0; i < (Layout & SYSVIEW_PACKET_LAYOUT_NUM_PARAMS) && p != NULL; i++) {
+      p = SYSVIEW_PACKET_DecodeU32(p, pEnd, &pEvent->aParam[i]);
+    }
+    pEvent->NumParams = i;
+  } else if (pEvent->Id == SYSVIEW_EVTID_EX) {
+    SYSVIEW_PACKET_DecodeU32(p, pEnd, &pEvent->SubId);
+  } else if (pEvent->Id >= SYSVIEW_DECODE_MODULE_EVENT_OFFSET) {
+    pEvent->SubId = pEvent->Id - SYSVIEW_DECODE_MODULE_EVENT_OFFSET;
+    for (i = pIndex->pHeader->NumModules; i > 0; i--) {
+      if (pEvent->Id >= pIndex->paModuleOffset[i - 1]) {
+        pEvent->ModuleIndex = (int)(i - 1);
+        pEvent->SubId       = pEvent->Id - pIndex->paModuleOffset[i - 1];
+        break;
+      }
+    }
+  }
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,135 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Index.h
+Purpose : Interface of the indexed trace file, which gives random
+          access to a SystemView stream by time and by context.
+*/
+
+#ifndef SYSVIEW_INDEX_H
+#define SYSVIEW_INDEX_H
+
+#include "SEGGER.h"
+#include "SYSVIEW_Decode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SYSVIEW_INDEX_MAX_CONTEXTS
+  #define SYSVIEW_INDEX_MAX_CONTEXTS      256     // Number of tasks and interrupts which are indexed
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SYSVIEW_INDEX_MAGIC               0x58495653u   // "SVIX"
+#define SYSVIEW_INDEX_VERSION             1u
+
+//
+// Kinds of contexts
+//
+#define SYSVIEW_INDEX_KIND_TASK           0       // Indexed at SYSVIEW_EVTID_TASK_START_EXEC, Id is the task ID as sent
+#define SYSVIEW_INDEX_KIND_ISR            1       // Indexed at SYSVIEW_EVTID_ISR_ENTER, Id is the interrupt ID
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+//
+// File header. The file is a sequence of sections at 8-byte aligned
+// offsets from the start of the file, stored in host byte order.
+//
+typedef struct {
+  U32 Magic;                  // SYSVIEW_INDEX_MAGIC
+  U32 Version;                // SYSVIEW_INDEX_VERSION
+  U32 DecodeFlags;            // Flags the stream was decoded with
+  U32 NumContexts;
+  U32 NumModules;
+  U32 NumResyncs;             // Corrupt packets after which the decoder has searched the next sync
+  U64 NumEvents;
+  U64 NumBytesStream;         // Size of the stream the file was built from
+  U64 NumBytesPayload;
+  U64 OffTime;                // U64[NumEvents], absolute time stamps, ascending
+  U64 OffId;                  // U32[NumEvents], event IDs as sent
+  U64 OffPayloadOff;          // U64[NumEvents + 1], offset of the payload of each event in the payload section
+  U64 OffPayload;             // U8[NumBytesPayload], payloads as sent
+  U64 OffContext;             // SYSVIEW_INDEX_CONTEXT[NumContexts], ascending by kind and ID
+  U64 OffEntry;               // U64[], per context, indices of the events which enter it, ascending
+  U64 OffModule;              // U32[NumModules], event offsets of the described modules, ascending
+  U64 FileSize;
+} SYSVIEW_INDEX_HEADER;
+
+typedef struct {
+  U32 Kind;                   // SYSVIEW_INDEX_KIND_*
+  U32 Id;
+  U64 FirstEntry;             // Index of the first entry of the context in the entry section
+  U64 NumEntries;
+} SYSVIEW_INDEX_CONTEXT;
+
+//
+// Opened index, points into the file data.
+//
+typedef struct {
+  const SYSVIEW_INDEX_HEADER*  pHeader;
+  const U64*                   paTime;
+  const U32*                   paId;
+  const U64*                   paPayloadOff;
+  const U8*                    pPayload;
+  const SYSVIEW_INDEX_CONTEXT* paContext;
+  const U64*                   paEntry;
+  const U32*                   paModuleOffset;
+  U64                          NumEvents;
+  unsigned                     NumContexts;
+} SYSVIEW_INDEX;
+
+//
+// Builder, too large for the stack.
+//
+typedef struct {
+  SYSVIEW_DECODE_CONTEXT Decode;
+  SYSVIEW_INDEX_HEADER   Header;
+  unsigned               NumContexts;
+  U32                    NumContextsSkipped;  // Contexts which were not indexed as more than SYSVIEW_INDEX_MAX_CONTEXTS were seen
+  SYSVIEW_INDEX_CONTEXT  aContext[SYSVIEW_INDEX_MAX_CONTEXTS];
+  U64                    aNumWritten[SYSVIEW_INDEX_MAX_CONTEXTS];   // Entries of each context written so far
+  U8*                    pIndex;              // NULL while scanning
+  U64                    NumEvents;
+  U64                    NumBytesPayload;
+} SYSVIEW_INDEX_BUILD;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+U64                          SYSVIEW_INDEX_Scan       (SYSVIEW_INDEX_BUILD* pBuild, const U8* pData, U64 NumBytes, unsigned DecodeFlags);
+void                         SYSVIEW_INDEX_Write      (SYSVIEW_INDEX_BUILD* pBuild, const U8* pData, U64 NumBytes, void* pIndex);
+int                          SYSVIEW_INDEX_Open       (SYSVIEW_INDEX* pIndex, const void* pData, U64 NumBytes);
+U64                          SYSVIEW_INDEX_FindTime   (const SYSVIEW_INDEX* pIndex, U64 Time);
+const SYSVIEW_INDEX_CONTEXT* SYSVIEW_INDEX_FindContext(const SYSVIEW_INDEX* pIndex, unsigned Kind, U32 Id);
+U64                          SYSVIEW_INDEX_FindEntry  (const SYSVIEW_INDEX* pIndex, const SYSVIEW_INDEX_CONTEXT* pContext, U64 Time);
+void                         SYSVIEW_INDEX_GetEvent   (const SYSVIEW_INDEX* pIndex, U64 EventIndex, SYSVIEW_DECODE_EVENT* pEvent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -0,0 +1,180 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Load.c
+Purpose : Sums up the task load reports accounted on the target, for
+          the load of the tasks of a stream without scheduler events.
+
+Additional information:
+  With SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0 the recorder sums up the time
+  between the scheduler and interrupt events per task and sends a
+  SYSVIEW_EVTID_EX packet with sub-ID SYSVIEW_EVTID_EX_LOAD every
+  SEGGER_SYSVIEW_LOAD_PERIOD and by SEGGER_SYSVIEW_RecordLoad():
+    <Period> <IdleLoad> <ISRLoad> <NumTasks> (<TaskId> <Load>)[NumTasks]
+  Period is in timestamp units, the loads are in 1/1000 of the period,
+  rounded. The rest of the period has been spent in tasks which did
+  not fit into the table of the recorder or outside of any task. The
+  reader keeps the last report and sums up the time of each task over
+  all reports, which is off by less than half a period / 1000 per
+  report.
+*/
+#include <string.h>
+#include "SYSVIEW_Load.h"
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _FindTask()
+*
+*  Function description
+*    Returns the load of a task, optionally adding it.
+*
+*  Parameters
+*    pLoad  - Load of the stream.
+*    TaskId - ID of the task.
+*    Add    - 1: Add the task if it is not summed up yet.
+*
+*  Return value
+*    Load of the task, NULL if not found or if the table is full.
+*/
+static SYSVIEW_LOAD_TASK* _FindTask(SYSVIEW_LOAD* pLoad, U32 TaskId, int Add) {
+  SYSVIEW_LOAD_TASK* pTask;
+  unsigned           i;
+
+  for (i = 0; i < pLoad->NumTasks; i++) {
+    if (pLoad->aTask[i].TaskId == TaskId) {
+      return &pLoad->aTask[i];
+    }
+  }
+  if (Add == 0 || pLoad->NumTasks == SYSVIEW_LOAD_MAX_TASKS) {
+    return NULL;
+  }
+  pTask         = &pLoad->aTask[pLoad->NumTasks++];
+  memset(pTask, 0, sizeof(*pTask));
+  pTask->TaskId = TaskId;
+  return pTask;
+}
+
+/*********************************************************************
+*
+*       _GetTime()
+*
+*  Function description
+*    Returns the time of a load in 1/1000 of a period.
+*/
+static U64 _GetTime(U32 Load, U32 Period) {
+  return ((U64)Load * Period + 500u) / 1000u;
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_LOAD_Init()
+*
+*  Function description
+*    Initializes the load of a stream.
+*/
+void SYSVIEW_LOAD_Init(SYSVIEW_LOAD* pLoad) {
+  memset(pLoad, 0, sizeof(*pLoad));
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_LOAD_OnEvent()
+*
+*  Function description
+*    Takes a load report of the stream. To be called from the callback
+*    of the streaming decoder.
+*
+*  Parameters
+*    pLoad  - Load of the stream.
+*    pEvent - Decoded event.
+*
+*  Return value
+*    1: The event is a load report, 0: Other event.
+*/
+int SYSVIEW_LOAD_OnEvent(SYSVIEW_LOAD* pLoad, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_LOAD_TASK* pTask;
+  U32                aValue[5 + 2 * SYSVIEW_LOAD_MAX_TASKS];
+  unsigned           NumValues;
+  unsigned           i;
+
+  if (pEvent->Id != SYSVIEW_EVTID_EX || pEvent->SubId != SYSVIEW_EVTID_EX_LOAD) {
+    return 0;
+  }
+  NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, SEGGER_COUNTOF(aValue));
+  if (NumValues < 5) {
+    return 1;
+  }
+  NumValues = (NumValues - 5) / 2;
+  if (NumValues > aValue[4]) {
+    NumValues = aValue[4];                  // Tasks sent
+  }
+  pLoad->NumReports++;
+  pLoad->Period     = aValue[1];
+  pLoad->IdleLoad   = aValue[2];
+  pLoad->ISRLoad    = aValue[3];
+  pLoad->TotalTime += aValue[1];
+  pLoad->IdleTime  += _GetTime(aValue[2], aValue[1]);
+  pLoad->ISRTime   += _GetTime(aValue[3], aValue[1]);
+  for (i = 0; i < pLoad->NumTasks; i++) {
+    pLoad->aTask[i].Load = 0;
+  }
+  for (i = 0; i < NumValues; i++) {
+    pTask = _FindTask(pLoad, aValue[5 + 2 * i], 1);
+    if (pTask == NULL) {
+      pLoad->NumUncounted++;
+      continue;
+    }
+    pTask->Load  = aValue[6 + 2 * i];
+    pTask->Time += _GetTime(pTask->Load, aValue[1]);
+  }
+  return 1;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_LOAD_GetTask()
+*
+*  Function description
+*    Returns the load of a task, NULL if the task has not been
+*    reported.
+*/
+const SYSVIEW_LOAD_TASK* SYSVIEW_LOAD_GetTask(const SYSVIEW_LOAD* pLoad, U32 TaskId) {
+  return _FindTask((SYSVIEW_LOAD*)pLoad, TaskId, 0);
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_LOAD_GetPermille()
+*
+*  Function description
+*    Returns the load of a task over all reports, in 1/1000 of the
+*    time reported.
+*/
+U32 SYSVIEW_LOAD_GetPermille(const SYSVIEW_LOAD* pLoad, U32 TaskId) {
+  const SYSVIEW_LOAD_TASK* pTask;
+
+  pTask = SYSVIEW_LOAD_GetTask(pLoad, TaskId);
+  if (pTask == NULL || pLoad->TotalTime == 0) {
+    return 0;
+  }
+  return (U32)((pTask->Time * 1000u + pLoad->TotalTime / 2u) / pLoad->TotalTime);
+}
+
+/*************************** End of file ****************************/
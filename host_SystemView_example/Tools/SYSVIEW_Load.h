@@ -0,0 +1,78 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Load.h
+Purpose : Interface of the host-side reader of the task load reports
+          accounted on the target.
+*/
+
+#ifndef SYSVIEW_LOAD_H
+#define SYSVIEW_LOAD_H
+
+#include "SEGGER.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Decode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SYSVIEW_LOAD_MAX_TASKS
+  #define SYSVIEW_LOAD_MAX_TASKS            256     // Tasks which are summed up over the reports
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  U32 TaskId;                                   // As sent by the recorder
+  U32 Load;                                     // Load in the last report, in 1/1000 of its period
+  U64 Time;                                     // Time run over all reports, in timestamp units
+} SYSVIEW_LOAD_TASK;
+
+//
+// Load of one stream.
+//
+typedef struct {
+  U32               NumReports;
+  U32               NumUncounted;               // Tasks which did not fit into aTask[]
+  U32               Period;                     // Period of the last report, in timestamp units
+  U32               IdleLoad;                   // Loads of the last report, in 1/1000 of its period
+  U32               ISRLoad;
+  U64               TotalTime;                  // Sums over all reports, in timestamp units
+  U64               IdleTime;
+  U64               ISRTime;
+  unsigned          NumTasks;
+  SYSVIEW_LOAD_TASK aTask[SYSVIEW_LOAD_MAX_TASKS];
+} SYSVIEW_LOAD;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+void                     SYSVIEW_LOAD_Init       (SYSVIEW_LOAD* pLoad);
+int                      SYSVIEW_LOAD_OnEvent    (SYSVIEW_LOAD* pLoad, const SYSVIEW_DECODE_EVENT* pEvent);
+const SYSVIEW_LOAD_TASK* SYSVIEW_LOAD_GetTask    (const SYSVIEW_LOAD* pLoad, U32 TaskId);
+U32                      SYSVIEW_LOAD_GetPermille(const SYSVIEW_LOAD* pLoad, U32 TaskId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
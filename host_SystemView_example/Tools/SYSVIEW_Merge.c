@@ -0,0 +1,265 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Merge.c
+Purpose : Merges the shards recorded with SEGGER_SYSVIEW_NUM_SHARDS > 1
+          into one time-ordered SystemView stream.
+
+Additional information:
+  Every shard has its own time stamp delta chain. The first sync packet
+  (SYSVIEW_EVTID_SHARD_SYNC) of a shard carries the absolute time stamp
+  and anchors the chain, later sync packets re-anchor it.
+  Events are written in order of their absolute time, with the time
+  stamp delta recomputed for the merged stream.
+  Sync and NOP packets are removed; the merged stream starts with one
+  SystemView sync. Overflow packets report the sum of the drop counts
+  of all shards.
+*/
+#include <string.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Merge.h"
+#include "SYSVIEW_Packet.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define MAX_SHARDS    32
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+typedef struct {
+  const U8* p;              // Next packet to parse
+  const U8* pEnd;
+  int       HaveTime;       // Time is valid, shard has been synced
+  I64       Time;           // Absolute time of the last parsed packet
+  U32       DropCount;      // Last drop count reported by the shard
+  //
+  // Current packet, valid if pPacket != NULL
+  //
+  const U8* pPacket;
+  const U8* pDelta;         // Time stamp delta, i.e. end of ID and payload
+  U32       Id;
+} SHARD_STATE;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static const U8 _abSync[10];
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _ParsePacket()
+*
+*  Function description
+*    Finds the time stamp delta of the packet at pShard->p.
+*
+*  Return value
+*    > 0: Packet parsed, pShard->pPacket, pDelta and Id are set.
+*    = 0: End of stream.
+*    < 0: Corrupt or truncated packet.
+*/
+static int _ParsePacket(SHARD_STATE* pShard) {
+  pShard->pPacket = pShard->p;
+  return SYSVIEW_PACKET_Parse(pShard->p, pShard->pEnd, &pShard->Id, &pShard->pDelta);
+}
+
+/*********************************************************************
+*
+*       _Advance()
+*
+*  Function description
+*    Moves a shard to its next event which goes into the merged stream
+*    and computes its absolute time.
+*
+*  Parameters
+*    pShard       - Shard to advance.
+*    pRefTime     - Time of the first sync of any shard.
+*    pHaveRefTime - *pRefTime is valid. Set by the first sync of any shard.
+*    pStats       - Statistics to update.
+*
+*  Return value
+*    > 0: pShard->pPacket is the next event.
+*    = 0: End of stream, pShard->pPacket is NULL.
+*    < 0: Corrupt stream.
+*/
+static int _Advance(SHARD_STATE* pShard, I64* pRefTime, int* pHaveRefTime, SYSVIEW_MERGE_STATS* pStats) {
+  const U8* p;
+  U32       Delta;
+  U32       Shard;
+  U32       TimeStamp;
+  int       r;
+
+  for (;;) {
+    pShard->pPacket = NULL;
+    if (pShard->p < pShard->pEnd && *pShard->p == SYSVIEW_EVTID_NOP) {   // Sync bytes, no time stamp
+      pShard->p++;
+      continue;
+    }
+    r = _ParsePacket(pShard);
+    if (r <= 0) {
+      pShard->pPacket = NULL;
+      return r;
+    }
+    p = SYSVIEW_PACKET_DecodeU32(pShard->pDelta, pShard->pEnd, &Delta);
+    if (p == NULL) {
+      pShard->pPacket = NULL;
+      return -1;
+    }
+    pShard->p = p;
+    if (pShard->HaveTime) {
+      pShard->Time += Delta;
+    }
+    if (pShard->Id == SYSVIEW_EVTID_SHARD_SYNC) {
+      //
+      // Skip the length, which is < 128, and anchor the shard to the absolute time stamp.
+      //
+      p = SYSVIEW_PACKET_DecodeU32(pShard->pPacket + 2, pShard->pDelta, &Shard);
+      if (p == NULL || SYSVIEW_PACKET_DecodeU32(p, pShard->pDelta, &TimeStamp) == NULL) {
+        return -1;
+      }
+      if (pShard->HaveTime == 0) {
+        if (*pHaveRefTime == 0) {
+          *pRefTime     = (I64)TimeStamp;
+          *pHaveRefTime = 1;
+        }
+        pShard->Time     = *pRefTime + (I32)(TimeStamp - (U32)*pRefTime);
+        pShard->HaveTime = 1;
+      } else {
+        pShard->Time    += (I32)(TimeStamp - (U32)pShard->Time);
+      }
+      continue;
+    }
+    if (pShard->HaveTime == 0) {
+      pStats->NumSkipped++;
+      continue;
+    }
+    if (pShard->Id == SYSVIEW_EVTID_OVERFLOW) {
+      SYSVIEW_PACKET_DecodeU32(pShard->pPacket + 1, pShard->pDelta, &pShard->DropCount);
+    }
+    return 1;
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_MERGE_Run()
+*
+*  Function description
+*    Merges the streams of all shards into one SystemView stream.
+*
+*  Parameters
+*    paShard   - Raw streams of the shards, in order of the shard index.
+*    NumShards - Number of shards, <= 32.
+*    pfWrite   - Called with the data of the merged stream.
+*    pContext  - Passed to pfWrite.
+*    pStats    - Receives merge statistics. May be NULL.
+*
+*  Return value
+*    == 0: O.K.
+*     < 0: Corrupt stream, the merged stream ends before the corrupt packet.
+*/
+int SYSVIEW_MERGE_Run(const SYSVIEW_MERGE_SHARD* paShard, unsigned NumShards, SYSVIEW_MERGE_WRITE_FUNC* pfWrite, void* pContext, SYSVIEW_MERGE_STATS* pStats) {
+  SHARD_STATE         aShard[MAX_SHARDS];
+  SHARD_STATE*        pNext;
+  SYSVIEW_MERGE_STATS Stats;
+  U8                  aPacket[16];
+  U8*                 p;
+  I64                 RefTime;
+  I64                 LastTime;
+  int                 HaveRefTime;
+  int                 HaveLastTime;
+  int                 r;
+  int                 Status;
+  unsigned            n;
+  U32                 DropCount;
+
+  if (NumShards > MAX_SHARDS) {
+    return -1;
+  }
+  memset(&Stats, 0, sizeof(Stats));
+  memset(aShard, 0, sizeof(aShard));
+  Status       = 0;
+  RefTime      = 0;
+  LastTime     = 0;
+  HaveRefTime  = 0;
+  HaveLastTime = 0;
+  for (n = 0; n < NumShards; n++) {
+    aShard[n].p    = paShard[n].pData;
+    aShard[n].pEnd = paShard[n].pData + paShard[n].NumBytes;
+    if (_Advance(&aShard[n], &RefTime, &HaveRefTime, &Stats) < 0) {
+      Status = -1;
+    }
+  }
+  pfWrite(pContext, _abSync, sizeof(_abSync));
+  for (;;) {
+    //
+    // Pick the earliest event. On equal time, the lower shard wins.
+    //
+    pNext = NULL;
+    for (n = 0; n < NumShards; n++) {
+      if (aShard[n].pPacket && (pNext == NULL || aShard[n].Time < pNext->Time)) {
+        pNext = &aShard[n];
+      }
+    }
+    if (pNext == NULL) {
+      break;
+    }
+    if (HaveLastTime == 0) {
+      LastTime     = pNext->Time;
+      HaveLastTime = 1;
+    }
+    if (pNext->Id == SYSVIEW_EVTID_OVERFLOW) {
+      DropCount = 0;
+      for (n = 0; n < NumShards; n++) {
+        DropCount += aShard[n].DropCount;
+      }
+      Stats.NumDropped = DropCount;
+      aPacket[0] = SYSVIEW_EVTID_OVERFLOW;
+      p = SYSVIEW_PACKET_EncodeU32(&aPacket[1], DropCount);
+    } else {
+      pfWrite(pContext, pNext->pPacket, (unsigned)(pNext->pDelta - pNext->pPacket));
+      p = aPacket;
+    }
+    p = SYSVIEW_PACKET_EncodeU32(p, (U32)(pNext->Time - LastTime));
+    pfWrite(pContext, aPacket, (unsigned)(p - aPacket));
+    LastTime = pNext->Time;
+    Stats.NumEvents++;
+    r = _Advance(pNext, &RefTime, &HaveRefTime, &Stats);
+    if (r < 0) {
+      Status = -1;
+    }
+  }
+  if (pStats) {
+    *pStats = Stats;
+  }
+  return Status;
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,54 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Merge.h
+Purpose : Interface of the host-side merge of SystemView shards.
+*/
+
+#ifndef SYSVIEW_MERGE_H
+#define SYSVIEW_MERGE_H
+
+#include "SEGGER.h"
+#include "SYSVIEW_Packet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  const U8* pData;          // Raw stream read from the RTT up-channel of the shard
+  unsigned  NumBytes;
+} SYSVIEW_MERGE_SHARD;
+
+typedef struct {
+  U32 NumEvents;            // Number of events written to the merged stream
+  U32 NumSkipped;           // Number of events discarded because their shard had not been synced yet
+  U32 NumDropped;           // Sum of the drop counts reported by all shards
+} SYSVIEW_MERGE_STATS;
+
+typedef SYSVIEW_PACKET_WRITE_FUNC SYSVIEW_MERGE_WRITE_FUNC;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+int SYSVIEW_MERGE_Run(const SYSVIEW_MERGE_SHARD* paShard, unsigned NumShards, SYSVIEW_MERGE_WRITE_FUNC* pfWrite, void* pContext, SYSVIEW_MERGE_STATS* pStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
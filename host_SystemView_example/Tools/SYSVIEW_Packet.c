@@ -0,0 +1,200 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Packet.c
+Purpose : Packet level parsing of SystemView streams, shared by the
+          host tools.
+
+Additional information:
+  A packet is <Id> [<Len>] <Payload> <TimeStampDelta>, all numbers
+  encoded as variable-length U32. Events with Id < 24 are sent without
+  length, their payload layout is fixed. A sync is a run of NOP (0)
+  bytes without time stamp.
+*/
+#include <stddef.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Packet.h"
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+//
+// Number of U32 parameters of the events with ID < 24,
+// which are sent without length.
+//
+const U8 SYSVIEW_PACKET_aFixedLayout[SYSVIEW_PACKET_NUM_FIXED_IDS] = {
+  0,                              // SYSVIEW_EVTID_NOP, not sent with time stamp
+  1,                              // SYSVIEW_EVTID_OVERFLOW
+  1,                              // SYSVIEW_EVTID_ISR_ENTER
+  0,                              // SYSVIEW_EVTID_ISR_EXIT
+  1,                              // SYSVIEW_EVTID_TASK_START_EXEC
+  0,                              // SYSVIEW_EVTID_TASK_STOP_EXEC
+  1,                              // SYSVIEW_EVTID_TASK_START_READY
+  2,                              // SYSVIEW_EVTID_TASK_STOP_READY
+  1,                              // SYSVIEW_EVTID_TASK_CREATE
+  2 | SYSVIEW_PACKET_LAYOUT_STR,  // SYSVIEW_EVTID_TASK_INFO
+  0,                              // SYSVIEW_EVTID_TRACE_START
+  0,                              // SYSVIEW_EVTID_TRACE_STOP
+  1,                              // SYSVIEW_EVTID_SYSTIME_CYCLES
+  2,                              // SYSVIEW_EVTID_SYSTIME_US
+  0 | SYSVIEW_PACKET_LAYOUT_STR,  // SYSVIEW_EVTID_SYSDESC
+  1,                              // SYSVIEW_EVTID_MARK_START
+  1,                              // SYSVIEW_EVTID_MARK_STOP
+  0,                              // SYSVIEW_EVTID_IDLE
+  0,                              // SYSVIEW_EVTID_ISR_TO_SCHEDULER
+  1,                              // SYSVIEW_EVTID_TIMER_ENTER
+  0,                              // SYSVIEW_EVTID_TIMER_EXIT
+  4,                              // SYSVIEW_EVTID_STACK_INFO
+  2 | SYSVIEW_PACKET_LAYOUT_STR,  // SYSVIEW_EVTID_MODULEDESC
+  SYSVIEW_PACKET_LAYOUT_INVALID   // Not defined
+};
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_PACKET_SkipString()
+*
+*  Function description
+*    Skips a string as encoded by SEGGER_SYSVIEW_EncodeString().
+*
+*  Return value
+*    Pointer to the byte following the string, NULL if the string is truncated.
+*/
+const U8* SYSVIEW_PACKET_SkipString(const U8* p, const U8* pEnd) {
+  unsigned Len;
+
+  if (p >= pEnd) {
+    return NULL;
+  }
+  Len = *p++;
+  if (Len == 255) {
+    if (pEnd - p < 2) {
+      return NULL;
+    }
+    Len = p[0] | ((unsigned)p[1] << 8);
+    p  += 2;
+  }
+  if ((unsigned)(pEnd - p) < Len) {
+    return NULL;
+  }
+  return p + Len;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PACKET_DecodeU32()
+*
+*  Function description
+*    Decodes a variable-length encoded U32.
+*
+*  Return value
+*    Pointer to the byte following the value, NULL if the value is truncated.
+*/
+const U8* SYSVIEW_PACKET_DecodeU32(const U8* p, const U8* pEnd, U32* pValue) {
+  U32      v;
+  unsigned Shift;
+
+  v     = 0;
+  Shift = 0;
+  do {
+    if (p >= pEnd || Shift > 28) {
+      return NULL;
+    }
+    v |= (U32)(*p & 0x7F) << Shift;
+    Shift += 7;
+  } while (*p++ & 0x80);
+  *pValue = v;
+  return p;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PACKET_EncodeU32()
+*
+*  Function description
+*    Encodes a U32 as variable-length value, at most 5 bytes.
+*
+*  Return value
+*    Pointer to the byte following the value.
+*/
+U8* SYSVIEW_PACKET_EncodeU32(U8* p, U32 v) {
+  while (v > 0x7F) {
+    *p++ = (U8)(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (U8)v;
+  return p;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PACKET_Parse()
+*
+*  Function description
+*    Finds the time stamp delta of the packet at p.
+*
+*  Parameters
+*    p       - Start of the packet, must not be a NOP (sync) byte.
+*    pEnd    - End of the stream.
+*    pId     - Receives the event ID.
+*    ppDelta - Receives the position of the time stamp delta,
+*              i.e. the end of ID and payload.
+*
+*  Return value
+*    > 0: Packet parsed.
+*    = 0: End of stream.
+*    < 0: Corrupt or truncated packet.
+*/
+int SYSVIEW_PACKET_Parse(const U8* p, const U8* pEnd, U32* pId, const U8** ppDelta) {
+  U32      Len;
+  unsigned Layout;
+  unsigned i;
+
+  if (p >= pEnd) {
+    return 0;
+  }
+  p = SYSVIEW_PACKET_DecodeU32(p, pEnd, pId);
+  if (p == NULL) {
+    return -1;
+  }
+  if (*pId < SYSVIEW_PACKET_NUM_FIXED_IDS) {
+    Layout = SYSVIEW_PACKET_aFixedLayout[*pId];
+    if (Layout == SYSVIEW_PACKET_LAYOUT_INVALID) {
+      return -1;
+    }
+    for (i = 0; i < (Layout & SYSVIEW_PACKET_LAYOUT_NUM_PARAMS); i++) {
+      p = SYSVIEW_PACKET_DecodeU32(p, pEnd, &Len);
+      if (p == NULL) {
+        return -1;
+      }
+    }
+    if (Layout & SYSVIEW_PACKET_LAYOUT_STR) {
+      p = SYSVIEW_PACKET_SkipString(p, pEnd);
+      if (p == NULL) {
+        return -1;
+      }
+    }
+  } else {
+    p = SYSVIEW_PACKET_DecodeU32(p, pEnd, &Len);
+    if (p == NULL || (U32)(pEnd - p) < Len) {
+      return -1;
+    }
+    p += Len;
+  }
+  *ppDelta = p;
+  return 1;
+}
+
+/*************************** End of file ****************************/
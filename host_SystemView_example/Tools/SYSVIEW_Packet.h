@@ -0,0 +1,65 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Packet.h
+Purpose : Interface of the packet level parsing of SystemView streams,
+          shared by the host tools.
+*/
+
+#ifndef SYSVIEW_PACKET_H
+#define SYSVIEW_PACKET_H
+
+#include "SEGGER.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SYSVIEW_PACKET_NUM_FIXED_IDS        24      // Events with a lower ID are sent without length
+#define SYSVIEW_PACKET_LAYOUT_NUM_PARAMS    0x0Fu   // Mask in SYSVIEW_PACKET_aFixedLayout[]: Number of U32 parameters
+#define SYSVIEW_PACKET_LAYOUT_STR           0x80u   // Flag in SYSVIEW_PACKET_aFixedLayout[]: Parameters are followed by a string
+#define SYSVIEW_PACKET_LAYOUT_INVALID       0xFFu   // Event ID is not defined
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef void SYSVIEW_PACKET_WRITE_FUNC(void* pContext, const U8* pData, unsigned NumBytes);
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const U8 SYSVIEW_PACKET_aFixedLayout[SYSVIEW_PACKET_NUM_FIXED_IDS];
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+const U8* SYSVIEW_PACKET_DecodeU32 (const U8* p, const U8* pEnd, U32* pValue);
+U8*       SYSVIEW_PACKET_EncodeU32 (U8* p, U32 v);
+const U8* SYSVIEW_PACKET_SkipString(const U8* p, const U8* pEnd);
+int       SYSVIEW_PACKET_Parse     (const U8* p, const U8* pEnd, U32* pId, const U8** ppDelta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
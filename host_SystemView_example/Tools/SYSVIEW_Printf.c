@@ -0,0 +1,405 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Printf.c
+Purpose : Formats messages recorded with SEGGER_SYSVIEW_USE_DEFERRED_PRINTF
+          on the host.
+
+Additional information:
+  With SEGGER_SYSVIEW_USE_DEFERRED_PRINTF, SEGGER_SYSVIEW_PrintfHost()
+  and its variants send a SYSVIEW_EVTID_EX packet with sub-ID
+  SYSVIEW_EVTID_EX_PRINT_DEFERRED, which holds the address of the
+  format string, the options and the arguments as 32-bit values.
+  The strings are taken from the allocated sections with contents of
+  the application's ELF file, by their address on target, so string
+  arguments which point to constants are shown, too.
+  The arguments are taken as the recorder counts them: every
+  conversion but "%%" takes one, after flags, field width, precision
+  and length modifiers, which are passed on to the host's snprintf().
+*/
+#include <stdio.h>
+#include <string.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Printf.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SHT_PROGBITS          1u
+#define SHF_ALLOC             2u
+#define MAX_SPEC_LEN          32            // Conversion specification passed to snprintf()
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  char*    sBuffer;
+  unsigned BufferSize;
+  unsigned Len;                             // Characters of the message, also those which did not fit
+} OUTPUT;
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _Load()
+*
+*  Function description
+*    Reads a little endian value of 1 to 8 bytes.
+*/
+static U64 _Load(const U8* p, unsigned NumBytes) {
+  U64 v;
+
+  v = 0;
+  while (NumBytes--) {
+    v = (v << 8) | p[NumBytes];
+  }
+  return v;
+}
+
+/*********************************************************************
+*
+*       _IsModifier()
+*
+*  Function description
+*    Checks for a character between '%' and the conversion, as skipped
+*    by the recorder.
+*/
+static int _IsModifier(char c) {
+  return ((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == ' ') || (c == '#') || (c == '.') || (c == 'l') || (c == 'h') || (c == 'z');
+}
+
+/*********************************************************************
+*
+*       _Put()
+*
+*  Function description
+*    Appends characters to the message, as far as they fit.
+*/
+static void _Put(OUTPUT* pOut, const char* s, unsigned NumChars) {
+  unsigned NumCharsAtOnce;
+
+  if (pOut->Len + 1u < pOut->BufferSize) {
+    NumCharsAtOnce = pOut->BufferSize - 1u - pOut->Len;
+    if (NumCharsAtOnce > NumChars) {
+      NumCharsAtOnce = NumChars;
+    }
+    memcpy(pOut->sBuffer + pOut->Len, s, NumCharsAtOnce);
+  }
+  pOut->Len += NumChars;
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_PRINTF_Init()
+*
+*  Function description
+*    Initializes an empty string table.
+*/
+void SYSVIEW_PRINTF_Init(SYSVIEW_PRINTF_STRINGS* pStrings) {
+  memset(pStrings, 0, sizeof(*pStrings));
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PRINTF_AddSection()
+*
+*  Function description
+*    Adds a memory region of the application to the string table.
+*
+*  Parameters
+*    pStrings - String table.
+*    Addr     - Address of the region on target.
+*    pData    - Contents of the region. Must stay valid while the table is used.
+*    Size     - Size of the region.
+*
+*  Return value
+*    == 0: O.K.
+*     < 0: Table full.
+*/
+int SYSVIEW_PRINTF_AddSection(SYSVIEW_PRINTF_STRINGS* pStrings, U32 Addr, const void* pData, U32 Size) {
+  SYSVIEW_PRINTF_SECTION* pSection;
+
+  if (pStrings->NumSections == SYSVIEW_PRINTF_MAX_SECTIONS) {
+    return -1;
+  }
+  pSection        = &pStrings->aSection[pStrings->NumSections++];
+  pSection->Addr  = Addr;
+  pSection->Size  = Size;
+  pSection->pData = (const U8*)pData;
+  return 0;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PRINTF_AddElf()
+*
+*  Function description
+*    Adds the allocated sections with contents of an ELF file, e.g.
+*    .text and .rodata, to the string table.
+*
+*  Parameters
+*    pStrings - String table.
+*    pElf     - Contents of the ELF file. Must stay valid while the table is used.
+*    NumBytes - Size of the ELF file.
+*
+*  Return value
+*    >= 0: Number of sections added.
+*     < 0: Not a little endian ELF file.
+*
+*  Additional information
+*    Handles 32-bit and 64-bit ELF files. Sections which are not
+*    below 4 GB are skipped.
+*/
+int SYSVIEW_PRINTF_AddElf(SYSVIEW_PRINTF_STRINGS* pStrings, const void* pElf, U32 NumBytes) {
+  const U8* p;
+  const U8* pSh;
+  U64       ShOff;
+  U64       Flags;
+  U64       Addr;
+  U64       Off;
+  U64       Size;
+  unsigned  ShEntSize;
+  unsigned  ShNum;
+  unsigned  Is64;
+  unsigned  i;
+  int       NumSections;
+
+  p = (const U8*)pElf;
+  if (NumBytes < 64 || memcmp(p, "\177ELF", 4) != 0 || p[5] != 1) {
+    return -1;
+  }
+  Is64 = (p[4] == 2) ? 1u : 0u;
+  if (Is64) {
+    ShOff     = _Load(p + 0x28, 8);
+    ShEntSize = (unsigned)_Load(p + 0x3A, 2);
+    ShNum     = (unsigned)_Load(p + 0x3C, 2);
+  } else {
+    ShOff     = _Load(p + 0x20, 4);
+    ShEntSize = (unsigned)_Load(p + 0x2E, 2);
+    ShNum     = (unsigned)_Load(p + 0x30, 2);
+  }
+  if (ShEntSize < (Is64 ? 40u : 24u) || ShOff + (U64)ShEntSize * ShNum > NumBytes) {
+    return -1;
+  }
+  NumSections = 0;
+  for (i = 0; i < ShNum; i++) {
+    pSh = p + ShOff + (U64)i * ShEntSize;
+    if (_Load(pSh + 4, 4) != SHT_PROGBITS) {
+      continue;
+    }
+    if (Is64) {
+      Flags = _Load(pSh + 8,  8);
+      Addr  = _Load(pSh + 16, 8);
+      Off   = _Load(pSh + 24, 8);
+      Size  = _Load(pSh + 32, 8);
+    } else {
+      Flags = _Load(pSh + 8,  4);
+      Addr  = _Load(pSh + 12, 4);
+      Off   = _Load(pSh + 16, 4);
+      Size  = _Load(pSh + 20, 4);
+    }
+    if ((Flags & SHF_ALLOC) == 0 || Size == 0 || Off + Size > NumBytes || Addr + Size > 0x100000000ull) {
+      continue;
+    }
+    if (SYSVIEW_PRINTF_AddSection(pStrings, (U32)Addr, p + Off, (U32)Size) < 0) {
+      break;
+    }
+    NumSections++;
+  }
+  return NumSections;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PRINTF_GetString()
+*
+*  Function description
+*    Returns the string at an address on target.
+*
+*  Return value
+*    != NULL: String, terminated within its section.
+*    == NULL: Address not in the string table.
+*/
+const char* SYSVIEW_PRINTF_GetString(const SYSVIEW_PRINTF_STRINGS* pStrings, U32 Addr) {
+  const SYSVIEW_PRINTF_SECTION* pSection;
+  unsigned                      i;
+  U32                           Off;
+
+  for (i = 0; i < pStrings->NumSections; i++) {
+    pSection = &pStrings->aSection[i];
+    Off      = Addr - pSection->Addr;
+    if (Addr >= pSection->Addr && Off < pSection->Size) {
+      if (memchr(pSection->pData + Off, 0, pSection->Size - Off) == NULL) {
+        return NULL;
+      }
+      return (const char*)(pSection->pData + Off);
+    }
+  }
+  return NULL;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_PRINTF_Format()
+*
+*  Function description
+*    Formats a deferred message.
+*
+*  Parameters
+*    pStrings   - String table of the application.
+*    pEvent     - SYSVIEW_EVTID_EX event with sub-ID SYSVIEW_EVTID_EX_PRINT_DEFERRED.
+*    pOptions   - Receives the options, i.e. the log level. May be NULL.
+*    sBuffer    - Receives the message, zero-terminated.
+*    BufferSize - Size of sBuffer, the message is truncated to fit.
+*
+*  Return value
+*    >= 0: Length of the message, which is truncated if >= BufferSize.
+*     < 0: Not a deferred message, or its format string is not in the table.
+*
+*  Additional information
+*    Missing arguments are taken as 0. A "%s" argument which is not in
+*    the string table is shown as its address.
+*/
+int SYSVIEW_PRINTF_Format(const SYSVIEW_PRINTF_STRINGS* pStrings, const SYSVIEW_DECODE_EVENT* pEvent, U32* pOptions, char* sBuffer, unsigned BufferSize) {
+  U32         aValue[4 + SYSVIEW_PRINTF_MAX_ARGUMENTS];
+  char        acSpec[MAX_SPEC_LEN + 2];
+  char        acConv[64];
+  OUTPUT      Out;
+  const char* sFormat;
+  const char* s;
+  const char* sArg;
+  unsigned    NumValues;
+  unsigned    NumArgs;
+  unsigned    iArg;
+  unsigned    SpecLen;
+  U32         v;
+  int         r;
+  char        c;
+
+  if (pEvent->Id != SYSVIEW_EVTID_EX || pEvent->SubId != SYSVIEW_EVTID_EX_PRINT_DEFERRED) {
+    return -1;
+  }
+  NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, SEGGER_COUNTOF(aValue));
+  if (NumValues < 4) {
+    return -1;
+  }
+  sFormat = SYSVIEW_PRINTF_GetString(pStrings, aValue[1]);
+  if (sFormat == NULL) {
+    return -1;
+  }
+  if (pOptions) {
+    *pOptions = aValue[2];
+  }
+  NumArgs = aValue[3];
+  if (NumArgs > NumValues - 4) {
+    NumArgs = NumValues - 4;
+  }
+  Out.sBuffer    = sBuffer;
+  Out.BufferSize = BufferSize;
+  Out.Len        = 0;
+  iArg           = 0;
+  s              = sFormat;
+  for (;;) {
+    c = *s;
+    if (c == 0) {
+      break;
+    }
+    if (c != '%') {
+      sArg = s;
+      while (*s != 0 && *s != '%') {
+        s++;
+      }
+      _Put(&Out, sArg, (unsigned)(s - sArg));
+      continue;
+    }
+    //
+    // Collect the conversion specification, without length modifiers.
+    //
+    SpecLen           = 0;
+    acSpec[SpecLen++] = '%';
+    s++;
+    while (_IsModifier(*s)) {
+      if (*s != 'l' && *s != 'h' && *s != 'z' && SpecLen < MAX_SPEC_LEN) {
+        acSpec[SpecLen++] = *s;
+      }
+      s++;
+    }
+    c = *s;
+    if (c == 0) {
+      break;
+    }
+    s++;
+    if (c == '%') {
+      _Put(&Out, "%", 1);
+      continue;
+    }
+    v = (iArg < NumArgs) ? aValue[4 + iArg] : 0u;
+    iArg++;
+    acSpec[SpecLen++] = c;
+    acSpec[SpecLen]   = 0;
+    switch (c) {
+    case 'd':
+    case 'i':
+    case 'c':
+      r = snprintf(acConv, sizeof(acConv), acSpec, (int)v);
+      break;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+      r = snprintf(acConv, sizeof(acConv), acSpec, (unsigned)v);
+      break;
+    case 'p':
+      r = snprintf(acConv, sizeof(acConv), "0x%08X", (unsigned)v);
+      break;
+    case 's':
+      sArg = SYSVIEW_PRINTF_GetString(pStrings, v);
+      if (sArg == NULL) {
+        r = snprintf(acConv, sizeof(acConv), "<0x%08X>", (unsigned)v);
+        break;
+      }
+      r = snprintf(NULL, 0, acSpec, sArg);
+      if (r >= (int)sizeof(acConv)) {
+        _Put(&Out, sArg, (unsigned)strlen(sArg));   // Too long to pad, shown as is
+        r = -1;
+        break;
+      }
+      r = snprintf(acConv, sizeof(acConv), acSpec, sArg);
+      break;
+    default:
+      r = snprintf(acConv, sizeof(acConv), "%s", acSpec);
+      break;
+    }
+    if (r > 0) {
+      _Put(&Out, acConv, ((unsigned)r < sizeof(acConv)) ? (unsigned)r : (unsigned)sizeof(acConv) - 1u);
+    }
+  }
+  if (BufferSize) {
+    sBuffer[(Out.Len < BufferSize) ? Out.Len : BufferSize - 1u] = 0;
+  }
+  return (int)Out.Len;
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,74 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Printf.h
+Purpose : Interface of the host-side formatter of messages recorded
+          with SEGGER_SYSVIEW_USE_DEFERRED_PRINTF.
+*/
+
+#ifndef SYSVIEW_PRINTF_H
+#define SYSVIEW_PRINTF_H
+
+#include "SEGGER.h"
+#include "SYSVIEW_Decode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SYSVIEW_PRINTF_MAX_SECTIONS
+  #define SYSVIEW_PRINTF_MAX_SECTIONS       32      // Sections of the application which are searched for strings
+#endif
+
+#ifndef   SYSVIEW_PRINTF_MAX_ARGUMENTS
+  #define SYSVIEW_PRINTF_MAX_ARGUMENTS      16      // SEGGER_SYSVIEW_MAX_ARGUMENTS of the recorder
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  U32       Addr;                               // Address of the section on target
+  U32       Size;
+  const U8* pData;                              // Contents of the section, e.g. in a copy of the ELF file
+} SYSVIEW_PRINTF_SECTION;
+
+//
+// Strings of the application, by their address on target.
+//
+typedef struct {
+  unsigned               NumSections;
+  SYSVIEW_PRINTF_SECTION aSection[SYSVIEW_PRINTF_MAX_SECTIONS];
+} SYSVIEW_PRINTF_STRINGS;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+void        SYSVIEW_PRINTF_Init      (SYSVIEW_PRINTF_STRINGS* pStrings);
+int         SYSVIEW_PRINTF_AddSection(SYSVIEW_PRINTF_STRINGS* pStrings, U32 Addr, const void* pData, U32 Size);
+int         SYSVIEW_PRINTF_AddElf    (SYSVIEW_PRINTF_STRINGS* pStrings, const void* pElf, U32 NumBytes);
+const char* SYSVIEW_PRINTF_GetString (const SYSVIEW_PRINTF_STRINGS* pStrings, U32 Addr);
+int         SYSVIEW_PRINTF_Format    (const SYSVIEW_PRINTF_STRINGS* pStrings, const SYSVIEW_DECODE_EVENT* pEvent, U32* pOptions, char* sBuffer, unsigned BufferSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
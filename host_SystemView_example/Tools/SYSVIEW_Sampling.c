@@ -0,0 +1,225 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Sampling.c
+Purpose : Scales the counts of sampled events by their sampling
+          weight, for the rate of events of a sampled stream.
+
+Additional information:
+  Events sampled by SEGGER_SYSVIEW_SetSampling() or by class with
+  SEGGER_SYSVIEW_RECORD_SAMPLED() are recorded one of every n. The
+  recorder sends n for the IDs in a SYSVIEW_EVTID_EX packet with
+  sub-ID SYSVIEW_EVTID_EX_SAMPLING whenever n changes and after each
+  start:
+    <Ratio> <NumIds> <EventId>[NumIds]
+  Each recorded event of these IDs stands for Ratio events. The
+  reader keeps the weight of each ID, resets all weights to 1 on
+  SYSVIEW_EVTID_TRACE_START and sums the weights of the recorded
+  events per ID. The estimate is off by less than n events per
+  change of the ratio. Time stamps and parameters of the recorded
+  events are a systematic sample of all events, so e.g. latency
+  statistics of a sampled ID need no scaling.
+*/
+#include <string.h>
+#include "SYSVIEW_Sampling.h"
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _FindId()
+*
+*  Function description
+*    Returns the counts of an event ID, optionally adding them.
+*
+*  Parameters
+*    pSampling - Counts of the stream.
+*    EventId   - ID of the event.
+*    Add       - 1: Add the ID if it is not counted yet.
+*
+*  Return value
+*    Counts of the ID, NULL if not found or if the table is full.
+*/
+static SYSVIEW_SAMPLING_ID* _FindId(SYSVIEW_SAMPLING* pSampling, U32 EventId, int Add) {
+  SYSVIEW_SAMPLING_ID* pId;
+  unsigned             i;
+
+  for (i = 0; i < pSampling->NumIds; i++) {
+    if (pSampling->aId[i].EventId == EventId) {
+      return &pSampling->aId[i];
+    }
+  }
+  if (Add == 0 || pSampling->NumIds == SYSVIEW_SAMPLING_MAX_IDS) {
+    return NULL;
+  }
+  pId          = &pSampling->aId[pSampling->NumIds++];
+  memset(pId, 0, sizeof(*pId));
+  pId->EventId = EventId;
+  pId->Weight  = 1;
+  return pId;
+}
+
+/*********************************************************************
+*
+*       _SetWeights()
+*
+*  Function description
+*    Takes the weights of a SYSVIEW_EVTID_EX_SAMPLING packet.
+*/
+static void _SetWeights(SYSVIEW_SAMPLING* pSampling, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_SAMPLING_ID* pId;
+  U32                  aValue[3 + SEGGER_SYSVIEW_MAX_ARGUMENTS];
+  unsigned             NumValues;
+  unsigned             i;
+
+  NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, SEGGER_COUNTOF(aValue));
+  if (NumValues < 3) {
+    return;
+  }
+  NumValues -= 3;
+  if (NumValues > aValue[2]) {
+    NumValues = aValue[2];                  // IDs sent
+  }
+  for (i = 0; i < NumValues; i++) {
+    pId = _FindId(pSampling, aValue[3 + i], 1);
+    if (pId) {
+      pId->Weight = aValue[1] ? aValue[1] : 1u;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_SAMPLING_Init()
+*
+*  Function description
+*    Initializes the counts of a stream.
+*/
+void SYSVIEW_SAMPLING_Init(SYSVIEW_SAMPLING* pSampling) {
+  memset(pSampling, 0, sizeof(*pSampling));
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_SAMPLING_OnEvent()
+*
+*  Function description
+*    Counts an event of the stream. To be called from the callback
+*    of the streaming decoder.
+*
+*  Parameters
+*    pSampling - Counts of the stream.
+*    pEvent    - Decoded event.
+*
+*  Return value
+*    Number of events the event stands for, 1 for events which are
+*    not sampled, 0 for the sampling packets.
+*/
+U32 SYSVIEW_SAMPLING_OnEvent(SYSVIEW_SAMPLING* pSampling, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_SAMPLING_ID* pId;
+  unsigned             i;
+
+  if (pSampling->NumEvents++ == 0) {
+    pSampling->FirstTime = pEvent->Time;
+  }
+  pSampling->LastTime = pEvent->Time;
+  if (pEvent->Id == SYSVIEW_EVTID_TRACE_START) {
+    //
+    // The recorder sends the weights of all sampled IDs after the start.
+    //
+    for (i = 0; i < pSampling->NumIds; i++) {
+      pSampling->aId[i].Weight = 1;
+    }
+    return 1;
+  }
+  if (pEvent->Id == SYSVIEW_EVTID_EX && pEvent->SubId == SYSVIEW_EVTID_EX_SAMPLING) {
+    _SetWeights(pSampling, pEvent);
+    return 0;
+  }
+  if (pEvent->Id < 32) {
+    return 1;
+  }
+  pId = _FindId(pSampling, pEvent->Id, 1);
+  if (pId == NULL) {
+    pSampling->NumUncounted++;
+    return 1;
+  }
+  if (pId->NumRecorded++ == 0) {
+    pId->FirstTime = pEvent->Time;
+  }
+  pId->LastTime      = pEvent->Time;
+  pId->NumEstimated += pId->Weight;
+  return pId->Weight;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_SAMPLING_GetWeight()
+*
+*  Function description
+*    Returns the number of events each recorded event of an ID
+*    currently stands for.
+*/
+U32 SYSVIEW_SAMPLING_GetWeight(const SYSVIEW_SAMPLING* pSampling, U32 EventId) {
+  const SYSVIEW_SAMPLING_ID* pId;
+
+  pId = SYSVIEW_SAMPLING_GetId(pSampling, EventId);
+  return pId ? pId->Weight : 1u;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_SAMPLING_GetId()
+*
+*  Function description
+*    Returns the counts of an event ID, NULL if no event of the ID
+*    and no weight has been seen.
+*/
+const SYSVIEW_SAMPLING_ID* SYSVIEW_SAMPLING_GetId(const SYSVIEW_SAMPLING* pSampling, U32 EventId) {
+  return _FindId((SYSVIEW_SAMPLING*)pSampling, EventId, 0);
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_SAMPLING_GetRate()
+*
+*  Function description
+*    Returns the estimated number of events of an ID per second,
+*    over the duration of the stream.
+*
+*  Parameters
+*    pSampling     - Counts of the stream.
+*    EventId       - ID of the event.
+*    TimestampFreq - Frequency of the time stamp units of the stream.
+*
+*  Return value
+*    Events per second, 0 if the stream is too short.
+*/
+double SYSVIEW_SAMPLING_GetRate(const SYSVIEW_SAMPLING* pSampling, U32 EventId, U32 TimestampFreq) {
+  const SYSVIEW_SAMPLING_ID* pId;
+  double                     Duration;
+
+  pId      = SYSVIEW_SAMPLING_GetId(pSampling, EventId);
+  Duration = TimestampFreq ? (double)(pSampling->LastTime - pSampling->FirstTime) / TimestampFreq : 0;
+  if (pId == NULL || Duration <= 0) {
+    return 0;
+  }
+  return (double)pId->NumEstimated / Duration;
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,78 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Sampling.h
+Purpose : Interface of the host-side reader which scales the counts
+          of sampled events by their sampling weight.
+*/
+
+#ifndef SYSVIEW_SAMPLING_H
+#define SYSVIEW_SAMPLING_H
+
+#include "SEGGER.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Decode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef   SYSVIEW_SAMPLING_MAX_IDS
+  #define SYSVIEW_SAMPLING_MAX_IDS          256     // Event IDs >= 32 which are counted
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef struct {
+  U32 EventId;
+  U32 Weight;                                   // Events each recorded event stands for, from the last SYSVIEW_EVTID_EX_SAMPLING packet
+  U64 NumRecorded;
+  U64 NumEstimated;                             // Sum of the weights of the recorded events
+  U64 FirstTime;
+  U64 LastTime;
+} SYSVIEW_SAMPLING_ID;
+
+//
+// Counts of one stream, i.e. of one shard.
+//
+typedef struct {
+  unsigned            NumIds;
+  U32                 NumUncounted;             // Events of IDs which did not fit into aId[]
+  U64                 FirstTime;
+  U64                 LastTime;
+  U64                 NumEvents;
+  SYSVIEW_SAMPLING_ID aId[SYSVIEW_SAMPLING_MAX_IDS];
+} SYSVIEW_SAMPLING;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+void                       SYSVIEW_SAMPLING_Init     (SYSVIEW_SAMPLING* pSampling);
+U32                        SYSVIEW_SAMPLING_OnEvent  (SYSVIEW_SAMPLING* pSampling, const SYSVIEW_DECODE_EVENT* pEvent);
+U32                        SYSVIEW_SAMPLING_GetWeight(const SYSVIEW_SAMPLING* pSampling, U32 EventId);
+const SYSVIEW_SAMPLING_ID* SYSVIEW_SAMPLING_GetId    (const SYSVIEW_SAMPLING* pSampling, U32 EventId);
+double                     SYSVIEW_SAMPLING_GetRate  (const SYSVIEW_SAMPLING* pSampling, U32 EventId, U32 TimestampFreq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -0,0 +1,255 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Snapshot.c
+Purpose : Reads post-mortem buffer dumps recorded with
+          SEGGER_SYSVIEW_USE_CHECKPOINTS.
+
+Additional information:
+  In post mortem mode the up-buffer is a ring which is overwritten,
+  the valid data runs from RdOff to WrOff. With checkpoints, the
+  recorder periodically writes a sync followed by a SYSVIEW_EVTID_EX
+  packet with sub-ID SYSVIEW_EVTID_EX_CHECKPOINT, and then stores the
+  offset of that sync and the sequence number of the packet in
+  SEGGER_SYSVIEW_LastCheckpoint. The full system description, task
+  list and module list is sent before a checkpoint only when it has
+  changed, the checkpoint tells how far back it is.
+  The checkpoint named by SEGGER_SYSVIEW_LastCheckpoint is checked in
+  place. Only if it is not valid, e.g. as the variable was not
+  dumped with the buffer, the buffer is searched from its end.
+*/
+#include <stddef.h>
+#include "SEGGER_SYSVIEW.h"
+#include "SYSVIEW_Snapshot.h"
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define SYNC_SIZE             10
+#define MAX_CHECKPOINT_SIZE   (SYNC_SIZE + 2 * 5 + 5 * 5 + 5)   // Sync, ID, length, payload, time stamp delta
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _GetDist()
+*
+*  Function description
+*    Returns the number of bytes from one offset in the buffer to
+*    another one, in the direction of writing.
+*/
+static U32 _GetDist(const SYSVIEW_SNAPSHOT* pSnap, U32 From, U32 To) {
+  return (To >= From) ? To - From : To + pSnap->SizeOfBuffer - From;
+}
+
+/*********************************************************************
+*
+*       _Copy()
+*
+*  Function description
+*    Copies data from the buffer, wrapping around at its end.
+*/
+static void _Copy(const SYSVIEW_SNAPSHOT* pSnap, U32 Off, U8* pDest, U32 NumBytes) {
+  while (NumBytes--) {
+    *pDest++ = pSnap->pBuffer[Off];
+    if (++Off == pSnap->SizeOfBuffer) {
+      Off = 0;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _Write()
+*
+*  Function description
+*    Passes data from the buffer to pfWrite, wrapping around at its end.
+*/
+static void _Write(const SYSVIEW_SNAPSHOT* pSnap, U32 Off, U32 NumBytes, SYSVIEW_PACKET_WRITE_FUNC* pfWrite, void* pContext) {
+  U32 NumBytesAtOnce;
+
+  while (NumBytes) {
+    NumBytesAtOnce = pSnap->SizeOfBuffer - Off;
+    if (NumBytesAtOnce > NumBytes) {
+      NumBytesAtOnce = NumBytes;
+    }
+    pfWrite(pContext, pSnap->pBuffer + Off, NumBytesAtOnce);
+    NumBytes -= NumBytesAtOnce;
+    Off       = 0;
+  }
+}
+
+/*********************************************************************
+*
+*       _ParseCheckpoint()
+*
+*  Function description
+*    Checks for a complete checkpoint at an offset in the valid data
+*    and decodes it.
+*
+*  Return value
+*    == 0: O.K.
+*     < 0: No checkpoint at the offset.
+*/
+static int _ParseCheckpoint(const SYSVIEW_SNAPSHOT* pSnap, U32 Off, SYSVIEW_SNAPSHOT_CHECKPOINT* pCp) {
+  U8        aData[MAX_CHECKPOINT_SIZE];
+  const U8* p;
+  const U8* pEnd;
+  const U8* pDelta;
+  U32       NumBytesValid;
+  U32       NumBytesBefore;
+  U32       NumBytes;
+  U32       Id;
+  U32       Len;
+  U32       SubId;
+  unsigned  i;
+
+  if (Off >= pSnap->SizeOfBuffer) {
+    return -1;
+  }
+  NumBytesValid  = _GetDist(pSnap, pSnap->RdOff, pSnap->WrOff);
+  NumBytesBefore = _GetDist(pSnap, pSnap->RdOff, Off);
+  if (NumBytesBefore >= NumBytesValid) {
+    return -1;
+  }
+  NumBytes = NumBytesValid - NumBytesBefore;
+  if (NumBytes > sizeof(aData)) {
+    NumBytes = sizeof(aData);
+  }
+  if (NumBytes <= SYNC_SIZE) {
+    return -1;
+  }
+  _Copy(pSnap, Off, aData, NumBytes);
+  for (i = 0; i < SYNC_SIZE; i++) {
+    if (aData[i] != 0) {
+      return -1;
+    }
+  }
+  p    = aData + SYNC_SIZE;
+  pEnd = aData + NumBytes;
+  if (*p != SYSVIEW_EVTID_EX || SYSVIEW_PACKET_Parse(p, pEnd, &Id, &pDelta) <= 0) {
+    return -1;
+  }
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &Id);
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &Len);
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &SubId);
+  if (p == NULL || SubId != SYSVIEW_EVTID_EX_CHECKPOINT) {
+    return -1;
+  }
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &pCp->TimeStamp);
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &pCp->SeqNo);
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &pCp->DescDist);
+  p = SYSVIEW_PACKET_DecodeU32(p, pDelta, &pCp->DescSize);
+  if (p == NULL || SYSVIEW_PACKET_DecodeU32(pDelta, pEnd, &Id) == NULL) {
+    return -1;
+  }
+  pCp->Off     = Off;
+  pCp->HasDesc = (pCp->DescDist <= NumBytesBefore && pCp->DescSize <= pCp->DescDist) ? 1 : 0;
+  pCp->DescOff = pCp->HasDesc ? (Off + pSnap->SizeOfBuffer - pCp->DescDist) % pSnap->SizeOfBuffer : 0;
+  return 0;
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_SNAPSHOT_FindCheckpoint()
+*
+*  Function description
+*    Finds the most recent checkpoint in a buffer dump.
+*
+*  Parameters
+*    pSnap - Buffer dump.
+*    pCp   - Receives the checkpoint.
+*
+*  Return value
+*    == 0: O.K., found at SEGGER_SYSVIEW_LastCheckpoint.
+*    == 1: O.K., found by searching the buffer.
+*     < 0: No checkpoint in the buffer.
+*
+*  Additional information
+*    A checkpoint at CheckpointOff is only taken if its sequence number
+*    is CheckpointSeqNo, so a stale offset into overwritten data is
+*    not mistaken for it.
+*/
+int SYSVIEW_SNAPSHOT_FindCheckpoint(const SYSVIEW_SNAPSHOT* pSnap, SYSVIEW_SNAPSHOT_CHECKPOINT* pCp) {
+  U32 NumBytesValid;
+  U32 Off;
+  U32 i;
+
+  if (pSnap->CheckpointSeqNo != 0
+   && _ParseCheckpoint(pSnap, pSnap->CheckpointOff, pCp) == 0
+   && pCp->SeqNo == pSnap->CheckpointSeqNo) {
+    return 0;
+  }
+  NumBytesValid = _GetDist(pSnap, pSnap->RdOff, pSnap->WrOff);
+  i             = NumBytesValid;
+  while (i > SYNC_SIZE) {
+    i--;
+    Off = (pSnap->RdOff + i) % pSnap->SizeOfBuffer;
+    if (pSnap->pBuffer[Off] != SYSVIEW_EVTID_EX) {
+      continue;
+    }
+    Off = (Off + pSnap->SizeOfBuffer - SYNC_SIZE) % pSnap->SizeOfBuffer;
+    if (_ParseCheckpoint(pSnap, Off, pCp) == 0) {
+      return 1;
+    }
+  }
+  return -1;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_SNAPSHOT_Extract()
+*
+*  Function description
+*    Writes a stream which starts at a checkpoint, preceded by the
+*    full description if it is still in the buffer.
+*
+*  Parameters
+*    pSnap    - Buffer dump.
+*    pCp      - Checkpoint returned by SYSVIEW_SNAPSHOT_FindCheckpoint().
+*    pfWrite  - Called with the data of the stream.
+*    pContext - Passed to pfWrite.
+*
+*  Return value
+*    Number of bytes written.
+*
+*  Additional information
+*    The full description and the events from the checkpoint on each
+*    start with a sync. The time stamp deltas of the events from the
+*    checkpoint on add up from pCp->TimeStamp, i.e. their absolute
+*    time is pCp->TimeStamp plus their time in the stream minus the
+*    time of the last event before the checkpoint.
+*/
+U32 SYSVIEW_SNAPSHOT_Extract(const SYSVIEW_SNAPSHOT* pSnap, const SYSVIEW_SNAPSHOT_CHECKPOINT* pCp, SYSVIEW_PACKET_WRITE_FUNC* pfWrite, void* pContext) {
+  U32 NumBytes;
+  U32 NumBytesWritten;
+
+  NumBytesWritten = 0;
+  if (pCp->HasDesc) {
+    _Write(pSnap, pCp->DescOff, pCp->DescSize, pfWrite, pContext);
+    NumBytesWritten += pCp->DescSize;
+  }
+  NumBytes = _GetDist(pSnap, pCp->Off, pSnap->WrOff);
+  _Write(pSnap, pCp->Off, NumBytes, pfWrite, pContext);
+  return NumBytesWritten + NumBytes;
+}
+
+/*************************** End of file ****************************/
@@ -0,0 +1,65 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Snapshot.h
+Purpose : Interface of the reader of post-mortem buffer dumps recorded
+          with SEGGER_SYSVIEW_USE_CHECKPOINTS.
+*/
+
+#ifndef SYSVIEW_SNAPSHOT_H
+#define SYSVIEW_SNAPSHOT_H
+
+#include "SEGGER.h"
+#include "SYSVIEW_Packet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+//
+// Dump of the SystemView up-buffer and of SEGGER_SYSVIEW_LastCheckpoint.
+//
+typedef struct {
+  const U8* pBuffer;          // Copy of the buffer data
+  U32       SizeOfBuffer;
+  U32       WrOff;            // Of the up-buffer, end of the valid data
+  U32       RdOff;            // Of the up-buffer, start of the valid data
+  U32       CheckpointOff;    // SEGGER_SYSVIEW_LastCheckpoint.Off
+  U32       CheckpointSeqNo;  // SEGGER_SYSVIEW_LastCheckpoint.SeqNo, 0 if not known
+} SYSVIEW_SNAPSHOT;
+
+typedef struct {
+  U32 Off;                    // Offset of the sync of the checkpoint in the buffer
+  U32 TimeStamp;              // Absolute time stamp of the packet before the checkpoint
+  U32 SeqNo;                  // Sequence number of the checkpoint packet
+  U32 DescDist;               // Distance from the sync of the full description to the one of the checkpoint
+  U32 DescSize;
+  int HasDesc;                // 1: The full description is still in the buffer
+  U32 DescOff;                // Offset of the sync of the full description in the buffer, if HasDesc
+} SYSVIEW_SNAPSHOT_CHECKPOINT;
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+int SYSVIEW_SNAPSHOT_FindCheckpoint(const SYSVIEW_SNAPSHOT* pSnap, SYSVIEW_SNAPSHOT_CHECKPOINT* pCp);
+U32 SYSVIEW_SNAPSHOT_Extract       (const SYSVIEW_SNAPSHOT* pSnap, const SYSVIEW_SNAPSHOT_CHECKPOINT* pCp, SYSVIEW_PACKET_WRITE_FUNC* pfWrite, void* pContext);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -0,0 +1,506 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Varint.c
+Purpose : Bulk decoder of variable-length encoded U32 values, as
+          written by ENCODE_U32() and SEGGER_SYSVIEW_EncodeU32().
+
+Additional information:
+  A value is sent in 1 to 5 bytes, 7 bits per byte, least significant
+  first. Bit 7 is set in all bytes but the last.
+  Decoding byte by byte takes a branch per byte, which is hard to
+  predict in a stream of mixed values. The kernels take the
+  continuation bits of a block of bytes at once:
+    scalar - Loads 8 bytes into a 64-bit register. The length of the
+             value is the number of trailing continuation bits plus one,
+             the 7-bit groups are merged without branches.
+    SSE4.1 - Loads 16 bytes and takes their continuation bits by
+             PMOVMSKB. The bits of the first 12 bytes select an entry
+             of _aShuffle[], which describes up to 4 values of 1 to 4
+             bytes in them. PSHUFB moves each value into a 32-bit lane,
+             where the 7-bit groups are merged, as in Masked VByte.
+             Runs of 8 values of 1 byte are widened by PMOVZXBD.
+  SYSVIEW_VARINT_KERNEL_AUTO selects SSE4.1 for runs of values and the
+  scalar kernel for the parameters of a packet, which are too few to
+  pay off the block loads and table lookups (see make decode).
+  Values the table does not describe, i.e. values of 5 bytes, are
+  decoded by the scalar kernel. Near the end of the data, where a block
+  cannot be loaded, all kernels decode byte by byte. All kernels return
+  the same result as the bytewise reference SYSVIEW_VARINT_DecodeU32sRef().
+  The block loads assume a little-endian host.
+*/
+#include <stddef.h>
+#include <string.h>
+#include "SYSVIEW_Varint.h"
+#include "SYSVIEW_Packet.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+  #error "SYSVIEW_Varint.c requires a little-endian host"
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define SUPPORT_X86_KERNELS   1
+  #include <immintrin.h>
+#else
+  #define SUPPORT_X86_KERNELS   0
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+#define MAX_VARINT_SIZE   5
+#define CONT_BITS_VALUE   0x0000008080808080ull   // Continuation bits of the first MAX_VARINT_SIZE bytes
+#define SHUFFLE_BITS      12                      // Bytes described by an entry of _aShuffle[]
+
+/*********************************************************************
+*
+*       Types, local
+*
+**********************************************************************
+*/
+typedef struct {
+  U8 aShuffle[16];    // PSHUFB control, moves value i into bytes 4*i..4*i+3
+  U8 NumValues;       // Number of values of 1 to 4 bytes at the start of the block, 0: Decode the first value by the scalar kernel
+  U8 NumBytes;        // Number of bytes of these values
+} SHUFFLE;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+//
+// Mask of the bytes of a value with 1 to 5 bytes
+//
+static const U64 _aLenMask[MAX_VARINT_SIZE + 1] = {
+  0,
+  0x00000000FFull,
+  0x000000FFFFull,
+  0x0000FFFFFFull,
+  0x00FFFFFFFFull,
+  0xFFFFFFFFFFull
+};
+
+static const char* const _asKernelName[SYSVIEW_VARINT_NUM_KERNELS] = {
+  "auto", "bytewise", "scalar", "sse4.1"
+};
+
+static SHUFFLE  _aShuffle[1u << SHUFFLE_BITS];   // Indexed by the continuation bits of the first SHUFFLE_BITS bytes
+static unsigned _Kernel;
+static unsigned _DecodeAuto      (const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext);
+static unsigned _DecodeAutoPadded(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext);
+static SYSVIEW_VARINT_DECODE_FUNC* _pfDecode       = _DecodeAuto;         // SYSVIEW_VARINT_DecodeU32s()
+static SYSVIEW_VARINT_DECODE_FUNC* _pfDecodePadded = _DecodeAutoPadded;   // SYSVIEW_VARINT_DecodeU32sPadded()
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       _Load64()
+*/
+static inline U64 _Load64(const U8* p) {
+  U64 v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/*********************************************************************
+*
+*       _Merge()
+*
+*  Function description
+*    Merges the 7-bit groups of a value with its bytes in the low
+*    bytes of v and all other bytes 0. Bits of the 5th byte above
+*    bit 31 are dropped, as by SYSVIEW_PACKET_DecodeU32().
+*/
+static inline U32 _Merge(U64 v) {
+  return (U32)( (v        & 0x0000007Fu)
+             | ((v >> 1)  & 0x00003F80u)
+             | ((v >> 2)  & 0x001FC000u)
+             | ((v >> 3)  & 0x0FE00000u)
+             | ((v >> 4)  & 0xF0000000u));
+}
+
+/*********************************************************************
+*
+*       _DecodeTail()
+*
+*  Function description
+*    Decodes byte by byte, where no block can be loaded.
+*/
+static unsigned _DecodeTail(const U8* p, const U8* pEnd, U32* paValue, unsigned n, unsigned NumValues, const U8** ppNext) {
+  const U8* pNext;
+
+  while (n < NumValues) {
+    pNext = SYSVIEW_PACKET_DecodeU32(p, pEnd, &paValue[n]);
+    if (pNext == NULL) {
+      break;
+    }
+    p = pNext;
+    n++;
+  }
+  *ppNext = p;
+  return n;
+}
+
+/*********************************************************************
+*
+*       _DecodeOne()
+*
+*  Function description
+*    Decodes one value from 8 bytes loaded into a 64-bit register.
+*    At least 8 bytes must be readable at p.
+*
+*  Return value
+*    > 0: Number of bytes of the value.
+*    = 0: Value has more than 5 bytes or ends after pEnd.
+*/
+static inline unsigned _DecodeOne(const U8* p, const U8* pEnd, U32* pValue) {
+  U64      v;
+  U64      Term;
+  unsigned NumBytes;
+
+  v    = _Load64(p);
+  Term = ~v & CONT_BITS_VALUE;                // Bit 7 of each byte which ends a value
+  if (Term == 0) {
+    return 0;
+  }
+  NumBytes = ((unsigned)__builtin_ctzll(Term) >> 3) + 1;
+  if (p + NumBytes > pEnd) {
+    return 0;
+  }
+  *pValue = _Merge(v & _aLenMask[NumBytes]);
+  return NumBytes;
+}
+
+/*********************************************************************
+*
+*       _DecodeScalar()
+*
+*  Function description
+*    Decodes values with 8 bytes per step in a 64-bit register.
+*/
+static unsigned _DecodeScalar(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  unsigned NumBytes;
+  unsigned n;
+
+  n = 0;
+  while (n < NumValues && (pReadEnd - p) >= 8) {
+    NumBytes = _DecodeOne(p, pEnd, &paValue[n]);
+    if (NumBytes == 0) {
+      break;                                  // Corrupt or truncated
+    }
+    p += NumBytes;
+    n++;
+  }
+  return _DecodeTail(p, pEnd, paValue, n, NumValues, ppNext);
+}
+
+#if SUPPORT_X86_KERNELS
+
+/*********************************************************************
+*
+*       _InitShuffle()
+*
+*  Function description
+*    Fills _aShuffle[] for all combinations of continuation bits of
+*    the first SHUFFLE_BITS bytes of a block.
+*/
+static void _InitShuffle(void) {
+  SHUFFLE* pEntry;
+  unsigned Cont;
+  unsigned Pos;
+  unsigned NumBytes;
+  unsigned i;
+
+  if (_aShuffle[0].NumValues != 0) {
+    return;                                   // Already initialized
+  }
+  for (Cont = 0; Cont < (1u << SHUFFLE_BITS); Cont++) {
+    pEntry = &_aShuffle[Cont];
+    memset(pEntry->aShuffle, 0x80, sizeof(pEntry->aShuffle));   // Bit 7 set: PSHUFB writes 0
+    Pos = 0;
+    while (pEntry->NumValues < 4) {
+      NumBytes = 1;
+      while (Pos + NumBytes <= SHUFFLE_BITS && (Cont & (1u << (Pos + NumBytes - 1)))) {
+        NumBytes++;
+      }
+      if (Pos + NumBytes > SHUFFLE_BITS || NumBytes > 4) {
+        break;                                // Value continues after the described bytes or has 5 bytes
+      }
+      for (i = 0; i < NumBytes; i++) {
+        pEntry->aShuffle[pEntry->NumValues * 4 + i] = (U8)(Pos + i);
+      }
+      pEntry->NumValues++;
+      Pos += NumBytes;
+    }
+    pEntry->NumBytes = (U8)Pos;
+  }
+}
+
+/*********************************************************************
+*
+*       _MergeLanes()
+*
+*  Function description
+*    Merges the 7-bit groups of 4 values of up to 4 bytes, one per
+*    32-bit lane.
+*/
+__attribute__((target("sse4.1")))
+static inline __m128i _MergeLanes(__m128i x) {
+  __m128i v;
+
+  v =                  _mm_and_si128(x,                     _mm_set1_epi32(0x0000007F));
+  v = _mm_or_si128(v,  _mm_and_si128(_mm_srli_epi32(x, 1),  _mm_set1_epi32(0x00003F80)));
+  v = _mm_or_si128(v,  _mm_and_si128(_mm_srli_epi32(x, 2),  _mm_set1_epi32(0x001FC000)));
+  v = _mm_or_si128(v,  _mm_and_si128(_mm_srli_epi32(x, 3),  _mm_set1_epi32(0x0FE00000)));
+  return v;
+}
+
+/*********************************************************************
+*
+*       _DecodeSSE41()
+*
+*  Function description
+*    Decodes values with 16 bytes per step.
+*/
+__attribute__((target("sse4.1")))
+static unsigned _DecodeSSE41(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  const SHUFFLE* pEntry;
+  __m128i        x;
+  unsigned       Cont;
+  unsigned       NumBytes;
+  unsigned       n;
+
+  n = 0;
+  while (n < NumValues && (pReadEnd - p) >= 16) {
+    if ((NumValues - n) >= 8) {
+      x    = _mm_loadu_si128((const __m128i*)p);
+      Cont = (unsigned)_mm_movemask_epi8(x);  // Bit i set: Byte i is continued
+      if ((Cont & 0xFFu) == 0 && (pEnd - p) >= 8) {
+        //
+        // 8 values of 1 byte
+        //
+        _mm_storeu_si128((__m128i*)&paValue[n],     _mm_cvtepu8_epi32(x));
+        _mm_storeu_si128((__m128i*)&paValue[n + 4], _mm_cvtepu8_epi32(_mm_srli_si128(x, 4)));
+        n += 8;
+        p += 8;
+        continue;
+      }
+      pEntry = &_aShuffle[Cont & ((1u << SHUFFLE_BITS) - 1)];
+      if (pEntry->NumValues != 0 && p + pEntry->NumBytes <= pEnd) {
+        x = _mm_shuffle_epi8(x, _mm_loadu_si128((const __m128i*)pEntry->aShuffle));
+        _mm_storeu_si128((__m128i*)&paValue[n], _MergeLanes(x));
+        n += pEntry->NumValues;
+        p += pEntry->NumBytes;
+        continue;
+      }
+    }
+    NumBytes = _DecodeOne(p, pEnd, &paValue[n]);
+    if (NumBytes == 0) {
+      break;                                  // Corrupt or truncated
+    }
+    p += NumBytes;
+    n++;
+  }
+  return _DecodeTail(p, pEnd, paValue, n, NumValues, ppNext);
+}
+
+#endif  // SUPPORT_X86_KERNELS
+
+/*********************************************************************
+*
+*       _IsSupported()
+*/
+static int _IsSupported(unsigned Kernel) {
+  switch (Kernel) {
+  case SYSVIEW_VARINT_KERNEL_AUTO:
+  case SYSVIEW_VARINT_KERNEL_BYTEWISE:
+  case SYSVIEW_VARINT_KERNEL_SCALAR:
+    return 1;
+#if SUPPORT_X86_KERNELS
+  case SYSVIEW_VARINT_KERNEL_SSE41:
+    return __builtin_cpu_supports("sse4.1");
+#endif
+  default:
+    return 0;
+  }
+}
+
+/*********************************************************************
+*
+*       _DecodeAuto()
+*
+*  Function description
+*    Selects the fastest kernels on the first call.
+*/
+static unsigned _DecodeAuto(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  SYSVIEW_VARINT_SetKernel(SYSVIEW_VARINT_KERNEL_AUTO);
+  return _pfDecode(p, pEnd, pReadEnd, paValue, NumValues, ppNext);
+}
+
+/*********************************************************************
+*
+*       _DecodeAutoPadded()
+*/
+static unsigned _DecodeAutoPadded(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  SYSVIEW_VARINT_SetKernel(SYSVIEW_VARINT_KERNEL_AUTO);
+  return _pfDecodePadded(p, pEnd, pReadEnd, paValue, NumValues, ppNext);
+}
+
+/*********************************************************************
+*
+*       _DecodeBytewise()
+*/
+static unsigned _DecodeBytewise(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  (void)pReadEnd;
+  return _DecodeTail(p, pEnd, paValue, 0, NumValues, ppNext);
+}
+
+/*********************************************************************
+*
+*       Global functions
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       SYSVIEW_VARINT_SetKernel()
+*
+*  Function description
+*    Selects the kernel of SYSVIEW_VARINT_DecodeU32s() and
+*    SYSVIEW_VARINT_DecodeU32sPadded().
+*
+*  Parameters
+*    Kernel - SYSVIEW_VARINT_KERNEL_*. With SYSVIEW_VARINT_KERNEL_AUTO,
+*             SYSVIEW_VARINT_DecodeU32s() uses SSE4.1 if the CPU
+*             supports it and SYSVIEW_VARINT_DecodeU32sPadded(), which
+*             decodes the few parameters of a packet, the scalar kernel.
+*
+*  Return value
+*    == 0: O.K.
+*     < 0: Kernel not supported by build or CPU, unchanged.
+*/
+int SYSVIEW_VARINT_SetKernel(unsigned Kernel) {
+  if (_IsSupported(Kernel) == 0) {
+    return -1;
+  }
+  if (Kernel == SYSVIEW_VARINT_KERNEL_AUTO) {
+    Kernel = _IsSupported(SYSVIEW_VARINT_KERNEL_SSE41) ? SYSVIEW_VARINT_KERNEL_SSE41 : SYSVIEW_VARINT_KERNEL_SCALAR;
+    _pfDecodePadded = _DecodeScalar;
+  } else {
+    _pfDecodePadded = NULL;
+  }
+#if SUPPORT_X86_KERNELS
+  if (Kernel == SYSVIEW_VARINT_KERNEL_SSE41) {
+    _InitShuffle();
+  }
+#endif
+  switch (Kernel) {
+#if SUPPORT_X86_KERNELS
+  case SYSVIEW_VARINT_KERNEL_SSE41:  _pfDecode = _DecodeSSE41;    break;
+#endif
+  case SYSVIEW_VARINT_KERNEL_SCALAR: _pfDecode = _DecodeScalar;   break;
+  default:                           _pfDecode = _DecodeBytewise; break;
+  }
+  if (_pfDecodePadded == NULL) {
+    _pfDecodePadded = _pfDecode;
+  }
+  _Kernel = Kernel;
+  return 0;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_VARINT_GetKernel()
+*
+*  Return value
+*    Kernel of SYSVIEW_VARINT_DecodeU32s(), SYSVIEW_VARINT_KERNEL_AUTO
+*    before the first decode or SYSVIEW_VARINT_SetKernel().
+*/
+unsigned SYSVIEW_VARINT_GetKernel(void) {
+  return _Kernel;
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_VARINT_GetKernelName()
+*/
+const char* SYSVIEW_VARINT_GetKernelName(unsigned Kernel) {
+  return (Kernel < SYSVIEW_VARINT_NUM_KERNELS) ? _asKernelName[Kernel] : "";
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_VARINT_DecodeU32s()
+*
+*  Function description
+*    Decodes consecutive variable-length encoded U32 values with the
+*    selected kernel.
+*
+*  Parameters
+*    p         - First value.
+*    pEnd      - End of the data.
+*    paValue   - Receives the values.
+*    NumValues - Number of values to decode.
+*    ppNext    - Receives the position after the last decoded value.
+*
+*  Return value
+*    Number of values decoded. Less than NumValues if the data ends
+*    within a value or a value has more than 5 bytes.
+*/
+unsigned SYSVIEW_VARINT_DecodeU32s(const U8* p, const U8* pEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  return _pfDecode(p, pEnd, pEnd, paValue, NumValues, ppNext);
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_VARINT_DecodeU32sPadded()
+*
+*  Function description
+*    Decodes consecutive variable-length encoded U32 values in a larger
+*    buffer, e.g. the parameters in the payload of a packet.
+*
+*  Parameters
+*    p         - First value.
+*    pEnd      - End of the values.
+*    pReadEnd  - End of the buffer. Data up to here may be read, so the
+*                kernels can load whole blocks up to the end of the values.
+*    paValue   - Receives the values.
+*    NumValues - Number of values to decode.
+*    ppNext    - Receives the position after the last decoded value.
+*
+*  Return value
+*    Number of values decoded, as by SYSVIEW_VARINT_DecodeU32s().
+*/
+unsigned SYSVIEW_VARINT_DecodeU32sPadded(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  return _pfDecodePadded(p, pEnd, pReadEnd, paValue, NumValues, ppNext);
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_VARINT_DecodeU32sRef()
+*
+*  Function description
+*    Reference of SYSVIEW_VARINT_DecodeU32s(), decodes byte by byte
+*    with SYSVIEW_PACKET_DecodeU32().
+*/
+unsigned SYSVIEW_VARINT_DecodeU32sRef(const U8* p, const U8* pEnd, U32* paValue, unsigned NumValues, const U8** ppNext) {
+  return _DecodeTail(p, pEnd, paValue, 0, NumValues, ppNext);
+}
+
+/*************************** End of file ****************************/
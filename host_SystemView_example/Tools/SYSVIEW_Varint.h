@@ -0,0 +1,63 @@
+/*********************************************************************
+*                    SEGGER Microcontroller GmbH                     *
+*                        The Embedded Experts                        *
+**********************************************************************
+-------------------------- END-OF-HEADER -----------------------------
+
+File    : SYSVIEW_Varint.h
+Purpose : Interface of the bulk decoder of variable-length encoded
+          U32 values.
+*/
+
+#ifndef SYSVIEW_VARINT_H
+#define SYSVIEW_VARINT_H
+
+#include "SEGGER.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Defines, fixed
+*
+**********************************************************************
+*/
+//
+// Kernels for SYSVIEW_VARINT_SetKernel()
+//
+#define SYSVIEW_VARINT_KERNEL_AUTO      0   // Fastest kernels supported by the CPU, see SYSVIEW_VARINT_SetKernel()
+#define SYSVIEW_VARINT_KERNEL_BYTEWISE  1   // Byte by byte, the reference
+#define SYSVIEW_VARINT_KERNEL_SCALAR    2   // 8 bytes per step in a 64-bit register, portable
+#define SYSVIEW_VARINT_KERNEL_SSE41     3   // Up to 4 values per PSHUFB, x86-64 with SSE4.1
+#define SYSVIEW_VARINT_NUM_KERNELS      4
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+typedef unsigned SYSVIEW_VARINT_DECODE_FUNC(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext);
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+int         SYSVIEW_VARINT_SetKernel       (unsigned Kernel);
+unsigned    SYSVIEW_VARINT_GetKernel       (void);
+const char* SYSVIEW_VARINT_GetKernelName   (unsigned Kernel);
+unsigned    SYSVIEW_VARINT_DecodeU32s      (const U8* p, const U8* pEnd, U32* paValue, unsigned NumValues, const U8** ppNext);
+unsigned    SYSVIEW_VARINT_DecodeU32sPadded(const U8* p, const U8* pEnd, const U8* pReadEnd, U32* paValue, unsigned NumValues, const U8** ppNext);
+unsigned    SYSVIEW_VARINT_DecodeU32sRef   (const U8* p, const U8* pEnd, U32* paValue, unsigned NumValues, const U8** ppNext);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
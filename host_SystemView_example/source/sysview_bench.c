@@ -0,0 +1,188 @@
+/*
+ * Microbenchmark for the SEGGER_SYSVIEW_Record* entry points on the POSIX host build.
+ *
+ * Every entry point is called NUM_SAMPLES times. Each call is timed on its own,
+ * the timer overhead is subtracted, and the RTT up-channel is drained (untimed)
+ * every BATCH_SIZE calls so that the benchmark measures the recording path
+ * and not the overflow path.
+ *
+ * The recorder configuration is fixed at compile time. "make bench" builds and
+ * runs one binary per permutation of SEGGER_SYSVIEW_USE_STATIC_BUFFER,
+ * SEGGER_SYSVIEW_SUPPORT_LONG_ID and SEGGER_SYSVIEW_POST_MORTEM_MODE, plus
+ * SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING where it is available.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_SAMPLES     200000
+#define BATCH_SIZE      32
+#define TASK_ID         0x20001000u
+#define ISR_ID          15u
+#define EVENT_ID        (32u + 34u)     // apiID_OFFSET + apiID_VTASKDELAY
+
+typedef void BENCH_FUNC(U32 i);
+
+typedef struct {
+  const char* sName;
+  BENCH_FUNC* pfRecord;
+} BENCH;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U32 _aSample[NUM_SAMPLES];
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void _RecordVoid   (U32 i) { (void)i; SEGGER_SYSVIEW_RecordVoid(EVENT_ID); }
+static void _RecordU32    (U32 i) { SEGGER_SYSVIEW_RecordU32(EVENT_ID, i); }
+static void _RecordU32x2  (U32 i) { SEGGER_SYSVIEW_RecordU32x2(EVENT_ID, i, TASK_ID); }
+static void _RecordU32x3  (U32 i) { SEGGER_SYSVIEW_RecordU32x3(EVENT_ID, i, TASK_ID, 3); }
+static void _RecordU32x4  (U32 i) { SEGGER_SYSVIEW_RecordU32x4(EVENT_ID, i, TASK_ID, 3, 4); }
+static void _RecordU32x5  (U32 i) { SEGGER_SYSVIEW_RecordU32x5(EVENT_ID, i, TASK_ID, 3, 4, 5); }
+static void _RecordU32x6  (U32 i) { SEGGER_SYSVIEW_RecordU32x6(EVENT_ID, i, TASK_ID, 3, 4, 5, 6); }
+static void _RecordU32x7  (U32 i) { SEGGER_SYSVIEW_RecordU32x7(EVENT_ID, i, TASK_ID, 3, 4, 5, 6, 7); }
+static void _RecordU32x8  (U32 i) { SEGGER_SYSVIEW_RecordU32x8(EVENT_ID, i, TASK_ID, 3, 4, 5, 6, 7, 8); }
+static void _RecordU32x9  (U32 i) { SEGGER_SYSVIEW_RecordU32x9(EVENT_ID, i, TASK_ID, 3, 4, 5, 6, 7, 8, 9); }
+static void _RecordU32x10 (U32 i) { SEGGER_SYSVIEW_RecordU32x10(EVENT_ID, i, TASK_ID, 3, 4, 5, 6, 7, 8, 9, 10); }
+static void _RecordString (U32 i) { (void)i; SEGGER_SYSVIEW_RecordString(EVENT_ID, "Task1"); }
+static void _OnTaskStartExec(U32 i) { (void)i; SEGGER_SYSVIEW_OnTaskStartExec(TASK_ID); }
+static void _PrintfTarget (U32 i) { SEGGER_SYSVIEW_PrintfTarget("Task1 loop %u", i); }
+
+static void _RecordEnterISR(U32 i) {
+  (void)i;
+  SEGGER_SYSVIEW_POSIX_SetInterruptId(ISR_ID);
+  SEGGER_SYSVIEW_RecordEnterISR();
+  SEGGER_SYSVIEW_POSIX_SetInterruptId(0);
+}
+
+static const BENCH _aBench[] = {
+  { "RecordVoid",      _RecordVoid      },
+  { "RecordU32",       _RecordU32       },
+  { "RecordU32x2",     _RecordU32x2     },
+  { "RecordU32x3",     _RecordU32x3     },
+  { "RecordU32x4",     _RecordU32x4     },
+  { "RecordU32x5",     _RecordU32x5     },
+  { "RecordU32x6",     _RecordU32x6     },
+  { "RecordU32x7",     _RecordU32x7     },
+  { "RecordU32x8",     _RecordU32x8     },
+  { "RecordU32x9",     _RecordU32x9     },
+  { "RecordU32x10",    _RecordU32x10    },
+  { "RecordString",    _RecordString    },
+  { "OnTaskStartExec", _OnTaskStartExec },
+  { "RecordEnterISR",  _RecordEnterISR  },
+  { "PrintfTarget",    _PrintfTarget    },
+};
+
+static int _CompareU32(const void* p0, const void* p1) {
+  U32 v0;
+  U32 v1;
+
+  v0 = *(const U32*)p0;
+  v1 = *(const U32*)p1;
+  return (v0 > v1) - (v0 < v1);
+}
+
+static U32 _Percentile(const U32* pSorted, unsigned NumItems, unsigned PerMille) {
+  return pSorted[((U64)NumItems * PerMille) / 1000u];
+}
+
+static unsigned _Drain(void) {
+  char     acBuffer[1024];
+  unsigned NumBytes;
+  unsigned Total;
+
+  Total = 0;
+  do {
+    NumBytes = SEGGER_RTT_ReadUpBuffer(SEGGER_SYSVIEW_GetChannelID(), acBuffer, sizeof(acBuffer));
+    Total   += NumBytes;
+  } while (NumBytes);
+  return Total;
+}
+
+/*********************************************************************
+*
+*       _GetTimerOverhead()
+*
+*  Function description
+*    Returns the median cost of an empty timed region in ns,
+*    which is subtracted from every sample.
+*/
+static U32 _GetTimerOverhead(void) {
+  U64 t0;
+  U64 t1;
+  U32 i;
+
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    t0 = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    t1 = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    _aSample[i] = (U32)(t1 - t0);
+  }
+  qsort(_aSample, NUM_SAMPLES, sizeof(_aSample[0]), _CompareU32);
+  return _Percentile(_aSample, NUM_SAMPLES, 500);
+}
+
+static void _Run(const BENCH* pBench, U32 Overhead) {
+  U64 t0;
+  U64 t1;
+  U64 Sum;
+  U64 NumBytes;
+  U32 Delta;
+  U32 i;
+
+  NumBytes = 0;
+  Sum      = 0;
+  _Drain();
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    t0 = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    pBench->pfRecord(i);
+    t1 = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    Delta = (U32)(t1 - t0);
+    Delta = (Delta > Overhead) ? Delta - Overhead : 0;
+    _aSample[i] = Delta;
+    Sum += Delta;
+    if ((i % BATCH_SIZE) == BATCH_SIZE - 1) {
+      NumBytes += _Drain();
+    }
+  }
+  NumBytes += _Drain();
+  qsort(_aSample, NUM_SAMPLES, sizeof(_aSample[0]), _CompareU32);
+  printf("%-16s %9.1f %11.2f %7u %7u %7u\n",
+         pBench->sName,
+         (double)Sum / NUM_SAMPLES,
+         (double)NumBytes / NUM_SAMPLES,
+         _Percentile(_aSample, NUM_SAMPLES, 500),
+         _Percentile(_aSample, NUM_SAMPLES, 990),
+         _Percentile(_aSample, NUM_SAMPLES, 999));
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  U32      Overhead;
+  unsigned i;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  Overhead = _GetTimerOverhead();
+  printf("Config: USE_STATIC_BUFFER=%d SUPPORT_LONG_ID=%d POST_MORTEM_MODE=%d USE_IN_PLACE_ENCODING=%d, timer overhead %u ns\n",
+         SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_SUPPORT_LONG_ID, SEGGER_SYSVIEW_POST_MORTEM_MODE,
+         SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING, Overhead);
+  printf("%-16s %9s %11s %7s %7s %7s\n", "Event", "ns/event", "bytes/event", "p50", "p99", "p99.9");
+  for (i = 0; i < sizeof(_aBench) / sizeof(_aBench[0]); i++) {
+    _Run(&_aBench[i], Overhead);
+  }
+  SEGGER_SYSVIEW_Stop();
+  printf("\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,273 @@
+/*
+ * Test of the down-channel commands on the POSIX host build.
+ *
+ * A script of operator lines is encoded with SYSVIEW_COMMAND_Parse() and
+ * written to the down buffer, as the host does, between the events. The
+ * recorder processes each command in SEGGER_SYSVIEW_IsStarted(). The
+ * stream is decoded and must contain exactly the events selected by the
+ * event ranges, the task filter and the sampling ratios. In buffer mode
+ * stop-on-full, the recording stops as the buffer is full and holds
+ * all events since the start, without overflow, until it is restarted.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_Int.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Command.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define EVENT_ID            64u
+#define FILL_EVENT_ID       (EVENT_ID + 16u)   // Events recorded until the buffer is full
+#define MAX_EVENTS          64
+#define MAX_FILL_EVENTS     1000000u
+#define TASK_A              0x20001000u
+#define TASK_B              0x20002000u
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32 Id;
+  U32 Para;
+} EXPECTED;
+
+typedef struct {
+  unsigned NumEvents;
+  unsigned NumFillEvents;
+  unsigned NumOverflows;
+  unsigned NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static STREAM   _Stream;
+static EXPECTED _aExpected[MAX_EVENTS];
+static unsigned _NumExpected;
+static unsigned _NumFillEvents;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _Drain(void) {
+  return SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static void _Record(U32 Id, U32 Para, int IsExpected) {
+  SEGGER_SYSVIEW_RECORD(Id, Para);
+  if (IsExpected) {
+    _aExpected[_NumExpected].Id   = Id;
+    _aExpected[_NumExpected].Para = Para;
+    _NumExpected++;
+  }
+}
+
+/*********************************************************************
+*
+*       _Command()
+*
+*  Function description
+*    Sends the command of an operator line through the down buffer
+*    and lets the recorder process it.
+*/
+static void _Command(const char* sLine) {
+  U8  aCmd[SYSVIEW_COMMAND_MAX_SIZE];
+  int NumBytes;
+
+  NumBytes = SYSVIEW_COMMAND_Parse(sLine, aCmd, sizeof(aCmd));
+  if (NumBytes <= 0) {
+    printf("Command \"%s\" not encoded\n", sLine);
+    _NumErrors++;
+    return;
+  }
+  SEGGER_RTT_WriteDownBuffer(SEGGER_SYSVIEW_GetChannelID(), aCmd, (unsigned)NumBytes);
+  SEGGER_SYSVIEW_IsStarted();
+}
+
+/*********************************************************************
+*
+*       _CheckParser()
+*
+*  Function description
+*    Checks that invalid operator lines are rejected.
+*/
+static void _CheckParser(void) {
+  static const char* const _asInvalid[] = {
+    "begin", "start now", "disable", "disable x", "disable 70000", "filter 1",
+    "task 0", "task 256 1", "sample 64", "sample 64 256", "mode fast", "enable 1 2 3", "disable -1"
+  };
+  U8       aCmd[SYSVIEW_COMMAND_MAX_SIZE];
+  unsigned i;
+
+  for (i = 0; i < SEGGER_COUNTOF(_asInvalid); i++) {
+    if (SYSVIEW_COMMAND_Parse(_asInvalid[i], aCmd, sizeof(aCmd)) != -1) {
+      printf("Command \"%s\" not rejected\n", _asInvalid[i]);
+      _NumErrors++;
+    }
+  }
+  if (SYSVIEW_COMMAND_Parse(" \t", aCmd, sizeof(aCmd)) != 0
+   || SYSVIEW_COMMAND_Parse("filter 2 0x80000001", aCmd, sizeof(aCmd)) != 6
+   || aCmd[0] != SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER || aCmd[1] != 2 || aCmd[2] != 0x01 || aCmd[5] != 0x80) {
+    printf("Commands encoded incorrectly\n");
+    _NumErrors++;
+  }
+}
+
+/*********************************************************************
+*
+*       _RecordEvents()
+*
+*  Function description
+*    Plays the script of commands and records the test events.
+*/
+static void _RecordEvents(void) {
+  char ac[32];
+  U32  i;
+
+  _Command("systime");
+  _Command("tasklist");
+  //
+  // Event ranges.
+  //
+  _Command("disable 66 2");
+  for (i = 0; i < 4; i++) {
+    _Record(EVENT_ID + i, i, i < 2);
+  }
+  _Command("enable 0x42");
+  _Record(EVENT_ID + 2, 2, 1);
+  _Record(EVENT_ID + 3, 3, 0);
+  _Command("enable 67");
+  //
+  // Task filter. It applies from the next task switch on, to API, user
+  // and module events.
+  //
+  snprintf(ac, sizeof(ac), "task 1 0x%X", (unsigned)SEGGER_SYSVIEW_ShrinkId(TASK_A));
+  _Command(ac);
+  SEGGER_SYSVIEW_OnTaskStartExec(TASK_A);
+  _Record(EVENT_ID + 4, 1, 1);
+  SEGGER_SYSVIEW_OnTaskStopExec();
+  SEGGER_SYSVIEW_OnTaskStartExec(TASK_B);
+  _Record(EVENT_ID + 4, 2, 0);
+  SEGGER_SYSVIEW_OnIdle();
+  _Record(EVENT_ID + 4, 3, 1);
+  SEGGER_SYSVIEW_OnTaskStartExec(TASK_B);
+  _Command("task 1 0");
+  _Record(EVENT_ID + 4, 4, 0);
+  SEGGER_SYSVIEW_OnTaskStartExec(TASK_B);
+  _Record(EVENT_ID + 4, 5, 1);
+  //
+  // Sampling, starting with the first event.
+  //
+  _Command("sample 69 3");
+  for (i = 0; i < 7; i++) {
+    _Record(EVENT_ID + 5, i, i % 3 == 0);
+    _Record(EVENT_ID + 6, i, 1);
+  }
+  _Command("sample 69 1");
+  _Record(EVENT_ID + 5, 7, 1);
+  _Record(EVENT_ID + 5, 8, 1);
+}
+
+/*********************************************************************
+*
+*       _FillBuffer()
+*
+*  Function description
+*    Records events without draining the buffer in buffer mode
+*    stop-on-full until the recording stops.
+*/
+static void _FillBuffer(void) {
+  U32 i;
+
+  _Drain();
+  _Command("mode stop-on-full");
+  for (i = 0; i < MAX_FILL_EVENTS; i++) {
+    SEGGER_SYSVIEW_RecordU32(FILL_EVENT_ID, i);
+    if (SEGGER_SYSVIEW_IsStarted() == 0) {
+      break;
+    }
+  }
+  if (i == MAX_FILL_EVENTS) {
+    printf("Recording not stopped\n");
+    _NumErrors++;
+  }
+  _NumFillEvents = i;           // Event i has not been recorded
+  _Drain();
+  _Command("mode stream");
+  _Command("start");
+  if (SEGGER_SYSVIEW_IsStarted() == 0) {
+    printf("Recording not restarted\n");
+    _NumErrors++;
+  }
+  _Record(EVENT_ID + 7, 0, 1);
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  const EXPECTED* pExpected;
+  CHECK*          pCheck;
+  U32             Para;
+
+  pCheck = (CHECK*)pContext;
+  if (pEvent->Id == SYSVIEW_EVTID_OVERFLOW) {
+    pCheck->NumOverflows++;
+    return;
+  }
+  if (pEvent->Id < EVENT_ID) {
+    return;
+  }
+  Para = 0;
+  SYSVIEW_DECODE_GetU32s(pEvent, &Para, 1);
+  if (pEvent->Id == FILL_EVENT_ID) {
+    if (Para != pCheck->NumFillEvents) {
+      printf("Fill event %u: Parameter %u\n", pCheck->NumFillEvents, Para);
+      pCheck->NumErrors++;
+    }
+    pCheck->NumFillEvents++;
+    return;
+  }
+  if (pCheck->NumEvents < _NumExpected) {
+    pExpected = &_aExpected[pCheck->NumEvents];
+    if (pEvent->Id != pExpected->Id || Para != pExpected->Para) {
+      printf("Event %u: ID %u (%u), expected ID %u (%u)\n", pCheck->NumEvents, pEvent->Id, Para, pExpected->Id, pExpected->Para);
+      pCheck->NumErrors++;
+    }
+  }
+  pCheck->NumEvents++;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  CHECK                         Check;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  _CheckParser();
+  _RecordEvents();
+  _FillBuffer();
+  _Drain();
+  memset(&Check, 0, sizeof(Check));
+  Check.NumErrors = _NumErrors;
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  if (Check.NumEvents != _NumExpected || Check.NumFillEvents != _NumFillEvents || Check.NumOverflows != 0) {
+    printf("%u events, expected %u, %u fill events, expected %u, %u overflows\n",
+           Check.NumEvents, _NumExpected, Check.NumFillEvents, _NumFillEvents, Check.NumOverflows);
+    Check.NumErrors++;
+  }
+  printf("Config: USE_STATIC_BUFFER=%d USE_IN_PLACE_ENCODING=%d, %u events checked, stopped after %u fill events\n",
+         SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING, _NumExpected, _NumFillEvents);
+  printf("%s\n\n", Check.NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return Check.NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,475 @@
+/*
+ * Test and throughput benchmark of the streaming decoder (Tools/SYSVIEW_Decode.c)
+ * on the POSIX host build.
+ *
+ * A trace of a scheduler-like workload is recorded against a simulated cycle
+ * counter: interrupts, task switches, API events, module events, markers
+ * (SYSVIEW_EVTID_EX) and printf messages. It is recorded twice, as two
+ * sessions each starting with a sync. The test checks that
+ *   - every module event is reported with its module, event ID within the
+ *     module and absolute time,
+ *   - feeding the stream in chunks of random size, down to single bytes,
+ *     gives the same events as feeding it at once,
+ *   - after corrupting the first session, the decoder resynchronizes and
+ *     reports all events of the second session.
+ * The benchmark then decodes the trace, or the trace file given as second
+ * argument, repeated up to the given size (default 256 MB) in 64 KB chunks
+ * and reports MB/s and events/s, decoding the parameters of the API events.
+ * Then all parameters and time stamp deltas of the trace, re-encoded back
+ * to back, are decoded in bulk. Both are run with every kernel of
+ * SYSVIEW_VARINT_DecodeU32s() supported by the CPU and with the kernels
+ * selected by SYSVIEW_VARINT_KERNEL_AUTO.
+ * Built with SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, the stream is decoded
+ * with SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Packet.h"
+#include "SYSVIEW_Varint.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_LOOPS           50000         // Module events per session
+#define NUM_MODULE_EVENTS   4
+#define START_TIME          0xFFF00000u   // Wraps around after about 1 ms
+#define TASK_ID             0x20001000u
+#define ISR_ID              15u
+#define API_EVENT_ID        (32u + 34u)   // apiID_OFFSET + apiID_VTASKDELAY
+#define QUEUE_EVENT_ID      (32u + 53u)   // apiID_OFFSET + apiID_XQUEUEGENERICSEND
+#define QUEUE_ID            0x20004A30u
+#define API_EVENT_ID_MIN    32u           // User and FreeRTOS API events, parameters are U32
+#define MAX_VALUES          16
+#define CHUNK_SIZE          (64u * 1024u)
+#define NUM_RUNS            3
+#define DECODE_FLAGS        (SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0u)
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U64 NumEvents;
+  U64 Hash;                               // Over ID, sub ID, module, time and payload of all events
+  U32 NumModuleEvents;
+  U32 NumMarks;
+  U32 NumErrors;
+  U64 TimeBase;                           // Decoded time minus simulated time in the current session
+  U32 FirstIndex;                         // First module event index which is checked
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U64    _Time;
+static U64    _aTime[2 * NUM_LOOPS];      // Simulated time of each module event
+static STREAM _Trace;
+static U32    _Rand = 1;
+static SYSVIEW_DECODE_CONTEXT _Decode;    // Too large for the stack with a large SYSVIEW_DECODE_MAX_PACKET_SIZE
+static U64    _PrevTime;
+static U64    _NumValues;
+
+static SEGGER_SYSVIEW_MODULE _aModule[2] = {
+  { "M=Other",  8,                 0, NULL, NULL },
+  { "M=Test",   NUM_MODULE_EVENTS, 0, NULL, NULL },
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U32 _cbGetTimestamp(void) {
+  return (U32)_Time;
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Trace, ~0u);
+}
+
+static void _Advance(unsigned MaxTicks) {
+  _Time += 1 + _GetRand(MaxTicks);
+}
+
+/*********************************************************************
+*
+*       _Record()
+*
+*  Function description
+*    Records one session of NUM_LOOPS loops. Every loop records one
+*    module event with the loop index in [FirstIndex, FirstIndex + NUM_LOOPS).
+*/
+static void _Record(U32 FirstIndex) {
+  U32 i;
+
+  SEGGER_SYSVIEW_Start();
+  SEGGER_SYSVIEW_SendModule(0);             // Requested by SystemView after the start
+  SEGGER_SYSVIEW_SendModule(1);
+  _Drain();
+  for (i = FirstIndex; i < FirstIndex + NUM_LOOPS; i++) {
+    SEGGER_SYSVIEW_POSIX_SetInterruptId(ISR_ID);
+    SEGGER_SYSVIEW_RecordEnterISR();
+    _Advance(200);
+    SEGGER_SYSVIEW_RecordExitISRToScheduler();
+    SEGGER_SYSVIEW_POSIX_SetInterruptId(0);
+    _Advance(100);
+    SEGGER_SYSVIEW_OnTaskStartExec(TASK_ID + (i & 3) * 0x100);
+    _Advance(1000);
+    SEGGER_SYSVIEW_RecordU32x2(API_EVENT_ID, i, TASK_ID);
+    _Advance(1000);
+    SEGGER_SYSVIEW_RecordU32x4(QUEUE_EVENT_ID, SEGGER_SYSVIEW_ShrinkId(QUEUE_ID), SEGGER_SYSVIEW_ShrinkId(TASK_ID + 0x40), 100, 0);
+    _Advance(300);
+    _aTime[i] = _Time;
+    SEGGER_SYSVIEW_RecordU32(_aModule[1].EventOffset + (i % NUM_MODULE_EVENTS), i);
+    if ((i & 7) == 0) {
+      SEGGER_SYSVIEW_Mark(i & 3);
+    }
+    if ((i & 63) == 0) {
+      SEGGER_SYSVIEW_PrintfTarget("Loop %u", i);
+    }
+    _Advance(5000);
+    SEGGER_SYSVIEW_OnTaskStopExec();
+    SEGGER_SYSVIEW_OnIdle();
+    _Advance(50000);
+    _Drain();
+  }
+  SEGGER_SYSVIEW_Stop();
+  _Drain();
+}
+
+/*********************************************************************
+*
+*       _cbCheck()
+*
+*  Function description
+*    Hashes every event and checks the module events and markers.
+*/
+static void _cbCheck(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK*    pCheck;
+  U64       Hash;
+  U32       Index;
+  unsigned  i;
+
+  pCheck = (CHECK*)pContext;
+  Hash   = pCheck->Hash ^ (pEvent->Id + ((U64)pEvent->SubId << 16) + ((U64)(pEvent->ModuleIndex + 1) << 32));
+  Hash   = (Hash ^ pEvent->Time) * 0x100000001B3ull;
+  for (i = 0; i < pEvent->PayloadSize; i++) {
+    Hash = (Hash ^ pEvent->pPayload[i]) * 0x100000001B3ull;
+  }
+  pCheck->Hash = Hash;
+  pCheck->NumEvents++;
+  if (pEvent->Id == SYSVIEW_EVTID_EX && pEvent->SubId == SYSVIEW_EVTID_EX_MARK) {
+    pCheck->NumMarks++;
+  }
+  if (pEvent->ModuleIndex == 1) {
+    if (SYSVIEW_PACKET_DecodeU32(pEvent->pPayload, pEvent->pPayload + pEvent->PayloadSize, &Index) == NULL) {
+      Index = 0xFFFFFFFFu;
+    }
+    if (Index < pCheck->FirstIndex) {
+      return;                                 // Before the corrupt part, may be misdecoded
+    }
+    if (Index % NUM_LOOPS == 0) {
+      pCheck->TimeBase = pEvent->Time - _aTime[Index];   // Start of a session, time between the sessions is not sent
+    }
+    if (Index != pCheck->FirstIndex + pCheck->NumModuleEvents
+     || pEvent->SubId != Index % NUM_MODULE_EVENTS
+     || pEvent->Time - pCheck->TimeBase != _aTime[Index]) {
+      if (pCheck->NumErrors++ < 10) {
+        printf("Module event %u: index %u, event %u, time %llu\n", pCheck->FirstIndex + pCheck->NumModuleEvents,
+               Index, pEvent->SubId, (unsigned long long)pEvent->Time);
+      }
+    }
+    pCheck->NumModuleEvents++;
+  }
+}
+
+/*********************************************************************
+*
+*       _DecodeStream()
+*
+*  Function description
+*    Decodes the stream in chunks of up to MaxChunkSize bytes,
+*    of random size if Random is set.
+*/
+static void _DecodeStream(const U8* pData, size_t NumBytes, unsigned MaxChunkSize, int Random, CHECK* pCheck, U32 FirstIndex) {
+  size_t   Pos;
+  unsigned NumBytesChunk;
+
+  memset(pCheck, 0, sizeof(*pCheck));
+  pCheck->FirstIndex = FirstIndex;
+  SYSVIEW_DECODE_Init(&_Decode, DECODE_FLAGS, _cbCheck, pCheck);
+  for (Pos = 0; Pos < NumBytes; Pos += NumBytesChunk) {
+    NumBytesChunk = Random ? 1 + _GetRand(MaxChunkSize) : MaxChunkSize;
+    if (NumBytesChunk > NumBytes - Pos) {
+      NumBytesChunk = (unsigned)(NumBytes - Pos);
+    }
+    SYSVIEW_DECODE_Feed(&_Decode, pData + Pos, NumBytesChunk);
+  }
+}
+
+static unsigned _Test(void) {
+  CHECK    Ref;
+  CHECK    Check;
+  U8*      pCorrupt;
+  unsigned NumErrors;
+  unsigned MaxChunkSize;
+
+  //
+  // Stream at once
+  //
+  _DecodeStream(_Trace.pData, _Trace.Size, (unsigned)_Trace.Size, 0, &Ref, 0);
+  NumErrors = Ref.NumErrors;
+  if (Ref.NumModuleEvents != 2 * NUM_LOOPS || Ref.NumMarks != 2 * NUM_LOOPS / 8 || _Decode.NumResyncs || _Decode.NumBytesCarry) {
+    printf("At once: %u module events, %u markers, %u resyncs\n", Ref.NumModuleEvents, Ref.NumMarks, _Decode.NumResyncs);
+    NumErrors++;
+  }
+  printf("%u bytes, %llu events, %.2f bytes/event\n", (unsigned)_Trace.Size,
+         (unsigned long long)Ref.NumEvents, (double)_Trace.Size / Ref.NumEvents);
+  //
+  // Chunks of random size
+  //
+  for (MaxChunkSize = 1; MaxChunkSize <= 4096; MaxChunkSize *= 8) {
+    _DecodeStream(_Trace.pData, _Trace.Size, MaxChunkSize, 1, &Check, 0);
+    if (Check.NumEvents != Ref.NumEvents || Check.Hash != Ref.Hash || Check.NumErrors) {
+      printf("Chunks of up to %u bytes: %llu events, differ from stream at once\n", MaxChunkSize, (unsigned long long)Check.NumEvents);
+      NumErrors++;
+    }
+  }
+  //
+  // Corrupt the middle of the first session
+  //
+  pCorrupt = malloc(_Trace.Size);
+  memcpy(pCorrupt, _Trace.pData, _Trace.Size);
+  memset(pCorrupt + _Trace.Size / 4, 0xFF, 64);
+  _DecodeStream(pCorrupt, _Trace.Size, 1000, 1, &Check, NUM_LOOPS);
+  if (Check.NumModuleEvents != NUM_LOOPS || Check.NumErrors || _Decode.NumResyncs == 0) {
+    printf("Corrupt stream: %u module events of the second session, %u resyncs\n", Check.NumModuleEvents, _Decode.NumResyncs);
+    NumErrors++;
+  }
+  printf("Corrupt stream: %u resyncs, %llu bytes skipped\n", _Decode.NumResyncs, (unsigned long long)_Decode.NumBytesSkipped);
+  free(pCorrupt);
+  return NumErrors;
+}
+
+static void _cbCount(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  U32      aValue[MAX_VALUES];
+  unsigned NumValues;
+  unsigned i;
+  U64      Sum;
+
+  Sum = pEvent->Id + pEvent->Time;
+  if (pEvent->Id >= API_EVENT_ID_MIN && pEvent->Id < SYSVIEW_DECODE_MODULE_EVENT_OFFSET) {
+    NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, MAX_VALUES);
+    for (i = 0; i < NumValues; i++) {
+      Sum += aValue[i];
+    }
+  }
+  *(U64*)pContext += Sum;
+}
+
+/*********************************************************************
+*
+*       _cbCollect()
+*
+*  Function description
+*    Collects the parameters of the events with ID < 24 and of the
+*    API events, and the time stamp deltas, as sent in the stream.
+*/
+static void _cbCollect(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  STREAM*  pValues;
+  U32      aValue[MAX_VALUES];
+  unsigned NumValues;
+  unsigned i;
+
+  pValues = (STREAM*)pContext;
+  if (pEvent->Id >= API_EVENT_ID_MIN && pEvent->Id < SYSVIEW_DECODE_MODULE_EVENT_OFFSET) {
+    NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, MAX_VALUES);
+  } else {
+    NumValues = pEvent->NumParams;
+    memcpy(aValue, pEvent->aParam, NumValues * sizeof(U32));
+  }
+  aValue[NumValues++] = (U32)(pEvent->Time - _PrevTime);
+  _PrevTime           = pEvent->Time;
+  SEGGER_SYSVIEW_POSIX_ReserveStream(pValues, NumValues * 5u);
+  for (i = 0; i < NumValues; i++) {
+    pValues->Size = (size_t)(SYSVIEW_PACKET_EncodeU32(pValues->pData + pValues->Size, aValue[i]) - pValues->pData);
+  }
+  _NumValues += NumValues;
+}
+
+static double _GetTime(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*********************************************************************
+*
+*       _BenchDecode()
+*
+*  Function description
+*    Decodes the data in chunks of CHUNK_SIZE, decoding the parameters
+*    of the API events.
+*/
+static void _BenchDecode(const U8* pData, size_t NumBytes, const char* sKernel) {
+  size_t Pos;
+  U64    Sum;
+  double t;
+  double tBest;
+  int    i;
+
+  tBest = 0;
+  Sum   = 0;
+  for (i = 0; i < NUM_RUNS; i++) {
+    SYSVIEW_DECODE_Init(&_Decode, DECODE_FLAGS, _cbCount, &Sum);
+    t = _GetTime();
+    for (Pos = 0; Pos < NumBytes; Pos += CHUNK_SIZE) {
+      SYSVIEW_DECODE_Feed(&_Decode, pData + Pos, (unsigned)(NumBytes - Pos < CHUNK_SIZE ? NumBytes - Pos : CHUNK_SIZE));
+    }
+    t = _GetTime() - t;
+    if (tBest == 0 || t < tBest) {
+      tBest = t;
+    }
+  }
+  printf("  Stream  %-8s %6.0f MB/s, %6.1f M events/s, %6.2f ns/event (checksum %llx)\n",
+         sKernel, NumBytes / tBest / 1e6,
+         _Decode.NumEvents / tBest / 1e6, tBest * 1e9 / _Decode.NumEvents, (unsigned long long)Sum);
+}
+
+/*********************************************************************
+*
+*       _BenchVarint()
+*
+*  Function description
+*    Decodes the values in blocks of MAX_VALUES with SYSVIEW_VARINT_DecodeU32s().
+*/
+static void _BenchVarint(const U8* pData, size_t NumBytes, U64 NumValues, const char* sKernel) {
+  U32       aValue[MAX_VALUES];
+  const U8* p;
+  const U8* pEnd;
+  U64       n;
+  U64       Sum;
+  double    t;
+  double    tBest;
+  unsigned  i;
+  int       Run;
+
+  tBest = 0;
+  Sum   = 0;
+  for (Run = 0; Run < NUM_RUNS; Run++) {
+    t    = _GetTime();
+    p    = pData;
+    pEnd = pData + NumBytes;
+    n    = 0;
+    while (p < pEnd) {
+      n += SYSVIEW_VARINT_DecodeU32s(p, pEnd, aValue, MAX_VALUES, &p);
+      Sum += aValue[0];
+    }
+    t = _GetTime() - t;
+    if (tBest == 0 || t < tBest) {
+      tBest = t;
+    }
+  }
+  for (i = 0; i < MAX_VALUES; i++) {
+    Sum += aValue[i];
+  }
+  printf("  Varints %-8s %6.0f MB/s, %6.1f M values/s%s (checksum %llx)\n",
+         sKernel, NumBytes / tBest / 1e6,
+         NumValues / tBest / 1e6, (n == NumValues) ? "" : ", FAILED", (unsigned long long)Sum);
+}
+
+/*********************************************************************
+*
+*       _Bench()
+*
+*  Function description
+*    Runs the benchmarks with every kernel supported by the CPU on
+*    the trace repeated up to NumBytesTotal.
+*/
+static void _Bench(const STREAM* pTrace, size_t NumBytesTotal) {
+  STREAM   Values;
+  U8*      pData;
+  size_t   NumBytes;
+  unsigned Kernel;
+
+  NumBytes = 0;
+  pData    = malloc(NumBytesTotal + pTrace->Size);
+  while (NumBytes < NumBytesTotal) {
+    memcpy(pData + NumBytes, pTrace->pData, pTrace->Size);
+    NumBytes += pTrace->Size;
+  }
+  //
+  // Values of the trace, re-encoded back to back
+  //
+  memset(&Values, 0, sizeof(Values));
+  _NumValues = 0;
+  _PrevTime  = 0;
+  SYSVIEW_DECODE_Init(&_Decode, DECODE_FLAGS, _cbCollect, &Values);
+  SYSVIEW_DECODE_Feed(&_Decode, pData, (unsigned)(NumBytes < (64u << 20) ? NumBytes : (64u << 20)));
+  printf("Decoding %u MB in %u KB chunks, values re-encoded back to back: %llu values, %.2f bytes/value\n",
+         (unsigned)(NumBytes >> 20), CHUNK_SIZE >> 10, (unsigned long long)_NumValues, (double)Values.Size / _NumValues);
+  for (Kernel = SYSVIEW_VARINT_KERNEL_AUTO; Kernel < SYSVIEW_VARINT_NUM_KERNELS; Kernel++) {
+    if (SYSVIEW_VARINT_SetKernel(Kernel) == 0) {
+      _BenchDecode(pData, NumBytes, SYSVIEW_VARINT_GetKernelName(Kernel));
+    }
+  }
+  for (Kernel = SYSVIEW_VARINT_KERNEL_AUTO; Kernel < SYSVIEW_VARINT_NUM_KERNELS; Kernel++) {
+    if (SYSVIEW_VARINT_SetKernel(Kernel) == 0) {
+      _BenchVarint(Values.pData, Values.Size, _NumValues, SYSVIEW_VARINT_GetKernelName(Kernel));
+    }
+  }
+  SYSVIEW_VARINT_SetKernel(SYSVIEW_VARINT_KERNEL_AUTO);
+  SEGGER_SYSVIEW_POSIX_FreeStream(&Values);
+  free(pData);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char** argv) {
+  STREAM   File;
+  FILE*    pFile;
+  unsigned NumErrors;
+  unsigned NumMB;
+
+  NumMB = (argc > 1) ? (unsigned)atoi(argv[1]) : 256u;
+  memset(&File, 0, sizeof(File));
+  if (argc > 2) {
+    pFile = fopen(argv[2], "rb");
+    if (pFile == NULL) {
+      printf("Cannot open %s\n", argv[2]);
+      return EXIT_FAILURE;
+    }
+    do {
+      SEGGER_SYSVIEW_POSIX_ReserveStream(&File, 1u << 16);
+      File.Size += fread(File.pData + File.Size, 1, 1u << 16, pFile);
+    } while (!feof(pFile) && !ferror(pFile));
+    fclose(pFile);
+  }
+  _Time = START_TIME;
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_RegisterModule(&_aModule[0]);
+  SEGGER_SYSVIEW_RegisterModule(&_aModule[1]);
+  _Record(0);
+  _Time += 1000000;
+  _Record(NUM_LOOPS);
+  NumErrors = _Test();
+  if (NumErrors == 0 && NumMB) {
+    _Bench(File.Size ? &File : &_Trace, (size_t)NumMB << 20);
+  }
+  printf("%s\n", NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Trace);
+  SEGGER_SYSVIEW_POSIX_FreeStream(&File);
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*
+ * Test of the per event class drop statistics on the POSIX host build.
+ *
+ * A workload of context switches, interrupts, timers, API calls and
+ * bursts of prints is recorded against a simulated clock, while the
+ * up-buffer is drained by a simulated transport of limited bandwidth,
+ * so packets are dropped. The stream is decoded and, for every class,
+ * the events recorded plus the events counted as dropped in the last
+ * SYSVIEW_EVTID_EX_DROP_STATS packet must equal the events offered,
+ * and the counts must equal SEGGER_SYSVIEW_GetDropCounts().
+ * With SEGGER_SYSVIEW_USE_LOAD_SHEDDING, no event of the classes which
+ * are not shed, i.e. scheduler, interrupt and system events, may be lost.
+ * The report of the offered and dropped bandwidth per class is printed.
+ *
+ * Usage: sysview_drops [bytes per step]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Drops.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_STEPS           200000
+#define BYTES_PER_STEP      10            // Bandwidth of the transport, about 3/4 of the bandwidth offered
+#define NUM_PRINTS          10            // Prints per burst
+#define API_EVENT_ID        (32u + 8u)
+#define TIMESTAMP_FREQ      1000000000u
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U64    _Time;
+static STREAM _Stream;
+static U32    _Rand = 1;
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+static U32    _aNumOffered[SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+#endif
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U32 _cbGetTimestamp(void) {
+  return (U32)_Time;
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+static void _Drain(unsigned MaxNumBytes) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, MaxNumBytes);
+}
+
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_DROPS_OnEvent((SYSVIEW_DROPS*)pContext, pEvent);
+}
+
+/*********************************************************************
+*
+*       _Record()
+*
+*  Function description
+*    Records one step of the workload and counts the events offered.
+*/
+static void _Record(U32 Step) {
+  unsigned i;
+
+  i = _GetRand(64);
+  if (i == 0) {
+    for (i = 0; i < NUM_PRINTS; i++) {
+      SEGGER_SYSVIEW_Print("Debug output of a chatty driver");
+      _Time += 200;
+    }
+    _aNumOffered[SEGGER_SYSVIEW_DROP_CLASS_PRINT] += NUM_PRINTS;
+  } else if (i < 12) {
+    SEGGER_SYSVIEW_RecordEnterISR();
+    _Time += 300;
+    SEGGER_SYSVIEW_RecordExitISR();
+    _aNumOffered[SEGGER_SYSVIEW_DROP_CLASS_ISR] += 2;
+  } else if (i < 16) {
+    SEGGER_SYSVIEW_RecordEnterTimer(0x100u + _GetRand(4));
+    _Time += 300;
+    SEGGER_SYSVIEW_RecordExitTimer();
+    _aNumOffered[SEGGER_SYSVIEW_DROP_CLASS_TIMER] += 2;
+  } else if (i < 32) {
+    SEGGER_SYSVIEW_RecordU32(API_EVENT_ID, Step);
+    _Time += 500;
+    SEGGER_SYSVIEW_RecordEndCall(API_EVENT_ID);
+    _aNumOffered[SEGGER_SYSVIEW_DROP_CLASS_API] += 2;
+  } else {
+    SEGGER_SYSVIEW_OnTaskStopExec();
+    SEGGER_SYSVIEW_OnTaskStartExec(0x1000u + 0x100u * _GetRand(8));
+    _aNumOffered[SEGGER_SYSVIEW_DROP_CLASS_SCHED] += 2;
+  }
+  _Time += 1000 + _GetRand(1000);
+}
+
+/*********************************************************************
+*
+*       _PrintReport()
+*
+*  Function description
+*    Prints the bandwidth offered and dropped per class, the class
+*    offering the most first, and marks the classes which have to be
+*    filtered to fit into the bandwidth of the transport.
+*/
+static void _PrintReport(const SYSVIEW_DROPS* pDrops) {
+  SYSVIEW_DROPS_CLASS_INFO aInfo[SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+  unsigned                 aOrder[SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+  double                   Budget;
+  unsigned                 Class;
+  unsigned                 i;
+  unsigned                 j;
+
+  Budget = SYSVIEW_DROPS_GetReport(pDrops, TIMESTAMP_FREQ, 0, aInfo);
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_DROP_CLASSES; i++) {
+    for (j = i; j > 0 && aInfo[aOrder[j - 1]].OfferedBytesPerSec < aInfo[i].OfferedBytesPerSec; j--) {
+      aOrder[j] = aOrder[j - 1];
+    }
+    aOrder[j] = i;
+  }
+  printf("%-10s %10s %10s %8s %12s %7s\n", "Class", "Recorded", "Dropped", "Dropped", "Offered", "Share");
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_DROP_CLASSES; i++) {
+    Class = aOrder[i];
+    if (aInfo[Class].NumRecorded + aInfo[Class].NumDropped == 0) {
+      continue;
+    }
+    printf("%-10s %10llu %10u %7.1f%% %7.1f KB/s %6.1f%%%s\n", SYSVIEW_DROPS_GetClassName(Class),
+           (unsigned long long)aInfo[Class].NumRecorded, aInfo[Class].NumDropped, 100.0 * aInfo[Class].DropRatio,
+           aInfo[Class].OfferedBytesPerSec / 1000.0, 100.0 * aInfo[Class].OfferedShare,
+           aInfo[Class].ExceedsBudget ? "  exceeds budget" : "");
+  }
+  printf("Transport %.1f KB/s, %u overflow packets\n", Budget / 1000.0, pDrops->NumOverflows);
+}
+
+#endif
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char** argv) {
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  SYSVIEW_DROPS Drops;
+  U32           aDropCount[SEGGER_SYSVIEW_NUM_DROP_CLASSES];
+  unsigned      BytesPerStep;
+  unsigned      NumErrors;
+  unsigned      Class;
+  U32           i;
+
+  BytesPerStep = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : BYTES_PER_STEP;
+  _Time        = 0x10000000u;
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  for (i = 0; i < NUM_STEPS; i++) {
+    _Record(i);
+    _Drain(BytesPerStep);
+  }
+  //
+  // Drain all, then record one more event, which is preceded by the
+  // overflow and drop statistics packets with the final counts.
+  //
+  _Drain(~0u >> 1);
+  SEGGER_SYSVIEW_RecordU32(API_EVENT_ID, i);
+  _aNumOffered[SEGGER_SYSVIEW_DROP_CLASS_API]++;
+  _Drain(~0u >> 1);
+  SEGGER_SYSVIEW_GetDropCounts(aDropCount);
+  //
+  // Decode and check.
+  //
+  SYSVIEW_DROPS_Init(&Drops);
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Drops);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  NumErrors = 0;
+  if (Decode.NumResyncs != 0 || Drops.NumDropStats == 0) {
+    printf("%u resyncs, %u drop statistics packets\n", Decode.NumResyncs, Drops.NumDropStats);
+    NumErrors++;
+  }
+  for (Class = 0; Class < SEGGER_SYSVIEW_NUM_DROP_CLASSES; Class++) {
+    if (Drops.aNumDropped[Class] != aDropCount[Class]) {
+      printf("%s: %u dropped in stream, %u on target\n", SYSVIEW_DROPS_GetClassName(Class), Drops.aNumDropped[Class], aDropCount[Class]);
+      NumErrors++;
+    }
+    if (_aNumOffered[Class] && Drops.aNumRecorded[Class] + Drops.aNumDropped[Class] != _aNumOffered[Class]) {
+      printf("%s: %llu recorded + %u dropped, %u offered\n", SYSVIEW_DROPS_GetClassName(Class),
+             (unsigned long long)Drops.aNumRecorded[Class], Drops.aNumDropped[Class], _aNumOffered[Class]);
+      NumErrors++;
+    }
+#if (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+    if ((((SEGGER_SYSVIEW_SHED_CLASSES_LOW) | (SEGGER_SYSVIEW_SHED_CLASSES_NORMAL)) & (1u << Class)) == 0 && Drops.aNumDropped[Class] != 0) {
+      printf("%s: %u dropped, but not shed\n", SYSVIEW_DROPS_GetClassName(Class), Drops.aNumDropped[Class]);
+      NumErrors++;
+    }
+#endif
+  }
+  printf("Config: USE_STATIC_BUFFER=%d USE_RESERVE_COMMIT=%d USE_IN_PLACE_ENCODING=%d USE_DELTA_OF_DELTA=%d USE_LOAD_SHEDDING=%d, %u bytes per step\n",
+         SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_USE_RESERVE_COMMIT, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING,
+         SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, SEGGER_SYSVIEW_USE_LOAD_SHEDDING, BytesPerStep);
+  _PrintReport(&Drops);
+  printf("%s\n\n", NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+#else
+  (void)argc;
+  (void)argv;
+  (void)_GetRand;
+  (void)_Drain;
+  (void)_cbGetTimestamp;
+  printf("SEGGER_SYSVIEW_USE_DROP_STATS is 0\n");
+  return EXIT_SUCCESS;
+#endif
+}
@@ -0,0 +1,80 @@
+/*
+ * Converts a SystemView stream recorded with SEGGER_SYSVIEW_USE_DELTA_OF_DELTA
+ * into a standard SystemView stream.
+ *
+ * Usage: sysview_expand <out> <in>
+ *
+ * The input is the raw stream of one RTT up-channel. With
+ * SEGGER_SYSVIEW_NUM_SHARDS > 1, every shard is expanded on its own
+ * and the results are merged with sysview_merge.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SYSVIEW_Expand.h"
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U8* _ReadFile(const char* sFile, unsigned* pNumBytes) {
+  FILE* pFile;
+  U8*   pData;
+  long  Size;
+
+  pFile = fopen(sFile, "rb");
+  if (pFile == NULL) {
+    perror(sFile);
+    return NULL;
+  }
+  fseek(pFile, 0, SEEK_END);
+  Size = ftell(pFile);
+  fseek(pFile, 0, SEEK_SET);
+  pData = malloc(Size ? (size_t)Size : 1u);
+  if (pData && fread(pData, 1, (size_t)Size, pFile) != (size_t)Size) {
+    perror(sFile);
+    free(pData);
+    pData = NULL;
+  }
+  fclose(pFile);
+  *pNumBytes = (unsigned)Size;
+  return pData;
+}
+
+static void _cbWrite(void* pContext, const U8* pData, unsigned NumBytes) {
+  fwrite(pData, 1, NumBytes, (FILE*)pContext);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char** argv) {
+  FILE*    pFile;
+  U8*      pData;
+  unsigned NumBytes;
+  U32      NumPackets;
+  int      r;
+
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <out> <in>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  pData = _ReadFile(argv[2], &NumBytes);
+  if (pData == NULL) {
+    return EXIT_FAILURE;
+  }
+  pFile = fopen(argv[1], "wb");
+  if (pFile == NULL) {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  r = SYSVIEW_EXPAND_Run(pData, NumBytes, _cbWrite, pFile, &NumPackets);
+  fclose(pFile);
+  free(pData);
+  printf("Expanded %u packets.\n", NumPackets);
+  if (r < 0) {
+    fprintf(stderr, "Corrupt input, expanded stream is incomplete.\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/*
+ * Test of the event filter on the POSIX host build.
+ *
+ * Events are disabled by SEGGER_SYSVIEW_DisableEventRange() and by the
+ * command SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER, which is written to
+ * the down buffer as the host would send it. The stream is decoded and
+ * must contain exactly the enabled events. With
+ * SEGGER_SYSVIEW_USE_EVENT_FILTER, the parameters of disabled events
+ * recorded with SEGGER_SYSVIEW_RECORD() must not be evaluated, and the
+ * time per disabled event is measured for the check at the call site
+ * and for the check in _SendPacket().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_Int.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_CALLS           10000000
+#define EVENT_ID            64u
+#define MODULE_EVENT_ID     520u        // Event 8 of a module registered at offset 512
+#define MAX_EVENTS          32
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  unsigned NumEvents;
+  unsigned NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static STREAM   _Stream;
+static U32      _aExpected[MAX_EVENTS];
+static unsigned _NumExpected;
+static unsigned _NumEvaluated;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _Drain(void) {
+  return SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static void _Expect(U32 Id) {
+  _aExpected[_NumExpected++] = Id;
+}
+
+static U32 _Eval(U32 v) {
+  _NumEvaluated++;
+  return v;
+}
+
+/*********************************************************************
+*
+*       _SendFilterCommand()
+*
+*  Function description
+*    Sends SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER through the down
+*    buffer, as the host does, and lets the recorder process it.
+*/
+static void _SendFilterCommand(unsigned WordIndex, U32 DisableMask) {
+  U8 aCmd[6];
+
+  aCmd[0] = SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER;
+  aCmd[1] = (U8)WordIndex;
+  aCmd[2] = (U8)DisableMask;
+  aCmd[3] = (U8)(DisableMask >> 8);
+  aCmd[4] = (U8)(DisableMask >> 16);
+  aCmd[5] = (U8)(DisableMask >> 24);
+  SEGGER_RTT_WriteDownBuffer(SEGGER_SYSVIEW_GetChannelID(), aCmd, sizeof(aCmd));
+  SEGGER_SYSVIEW_IsStarted();
+}
+
+/*********************************************************************
+*
+*       _RecordEvents()
+*
+*  Function description
+*    Records the test events and stores the ones which are expected
+*    in the stream.
+*/
+static void _RecordEvents(void) {
+  U32 i;
+
+  //
+  // Core events are disabled by word 0 of the filter, with and without
+  // SEGGER_SYSVIEW_USE_EVENT_FILTER.
+  //
+  _SendFilterCommand(0, 1u << SYSVIEW_EVTID_PRINT_FORMATTED);
+  SEGGER_SYSVIEW_Print("Disabled");
+  _SendFilterCommand(0, 0);
+  SEGGER_SYSVIEW_Print("Enabled");
+  _Expect(SYSVIEW_EVTID_PRINT_FORMATTED);
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  //
+  // API events, by range. Parameters of disabled events are not evaluated.
+  //
+  SEGGER_SYSVIEW_DisableEventRange(EVENT_ID + 2, 3);
+  for (i = 0; i < 8; i++) {
+    SEGGER_SYSVIEW_RECORD(EVENT_ID + i, _Eval(i));
+    if (i < 2 || i > 4) {
+      _Expect(EVENT_ID + i);
+    }
+  }
+  if (_NumEvaluated != 5) {
+    printf("Parameters evaluated %u times, expected 5\n", _NumEvaluated);
+    _NumErrors++;
+  }
+  SEGGER_SYSVIEW_EnableEventRange(EVENT_ID + 3, 1);
+  SEGGER_SYSVIEW_RECORD(EVENT_ID + 3, 3u);
+  _Expect(EVENT_ID + 3);
+  //
+  // Module events, by the down-channel command. Events recorded without
+  // SEGGER_SYSVIEW_RECORD() are checked in _SendPacket().
+  //
+  _SendFilterCommand(MODULE_EVENT_ID / 32, 1u << (MODULE_EVENT_ID % 32));
+  SEGGER_SYSVIEW_RECORD(MODULE_EVENT_ID, 1u, 2u);
+  SEGGER_SYSVIEW_RecordU32x2(MODULE_EVENT_ID, 1u, 2u);
+  SEGGER_SYSVIEW_RecordU32x2(MODULE_EVENT_ID + 1, 1u, 2u);
+  _Expect(MODULE_EVENT_ID + 1);
+  //
+  // Events beyond the filter are always recorded.
+  //
+  SEGGER_SYSVIEW_DisableEventRange(SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS - 4, 100);
+  SEGGER_SYSVIEW_RECORD(SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS - 1);
+  SEGGER_SYSVIEW_RECORD(SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS);
+  _Expect(SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS);
+#else
+  (void)i;
+  (void)_Eval;
+#endif
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK* pCheck;
+
+  pCheck = (CHECK*)pContext;
+  if (pEvent->Id < 32 && pEvent->Id != SYSVIEW_EVTID_PRINT_FORMATTED) {
+    return;
+  }
+  if (pCheck->NumEvents < _NumExpected && pEvent->Id != _aExpected[pCheck->NumEvents]) {
+    printf("Event %u: ID %u, expected ID %u\n", pCheck->NumEvents, pEvent->Id, _aExpected[pCheck->NumEvents]);
+    pCheck->NumErrors++;
+  }
+  pCheck->NumEvents++;
+}
+
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+static void _RecordDisabled      (U32 i) { SEGGER_SYSVIEW_RECORD(EVENT_ID + 2, i, 0x20000400u, 100u, 0u); }
+static void _RecordU32x4Disabled(U32 i) { SEGGER_SYSVIEW_RecordU32x4(EVENT_ID + 2, i, 0x20000400u, 100u, 0u); }
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Records NUM_CALLS disabled events and prints the time per event.
+*/
+static void _Measure(const char* sName, void (*pfRecord)(U32 i)) {
+  U64 t;
+  U32 i;
+
+  _Drain();
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_CALLS; i++) {
+    pfRecord(i);
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("%-32s %6.2f ns/event %u bytes\n", sName, (double)t / NUM_CALLS, _Drain());
+}
+#endif
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  CHECK                         Check;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  _RecordEvents();
+  _Drain();
+  memset(&Check, 0, sizeof(Check));
+  Check.NumErrors = _NumErrors;
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  if (Check.NumEvents != _NumExpected) {
+    printf("%u events, expected %u\n", Check.NumEvents, _NumExpected);
+    Check.NumErrors++;
+  }
+  printf("Config: USE_EVENT_FILTER=%d USE_STATIC_BUFFER=%d USE_IN_PLACE_ENCODING=%d, %u events checked\n",
+         SEGGER_SYSVIEW_USE_EVENT_FILTER, SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING, _NumExpected);
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  _Measure("RECORD, disabled", _RecordDisabled);
+  _Measure("RecordU32x4, disabled", _RecordU32x4Disabled);
+#endif
+  printf("%s\n\n", Check.NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return Check.NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/*
+ * Native POSIX host example for the SystemView recorder core.
+ *
+ * Two worker threads stand in for FreeRTOS tasks and record the same kind
+ * of events as task1_handler/task2_handler of the board examples, including
+ * a simulated interrupt. The main thread drains the SystemView RTT up-channel
+ * and writes the raw SystemView stream to a file.
+ * With SEGGER_SYSVIEW_NUM_SHARDS > 1 the simulated interrupts record to
+ * shard 1, which is written to <file>.1 and can be merged with sysview_merge.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_TASKS       2
+#define NUM_LOOPS       1000
+#define SYSTICK_ISR_ID  15
+
+typedef struct {
+  U32         TaskId;
+  const char* sName;
+  U32         Prio;
+} TASK_DESC;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static TASK_DESC _aTasks[NUM_TASKS] = {
+  { 0x1000, "Task1", 2 },
+  { 0x2000, "Task2", 3 },
+};
+static volatile int _NumRunning;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void _SendTaskInfo(const TASK_DESC* pTask) {
+  SEGGER_SYSVIEW_TASKINFO Info;
+
+  Info.TaskID     = pTask->TaskId;
+  Info.sName      = pTask->sName;
+  Info.Prio       = pTask->Prio;
+  Info.StackBase  = 0;
+  Info.StackSize  = 0;
+  SEGGER_SYSVIEW_SendTaskInfo(&Info);
+}
+
+static void* _TaskHandler(void* p) {
+  const TASK_DESC* pTask;
+  int              i;
+
+  pTask = (const TASK_DESC*)p;
+  for (i = 0; i < NUM_LOOPS; i++) {
+    SEGGER_SYSVIEW_OnTaskStartExec(pTask->TaskId);
+    SEGGER_SYSVIEW_PrintfTarget("%s loop %d", pTask->sName, i);
+    SEGGER_SYSVIEW_RecordU32x2(32 + 34, pTask->TaskId, (U32)i);   // apiID_OFFSET + apiID_VTASKDELAY style API event
+    SEGGER_SYSVIEW_RecordEndCall(32 + 34);
+    if ((i % 10) == 0) {
+      SEGGER_SYSVIEW_POSIX_SetInterruptId(SYSTICK_ISR_ID);
+      SEGGER_SYSVIEW_POSIX_SetShard(SEGGER_SYSVIEW_NUM_SHARDS - 1);
+      SEGGER_SYSVIEW_RecordEnterISR();
+      SEGGER_SYSVIEW_RecordExitISR();
+      SEGGER_SYSVIEW_POSIX_SetShard(0);
+      SEGGER_SYSVIEW_POSIX_SetInterruptId(0);
+    }
+    SEGGER_SYSVIEW_OnTaskStopExec();
+  }
+  __atomic_fetch_sub(&_NumRunning, 1, __ATOMIC_SEQ_CST);
+  return NULL;
+}
+
+/*
+ * Writes the up-channels to the files span by span, straight from the RTT buffers.
+ * The lock is only held to peek and consume, not while writing, as the recorder
+ * skips packets instead of overwriting unread data (not in post-mortem mode).
+ */
+static unsigned _Drain(FILE** papFile) {
+  const void* pData;
+  unsigned    NumBytes;
+  unsigned    Total;
+  unsigned    n;
+
+  Total = 0;
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+    do {
+      SEGGER_RTT_LOCK();
+      NumBytes = SEGGER_RTT_PeekUpBufferNoLock(SEGGER_SYSVIEW_GetShardChannelID(n), &pData);
+      SEGGER_RTT_UNLOCK();
+      if (NumBytes && papFile[n]) {
+        fwrite(pData, 1, NumBytes, papFile[n]);
+      }
+      SEGGER_RTT_LOCK();
+      SEGGER_RTT_ConsumeUpBufferNoLock(SEGGER_SYSVIEW_GetShardChannelID(n), NumBytes);
+      SEGGER_RTT_UNLOCK();
+      Total += NumBytes;
+    } while (NumBytes);
+  }
+  return Total;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char** argv) {
+  pthread_t aThread[NUM_TASKS];
+  FILE*     apFile[SEGGER_SYSVIEW_NUM_SHARDS];
+  char      acName[256];
+  unsigned  Total;
+  int       i;
+
+  memset(apFile, 0, sizeof(apFile));
+  if (argc > 1) {
+    for (i = 0; i < SEGGER_SYSVIEW_NUM_SHARDS; i++) {
+      if (i == 0) {
+        snprintf(acName, sizeof(acName), "%s", argv[1]);
+      } else {
+        snprintf(acName, sizeof(acName), "%s.%d", argv[1], i);
+      }
+      apFile[i] = fopen(acName, "wb");
+      if (apFile[i] == NULL) {
+        perror(acName);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  for (i = 0; i < NUM_TASKS; i++) {
+    SEGGER_SYSVIEW_OnTaskCreate(_aTasks[i].TaskId);
+    _SendTaskInfo(&_aTasks[i]);
+  }
+  Total       = _Drain(apFile);
+  _NumRunning = NUM_TASKS;
+  for (i = 0; i < NUM_TASKS; i++) {
+    pthread_create(&aThread[i], NULL, _TaskHandler, &_aTasks[i]);
+  }
+  while (__atomic_load_n(&_NumRunning, __ATOMIC_SEQ_CST) != 0) {
+    Total += _Drain(apFile);
+  }
+  for (i = 0; i < NUM_TASKS; i++) {
+    pthread_join(aThread[i], NULL);
+  }
+  SEGGER_SYSVIEW_Stop();
+  Total += _Drain(apFile);
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_SHARDS; i++) {
+    if (apFile[i]) {
+      fclose(apFile[i]);
+    }
+  }
+  printf("Recorded %u bytes of SystemView data.\n", Total);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,469 @@
+/*
+ * Test, benchmark and converter of the indexed trace file (Tools/SYSVIEW_Index.c)
+ * on the POSIX host build.
+ *
+ * Without a trace file, a scheduler-like workload of 8 tasks and 2
+ * interrupts is recorded against a simulated cycle counter. The capture
+ * starts in the middle of a packet, as a post-mortem capture does. The
+ * test checks that
+ *   - every event of the index equals the event of the streaming decoder,
+ *   - every task and interrupt lists exactly the events entering it,
+ *   - seeking random times, globally and per context, finds the first
+ *     event at or after the time.
+ * The benchmark then indexes the trace repeated up to the given size
+ * (default 64 MB) into a memory-mapped file, and reports the build
+ * throughput, the time to open the file and the time of a seek.
+ *
+ * Usage: sysview_index [MB]
+ *        sysview_index <trace file> <index file> [dod]
+ * The second form converts a raw trace, recorded with
+ * SEGGER_SYSVIEW_USE_DELTA_OF_DELTA if "dod" is given.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Index.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_LOOPS           50000
+#define NUM_TASKS           8
+#define TASK_ID             0x20001000u
+#define ISR_ID              15u
+#define API_EVENT_ID        (32u + 34u)   // apiID_OFFSET + apiID_VTASKDELAY
+#define START_TIME          0xFFF00000u   // Wraps around after about 1 ms
+#define NUM_SEEKS           100000
+#define NUM_BENCH_SEEKS     1000000
+#define DECODE_FLAGS        (SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0u)
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U64  NumEvents;
+  U64* paTime;
+  U32* paId;
+  U64* paHash;                            // Over sub ID, module, parameters and payload
+} REF;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U64                    _Time;
+static STREAM                 _Trace;
+static U32                    _Rand = 1;
+static SYSVIEW_DECODE_CONTEXT _Decode;
+static SYSVIEW_INDEX_BUILD    _Build;     // Too large for the stack
+static REF                    _Ref;
+
+static SEGGER_SYSVIEW_MODULE _Module = { "M=Test", 4, 0, NULL, NULL };
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U32 _cbGetTimestamp(void) {
+  return (U32)_Time;
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+static U64 _GetRand64(U64 Range) {
+  return ((((U64)_GetRand(0x10000) << 32) | ((U64)_GetRand(0x10000) << 16) | _GetRand(0x10000))) % Range;
+}
+
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Trace, ~0u);
+}
+
+static void _Advance(unsigned MaxTicks) {
+  _Time += 1 + _GetRand(MaxTicks);
+}
+
+static double _GetTime(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*********************************************************************
+*
+*       _Record()
+*
+*  Function description
+*    Records the workload. The stream starts with the tail of a packet,
+*    as a capture of the post-mortem buffer.
+*/
+static void _Record(void) {
+  static const U8 _abTail[] = { 0x84, 0x20, 0x31, 0x05, 0xB2, 0x07 };
+  U32 i;
+  U32 Task;
+
+  SEGGER_SYSVIEW_POSIX_ReserveStream(&_Trace, sizeof(_abTail));
+  memcpy(_Trace.pData, _abTail, sizeof(_abTail));
+  _Trace.Size = sizeof(_abTail);
+  SEGGER_SYSVIEW_Start();
+  SEGGER_SYSVIEW_SendModule(0);
+  _Drain();
+  for (i = 0; i < NUM_LOOPS; i++) {
+    SEGGER_SYSVIEW_POSIX_SetInterruptId(ISR_ID + (i & 1));
+    SEGGER_SYSVIEW_RecordEnterISR();
+    _Advance(200);
+    SEGGER_SYSVIEW_RecordExitISRToScheduler();
+    SEGGER_SYSVIEW_POSIX_SetInterruptId(0);
+    _Advance(100);
+    Task = _GetRand(NUM_TASKS);
+    SEGGER_SYSVIEW_OnTaskStartExec(TASK_ID + Task * 0x100);
+    _Advance(1000);
+    SEGGER_SYSVIEW_RecordU32x2(API_EVENT_ID, i, Task);
+    _Advance(1000);
+    SEGGER_SYSVIEW_RecordU32(_Module.EventOffset + (i & 3), i);
+    if ((i & 63) == 0) {
+      SEGGER_SYSVIEW_PrintfTarget("Loop %u", i);
+    }
+    _Advance(5000);
+    SEGGER_SYSVIEW_OnTaskStopExec();
+    SEGGER_SYSVIEW_OnIdle();
+    _Advance(20000);
+    _Drain();
+  }
+  SEGGER_SYSVIEW_Stop();
+  _Drain();
+}
+
+static U64 _HashEvent(const SYSVIEW_DECODE_EVENT* pEvent) {
+  U64      Hash;
+  unsigned i;
+
+  Hash = 0xCBF29CE484222325ull ^ (pEvent->SubId + ((U64)(pEvent->ModuleIndex + 1) << 32));
+  for (i = 0; i < pEvent->NumParams; i++) {
+    Hash = (Hash ^ pEvent->aParam[i]) * 0x100000001B3ull;
+  }
+  for (i = 0; i < pEvent->PayloadSize; i++) {
+    Hash = (Hash ^ pEvent->pPayload[i]) * 0x100000001B3ull;
+  }
+  return Hash;
+}
+
+static void _cbRef(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  REF* pRef;
+
+  pRef = (REF*)pContext;
+  if ((pRef->NumEvents & (pRef->NumEvents - 1)) == 0) {
+    pRef->paTime = realloc(pRef->paTime, (pRef->NumEvents ? pRef->NumEvents * 2 : 1) * sizeof(U64));
+    pRef->paId   = realloc(pRef->paId,   (pRef->NumEvents ? pRef->NumEvents * 2 : 1) * sizeof(U32));
+    pRef->paHash = realloc(pRef->paHash, (pRef->NumEvents ? pRef->NumEvents * 2 : 1) * sizeof(U64));
+  }
+  pRef->paTime[pRef->NumEvents] = pEvent->Time;
+  pRef->paId[pRef->NumEvents]   = pEvent->Id;
+  pRef->paHash[pRef->NumEvents] = _HashEvent(pEvent);
+  pRef->NumEvents++;
+}
+
+/*********************************************************************
+*
+*       _BuildIndex()
+*
+*  Function description
+*    Builds the index of a stream into a memory-mapped file.
+*
+*  Return value
+*    Size of the file, 0 on error.
+*/
+static U64 _BuildIndex(const U8* pData, U64 NumBytes, unsigned DecodeFlags, const char* sFile) {
+  void* pIndex;
+  U64   FileSize;
+  int   hFile;
+
+  FileSize = SYSVIEW_INDEX_Scan(&_Build, pData, NumBytes, DecodeFlags);
+  hFile    = open(sFile, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (hFile < 0) {
+    printf("Cannot create %s\n", sFile);
+    return 0;
+  }
+  pIndex = MAP_FAILED;
+  if (ftruncate(hFile, (off_t)FileSize) == 0) {
+    pIndex = mmap(NULL, (size_t)FileSize, PROT_READ | PROT_WRITE, MAP_SHARED, hFile, 0);
+  }
+  close(hFile);
+  if (pIndex == MAP_FAILED) {
+    printf("Cannot map %s\n", sFile);
+    return 0;
+  }
+  SYSVIEW_INDEX_Write(&_Build, pData, NumBytes, pIndex);
+  munmap(pIndex, (size_t)FileSize);
+  return FileSize;
+}
+
+/*********************************************************************
+*
+*       _OpenIndex()
+*
+*  Function description
+*    Maps an index file and opens it.
+*
+*  Return value
+*    Mapped data, NULL on error.
+*/
+static void* _OpenIndex(const char* sFile, SYSVIEW_INDEX* pIndex, U64* pFileSize) {
+  struct stat Stat;
+  void*       pData;
+  int         hFile;
+
+  hFile = open(sFile, O_RDONLY);
+  if (hFile < 0) {
+    return NULL;
+  }
+  pData = MAP_FAILED;
+  if (fstat(hFile, &Stat) == 0 && Stat.st_size > 0) {
+    pData = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_SHARED, hFile, 0);
+  }
+  close(hFile);
+  if (pData == MAP_FAILED) {
+    return NULL;
+  }
+  *pFileSize = (U64)Stat.st_size;
+  if (SYSVIEW_INDEX_Open(pIndex, pData, *pFileSize) < 0) {
+    munmap(pData, (size_t)Stat.st_size);
+    return NULL;
+  }
+  return pData;
+}
+
+/*********************************************************************
+*
+*       _Check()
+*
+*  Function description
+*    Checks an opened index against the reference decode of the stream.
+*/
+static unsigned _Check(const SYSVIEW_INDEX* pIndex) {
+  const SYSVIEW_INDEX_CONTEXT* pContext;
+  SYSVIEW_DECODE_EVENT         Event;
+  U64                          aNumEntries[SYSVIEW_INDEX_MAX_CONTEXTS];
+  U64                          i;
+  U64                          n;
+  U64                          Time;
+  U64                          NumEntries;
+  unsigned                     Kind;
+  unsigned                     NumErrors;
+  unsigned                     k;
+
+  NumErrors = 0;
+  if (pIndex->NumEvents != _Ref.NumEvents || pIndex->NumContexts != NUM_TASKS + 2 || pIndex->pHeader->NumModules != 1) {
+    printf("%llu events, %u contexts, %u modules indexed\n", (unsigned long long)pIndex->NumEvents,
+           pIndex->NumContexts, pIndex->pHeader->NumModules);
+    return 1;
+  }
+  //
+  // Events and entries
+  //
+  memset(aNumEntries, 0, sizeof(aNumEntries));
+  for (i = 0; i < pIndex->NumEvents; i++) {
+    SYSVIEW_INDEX_GetEvent(pIndex, i, &Event);
+    if (Event.Time != _Ref.paTime[i] || Event.Id != _Ref.paId[i] || _HashEvent(&Event) != _Ref.paHash[i]
+     || (i > 0 && Event.Time < _Ref.paTime[i - 1])) {
+      if (NumErrors++ < 10) {
+        printf("Event %llu: ID %u, time %llu differs from decoder\n", (unsigned long long)i, Event.Id, (unsigned long long)Event.Time);
+      }
+      continue;
+    }
+    if (Event.Id == SYSVIEW_EVTID_TASK_START_EXEC || Event.Id == SYSVIEW_EVTID_ISR_ENTER) {
+      Kind     = (Event.Id == SYSVIEW_EVTID_ISR_ENTER) ? SYSVIEW_INDEX_KIND_ISR : SYSVIEW_INDEX_KIND_TASK;
+      pContext = SYSVIEW_INDEX_FindContext(pIndex, Kind, Event.aParam[0]);
+      if (pContext == NULL) {
+        NumErrors++;
+        continue;
+      }
+      k = (unsigned)(pContext - pIndex->paContext);
+      n = aNumEntries[k]++;
+      if (n >= pContext->NumEntries || pIndex->paEntry[pContext->FirstEntry + n] != i) {
+        if (NumErrors++ < 10) {
+          printf("Event %llu: not entry %llu of context %u\n", (unsigned long long)i, (unsigned long long)n, Event.aParam[0]);
+        }
+      }
+    }
+  }
+  for (k = 0; k < pIndex->NumContexts; k++) {
+    if (aNumEntries[k] != pIndex->paContext[k].NumEntries) {
+      printf("Context %u: %llu entries, %llu expected\n", pIndex->paContext[k].Id,
+             (unsigned long long)pIndex->paContext[k].NumEntries, (unsigned long long)aNumEntries[k]);
+      NumErrors++;
+    }
+  }
+  //
+  // Seeks
+  //
+  for (n = 0; n < NUM_SEEKS; n++) {
+    Time = _GetRand64(pIndex->paTime[pIndex->NumEvents - 1] + 2);
+    i    = SYSVIEW_INDEX_FindTime(pIndex, Time);
+    if ((i < pIndex->NumEvents && pIndex->paTime[i] < Time) || (i > 0 && pIndex->paTime[i - 1] >= Time)) {
+      if (NumErrors++ < 10) {
+        printf("Seek to %llu: event %llu\n", (unsigned long long)Time, (unsigned long long)i);
+      }
+    }
+    pContext   = &pIndex->paContext[_GetRand(pIndex->NumContexts)];
+    i          = SYSVIEW_INDEX_FindEntry(pIndex, pContext, Time);
+    NumEntries = pContext->NumEntries;
+    if ((i < NumEntries && pIndex->paTime[pIndex->paEntry[pContext->FirstEntry + i]] < Time)
+     || (i > 0 && pIndex->paTime[pIndex->paEntry[pContext->FirstEntry + i - 1]] >= Time)) {
+      if (NumErrors++ < 10) {
+        printf("Seek of context %u to %llu: entry %llu\n", pContext->Id, (unsigned long long)Time, (unsigned long long)i);
+      }
+    }
+  }
+  if (SYSVIEW_INDEX_FindContext(pIndex, SYSVIEW_INDEX_KIND_ISR, ISR_ID + 2) != NULL) {
+    NumErrors++;
+  }
+  return NumErrors;
+}
+
+static unsigned _Test(const char* sFile) {
+  SYSVIEW_INDEX Index;
+  void*         pData;
+  U64           FileSize;
+  unsigned      NumErrors;
+
+  SYSVIEW_DECODE_Init(&_Decode, DECODE_FLAGS, _cbRef, &_Ref);
+  SYSVIEW_DECODE_Feed(&_Decode, _Trace.pData, (unsigned)_Trace.Size);
+  if (_BuildIndex(_Trace.pData, _Trace.Size, DECODE_FLAGS, sFile) == 0) {
+    return 1;
+  }
+  pData = _OpenIndex(sFile, &Index, &FileSize);
+  if (pData == NULL) {
+    printf("Cannot open index\n");
+    return 1;
+  }
+  NumErrors = _Check(&Index);
+  printf("%u bytes, %llu events, %u contexts, %.2f index bytes/event, %llu bytes skipped to the first sync\n",
+         (unsigned)_Trace.Size, (unsigned long long)Index.NumEvents, Index.NumContexts,
+         (double)FileSize / Index.NumEvents, (unsigned long long)_Decode.NumBytesSkipped);
+  munmap(pData, (size_t)FileSize);
+  free(_Ref.paTime);
+  free(_Ref.paId);
+  free(_Ref.paHash);
+  return NumErrors;
+}
+
+static unsigned _Bench(size_t NumBytesTotal, const char* sFile) {
+  SYSVIEW_INDEX Index;
+  STREAM        Stream;
+  void*         pData;
+  double        t0;
+  double        t1;
+  double        t2;
+  double        t3;
+  U64           FileSize;
+  size_t        NumBytes;
+  U64           Sum;
+  U64           MaxTime;
+  unsigned      n;
+
+  memset(&Stream, 0, sizeof(Stream));
+  while (Stream.Size + _Trace.Size <= NumBytesTotal) {
+    SEGGER_SYSVIEW_POSIX_ReserveStream(&Stream, _Trace.Size);
+    memcpy(Stream.pData + Stream.Size, _Trace.pData, _Trace.Size);
+    Stream.Size += _Trace.Size;
+  }
+  t0       = _GetTime();
+  FileSize = _BuildIndex(Stream.pData, Stream.Size, DECODE_FLAGS, sFile);
+  t1       = _GetTime();
+  NumBytes = Stream.Size;
+  SEGGER_SYSVIEW_POSIX_FreeStream(&Stream);
+  if (FileSize == 0) {
+    return 1;
+  }
+  t2    = _GetTime();
+  pData = _OpenIndex(sFile, &Index, &FileSize);
+  t3    = _GetTime();
+  if (pData == NULL) {
+    printf("Cannot open index\n");
+    return 1;
+  }
+  printf("Indexed %u MB at %.0f MB/s into %u MB, %llu events, opened in %.3f ms\n",
+         (unsigned)(NumBytes >> 20), NumBytes / (t1 - t0) / 1e6, (unsigned)(FileSize >> 20),
+         (unsigned long long)Index.NumEvents, (t3 - t2) * 1e3);
+  MaxTime = Index.paTime[Index.NumEvents - 1] + 1;
+  Sum     = 0;
+  t0      = _GetTime();
+  for (n = 0; n < NUM_BENCH_SEEKS; n++) {
+    Sum += SYSVIEW_INDEX_FindTime(&Index, _GetRand64(MaxTime));
+  }
+  t1 = _GetTime();
+  printf("Seek by time: %.0f ns (checksum %llx)\n", (t1 - t0) * 1e9 / NUM_BENCH_SEEKS, (unsigned long long)Sum);
+  munmap(pData, (size_t)FileSize);
+  return 0;
+}
+
+static int _Convert(const char* sTrace, const char* sIndex, unsigned DecodeFlags) {
+  struct stat Stat;
+  void*       pTrace;
+  U64         FileSize;
+  int         hFile;
+
+  hFile = open(sTrace, O_RDONLY);
+  if (hFile < 0) {
+    printf("Cannot read %s\n", sTrace);
+    return EXIT_FAILURE;
+  }
+  pTrace = MAP_FAILED;
+  if (fstat(hFile, &Stat) == 0 && Stat.st_size > 0) {
+    pTrace = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, hFile, 0);
+  }
+  close(hFile);
+  if (pTrace == MAP_FAILED) {
+    printf("Cannot map %s\n", sTrace);
+    return EXIT_FAILURE;
+  }
+  FileSize = _BuildIndex((const U8*)pTrace, (U64)Stat.st_size, DecodeFlags, sIndex);
+  munmap(pTrace, (size_t)Stat.st_size);
+  if (FileSize == 0) {
+    return EXIT_FAILURE;
+  }
+  printf("%s: %llu events, %u contexts, %u resyncs, %llu bytes\n", sIndex, (unsigned long long)_Build.Header.NumEvents,
+         _Build.Header.NumContexts, _Build.Header.NumResyncs, (unsigned long long)FileSize);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+  char     acFile[] = "/tmp/sysview_index_XXXXXX";
+  size_t   NumBytesTotal;
+  unsigned NumErrors;
+  int      hFile;
+
+  if (argc > 2) {
+    return _Convert(argv[1], argv[2], (argc > 3 && strcmp(argv[3], "dod") == 0) ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0u);
+  }
+  NumBytesTotal = (argc > 1) ? (size_t)strtoul(argv[1], NULL, 0) << 20 : (size_t)64 << 20;
+  hFile         = mkstemp(acFile);
+  if (hFile < 0) {
+    printf("Cannot create temporary file\n");
+    return EXIT_FAILURE;
+  }
+  close(hFile);
+  _Time = START_TIME;
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_RegisterModule(&_Module);
+  _Record();
+  NumErrors  = _Test(acFile);
+  NumErrors += _Bench(NumBytesTotal, acFile);
+  unlink(acFile);
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Trace);
+  printf("%s\n", NumErrors ? "FAILED" : "OK");
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+/*
+ * Test of the task load accounting on the POSIX host build.
+ *
+ * Task switches, idle phases and nested interrupts are recorded against
+ * a simulated 1 GHz cycle counter, first with all events and then with
+ * the scheduler and interrupt events disabled. A model accounts the time
+ * between the events as the recorder does, with the same table size, and
+ * the load reports in the stream must match the model exactly. The
+ * summed up load per task of the host-side reader must be within 1/1000
+ * of the model. The stream bytes per second with and without the
+ * scheduler and interrupt events and the time per scheduler event are
+ * reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Load.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_TASKS           12u
+#define NUM_STEPS           400000u       // Steps of each phase
+#define NUM_BENCH_EVENTS    1000000u
+#define MAX_REPORTS         1024u
+#define MAX_STEP_TIME       20000u        // Cycles between two events, up to 20 us at 1 GHz
+#define TASK_ID_BASE        0x20200000u
+#define TASK_ID_SPACING     0x460u
+#define IDLE                NUM_TASKS     // Model: Idle
+#define OTHER               (NUM_TASKS + 1u) // Model: No task
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32      Period;
+  U32      IdleLoad;
+  U32      ISRLoad;
+  unsigned NumTasks;
+  U32      aTaskId[NUM_TASKS];
+  U32      aLoad[NUM_TASKS];
+} REPORT;
+
+typedef struct {
+  SYSVIEW_LOAD Load;
+  unsigned     NumReports;
+  unsigned     NumErrors;
+} CHECK;
+
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U32      _Time = 0xFFF00000u;              // Wraps around after 1 ms
+static STREAM   _Stream;
+static U32      _Rand = 1;
+static unsigned _NumErrors;
+
+//
+// Model of the accounting of the recorder.
+//
+static struct {
+  U32      PeriodStart;
+  U32      LastTime;
+  unsigned Cur;                                   // Task index, IDLE or OTHER
+  unsigned ISRNesting;
+  U32      IdleTime;
+  U32      ISRTime;
+  unsigned NumInTable;
+  int      aInTable[NUM_TASKS];
+  U32      aTime[NUM_TASKS];
+  U64      aTotalTime[NUM_TASKS];                 // Time of each task over all reports
+  U64      TotalTime;
+  unsigned NumReports;
+  REPORT   aReport[MAX_REPORTS];
+} _Model;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U32 _cbGetTimestamp(void) {
+  return _Time;
+}
+
+static unsigned _Drain(void) {
+  return SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 8) % Range;
+}
+
+static U32 _GetTaskId(unsigned Index) {
+  return TASK_ID_BASE + Index * TASK_ID_SPACING;
+}
+
+static U32 _GetLoad(U32 Time, U32 Period) {
+  return (U32)(((U64)Time * 1000u + Period / 2u) / Period);
+}
+
+/*********************************************************************
+*
+*       _ModelReport()
+*
+*  Function description
+*    Adds the expected report of the current period and starts the
+*    next one, as _SendLoad() of the recorder.
+*/
+static void _ModelReport(void) {
+  REPORT*  pReport;
+  U32      Period;
+  unsigned i;
+
+  Period = _Time - _Model.PeriodStart;
+  if (_Model.NumReports < MAX_REPORTS) {
+    pReport           = &_Model.aReport[_Model.NumReports];
+    pReport->Period   = Period >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT;
+    pReport->IdleLoad = _GetLoad(_Model.IdleTime, Period);
+    pReport->ISRLoad  = _GetLoad(_Model.ISRTime, Period);
+    pReport->NumTasks = 0;
+    for (i = 0; i < NUM_TASKS; i++) {
+      if (_Model.aInTable[i]) {
+        pReport->aTaskId[pReport->NumTasks] = SEGGER_SYSVIEW_ShrinkTaskId(_GetTaskId(i));
+        pReport->aLoad[pReport->NumTasks]   = _GetLoad(_Model.aTime[i], Period);
+        pReport->NumTasks++;
+      }
+    }
+  }
+  for (i = 0; i < NUM_TASKS; i++) {
+    _Model.aTotalTime[i] += _Model.aTime[i];
+  }
+  _Model.NumReports++;
+  _Model.TotalTime  += Period;
+  _Model.PeriodStart = _Time;
+  _Model.IdleTime    = 0;
+  _Model.ISRTime     = 0;
+  _Model.NumInTable  = 0;
+  for (i = 0; i < NUM_TASKS; i++) {
+    _Model.aTime[i]    = 0;
+    _Model.aInTable[i] = (i == _Model.Cur) ? _Model.aInTable[i] : 0;
+    _Model.NumInTable += (unsigned)_Model.aInTable[i];
+  }
+}
+
+/*********************************************************************
+*
+*       _ModelAccount()
+*
+*  Function description
+*    Accounts the time since the previous event and switches the
+*    context of the model to Cur, as _AccountLoad() of the recorder.
+*/
+static void _ModelAccount(unsigned Cur, int ISRDelta, int Report) {
+  U32 Delta;
+
+  Delta           = _Time - _Model.LastTime;
+  _Model.LastTime = _Time;
+  if (_Model.ISRNesting) {
+    _Model.ISRTime += Delta;
+  } else if (_Model.Cur < NUM_TASKS) {
+    if (_Model.aInTable[_Model.Cur]) {
+      _Model.aTime[_Model.Cur] += Delta;
+    }
+  } else if (_Model.Cur == IDLE) {
+    _Model.IdleTime += Delta;
+  }
+  _Model.ISRNesting += (unsigned)ISRDelta;
+  _Model.Cur         = Cur;
+  if (Cur < NUM_TASKS && _Model.aInTable[Cur] == 0 && _Model.NumInTable < SEGGER_SYSVIEW_NUM_LOAD_TASKS) {
+    _Model.aInTable[Cur] = 1;
+    _Model.NumInTable++;
+  }
+#if (SEGGER_SYSVIEW_LOAD_PERIOD > 0)
+  if (_Time - _Model.PeriodStart >= SEGGER_SYSVIEW_LOAD_PERIOD) {
+    Report = 1;
+  }
+#endif
+  if (Report) {
+    _ModelReport();
+  }
+}
+
+/*********************************************************************
+*
+*       _Step()
+*
+*  Function description
+*    Advances the time and records a random scheduler or interrupt
+*    event, updating the model.
+*/
+static void _Step(void) {
+  unsigned Index;
+  unsigned r;
+
+  _Time += _GetRand(MAX_STEP_TIME);
+  r      = _GetRand(16);
+  if (_Model.ISRNesting == 0) {
+    if (r < 4) {
+      SEGGER_SYSVIEW_RecordEnterISR();
+      _ModelAccount(_Model.Cur, 1, 0);
+    } else if (r < 6) {
+      SEGGER_SYSVIEW_OnIdle();
+      _ModelAccount(IDLE, 0, 0);
+    } else if (r < 7) {
+      SEGGER_SYSVIEW_OnTaskStopExec();
+      _ModelAccount(OTHER, 0, 0);
+    } else {
+      Index = _GetRand(_GetRand(NUM_TASKS) + 1u);     // Low indexes run more often
+      SEGGER_SYSVIEW_OnTaskStartExec(_GetTaskId(Index));
+      _ModelAccount(Index, 0, 0);
+    }
+  } else if (r < 2 && _Model.ISRNesting < 3) {
+    SEGGER_SYSVIEW_RecordEnterISR();
+    _ModelAccount(_Model.Cur, 1, 0);
+  } else if (r < 12 || _Model.ISRNesting > 1) {
+    SEGGER_SYSVIEW_RecordExitISR();
+    _ModelAccount(_Model.Cur, -1, 0);
+  } else {
+    //
+    // Switch to another task on exit of the interrupt.
+    //
+    SEGGER_SYSVIEW_RecordExitISRToScheduler();
+    _ModelAccount(_Model.Cur, -1, 0);
+    _Time += _GetRand(MAX_STEP_TIME / 8);
+    Index  = _GetRand(NUM_TASKS);
+    SEGGER_SYSVIEW_OnTaskStartExec(_GetTaskId(Index));
+    _ModelAccount(Index, 0, 0);
+  }
+}
+
+/*********************************************************************
+*
+*       _RunPhase()
+*
+*  Function description
+*    Records NUM_STEPS steps and the load report at the end and prints
+*    the stream bytes per second.
+*/
+static void _RunPhase(const char* sWhat) {
+  U64      NumBytes;
+  U32      Time;
+  unsigned i;
+
+  NumBytes = _Drain();
+  Time     = _Time;
+  for (i = 0; i < NUM_STEPS; i++) {
+    _Step();
+    if ((i & 63u) == 63u) {
+      NumBytes += _Drain();
+    }
+  }
+  SEGGER_SYSVIEW_RecordLoad();
+  _ModelAccount(_Model.Cur, 0, 1);
+  NumBytes += _Drain();
+  printf("%-32s %8.0f bytes/s\n", sWhat, (double)NumBytes * 1e9 / (U32)(_Time - Time));
+}
+
+static void _Error(CHECK* pCheck, const char* sError, unsigned Info) {
+  if (pCheck->NumErrors++ < 4) {
+    printf(sError, Info);
+  }
+}
+
+/*********************************************************************
+*
+*       _CheckReport()
+*
+*  Function description
+*    Compares a decoded load report with the report of the model.
+*/
+static void _CheckReport(CHECK* pCheck, const SYSVIEW_DECODE_EVENT* pEvent) {
+  const REPORT* pReport;
+  U32           aValue[5 + 2 * NUM_TASKS];
+  unsigned      NumValues;
+  unsigned      i;
+  unsigned      j;
+
+  if (pCheck->NumReports >= MAX_REPORTS || pCheck->NumReports >= _Model.NumReports) {
+    pCheck->NumReports++;
+    return;
+  }
+  pReport   = &_Model.aReport[pCheck->NumReports];
+  NumValues = SYSVIEW_DECODE_GetU32s(pEvent, aValue, SEGGER_COUNTOF(aValue));
+  if (NumValues != 5 + 2 * pReport->NumTasks || aValue[4] != pReport->NumTasks) {
+    _Error(pCheck, "Report %u: Wrong number of tasks\n", pCheck->NumReports);
+  } else if (aValue[1] != pReport->Period || aValue[2] != pReport->IdleLoad || aValue[3] != pReport->ISRLoad) {
+    _Error(pCheck, "Report %u: Wrong period, idle or interrupt load\n", pCheck->NumReports);
+  } else {
+    for (i = 0; i < pReport->NumTasks; i++) {
+      for (j = 0; j < pReport->NumTasks; j++) {
+        if (aValue[5 + 2 * j] == pReport->aTaskId[i]) {
+          break;
+        }
+      }
+      if (j == pReport->NumTasks || aValue[6 + 2 * j] != pReport->aLoad[i]) {
+        _Error(pCheck, "Report %u: Wrong task load\n", pCheck->NumReports);
+        break;
+      }
+    }
+  }
+  pCheck->NumReports++;
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK* pCheck;
+
+  pCheck = (CHECK*)pContext;
+  if (SYSVIEW_LOAD_OnEvent(&pCheck->Load, pEvent)) {
+    _CheckReport(pCheck, pEvent);
+  }
+}
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Records NUM_BENCH_EVENTS task switches and idle phases with the
+*    events disabled and prints the time per event, which is the time
+*    of the load accounting.
+*/
+static void _Measure(void) {
+  U64      t;
+  unsigned i;
+
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_EVENTS; i++) {
+    _Time += 1000u;
+    if (i & 3u) {
+      SEGGER_SYSVIEW_OnTaskStartExec(_GetTaskId(i % NUM_TASKS));
+    } else {
+      SEGGER_SYSVIEW_OnIdle();
+    }
+    if ((i & 63u) == 63u) {
+      _Drain();
+    }
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("Scheduler event, events disabled %6.2f ns/event\n", (double)t / NUM_BENCH_EVENTS);
+}
+#endif
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  static CHECK                  Check;
+  U32                           Load;
+  U32                           Expected;
+  unsigned                      i;
+
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Init(1000000000u, 1000000000u, NULL, NULL);
+  SEGGER_SYSVIEW_SetRAMBase(0x20000000u);
+  _Model.PeriodStart = _Time;
+  _Model.LastTime    = _Time;
+  _Model.Cur         = OTHER;
+  SEGGER_SYSVIEW_Start();
+  _RunPhase("All events");
+  SEGGER_SYSVIEW_DisableEvents(SYSVIEW_EVTMASK_ALL_INTERRUPTS | SYSVIEW_EVTMASK_TASK_START_EXEC | SYSVIEW_EVTMASK_TASK_STOP_EXEC | SYSVIEW_EVTMASK_IDLE);
+  _RunPhase("Scheduler and interrupts disabled");
+  _Drain();
+  SYSVIEW_LOAD_Init(&Check.Load);
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  _Stream.Size = 0;
+  printf("Config: NUM_LOAD_TASKS=%d LOAD_PERIOD=0x%X TIMESTAMP_SHIFT=%d\n",
+         SEGGER_SYSVIEW_NUM_LOAD_TASKS, (unsigned)SEGGER_SYSVIEW_LOAD_PERIOD, SEGGER_SYSVIEW_TIMESTAMP_SHIFT);
+  printf("%u reports, idle %u/1000, interrupts %u/1000 in the last one\n", Check.NumReports, Check.Load.IdleLoad, Check.Load.ISRLoad);
+  _NumErrors += Check.NumErrors;
+  if (Check.NumReports != _Model.NumReports || _Model.NumReports > MAX_REPORTS) {
+    printf("Expected %u reports\n", _Model.NumReports);
+    _NumErrors++;
+  }
+  //
+  // The summed up load is off by less than half of 1/1000 per report.
+  //
+  for (i = 0; i < NUM_TASKS; i++) {
+    Load     = SYSVIEW_LOAD_GetPermille(&Check.Load, SEGGER_SYSVIEW_ShrinkTaskId(_GetTaskId(i)));
+    Expected = (U32)((_Model.aTotalTime[i] * 1000u + _Model.TotalTime / 2u) / _Model.TotalTime);
+    printf("Task %2u: %3u/1000\n", i, Load);
+    if (Load + 1u < Expected || Load > Expected + 1u) {
+      printf("Task %u: Expected %u/1000\n", i, Expected);
+      _NumErrors++;
+    }
+  }
+  _Measure();
+  printf("%s\n\n", _NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return _NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+#else
+  printf("SEGGER_SYSVIEW_NUM_LOAD_TASKS is 0\n");
+  return EXIT_SUCCESS;
+#endif
+}
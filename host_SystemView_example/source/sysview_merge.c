@@ -0,0 +1,91 @@
+/*
+ * Merges SystemView shards into one time-ordered SystemView stream.
+ *
+ * Usage: sysview_merge <out> <shard0> [<shard1> ...]
+ *
+ * Each input is the raw stream of one RTT up-channel recorded with
+ * SEGGER_SYSVIEW_NUM_SHARDS > 1, in order of the shard index. The output
+ * can be loaded into SystemView like a single-channel recording.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SYSVIEW_Merge.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define MAX_SHARDS  32
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U8* _ReadFile(const char* sFile, unsigned* pNumBytes) {
+  FILE* pFile;
+  U8*   pData;
+  long  Size;
+
+  pFile = fopen(sFile, "rb");
+  if (pFile == NULL) {
+    perror(sFile);
+    return NULL;
+  }
+  fseek(pFile, 0, SEEK_END);
+  Size = ftell(pFile);
+  fseek(pFile, 0, SEEK_SET);
+  pData = malloc(Size ? (size_t)Size : 1u);
+  if (pData && fread(pData, 1, (size_t)Size, pFile) != (size_t)Size) {
+    perror(sFile);
+    free(pData);
+    pData = NULL;
+  }
+  fclose(pFile);
+  *pNumBytes = (unsigned)Size;
+  return pData;
+}
+
+static void _cbWrite(void* pContext, const U8* pData, unsigned NumBytes) {
+  fwrite(pData, 1, NumBytes, (FILE*)pContext);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char** argv) {
+  SYSVIEW_MERGE_SHARD aShard[MAX_SHARDS];
+  SYSVIEW_MERGE_STATS Stats;
+  FILE*               pFile;
+  unsigned            NumShards;
+  unsigned            i;
+  int                 r;
+
+  if (argc < 3 || argc - 2 > MAX_SHARDS) {
+    fprintf(stderr, "Usage: %s <out> <shard0> [<shard1> ...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  NumShards = (unsigned)argc - 2;
+  for (i = 0; i < NumShards; i++) {
+    aShard[i].pData = _ReadFile(argv[i + 2], &aShard[i].NumBytes);
+    if (aShard[i].pData == NULL) {
+      return EXIT_FAILURE;
+    }
+  }
+  pFile = fopen(argv[1], "wb");
+  if (pFile == NULL) {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  r = SYSVIEW_MERGE_Run(aShard, NumShards, _cbWrite, pFile, &Stats);
+  fclose(pFile);
+  printf("Merged %u shards: %u events, %u skipped before first sync, %u dropped on target.\n",
+         NumShards, Stats.NumEvents, Stats.NumSkipped, Stats.NumDropped);
+  for (i = 0; i < NumShards; i++) {
+    free((void*)aShard[i].pData);
+  }
+  if (r < 0) {
+    fprintf(stderr, "Corrupt input, merged stream is incomplete.\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
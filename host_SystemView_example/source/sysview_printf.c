@@ -0,0 +1,257 @@
+/*
+ * Test of deferred printf on the POSIX host build.
+ *
+ * The cost per call of SEGGER_SYSVIEW_PrintfTarget() and
+ * SEGGER_SYSVIEW_PrintfHost() is measured, in recording time and in
+ * stream bytes. With SEGGER_SYSVIEW_USE_DEFERRED_PRINTF, PrintfHost
+ * sends the address of the format string instead of the string: the
+ * application is linked without PIE, so the addresses in its own ELF
+ * file are the ones it runs at. Messages with various conversions are
+ * recorded, formatted with the strings of the ELF file and compared
+ * to the output of snprintf(), also for the SEGGER_SYSVIEW_PRINTF_HOST()
+ * macros, which count and convert the arguments at compile time.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Printf.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_CALLS           100000
+#define MAX_MESSAGES        32
+#define MAX_MESSAGE_LEN     128
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  const SYSVIEW_PRINTF_STRINGS* pStrings;
+  unsigned                      NumMessages;
+  unsigned                      NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static STREAM   _Stream;
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 1)
+static unsigned _NumExpected;
+static U32      _aExpectedOptions[MAX_MESSAGES];
+static char     _aacExpected[MAX_MESSAGES][MAX_MESSAGE_LEN];
+#endif
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _Drain(void) {
+  return SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static void _PrintfTarget(U32 i) { SEGGER_SYSVIEW_PrintfTarget("Task1 loop %u of %u, state %d", i, (U32)NUM_CALLS, -1); }
+static void _PrintfHost  (U32 i) { SEGGER_SYSVIEW_PrintfHost("Task1 loop %u of %u, state %d", i, (U32)NUM_CALLS, -1); }
+static void _PrintfMacro (U32 i) { SEGGER_SYSVIEW_PRINTF_HOST("Task1 loop %u of %u, state %d", i, (U32)NUM_CALLS, -1); }
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Records NUM_CALLS messages, draining the buffer after each, and
+*    prints the recording time and stream bytes per call.
+*/
+static void _Measure(const char* sName, void (*pfPrint)(U32 i)) {
+  U64 t;
+  U64 tTotal;
+  U64 NumBytes;
+  U32 i;
+
+  _Drain();
+  tTotal   = 0;
+  NumBytes = 0;
+  for (i = 0; i < NUM_CALLS; i++) {
+    t         = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    pfPrint(i);
+    tTotal   += SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+    NumBytes += _Drain();
+  }
+  printf("%-24s %6.1f ns/call %6.1f bytes/call\n", sName, (double)tTotal / NUM_CALLS, (double)NumBytes / NUM_CALLS);
+}
+
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 1)
+
+/*********************************************************************
+*
+*       _Expect()
+*
+*  Function description
+*    Stores the message which is expected for the next deferred print.
+*/
+static void _Expect(U32 Options, const char* sFormat, ...) {
+  va_list ParamList;
+
+  va_start(ParamList, sFormat);
+  vsnprintf(_aacExpected[_NumExpected], MAX_MESSAGE_LEN, sFormat, ParamList);
+  va_end(ParamList);
+  _aExpectedOptions[_NumExpected++] = Options;
+}
+
+#define PRINTF_HOST(...)   do { SEGGER_SYSVIEW_PrintfHost(__VA_ARGS__); _Expect(SEGGER_SYSVIEW_LOG,     __VA_ARGS__); } while (0)
+#define WARNF_HOST(...)    do { SEGGER_SYSVIEW_WarnfHost(__VA_ARGS__);  _Expect(SEGGER_SYSVIEW_WARNING, __VA_ARGS__); } while (0)
+#define ERRORF_HOST(...)   do { SEGGER_SYSVIEW_ErrorfHost(__VA_ARGS__); _Expect(SEGGER_SYSVIEW_ERROR,   __VA_ARGS__); } while (0)
+#define PRINTF_MACRO(...)  do { SEGGER_SYSVIEW_PRINTF_HOST(__VA_ARGS__); _Expect(SEGGER_SYSVIEW_LOG,     __VA_ARGS__); } while (0)
+#define WARNF_MACRO(...)   do { SEGGER_SYSVIEW_WARNF_HOST(__VA_ARGS__);  _Expect(SEGGER_SYSVIEW_WARNING, __VA_ARGS__); } while (0)
+#define ERRORF_MACRO(...)  do { SEGGER_SYSVIEW_ERRORF_HOST(__VA_ARGS__); _Expect(SEGGER_SYSVIEW_ERROR,   __VA_ARGS__); } while (0)
+
+/*********************************************************************
+*
+*       _RecordMessages()
+*
+*  Function description
+*    Records the test messages.
+*/
+static void _RecordMessages(void) {
+  static const char sName[] = "Task1";
+  char              acRam[16];
+  char              acAddr[16];
+
+  PRINTF_HOST("No arguments");
+  PRINTF_HOST("Task %d loop %u", -3, 42u);
+  PRINTF_HOST("[%5d|%-5d|%05d]", 17, -17, 17);
+  PRINTF_HOST("%x %X %08x %#x %o", 0xBEEFu, 0xBEEFu, 0x1234u, 255u, 8u);
+  PRINTF_HOST("100%% of %u%%", 7u);
+  PRINTF_HOST("%c%c%c", 'a', 'b', 'c');
+  PRINTF_HOST("%ld %lu %hd", 123456L, 4000000000UL, 5);
+  PRINTF_HOST("%s says %s", sName, "hello");
+  PRINTF_HOST("[%8s|%-8s]", sName, sName);
+  WARNF_HOST("Stack of %s at %u%%", sName, 93u);
+  ERRORF_HOST("Error %d in state %u", -22, 3u);
+  PRINTF_HOST("%zu bytes, %u%%", sizeof(acRam), 50u);
+  //
+  // 64-bit and floating-point arguments can not be sent, the message is dropped.
+  //
+  SEGGER_SYSVIEW_PrintfHost("Dropped %lld", 1LL);
+  SEGGER_SYSVIEW_PrintfHost("Dropped %.1f", 1.0);
+  //
+  // A string which is not in the ELF file is shown as its address.
+  //
+  strcpy(acRam, "in RAM");
+  snprintf(acAddr, sizeof(acAddr), "<0x%08X>", (unsigned)(U32)SEGGER_PTR2ADDR(acRam));
+  SEGGER_SYSVIEW_PrintfHost("String %s", acRam);
+  _Expect(SEGGER_SYSVIEW_LOG, "String %s", acAddr);
+  //
+  // Same with the macros.
+  //
+  PRINTF_MACRO("Macro without arguments");
+  PRINTF_MACRO("Macro %d %u %08X %c", -3, 42u, 0xBEEFu, 'm');
+  PRINTF_MACRO("Macro %s says %s", sName, "hello");
+  PRINTF_MACRO("%d %d %d %d %d %d %d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+  WARNF_MACRO("Macro warning %u%%", 93u);
+  ERRORF_MACRO("Macro error %d", -22);
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK* pCheck;
+  char   acMessage[MAX_MESSAGE_LEN];
+  U32    Options;
+  int    r;
+
+  pCheck = (CHECK*)pContext;
+  if (pEvent->Id != SYSVIEW_EVTID_EX || pEvent->SubId != SYSVIEW_EVTID_EX_PRINT_DEFERRED) {
+    return;
+  }
+  r = SYSVIEW_PRINTF_Format(pCheck->pStrings, pEvent, &Options, acMessage, sizeof(acMessage));
+  if (pCheck->NumMessages < _NumExpected) {
+    if (r < 0 || strcmp(acMessage, _aacExpected[pCheck->NumMessages]) != 0 || Options != _aExpectedOptions[pCheck->NumMessages]) {
+      printf("Message %u: \"%s\" (%u), expected \"%s\" (%u)\n", pCheck->NumMessages, r < 0 ? "" : acMessage, Options,
+             _aacExpected[pCheck->NumMessages], _aExpectedOptions[pCheck->NumMessages]);
+      pCheck->NumErrors++;
+    } else {
+      printf("  %s\n", acMessage);
+    }
+  }
+  pCheck->NumMessages++;
+}
+
+/*********************************************************************
+*
+*       _Check()
+*
+*  Function description
+*    Records the test messages and checks them with the strings of the
+*    ELF file of this application. The stream is decoded from the start
+*    of the recording, which has to precede the messages.
+*
+*  Return value
+*    Number of errors.
+*/
+static unsigned _Check(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  SYSVIEW_PRINTF_STRINGS        Strings;
+  CHECK                         Check;
+  FILE*                         pFile;
+  U8*                           pElf;
+  long                          NumBytes;
+
+  pFile = fopen("/proc/self/exe", "rb");
+  if (pFile == NULL) {
+    printf("Cannot open /proc/self/exe\n");
+    return 1;
+  }
+  fseek(pFile, 0, SEEK_END);
+  NumBytes = ftell(pFile);
+  fseek(pFile, 0, SEEK_SET);
+  pElf = malloc((size_t)NumBytes);
+  if (fread(pElf, 1, (size_t)NumBytes, pFile) != (size_t)NumBytes) {
+    NumBytes = 0;
+  }
+  fclose(pFile);
+  SYSVIEW_PRINTF_Init(&Strings);
+  if (SYSVIEW_PRINTF_AddElf(&Strings, pElf, (U32)NumBytes) <= 0) {
+    printf("No sections in /proc/self/exe\n");
+    free(pElf);
+    return 1;
+  }
+  _RecordMessages();
+  _Drain();
+  memset(&Check, 0, sizeof(Check));
+  Check.pStrings = &Strings;
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  if (Check.NumMessages != _NumExpected) {
+    printf("%u messages, expected %u\n", Check.NumMessages, _NumExpected);
+    Check.NumErrors++;
+  }
+  free(pElf);
+  return Check.NumErrors;
+}
+
+#endif
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  unsigned NumErrors;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  printf("Config: USE_DEFERRED_PRINTF=%d USE_DELTA_OF_DELTA=%d\n", SEGGER_SYSVIEW_USE_DEFERRED_PRINTF, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA);
+  NumErrors = 0;
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 1)
+  NumErrors = _Check();
+#endif
+  _Measure("PrintfTarget", _PrintfTarget);
+  _Measure(SEGGER_SYSVIEW_USE_DEFERRED_PRINTF ? "PrintfHost (deferred)" : "PrintfHost", _PrintfHost);
+  _Measure(SEGGER_SYSVIEW_USE_DEFERRED_PRINTF ? "PRINTF_HOST (deferred)" : "PRINTF_HOST", _PrintfMacro);
+  printf("%s\n\n", NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
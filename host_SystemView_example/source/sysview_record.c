@@ -0,0 +1,212 @@
+/*
+ * Test of SEGGER_SYSVIEW_RECORD() on the POSIX host build.
+ *
+ * Events with 0 to 16 parameters, with enum, negative, pointer, 64-bit
+ * and float parameters are recorded with SEGGER_SYSVIEW_RECORD(). The
+ * stream is decoded and every event must have the expected ID and
+ * parameters. The recording time and stream bytes per event are
+ * measured for SEGGER_SYSVIEW_RECORD() and SEGGER_SYSVIEW_RecordU32x4()
+ * with 4 parameters, and for SEGGER_SYSVIEW_RECORD() with 12.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_CALLS           100000
+#define EVENT_ID            64u
+#define MAX_EVENTS          32
+#define MAX_PARAMS          16
+
+#define CHECK_RECORD(Offset, NumParams, ...)                               \
+  do {                                                                     \
+    SEGGER_SYSVIEW_RECORD(EVENT_ID + (Offset), __VA_ARGS__);               \
+    _Expect(EVENT_ID + (Offset), (NumParams), __VA_ARGS__);                \
+  } while (0)
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32      Id;
+  unsigned NumParams;
+  U32      aParam[MAX_PARAMS];
+} EXPECTED;
+
+typedef struct {
+  unsigned NumEvents;
+  unsigned NumErrors;
+} CHECK;
+
+typedef enum {
+  COLOR_RED,
+  COLOR_GREEN,
+  COLOR_BLUE
+} COLOR;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static STREAM   _Stream;
+static EXPECTED _aExpected[MAX_EVENTS];
+static unsigned _NumExpected;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _Drain(void) {
+  return SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+/*********************************************************************
+*
+*       _Expect()
+*
+*  Function description
+*    Stores the event which is expected next. The parameters are
+*    passed as unsigned int.
+*/
+static void _Expect(U32 Id, unsigned NumParams, ...) {
+  EXPECTED* pExpected;
+  va_list   ParamList;
+  unsigned  i;
+
+  pExpected            = &_aExpected[_NumExpected++];
+  pExpected->Id        = Id;
+  pExpected->NumParams = NumParams;
+  va_start(ParamList, NumParams);
+  for (i = 0; i < NumParams; i++) {
+    pExpected->aParam[i] = va_arg(ParamList, unsigned);
+  }
+  va_end(ParamList);
+}
+
+/*********************************************************************
+*
+*       _RecordEvents()
+*
+*  Function description
+*    Records the test events.
+*/
+static void _RecordEvents(void) {
+  COLOR Color;
+  int   Value;
+
+  SEGGER_SYSVIEW_RECORD(EVENT_ID);
+  _Expect(EVENT_ID, 0);
+  CHECK_RECORD( 1,  1, 0x7Fu);
+  CHECK_RECORD( 2,  2, 0x80u, 0xFFFFFFFFu);
+  CHECK_RECORD( 3,  3, 1u, 2u, 3u);
+  CHECK_RECORD( 4,  4, 1u, 2u, 3u, 4u);
+  CHECK_RECORD( 5,  5, 1u, 2u, 3u, 4u, 5u);
+  CHECK_RECORD( 6,  6, 1u, 2u, 3u, 4u, 5u, 6u);
+  CHECK_RECORD( 7,  7, 1u, 2u, 3u, 4u, 5u, 6u, 7u);
+  CHECK_RECORD( 8,  8, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u);
+  CHECK_RECORD( 9,  9, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u);
+  CHECK_RECORD(10, 10, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u);
+  CHECK_RECORD(11, 11, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u);
+  CHECK_RECORD(12, 12, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u, 12u);
+  CHECK_RECORD(16, 16, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u, 12u, 13u, 14u, 15u, 0x12345678u);
+  //
+  // Parameters which are no unsigned 32-bit values.
+  //
+  Color = COLOR_BLUE;
+  Value = -1;
+  SEGGER_SYSVIEW_RECORD(EVENT_ID + 20, Color, Value);
+  _Expect(EVENT_ID + 20, 2, 2u, 0xFFFFFFFFu);
+  SEGGER_SYSVIEW_RECORD(EVENT_ID + 21, &_Stream);
+  _Expect(EVENT_ID + 21, 1, (unsigned)(U32)SEGGER_PTR2ADDR(&_Stream));
+  SEGGER_SYSVIEW_RECORD(EVENT_ID + 22, SEGGER_SYSVIEW_U64_ARGS(0x123456789ABCDEF0ull), 7u);
+  _Expect(EVENT_ID + 22, 3, 0x9ABCDEF0u, 0x12345678u, 7u);
+  SEGGER_SYSVIEW_RECORD(EVENT_ID + 23, SEGGER_SYSVIEW_FLOAT_ARG(1.5f), SEGGER_SYSVIEW_FLOAT_ARG(-2.0f));
+  _Expect(EVENT_ID + 23, 2, 0x3FC00000u, 0xC0000000u);
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  const EXPECTED* pExpected;
+  CHECK*          pCheck;
+  U32             aParam[MAX_PARAMS + 1];
+  unsigned        NumParams;
+
+  pCheck = (CHECK*)pContext;
+  if (pEvent->Id < EVENT_ID) {
+    return;
+  }
+  if (pCheck->NumEvents < _NumExpected) {
+    pExpected = &_aExpected[pCheck->NumEvents];
+    NumParams = SYSVIEW_DECODE_GetU32s(pEvent, aParam, MAX_PARAMS + 1);
+    if (pEvent->Id != pExpected->Id || NumParams != pExpected->NumParams
+     || memcmp(aParam, pExpected->aParam, NumParams * sizeof(U32)) != 0) {
+      printf("Event %u: ID %u with %u parameters, expected ID %u with %u\n", pCheck->NumEvents,
+             pEvent->Id, NumParams, pExpected->Id, pExpected->NumParams);
+      pCheck->NumErrors++;
+    }
+  }
+  pCheck->NumEvents++;
+}
+
+static void _Record4   (U32 i) { SEGGER_SYSVIEW_RECORD(EVENT_ID + 4, i, 0x20000400u, 100u, 0u); }
+static void _RecordU32x4(U32 i) { SEGGER_SYSVIEW_RecordU32x4(EVENT_ID + 4, i, 0x20000400u, 100u, 0u); }
+static void _Record12  (U32 i) { SEGGER_SYSVIEW_RECORD(EVENT_ID + 12, i, 0x20000400u, 100u, 0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u); }
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Records NUM_CALLS events, draining the buffer after each, and
+*    prints the recording time and stream bytes per event.
+*/
+static void _Measure(const char* sName, void (*pfRecord)(U32 i)) {
+  U64 t;
+  U64 tTotal;
+  U64 NumBytes;
+  U32 i;
+
+  _Drain();
+  tTotal   = 0;
+  NumBytes = 0;
+  for (i = 0; i < NUM_CALLS; i++) {
+    t         = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    pfRecord(i);
+    tTotal   += SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+    NumBytes += _Drain();
+  }
+  printf("%-24s %6.1f ns/event %6.1f bytes/event\n", sName, (double)tTotal / NUM_CALLS, (double)NumBytes / NUM_CALLS);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  CHECK                         Check;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  _RecordEvents();
+  _Drain();
+  memset(&Check, 0, sizeof(Check));
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  if (Check.NumEvents != _NumExpected) {
+    printf("%u events, expected %u\n", Check.NumEvents, _NumExpected);
+    Check.NumErrors++;
+  }
+  printf("Config: USE_STATIC_BUFFER=%d USE_IN_PLACE_ENCODING=%d, %u events checked\n",
+         SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING, _NumExpected);
+  _Measure("RECORD, 4 parameters", _Record4);
+  _Measure("RecordU32x4", _RecordU32x4);
+  _Measure("RECORD, 12 parameters", _Record12);
+  printf("%s\n\n", Check.NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return Check.NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+/*
+ * Test of sampled recording on the POSIX host build.
+ *
+ * Events are sampled by class with SEGGER_SYSVIEW_RECORD_SAMPLED(), with
+ * the ratio set on target and by the host through the down buffer, and
+ * by ID with SEGGER_SYSVIEW_SetSampling(). The recording is restarted
+ * in between. The stream is decoded with the sampling reader and the
+ * scaled count of each ID must match the number of events recorded by
+ * the application, within the ratio, and the parameters of skipped
+ * events must not be evaluated. The time and stream bytes per event
+ * are measured for a class sampled 1 of 1 and 1 of 16.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Command.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Sampling.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_ITERATIONS      1000u
+#define NUM_CALLS           1000000
+#define EVENT_ID            64u
+#define CLASS_SEND          0u
+#define CLASS_NOTIFY        1u
+#define RATIO_SEND          8u
+#define RATIO_NOTIFY        4u
+#define RATIO_ID            5u
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32 EventId;
+  U32 Ratio;                    // Largest ratio of the ID in the test
+  U32 NumCalls;                 // Events recorded by the application
+} EXPECTED;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const U32 _aSendId[]   = { EVENT_ID, EVENT_ID + 1 };
+static const U32 _aNotifyId[] = { EVENT_ID + 2 };
+
+static STREAM   _Stream;
+static EXPECTED _aExpected[] = {
+  { EVENT_ID,     RATIO_SEND,   0 },
+  { EVENT_ID + 1, RATIO_SEND,   0 },
+  { EVENT_ID + 2, RATIO_NOTIFY, 0 },
+  { EVENT_ID + 3, RATIO_ID,     0 },
+  { EVENT_ID + 4, 1,            0 },
+};
+static unsigned _NumEvaluated;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _Drain(void) {
+  return SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static U32 _Eval(U32 v) {
+  _NumEvaluated++;
+  return v;
+}
+
+/*********************************************************************
+*
+*       _Command()
+*
+*  Function description
+*    Sends the command of an operator line through the down buffer
+*    and lets the recorder process it.
+*/
+static void _Command(const char* sLine) {
+  U8  aCmd[SYSVIEW_COMMAND_MAX_SIZE];
+  int NumBytes;
+
+  NumBytes = SYSVIEW_COMMAND_Parse(sLine, aCmd, sizeof(aCmd));
+  if (NumBytes <= 0) {
+    printf("Command \"%s\" not encoded\n", sLine);
+    _NumErrors++;
+    return;
+  }
+  SEGGER_RTT_WriteDownBuffer(SEGGER_SYSVIEW_GetChannelID(), aCmd, (unsigned)NumBytes);
+  SEGGER_SYSVIEW_IsStarted();
+}
+
+/*********************************************************************
+*
+*       _RecordEvents()
+*
+*  Function description
+*    Records NumIterations of the test events, draining the buffer
+*    after each.
+*/
+static void _RecordEvents(unsigned NumIterations) {
+  U32 i;
+
+  for (i = 0; i < NumIterations; i++) {
+    SEGGER_SYSVIEW_RECORD_SAMPLED(CLASS_SEND, EVENT_ID, _Eval(i));
+    _aExpected[0].NumCalls++;
+    if ((i & 1u) == 0) {
+      SEGGER_SYSVIEW_RECORD_SAMPLED(CLASS_SEND, EVENT_ID + 1, i, 1u);
+      _aExpected[1].NumCalls++;
+    }
+    SEGGER_SYSVIEW_RECORD_SAMPLED(CLASS_NOTIFY, EVENT_ID + 2, i);
+    _aExpected[2].NumCalls++;
+    SEGGER_SYSVIEW_RecordU32(EVENT_ID + 3, i);
+    _aExpected[3].NumCalls++;
+    SEGGER_SYSVIEW_RECORD(EVENT_ID + 4, i);
+    _aExpected[4].NumCalls++;
+    _Drain();
+  }
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  SYSVIEW_SAMPLING_OnEvent((SYSVIEW_SAMPLING*)pContext, pEvent);
+}
+
+static void _RecordSend1 (U32 i) { SEGGER_SYSVIEW_RECORD_SAMPLED(CLASS_SEND, EVENT_ID, i, 0x20000400u, 100u, 0u); }
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Records NUM_CALLS events of the send class at a ratio and prints
+*    the time and stream bytes per event.
+*/
+static void _Measure(unsigned Ratio) {
+  U64      t;
+  U64      NumBytes;
+  unsigned i;
+
+  SEGGER_SYSVIEW_SetClassSampling(CLASS_SEND, Ratio, NULL, 0);
+  _Drain();
+  NumBytes = 0;
+  t        = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_CALLS; i++) {
+    _RecordSend1(i);
+    if ((i & 63u) == 63u) {
+      NumBytes += _Drain();
+    }
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  NumBytes += _Drain();
+  printf("RECORD_SAMPLED, 1 of %-3u       %6.2f ns/event %5.2f bytes/event\n", Ratio, (double)t / NUM_CALLS, (double)NumBytes / NUM_CALLS);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  static SYSVIEW_SAMPLING       Sampling;
+  const SYSVIEW_SAMPLING_ID*    pId;
+  const EXPECTED*               pExpected;
+  unsigned                      NumSampled;
+  unsigned                      i;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  //
+  // Class ratios set on target and, once the IDs are known, by the host.
+  //
+  if (SEGGER_SYSVIEW_SetClassSampling(CLASS_SEND, RATIO_SEND, _aSendId, SEGGER_COUNTOF(_aSendId)) != 0
+   || SEGGER_SYSVIEW_SetClassSampling(CLASS_NOTIFY, 1, _aNotifyId, SEGGER_COUNTOF(_aNotifyId)) != 0
+   || SEGGER_SYSVIEW_SetClassSampling(SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES, 2, NULL, 0) != -1
+   || SEGGER_SYSVIEW_SetSampling(EVENT_ID + 3, RATIO_ID) != 0) {
+    printf("Sampling not set\n");
+    _NumErrors++;
+  }
+  _RecordEvents(NUM_ITERATIONS / 4);
+  _Command("sample-class 1 4");
+  _RecordEvents(NUM_ITERATIONS / 4);
+  //
+  // The weights are sent again after a restart.
+  //
+  SEGGER_SYSVIEW_Stop();
+  SEGGER_SYSVIEW_Start();
+  _RecordEvents(NUM_ITERATIONS / 2);
+  _Drain();
+  NumSampled = _NumEvaluated;
+  //
+  // Decode and compare the scaled counts.
+  //
+  SYSVIEW_SAMPLING_Init(&Sampling);
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Sampling);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  printf("Config: USE_STATIC_BUFFER=%d USE_IN_PLACE_ENCODING=%d\n", SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING);
+  for (i = 0; i < SEGGER_COUNTOF(_aExpected); i++) {
+    pExpected = &_aExpected[i];
+    pId       = SYSVIEW_SAMPLING_GetId(&Sampling, pExpected->EventId);
+    if (pId == NULL) {
+      printf("ID %u: Not recorded\n", pExpected->EventId);
+      _NumErrors++;
+      continue;
+    }
+    printf("ID %u: %6u calls, %6u recorded, %6u estimated, weight %u\n", pExpected->EventId, pExpected->NumCalls,
+           (unsigned)pId->NumRecorded, (unsigned)pId->NumEstimated, pId->Weight);
+    //
+    // The estimate is off by less than the ratio per change of the ratio and restart.
+    //
+    if (pId->Weight != pExpected->Ratio
+     || pId->NumEstimated + 3 * pExpected->Ratio < pExpected->NumCalls || pId->NumEstimated > pExpected->NumCalls + 3 * pExpected->Ratio) {
+      printf("ID %u: Expected weight %u and %u events\n", pExpected->EventId, pExpected->Ratio, pExpected->NumCalls);
+      _NumErrors++;
+    }
+  }
+  pId = SYSVIEW_SAMPLING_GetId(&Sampling, EVENT_ID);
+  if (pId == NULL || NumSampled != pId->NumRecorded) {
+    printf("Parameters evaluated %u times\n", NumSampled);
+    _NumErrors++;
+  }
+  _Measure(1);
+  _Measure(16);
+  printf("%s\n\n", _NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return _NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
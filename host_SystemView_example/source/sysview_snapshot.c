@@ -0,0 +1,349 @@
+/*
+ * Test of post-mortem checkpoints on the POSIX host build.
+ *
+ * Events are recorded in post mortem mode against a simulated 1 GHz
+ * cycle counter, with a task list of NUM_TASKS tasks.
+ * First the up-buffer is drained after each event, and the stream bytes
+ * and recording time per event are reported: the periodic sync info
+ * resends the task list, a checkpoint does not.
+ * With SEGGER_SYSVIEW_USE_CHECKPOINTS, the recording then continues
+ * without draining, a task is added in the middle, and the buffer is
+ * dumped as a debugger would after a crash. The most recent checkpoint
+ * must be found at SEGGER_SYSVIEW_LastCheckpoint, and the stream
+ * extracted from it must decode with all tasks described and the
+ * absolute time of every event equal to the simulated time. With a
+ * stale SEGGER_SYSVIEW_LastCheckpoint the checkpoint must be found by
+ * searching the buffer. Both ways are timed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+#include "SYSVIEW_Snapshot.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_EVENTS          100000
+#define NUM_EVENTS_DUMP     200000        // Overwrites the buffer several times
+#define NUM_TASKS           8
+#define TEST_EVENT_ID       (32u + 41u)
+#define START_TIME          0xFFF00000u   // Wraps around after about 1 ms
+#define NUM_FIND_LOOPS      1000
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32      Base;                          // Absolute time minus time in the stream, from the checkpoint on
+  U32      PrevTime;                      // Time of the previous event in the stream
+  int      HasCheckpoint;
+  U32      NextIndex;                     // Index of the next test event expected
+  U32      NumEvents;
+  U32      TasksSeen;                     // Bit i: _aTask[i] described
+  unsigned NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static U64  _cbGetTime(void);
+static void _cbSendTaskList(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U64    _Time;
+static STREAM _Stream;
+static U32    _Rand = 1;
+static SEGGER_SYSVIEW_TASKINFO _aTask[NUM_TASKS + 1];
+static unsigned _NumTasks;
+static char   _aacTaskName[NUM_TASKS + 1][16];
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+static U32    _aTime[NUM_EVENTS_DUMP];   // Simulated time stamp of each event of the dump
+#endif
+
+static const SEGGER_SYSVIEW_OS_API _OSAPI = {
+  _cbGetTime,
+  _cbSendTaskList
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U32 _cbGetTimestamp(void) {
+  return (U32)_Time;
+}
+
+static U64 _cbGetTime(void) {
+  return _Time / 1000u;
+}
+
+static void _cbSendTaskList(void) {
+  unsigned i;
+
+  for (i = 0; i < _NumTasks; i++) {
+    SEGGER_SYSVIEW_SendTaskInfo(&_aTask[i]);
+  }
+}
+
+static void _cbSendSystemDesc(void) {
+  SEGGER_SYSVIEW_SendSysDesc("N=Snapshot Test,D=x86-64,O=POSIX");
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+/*********************************************************************
+*
+*       _AddTask()
+*
+*  Function description
+*    Adds a task to the task list and describes it.
+*/
+static void _AddTask(int Send) {
+  SEGGER_SYSVIEW_TASKINFO* pTask;
+
+  pTask = &_aTask[_NumTasks];
+  snprintf(_aacTaskName[_NumTasks], sizeof(_aacTaskName[0]), "Task %u", _NumTasks);
+  pTask->TaskID    = 0x1000u + 0x100u * _NumTasks;
+  pTask->sName     = _aacTaskName[_NumTasks];
+  pTask->Prio      = 1 + _NumTasks;
+  pTask->StackBase = 0x20000000u + 0x1000u * _NumTasks;
+  pTask->StackSize = 0x800u;
+  _NumTasks++;
+  if (Send) {
+    SEGGER_SYSVIEW_OnTaskCreate(pTask->TaskID);
+    SEGGER_SYSVIEW_SendTaskInfo(pTask);
+  }
+}
+
+/*********************************************************************
+*
+*       _RecordDrained()
+*
+*  Function description
+*    Records NUM_EVENTS test events and drains the buffer after each.
+*
+*  Return value
+*    Recording time in nanoseconds.
+*/
+static U64 _RecordDrained(void) {
+  U64 t;
+  U64 tTotal;
+  U32 i;
+
+  tTotal = 0;
+  for (i = 0; i < NUM_EVENTS; i++) {
+    _Time += 1000 + _GetRand(1000);
+    t      = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+    SEGGER_SYSVIEW_RecordU32(TEST_EVENT_ID, i);
+    tTotal += SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+    _Drain();
+  }
+  return tTotal;
+}
+
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+
+static void _cbWrite(void* pContext, const U8* pData, unsigned NumBytes) {
+  STREAM* pStream;
+
+  pStream = (STREAM*)pContext;
+  SEGGER_SYSVIEW_POSIX_ReserveStream(pStream, NumBytes);
+  memcpy(pStream->pData + pStream->Size, pData, NumBytes);
+  pStream->Size += NumBytes;
+}
+
+/*********************************************************************
+*
+*       _cbOnEvent()
+*
+*  Function description
+*    Checks the events of the stream extracted from the dump.
+*/
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK*   pCheck;
+  U32      aValue[5];
+  U32      Time;
+  unsigned i;
+
+  pCheck = (CHECK*)pContext;
+  Time   = (U32)pEvent->Time;
+  if (pEvent->Id == SYSVIEW_EVTID_TASK_INFO) {
+    for (i = 0; i < _NumTasks; i++) {
+      if (pEvent->aParam[0] == SEGGER_SYSVIEW_ShrinkId(_aTask[i].TaskID)) {
+        pCheck->TasksSeen |= 1u << i;
+      }
+    }
+  } else if (pEvent->Id == SYSVIEW_EVTID_EX && pEvent->SubId == SYSVIEW_EVTID_EX_CHECKPOINT && pCheck->HasCheckpoint == 0) {
+    if (SYSVIEW_DECODE_GetU32s(pEvent, aValue, 5) == 5) {
+      pCheck->Base          = aValue[1] - pCheck->PrevTime;
+      pCheck->HasCheckpoint = 1;
+    }
+  } else if (pEvent->Id == TEST_EVENT_ID) {
+    if (pCheck->HasCheckpoint == 0 || SYSVIEW_DECODE_GetU32s(pEvent, aValue, 1) != 1) {
+      pCheck->NumErrors++;
+    } else if (pCheck->NumEvents > 0 && aValue[0] != pCheck->NextIndex) {
+      if (pCheck->NumErrors++ < 10) {
+        printf("Event %u follows event %u\n", aValue[0], pCheck->NextIndex - 1);
+      }
+    } else if (aValue[0] >= NUM_EVENTS_DUMP || pCheck->Base + Time != _aTime[aValue[0]]) {
+      if (pCheck->NumErrors++ < 10) {
+        printf("Event %u: time %u, expected %u\n", aValue[0], pCheck->Base + Time,
+               (aValue[0] < NUM_EVENTS_DUMP) ? _aTime[aValue[0]] : 0);
+      }
+    } else {
+      pCheck->NextIndex = aValue[0] + 1;
+      pCheck->NumEvents++;
+    }
+  }
+  pCheck->PrevTime = Time;
+}
+
+/*********************************************************************
+*
+*       _TestDump()
+*
+*  Function description
+*    Records without draining, dumps the buffer and reads it back.
+*
+*  Return value
+*    Number of errors found.
+*/
+static unsigned _TestDump(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  SEGGER_RTT_BUFFER_UP*       pRing;
+  SYSVIEW_SNAPSHOT            Snap;
+  SYSVIEW_SNAPSHOT_CHECKPOINT Cp;
+  SYSVIEW_SNAPSHOT_CHECKPOINT CpScan;
+  CHECK                       Check;
+  U8*                         pDump;
+  U64                         t;
+  U64                         tLocator;
+  U64                         tScan;
+  unsigned                    NumErrors;
+  U32                         i;
+  int                         r;
+
+  NumErrors = 0;
+  r         = -1;
+  for (i = 0; i < NUM_EVENTS_DUMP; i++) {
+    if (i == NUM_EVENTS_DUMP - 2000) {
+      _AddTask(1);
+    }
+    _Time    += 1000 + _GetRand(1000);
+    _aTime[i] = (U32)_Time;
+    SEGGER_SYSVIEW_RecordU32(TEST_EVENT_ID, i);
+  }
+  //
+  // Dump the buffer as a debugger would.
+  //
+  pRing = &_SEGGER_RTT.aUp[SEGGER_SYSVIEW_GetChannelID()];
+  pDump = malloc(pRing->SizeOfBuffer);
+  memcpy(pDump, pRing->pBuffer, pRing->SizeOfBuffer);
+  Snap.pBuffer         = pDump;
+  Snap.SizeOfBuffer    = pRing->SizeOfBuffer;
+  Snap.WrOff           = pRing->WrOff;
+  Snap.RdOff           = pRing->RdOff;
+  Snap.CheckpointOff   = SEGGER_SYSVIEW_LastCheckpoint.Off;
+  Snap.CheckpointSeqNo = SEGGER_SYSVIEW_LastCheckpoint.SeqNo;
+  //
+  // Find the checkpoint at the locator and by searching.
+  //
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_FIND_LOOPS; i++) {
+    r = SYSVIEW_SNAPSHOT_FindCheckpoint(&Snap, &Cp);
+  }
+  tLocator = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  if (r != 0) {
+    printf("Checkpoint not found at SEGGER_SYSVIEW_LastCheckpoint\n");
+    free(pDump);
+    return NumErrors + 1;
+  }
+  Snap.CheckpointSeqNo++;                   // Stale locator
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_FIND_LOOPS; i++) {
+    r = SYSVIEW_SNAPSHOT_FindCheckpoint(&Snap, &CpScan);
+  }
+  tScan = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  if (r != 1 || CpScan.Off != Cp.Off || CpScan.SeqNo != Cp.SeqNo) {
+    printf("Search found checkpoint at %u, expected %u\n", (r >= 0) ? CpScan.Off : 0xFFFFFFFFu, Cp.Off);
+    NumErrors++;
+  }
+  if (Cp.HasDesc == 0) {
+    printf("Full description overwritten, %u bytes before checkpoint\n", Cp.DescDist);
+    NumErrors++;
+  }
+  //
+  // Extract and decode the stream from the checkpoint on.
+  //
+  _Stream.Size = 0;
+  SYSVIEW_SNAPSHOT_Extract(&Snap, &Cp, _cbWrite, &_Stream);
+  memset(&Check, 0, sizeof(Check));
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  NumErrors += Check.NumErrors;
+  if (Check.HasCheckpoint == 0 || Decode.NumResyncs != 0) {
+    printf("Extracted stream corrupt\n");
+    NumErrors++;
+  }
+  if (Check.TasksSeen != (1u << _NumTasks) - 1) {
+    printf("%d of %u tasks described\n", __builtin_popcount(Check.TasksSeen), _NumTasks);
+    NumErrors++;
+  }
+  if (Check.NumEvents == 0 || Check.NextIndex != NUM_EVENTS_DUMP) {
+    printf("Events up to %u of %u received\n", Check.NextIndex, NUM_EVENTS_DUMP);
+    NumErrors++;
+  }
+  printf("Dump: %u bytes, checkpoint %u at offset %u, %u bytes to full description of %u bytes\n",
+         Snap.SizeOfBuffer, Cp.SeqNo, Cp.Off, Cp.DescDist, Cp.DescSize);
+  printf("Extracted %u bytes, %u events after checkpoint\n", (unsigned)_Stream.Size, Check.NumEvents);
+  printf("Find checkpoint: %.3f us at SEGGER_SYSVIEW_LastCheckpoint, %.3f us by search\n",
+         (double)tLocator / NUM_FIND_LOOPS / 1000.0, (double)tScan / NUM_FIND_LOOPS / 1000.0);
+  free(pDump);
+  return NumErrors;
+}
+
+#endif
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  unsigned NumErrors;
+  U64      tRecord;
+
+  _Time = START_TIME;
+  while (_NumTasks < NUM_TASKS) {
+    _AddTask(0);
+  }
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Init(1000000000u, 1000000000u, &_OSAPI, _cbSendSystemDesc);
+  SEGGER_SYSVIEW_SetRAMBase(0);
+  SEGGER_SYSVIEW_Start();
+  _Drain();
+  _Stream.Size = 0;
+  tRecord      = _RecordDrained();
+  printf("Config: USE_CHECKPOINTS=%d USE_DELTA_OF_DELTA=%d RTT_BUFFER_SIZE=%d\n",
+         SEGGER_SYSVIEW_USE_CHECKPOINTS, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, SEGGER_SYSVIEW_RTT_BUFFER_SIZE);
+  printf("Drained: %.2f bytes/event, %.1f ns/event\n",
+         (double)_Stream.Size / NUM_EVENTS, (double)tRecord / NUM_EVENTS);
+  NumErrors = 0;
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+  NumErrors += _TestDump();
+#endif
+  printf("%s\n\n", NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,289 @@
+/*
+ * Multi-producer stress test for the SystemView recorder on the POSIX host build.
+ *
+ * NUM_PRODUCERS threads record numbered events as fast as they can while the
+ * main thread drains the RTT up-channel. Afterwards the captured stream is
+ * parsed and checked: every packet must decode, the per-producer sequence
+ * numbers must increase and no timestamp delta may be negative.
+ * With SEGGER_SYSVIEW_NUM_SHARDS > 1 every producer records to shard
+ * Index % SEGGER_SYSVIEW_NUM_SHARDS, and the shards are merged before the check.
+ * With SEGGER_SYSVIEW_USE_DELTA_OF_DELTA every shard is expanded first.
+ * With SEGGER_SYSVIEW_POSIX_LOCK_STATS the time SEGGER_RTT_LOCK() was held,
+ * which is the interrupt-masked time on target, is reported per event.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Expand.h"
+#include "SYSVIEW_Merge.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_PRODUCERS       4
+#define NUM_EVENTS          200000
+#define STRESS_EVENT_ID     (32u + 40u)
+#define MAX_DELTA           0x40000000u   // A "negative" delta wraps to a value above this
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static volatile int _NumRunning;
+static STREAM       _aShardStream[SEGGER_SYSVIEW_NUM_SHARDS];
+static STREAM       _Stream;        // Merged stream which is checked
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void* _Producer(void* p) {
+  U32 Index;
+  U32 Seq;
+
+  Index = (U32)(PTR_ADDR)p;
+  SEGGER_SYSVIEW_POSIX_SetShard(Index % SEGGER_SYSVIEW_NUM_SHARDS);
+  for (Seq = 1; Seq <= NUM_EVENTS; Seq++) {
+    SEGGER_SYSVIEW_RecordU32x3(STRESS_EVENT_ID, Index, Seq, 0x12345678u);
+  }
+  __atomic_fetch_sub(&_NumRunning, 1, __ATOMIC_SEQ_CST);
+  return NULL;
+}
+
+static void _Drain(void) {
+  unsigned n;
+
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+    SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetShardChannelID(n), &_aShardStream[n], ~0u);
+  }
+}
+
+static void _cbWrite(void* pContext, const U8* pData, unsigned NumBytes) {
+  STREAM* pStream;
+
+  pStream = (STREAM*)pContext;
+  SEGGER_SYSVIEW_POSIX_ReserveStream(pStream, NumBytes);
+  memcpy(pStream->pData + pStream->Size, pData, NumBytes);
+  pStream->Size += NumBytes;
+}
+
+static int _Expand(void) {
+  STREAM   Expanded;
+  unsigned n;
+  int      r;
+
+  r = 0;
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+    memset(&Expanded, 0, sizeof(Expanded));
+    if (SYSVIEW_EXPAND_Run(_aShardStream[n].pData, (unsigned)_aShardStream[n].Size, _cbWrite, &Expanded, NULL) < 0) {
+      printf("Shard %u: corrupt stream\n", n);
+      r = 1;
+    }
+    free(_aShardStream[n].pData);
+    _aShardStream[n] = Expanded;
+  }
+  return r;
+}
+
+static int _Merge(void) {
+  SYSVIEW_MERGE_SHARD aShard[SEGGER_SYSVIEW_NUM_SHARDS];
+  SYSVIEW_MERGE_STATS Stats;
+  unsigned            n;
+  int                 r;
+
+  if (SEGGER_SYSVIEW_NUM_SHARDS == 1) {
+    _Stream = _aShardStream[0];
+    return 0;
+  }
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+    aShard[n].pData    = _aShardStream[n].pData;
+    aShard[n].NumBytes = (unsigned)_aShardStream[n].Size;
+  }
+  r = SYSVIEW_MERGE_Run(aShard, SEGGER_SYSVIEW_NUM_SHARDS, _cbWrite, &_Stream, &Stats);
+  printf("Merged %u shards: %u events, %u skipped before first sync\n",
+         SEGGER_SYSVIEW_NUM_SHARDS, Stats.NumEvents, Stats.NumSkipped);
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+    free(_aShardStream[n].pData);
+  }
+  return (r < 0 || Stats.NumSkipped) ? 1 : 0;
+}
+
+static int _SkipStr(const U8** ppData, const U8* pEnd) {
+  const U8* p;
+
+  p = *ppData;
+  if (p >= pEnd || *p >= 255 || (U32)(pEnd - p) <= *p) {
+    return -1;
+  }
+  *ppData = p + 1 + *p;
+  return 0;
+}
+
+static int _GetU32(const U8** ppData, const U8* pEnd, U32* pValue) {
+  const U8* p;
+  U32       v;
+  unsigned  Shift;
+
+  p     = *ppData;
+  v     = 0;
+  Shift = 0;
+  do {
+    if (p >= pEnd || Shift > 28) {
+      return -1;
+    }
+    v |= (U32)(*p & 0x7F) << Shift;
+    Shift += 7;
+  } while (*p++ & 0x80);
+  *ppData = p;
+  *pValue = v;
+  return 0;
+}
+
+/*********************************************************************
+*
+*       _Check()
+*
+*  Function description
+*    Parses the captured stream and checks it for consistency.
+*    Besides the stress events, only the packets sent by
+*    SEGGER_SYSVIEW_Start() and SEGGER_SYSVIEW_Stop() are expected.
+*
+*  Return value
+*    Number of errors found.
+*/
+static unsigned _Check(void) {
+  const U8* p;
+  const U8* pEnd;
+  const U8* pPayload;
+  U32       aLastSeq[NUM_PRODUCERS];
+  U32       Id;
+  U32       Len;
+  U32       Delta;
+  U32       Index;
+  U32       Seq;
+  U32       NumDropped;
+  U32       Dummy;
+  unsigned  NumEvents;
+  unsigned  NumOverflows;
+  unsigned  NumErrors;
+
+  memset(aLastSeq, 0, sizeof(aLastSeq));
+  NumEvents    = 0;
+  NumOverflows = 0;
+  NumDropped   = 0;
+  NumErrors    = 0;
+  p            = _Stream.pData;
+  pEnd         = _Stream.pData + _Stream.Size;
+  while (p < pEnd) {
+    if (*p == SYSVIEW_EVTID_NOP) {  // Sync, no time stamp
+      p++;
+      continue;
+    }
+    if (_GetU32(&p, pEnd, &Id)) {
+      goto Corrupt;
+    }
+    if (Id == SYSVIEW_EVTID_OVERFLOW) {
+      if (_GetU32(&p, pEnd, &Len)) {
+        goto Corrupt;
+      }
+      NumOverflows++;
+      NumDropped = Len;             // The drop count is cumulative
+    } else if (Id == STRESS_EVENT_ID) {
+      if (_GetU32(&p, pEnd, &Len) || (U32)(pEnd - p) < Len) {
+        goto Corrupt;
+      }
+      pPayload = p;
+      p       += Len;
+      if (_GetU32(&pPayload, p, &Index) || _GetU32(&pPayload, p, &Seq) || Index >= NUM_PRODUCERS) {
+        goto Corrupt;
+      }
+      if (Seq <= aLastSeq[Index]) {
+        printf("Producer %u: sequence %u after %u\n", Index, Seq, aLastSeq[Index]);
+        NumErrors++;
+      }
+      aLastSeq[Index] = Seq;
+      NumEvents++;
+    } else if (Id == SYSVIEW_EVTID_SYSTIME_US) {
+      if (_GetU32(&p, pEnd, &Dummy) || _GetU32(&p, pEnd, &Dummy)) {
+        goto Corrupt;
+      }
+    } else if (Id == SYSVIEW_EVTID_SYSDESC) {
+      if (_SkipStr(&p, pEnd)) {
+        goto Corrupt;
+      }
+    } else if (Id >= 24) {          // Init, number of modules, shard sync
+      if (_GetU32(&p, pEnd, &Len) || (U32)(pEnd - p) < Len) {
+        goto Corrupt;
+      }
+      p += Len;
+    } else if (Id != SYSVIEW_EVTID_TRACE_START && Id != SYSVIEW_EVTID_TRACE_STOP) {
+      goto Corrupt;
+    }
+    if (_GetU32(&p, pEnd, &Delta)) {
+      goto Corrupt;
+    }
+    if (Delta > MAX_DELTA) {
+      printf("Negative timestamp delta at offset %u\n", (unsigned)(p - _Stream.pData));
+      NumErrors++;
+    }
+  }
+  printf("%u events received, %u overflow packets, %u events dropped in total\n",
+         NumEvents, NumOverflows, NumDropped);
+  return NumErrors;
+Corrupt:
+  printf("Corrupt packet at offset %u\n", (unsigned)(p - _Stream.pData));
+  return NumErrors + 1;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  SEGGER_SYSVIEW_POSIX_LOCK_STATS_INFO LockStats;
+  pthread_t aThread[NUM_PRODUCERS];
+  U64       t;
+  unsigned  NumErrors;
+  U32       i;
+
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  _Drain();
+  _NumRunning = NUM_PRODUCERS;
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_PRODUCERS; i++) {
+    pthread_create(&aThread[i], NULL, _Producer, (void*)(PTR_ADDR)i);
+  }
+  while (__atomic_load_n(&_NumRunning, __ATOMIC_SEQ_CST) != 0) {
+    _Drain();
+  }
+  for (i = 0; i < NUM_PRODUCERS; i++) {
+    pthread_join(aThread[i], NULL);
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  SEGGER_SYSVIEW_Stop();
+  _Drain();
+  SEGGER_SYSVIEW_POSIX_GetLockStats(&LockStats);
+  printf("Config: USE_STATIC_BUFFER=%d USE_RESERVE_COMMIT=%d USE_IN_PLACE_ENCODING=%d NUM_SHARDS=%d USE_DELTA_OF_DELTA=%d, %d producers\n",
+         SEGGER_SYSVIEW_USE_STATIC_BUFFER, SEGGER_SYSVIEW_USE_RESERVE_COMMIT, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING,
+         SEGGER_SYSVIEW_NUM_SHARDS, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, NUM_PRODUCERS);
+  printf("%.1f ns/event wall time", (double)t / (NUM_PRODUCERS * NUM_EVENTS));
+  if (LockStats.NumLocks) {
+    printf(", lock held %.1f ns/event, %.1f ns/lock, max %u ns",
+           (double)LockStats.TotalNs / (NUM_PRODUCERS * NUM_EVENTS),
+           (double)LockStats.TotalNs / LockStats.NumLocks,
+           (unsigned)LockStats.MaxNs);
+  }
+  printf("\n");
+  NumErrors  = SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? _Expand() : 0;
+  NumErrors += _Merge();
+  NumErrors += _Check();
+  printf("%s\n\n", NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,238 @@
+/*
+ * Test of the context switch hook of the FreeRTOS sample on the POSIX
+ * host build.
+ *
+ * Tasks are created through traceTASK_CREATE() with TCBs which hold
+ * the fields used by the trace macros, the idle and timer service
+ * tasks among them, and a random sequence of task switches is traced
+ * with traceTASK_SWITCHED_IN(). The stream is decoded and each switch
+ * must be recorded as idle for the idle task and as the start of the
+ * task otherwise, and the idle task must not be sent with the task
+ * list. The time per switch is reported with the recording started
+ * and, to show the cost of the idle check, with the recording stopped.
+ * With SYSVIEW_FREERTOS_USE_TASK_FLAGS the idle task is found by the
+ * flags of the TCB, otherwise by the name.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_FreeRTOS.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_SWITCHES        100000u
+#define NUM_BENCH_SWITCHES  1000000u
+#define STACK_SIZE          0x400u
+
+//
+// The fields of the FreeRTOS TCB used by the trace macros. The
+// stack pointers are kept as U32, as the macros cast them to U32.
+//
+typedef struct {
+  U32         pxTopOfStack;
+  UBaseType_t uxPriority;
+  U32         pxStack;
+  char        pcTaskName[configMAX_TASK_NAME_LEN];
+  UBaseType_t uxTaskNumber;
+} TCB_t;
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  unsigned NumSwitches;
+  unsigned NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+extern const SEGGER_SYSVIEW_OS_API SYSVIEW_X_OS_TraceAPI;
+
+static const char* _asName[] = { "IDLE", "Tmr Svc", "Main", "Sensor", "Control", "Comm", "Log", "Display" };
+
+static TCB_t    _aTCB[SEGGER_COUNTOF(_asName)];     // In the low 4 GB, as the app is linked with -no-pie
+static TCB_t*   pxCurrentTCB;
+static U8       _aSwitch[NUM_SWITCHES];             // Index of the task switched to, in order
+static STREAM   _Stream;
+static U32      _Rand = 1;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/*********************************************************************
+*
+*       Kernel functions used by the sample
+*/
+TickType_t xTaskGetTickCountFromISR(void) {
+  return 0;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+  return ((TCB_t*)xTask)->pxTopOfStack - ((TCB_t*)xTask)->pxStack;
+}
+
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 8) % Range;
+}
+
+/*********************************************************************
+*
+*       _CreateTasks()
+*
+*  Function description
+*    Creates the tasks as the kernel does, with the name and stack
+*    set before traceTASK_CREATE().
+*/
+static void _CreateTasks(void) {
+  TCB_t*   pxNewTCB;
+  unsigned i;
+
+  for (i = 0; i < SEGGER_COUNTOF(_aTCB); i++) {
+    pxNewTCB               = &_aTCB[i];
+    pxNewTCB->pxStack      = 0x20200000u + i * STACK_SIZE;
+    pxNewTCB->pxTopOfStack = pxNewTCB->pxStack + STACK_SIZE - 0x40u;
+    pxNewTCB->uxPriority   = i;
+    strcpy(pxNewTCB->pcTaskName, _asName[i]);
+    traceTASK_CREATE(pxNewTCB);
+  }
+}
+
+/*********************************************************************
+*
+*       _Switch()
+*
+*  Function description
+*    Switches to a task, as vTaskSwitchContext().
+*/
+static void _Switch(unsigned Index) {
+  pxCurrentTCB = &_aTCB[Index];
+  traceTASK_SWITCHED_IN();
+}
+
+static void _Error(CHECK* pCheck, const char* sError, unsigned Info) {
+  if (pCheck->NumErrors++ < 4) {
+    printf(sError, Info);
+  }
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK*   pCheck;
+  unsigned Index;
+
+  pCheck = (CHECK*)pContext;
+  switch (pEvent->Id) {
+  case SYSVIEW_EVTID_TASK_INFO:
+    if (pEvent->aParam[0] == SEGGER_SYSVIEW_ShrinkTaskId((U32)(uintptr_t)&_aTCB[0])) {
+      _Error(pCheck, "Idle task 0x%X sent with the task list\n", pEvent->aParam[0]);
+    }
+    break;
+  case SYSVIEW_EVTID_IDLE:
+  case SYSVIEW_EVTID_TASK_START_EXEC:
+    if (pCheck->NumSwitches >= NUM_SWITCHES) {
+      _Error(pCheck, "Switch %u not traced\n", pCheck->NumSwitches);
+      break;
+    }
+    Index = _aSwitch[pCheck->NumSwitches];
+    if (Index == 0) {
+      if (pEvent->Id != SYSVIEW_EVTID_IDLE) {
+        _Error(pCheck, "Switch %u: Idle task not recorded as idle\n", pCheck->NumSwitches);
+      }
+    } else if (pEvent->Id != SYSVIEW_EVTID_TASK_START_EXEC || pEvent->aParam[0] != SEGGER_SYSVIEW_ShrinkTaskId((U32)(uintptr_t)&_aTCB[Index])) {
+      _Error(pCheck, "Switch %u: Wrong task\n", pCheck->NumSwitches);
+    }
+    pCheck->NumSwitches++;
+    break;
+  default:
+    break;
+  }
+}
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Traces NUM_BENCH_SWITCHES task switches, one of four to the idle
+*    task, and prints the time per switch.
+*/
+static void _Measure(const char* sWhat) {
+  U64      t;
+  unsigned i;
+
+  _Drain();
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_SWITCHES; i++) {
+    _Switch((i & 3u) ? 1u + (i % (SEGGER_COUNTOF(_aTCB) - 1u)) : 0u);
+    if ((i & 63u) == 63u) {
+      _Drain();
+    }
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  _Stream.Size = 0;
+  printf("traceTASK_SWITCHED_IN(), recording %-8s %6.2f ns/switch\n", sWhat, (double)t / NUM_BENCH_SWITCHES);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  static CHECK                  Check;
+  unsigned                      i;
+
+  SEGGER_SYSVIEW_Init(1000000000u, 1000000000u, &SYSVIEW_X_OS_TraceAPI, NULL);
+  SEGGER_SYSVIEW_SetRAMBase(0);
+  SEGGER_SYSVIEW_Start();
+  _CreateTasks();
+  for (i = 0; i < NUM_SWITCHES; i++) {
+    _aSwitch[i] = (U8)_GetRand(SEGGER_COUNTOF(_aTCB));
+    _Switch(_aSwitch[i]);
+    if ((i & 63u) == 63u) {
+      _Drain();
+    }
+  }
+  //
+  // Send the task list again, as when the host connects.
+  //
+  SEGGER_SYSVIEW_SendTaskList();
+  _Drain();
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  _Stream.Size = 0;
+  printf("Config: SYSVIEW_FREERTOS_USE_TASK_FLAGS=%d\n", SYSVIEW_FREERTOS_USE_TASK_FLAGS);
+  printf("%u switches traced\n", Check.NumSwitches);
+  _NumErrors += Check.NumErrors;
+  if (Check.NumSwitches != NUM_SWITCHES) {
+    printf("Expected %u switches\n", NUM_SWITCHES);
+    _NumErrors++;
+  }
+  if (SYSVIEW_GET_TASK_FLAGS(&_aTCB[0]) != SYSVIEW_FREERTOS_TASK_FLAG_IDLE
+   || SYSVIEW_GET_TASK_FLAGS(&_aTCB[1]) != SYSVIEW_FREERTOS_TASK_FLAG_TIMER
+   || SYSVIEW_GET_TASK_FLAGS(&_aTCB[2]) != 0u) {
+    printf("Wrong task flags\n");
+    _NumErrors++;
+  }
+  _Measure("started");
+  SEGGER_SYSVIEW_Stop();
+  _Measure("stopped");
+  printf("%s\n\n", _NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return _NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,292 @@
+/*
+ * Test of the task IDs sent to the host on the POSIX host build.
+ *
+ * A switch-heavy workload is recorded with task handles laid out as
+ * FreeRTOS TCBs in the OCRAM of the i.MX RT1170, with the RAM base of
+ * its SystemView configuration. Tasks are deleted and created while
+ * it runs, so task IDs are freed and reused. The stream is decoded
+ * and the task of every scheduler event, as named by the task info
+ * sent for its ID, must be the task the workload switched to. The
+ * stream bytes per task switch are reported. When
+ * SEGGER_SYSVIEW_NUM_TASK_IDS covers all tasks, the task IDs must be
+ * encoded in one byte.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_TASKS           12u
+#define NUM_SWITCHES        100000u
+#define RECREATE_PERIOD     1000u         // Switches between deleting and creating a task
+#define RAM_BASE            0x10000000u   // SYSVIEW_RAM_BASE of SEGGER_SYSVIEW_Config_FreeRTOS.c
+#define TCB_BASE            0x20200000u   // OCRAM
+#define TCB_SIZE            0x5Cu
+#define STACK_SIZE          0x400u
+#define TIME_STEP           600u          // Time stamp ticks per task switch
+#define MAX_HOST_TASKS      64u
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32 TaskId;                     // As passed to the recorder
+  U32 Serial;                     // Sent as priority, identifies the task on the host
+} TASK;
+
+typedef struct {
+  U32 Id;                         // As sent to the host
+  U32 Serial;
+  int IsLive;
+} HOST_TASK;
+
+typedef struct {
+  HOST_TASK aTask[MAX_HOST_TASKS];
+  unsigned  NumTasks;
+  unsigned  NumSwitches;          // SYSVIEW_EVTID_TASK_START_EXEC decoded
+  U64       NumSchedBytes;        // Bytes of the scheduler events
+  U32       MaxSchedId;           // Largest task ID of a scheduler event
+  unsigned  NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static STREAM   _Stream;
+static TASK     _aTask[NUM_TASKS];
+static U32      _aSwitchSerial[NUM_SWITCHES];     // Task switched to, in order
+static U32      _NextSerial;
+static U32      _NextTcb = TCB_BASE;
+static U32      _Rand    = 1;
+static U64      _Time;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static U32 _cbGetTimestamp(void) {
+  return (U32)_Time;
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+/*********************************************************************
+*
+*       _CreateTask()
+*
+*  Function description
+*    Creates a task at the next TCB address, as traceTASK_CREATE().
+*/
+static void _CreateTask(TASK* pTask) {
+  SEGGER_SYSVIEW_TASKINFO Info;
+
+  pTask->TaskId = _NextTcb;
+  pTask->Serial = ++_NextSerial;
+  _NextTcb     += TCB_SIZE + STACK_SIZE;
+  SEGGER_SYSVIEW_OnTaskCreate(pTask->TaskId);
+  memset(&Info, 0, sizeof(Info));
+  Info.TaskID    = pTask->TaskId;
+  Info.sName     = "Task";
+  Info.Prio      = pTask->Serial;
+  Info.StackBase = pTask->TaskId + TCB_SIZE;
+  Info.StackSize = STACK_SIZE;
+  SEGGER_SYSVIEW_SendTaskInfo(&Info);
+}
+
+/*********************************************************************
+*
+*       _Record()
+*
+*  Function description
+*    Records the workload: each switch readies a random task, blocks
+*    the running one and starts the new one.
+*/
+static void _Record(void) {
+  unsigned i;
+  unsigned Cur;
+  unsigned Next;
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    _CreateTask(&_aTask[i]);
+  }
+  Cur = 0;
+  for (i = 0; i < NUM_SWITCHES; i++) {
+    _Time += TIME_STEP;
+    if ((i % RECREATE_PERIOD) == RECREATE_PERIOD - 1) {
+      //
+      // Delete a task which is not running and create a new one in its place.
+      //
+      Next = (Cur + 1 + _GetRand(NUM_TASKS - 1)) % NUM_TASKS;
+      SEGGER_SYSVIEW_OnTaskTerminate(_aTask[Next].TaskId);
+      _CreateTask(&_aTask[Next]);
+    }
+    Next = _GetRand(NUM_TASKS);
+    SEGGER_SYSVIEW_OnTaskStartReady(_aTask[Next].TaskId);
+    SEGGER_SYSVIEW_OnTaskStopReady(_aTask[Cur].TaskId, 0);
+    SEGGER_SYSVIEW_OnTaskStartExec(_aTask[Next].TaskId);
+    _aSwitchSerial[i] = _aTask[Next].Serial;
+    Cur = Next;
+    if ((i & 15u) == 15u) {
+      _Drain();
+    }
+  }
+  _Drain();
+}
+
+/*********************************************************************
+*
+*       _FindHostTask()
+*
+*  Function description
+*    Returns the live task with an ID on the host, NULL if none.
+*/
+static HOST_TASK* _FindHostTask(CHECK* pCheck, U32 Id) {
+  unsigned i;
+
+  for (i = 0; i < pCheck->NumTasks; i++) {
+    if (pCheck->aTask[i].IsLive && pCheck->aTask[i].Id == Id) {
+      return &pCheck->aTask[i];
+    }
+  }
+  return NULL;
+}
+
+/*********************************************************************
+*
+*       _AddHostTask()
+*
+*  Function description
+*    Adds a live task, in the place of a terminated one if possible.
+*/
+static HOST_TASK* _AddHostTask(CHECK* pCheck, U32 Id) {
+  HOST_TASK* pTask;
+  unsigned   i;
+
+  pTask = NULL;
+  for (i = 0; i < pCheck->NumTasks; i++) {
+    if (pCheck->aTask[i].IsLive == 0) {
+      pTask = &pCheck->aTask[i];
+      break;
+    }
+  }
+  if (pTask == NULL) {
+    if (pCheck->NumTasks == MAX_HOST_TASKS) {
+      return NULL;
+    }
+    pTask = &pCheck->aTask[pCheck->NumTasks++];
+  }
+  pTask->Id     = Id;
+  pTask->IsLive = 1;
+  return pTask;
+}
+
+static void _Error(CHECK* pCheck, const char* sError, U32 Id, U32 Info) {
+  if (pCheck->NumErrors++ < 4) {
+    printf(sError, Id, Info);
+  }
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK*     pCheck;
+  HOST_TASK* pTask;
+  U32        Id;
+
+  pCheck = (CHECK*)pContext;
+  Id     = pEvent->aParam[0];
+  if (pEvent->Id == SYSVIEW_EVTID_TASK_TERMINATE) {
+    SYSVIEW_DECODE_GetU32s(pEvent, &Id, 1);       // Parameters of events >= 24 are not decoded
+  }
+  switch (pEvent->Id) {
+  case SYSVIEW_EVTID_TASK_CREATE:
+    if (_FindHostTask(pCheck, Id) != NULL) {
+      _Error(pCheck, "Task ID %u created twice in event %u\n", Id, pEvent->Id);
+    }
+    break;
+  case SYSVIEW_EVTID_TASK_INFO:
+    pTask = _FindHostTask(pCheck, Id);
+    if (pTask == NULL) {
+      pTask = _AddHostTask(pCheck, Id);
+    }
+    if (pTask == NULL) {
+      _Error(pCheck, "Task ID %u not stored in event %u\n", Id, pEvent->Id);
+      break;
+    }
+    pTask->Serial = pEvent->aParam[1];
+    break;
+  case SYSVIEW_EVTID_TASK_TERMINATE:
+    pTask = _FindHostTask(pCheck, Id);
+    if (pTask == NULL) {
+      _Error(pCheck, "Unknown task ID %u in event %u\n", Id, pEvent->Id);
+    } else {
+      pTask->IsLive = 0;
+    }
+    break;
+  case SYSVIEW_EVTID_TASK_START_READY:
+  case SYSVIEW_EVTID_TASK_STOP_READY:
+  case SYSVIEW_EVTID_TASK_START_EXEC:
+    pCheck->NumSchedBytes += pEvent->PacketSize;
+    if (Id > pCheck->MaxSchedId) {
+      pCheck->MaxSchedId = Id;
+    }
+    pTask = _FindHostTask(pCheck, Id);
+    if (pTask == NULL) {
+      _Error(pCheck, "Unknown task ID %u in event %u\n", Id, pEvent->Id);
+      break;
+    }
+    if (pEvent->Id == SYSVIEW_EVTID_TASK_START_EXEC) {
+      if (pCheck->NumSwitches >= NUM_SWITCHES || pTask->Serial != _aSwitchSerial[pCheck->NumSwitches]) {
+        _Error(pCheck, "Switch %u: Wrong task %u\n", pCheck->NumSwitches, pTask->Serial);
+      }
+      pCheck->NumSwitches++;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  static CHECK                  Check;
+
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_SetRAMBase(RAM_BASE);
+  SEGGER_SYSVIEW_Start();
+  _Record();
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  printf("Config: NUM_TASK_IDS=%d USE_IN_PLACE_ENCODING=%d\n", SEGGER_SYSVIEW_NUM_TASK_IDS, SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING);
+  printf("%u switches, largest task ID 0x%X, %.2f bytes/switch\n", Check.NumSwitches, Check.MaxSchedId, (double)Check.NumSchedBytes / NUM_SWITCHES);
+  _NumErrors += Check.NumErrors;
+  if (Check.NumSwitches != NUM_SWITCHES) {
+    printf("Expected %u switches\n", NUM_SWITCHES);
+    _NumErrors++;
+  }
+#if (SEGGER_SYSVIEW_NUM_TASK_IDS >= NUM_TASKS) && (SEGGER_SYSVIEW_NUM_TASK_IDS < 128)
+  if (Check.MaxSchedId > 0x7Fu) {
+    printf("Task IDs not encoded in one byte\n");
+    _NumErrors++;
+  }
+#endif
+  printf("%s\n\n", _NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return _NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,289 @@
+/*
+ * Test of the task list of the FreeRTOS sample on the POSIX host build.
+ *
+ * The FreeRTOS sample is built against stand-ins of the kernel headers
+ * in Sample/FreeRTOS. Hundreds of tasks are added, updated and deleted
+ * in random order, as by the trace hooks of the kernel, while a model
+ * keeps the tasks which fit into the list of the sample. The recording
+ * is then restarted, which sends the task list, and the stream must
+ * hold the task and stack information of exactly the tasks of the
+ * model, with their current priority and stack high water mark. The time per update, per
+ * delete and add and per task sent with the task list is reported.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_FreeRTOS.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_TASKS           400u
+#define NUM_OPS             100000u
+#define NUM_BENCH_OPS       1000000u
+#define TCB_BASE            0x20200000u
+#define TCB_SIZE            0x60u
+#define STACK_SIZE          0x400u
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  U32      xHandle;
+  unsigned Prio;
+  int      InList;                // Expected in the task list of the sample
+  char     acName[16];
+} TASK;
+
+typedef struct {
+  unsigned NumTaskInfos;
+  unsigned NumStackInfos;
+  unsigned NumErrors;
+} CHECK;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+extern const SEGGER_SYSVIEW_OS_API SYSVIEW_X_OS_TraceAPI;
+
+static STREAM   _Stream;
+static TASK     _aTask[NUM_TASKS];
+static unsigned _NumInList;
+static U32      _NextTcb = TCB_BASE;
+static U32      _NextSerial;
+static U32      _Rand    = 1;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/*********************************************************************
+*
+*       Kernel functions used by the sample
+*/
+TickType_t xTaskGetTickCountFromISR(void) {
+  return 0;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+  return (UBaseType_t)(((uintptr_t)xTask >> 3) & 0xFFu);
+}
+
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 8) % Range;
+}
+
+static U32 _GetHWM(U32 xHandle) {
+  return uxTaskGetStackHighWaterMark((TaskHandle_t)(uintptr_t)xHandle);
+}
+
+/*********************************************************************
+*
+*       _CreateTask()
+*
+*  Function description
+*    Creates a task at the next TCB address, which is spaced randomly,
+*    as traceTASK_CREATE(), and adds it to the model if it fits.
+*/
+static void _CreateTask(TASK* pTask) {
+  pTask->xHandle = _NextTcb;
+  pTask->Prio    = _GetRand(32);
+  _NextTcb      += TCB_SIZE + STACK_SIZE + 8u * _GetRand(64);
+  snprintf(pTask->acName, sizeof(pTask->acName), "Task%u", (unsigned)++_NextSerial);
+  pTask->InList  = (_NumInList < SYSVIEW_FREERTOS_MAX_NOF_TASKS);
+  _NumInList    += (unsigned)pTask->InList;
+  SEGGER_SYSVIEW_OnTaskCreate(pTask->xHandle);
+  SYSVIEW_AddTask(pTask->xHandle, pTask->acName, pTask->Prio, pTask->xHandle + TCB_SIZE, _GetHWM(pTask->xHandle));
+}
+
+/*********************************************************************
+*
+*       _UpdateTask()
+*
+*  Function description
+*    Changes the priority of a task, as traceTASK_PRIORITY_SET().
+*    A task which is not in the list is added if it fits by now.
+*/
+static void _UpdateTask(TASK* pTask) {
+  pTask->Prio = _GetRand(32);
+  if (pTask->InList == 0 && _NumInList < SYSVIEW_FREERTOS_MAX_NOF_TASKS) {
+    pTask->InList = 1;
+    _NumInList++;
+  }
+  SYSVIEW_UpdateTask(pTask->xHandle, pTask->acName, pTask->Prio, pTask->xHandle + TCB_SIZE, _GetHWM(pTask->xHandle));
+}
+
+/*********************************************************************
+*
+*       _DeleteTask()
+*
+*  Function description
+*    Deletes a task, as traceTASK_DELETE().
+*/
+static void _DeleteTask(TASK* pTask) {
+  SEGGER_SYSVIEW_OnTaskTerminate(pTask->xHandle);
+  SYSVIEW_DeleteTask(pTask->xHandle);
+  _NumInList   -= (unsigned)pTask->InList;
+  pTask->InList = 0;
+}
+
+static TASK* _FindTask(U32 Id) {
+  unsigned i;
+
+  for (i = 0; i < NUM_TASKS; i++) {
+    if (SEGGER_SYSVIEW_ShrinkTaskId(_aTask[i].xHandle) == Id) {
+      return &_aTask[i];
+    }
+  }
+  return NULL;
+}
+
+static void _Error(CHECK* pCheck, const char* sError, U32 Id) {
+  if (pCheck->NumErrors++ < 4) {
+    printf(sError, Id);
+  }
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK* pCheck;
+  TASK*  pTask;
+
+  pCheck = (CHECK*)pContext;
+  if (pEvent->Id != SYSVIEW_EVTID_TASK_INFO && pEvent->Id != SYSVIEW_EVTID_STACK_INFO) {
+    return;
+  }
+  pTask = _FindTask(pEvent->aParam[0]);
+  if (pTask == NULL || pTask->InList == 0) {
+    _Error(pCheck, "Task ID 0x%X sent, but not in the list\n", pEvent->aParam[0]);
+    return;
+  }
+  if (pEvent->Id == SYSVIEW_EVTID_TASK_INFO) {
+    pCheck->NumTaskInfos++;
+    if (pEvent->aParam[1] != pTask->Prio) {
+      _Error(pCheck, "Task ID 0x%X: Wrong priority\n", pEvent->aParam[0]);
+    }
+  } else {
+    pCheck->NumStackInfos++;
+    if (pEvent->aParam[1] != pTask->xHandle + TCB_SIZE || pEvent->aParam[2] != _GetHWM(pTask->xHandle)) {
+      _Error(pCheck, "Task ID 0x%X: Wrong stack information\n", pEvent->aParam[0]);
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _Check()
+*
+*  Function description
+*    Restarts the recording, which sends the task list as when the
+*    host connects, and compares it with the model.
+*/
+static void _Check(void) {
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  CHECK                         Check;
+
+  SEGGER_SYSVIEW_Stop();
+  _Drain();
+  _Stream.Size = 0;
+  SEGGER_SYSVIEW_Start();
+  _Drain();
+  memset(&Check, 0, sizeof(Check));
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  printf("%u tasks, %u in the list, %u sent\n", NUM_TASKS, _NumInList, Check.NumTaskInfos);
+  //
+  // Each task is sent once, so all tasks of the model are sent if the counts match.
+  //
+  if (Check.NumTaskInfos != _NumInList || Check.NumStackInfos != _NumInList) {
+    printf("Expected %u tasks\n", _NumInList);
+    _NumErrors++;
+  }
+  _NumErrors += Check.NumErrors;
+}
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Measures the list operations with the recording stopped, so
+*    only the list of the sample is measured.
+*/
+static void _Measure(void) {
+  TASK*    pTask;
+  U64      t;
+  unsigned NumSent;
+  unsigned i;
+
+  SEGGER_SYSVIEW_Stop();
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_OPS; i++) {
+    pTask = &_aTask[_GetRand(NUM_TASKS)];
+    SYSVIEW_UpdateTask(pTask->xHandle, pTask->acName, pTask->Prio, pTask->xHandle + TCB_SIZE, 0);
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("Update          %6.2f ns/op\n", (double)t / NUM_BENCH_OPS);
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_OPS; i++) {
+    pTask = &_aTask[_GetRand(NUM_TASKS)];
+    SYSVIEW_DeleteTask(pTask->xHandle);
+    SYSVIEW_AddTask(pTask->xHandle, pTask->acName, pTask->Prio, pTask->xHandle + TCB_SIZE, 0);
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("Delete and add  %6.2f ns/op\n", (double)t / NUM_BENCH_OPS);
+  NumSent = 0;
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_OPS / NUM_TASKS; i++) {
+    SEGGER_SYSVIEW_SendTaskList();
+    NumSent += _NumInList;
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("Task list       %6.2f ns/task\n", (double)t / NumSent);
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  TASK*    pTask;
+  unsigned i;
+
+  SEGGER_SYSVIEW_Init(1000000000u, 1000000000u, &SYSVIEW_X_OS_TraceAPI, NULL);
+  SEGGER_SYSVIEW_SetRAMBase(0);
+  SEGGER_SYSVIEW_Start();
+  for (i = 0; i < NUM_TASKS; i++) {
+    _CreateTask(&_aTask[i]);
+    _Drain();
+  }
+  for (i = 0; i < NUM_OPS; i++) {
+    pTask = &_aTask[_GetRand(NUM_TASKS)];
+    if (_GetRand(2)) {
+      _UpdateTask(pTask);
+    } else {
+      _DeleteTask(pTask);
+      _CreateTask(pTask);
+    }
+    _Drain();
+    _Stream.Size = 0;
+  }
+  printf("Config: SYSVIEW_FREERTOS_MAX_NOF_TASKS=%d\n", SYSVIEW_FREERTOS_MAX_NOF_TASKS);
+  _Check();
+  _Measure();
+  printf("%s\n\n", _NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return _NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
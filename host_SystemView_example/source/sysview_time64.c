@@ -0,0 +1,272 @@
+/*
+ * Test of the 64-bit extended timestamp on the POSIX host build.
+ *
+ * Events are recorded against a simulated 1 GHz 32-bit cycle counter,
+ * as the DWT cycle counter of the i.MX RT1170 CM7, which wraps every
+ * 4.3 s. Bursts of events alternate with idle phases of about 10 s,
+ * in which only a 10 Hz tick calls SEGGER_SYSVIEW_UpdateTime64(). On
+ * each tick SEGGER_SYSVIEW_GetTime64() and SEGGER_SYSVIEW_GetTimeUs()
+ * must return the simulated time, also when an interrupt which counts
+ * a wrap preempts them between reading the wrap count and the counter.
+ * The stream is decoded and the time of every event, as summed up from
+ * the timestamp deltas, must equal the simulated time scaled by
+ * SEGGER_SYSVIEW_TIMESTAMP_SHIFT, so no wrap is lost in the idle phases.
+ * SYSTIME_CYCLES events must carry the counter at their time, and
+ * SYSTIME_US events, which get the time from SEGGER_SYSVIEW_GetTimeUs(),
+ * the simulated time in micro seconds. The time per call is reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Decode.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_ROUNDS          30u
+#define EVENTS_PER_ROUND    2000u
+#define NUM_EVENTS          (NUM_ROUNDS * EVENTS_PER_ROUND)
+#define NUM_BENCH_CALLS     10000000u
+#define TEST_EVENT_ID       (32u + 41u)
+#define START_TIME          0xF0000000u   // Wraps around after about 270 ms
+#define TICK_PERIOD         100000000u    // 10 Hz at 1 GHz
+#define IDLE_TICKS          100u          // Ticks of each idle phase
+#define PREEMPT_PERIOD      7u            // Ticks between preempted reads of the time
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+typedef struct {
+  unsigned NumEvents;
+  unsigned NumSystimeUs;
+  unsigned NumSystimeCycles;
+  unsigned NumErrors;
+} CHECK;
+
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const SEGGER_SYSVIEW_OS_API _OSAPI = { SEGGER_SYSVIEW_GetTimeUs, NULL };
+
+static U64      _Time = START_TIME;
+static U64      _aTime[NUM_EVENTS];               // Time of each test event
+static U64      _aSystimeUs[NUM_ROUNDS + 1];      // Time in micro seconds of each SYSTIME_US event
+static unsigned _NumSystimeUs;
+static int      _Preempt;                         // 1: The next read of the counter is preempted by an interrupt
+static STREAM   _Stream;
+static U32      _Rand = 1;
+static unsigned _NumErrors;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Stream, ~0u);
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+/*********************************************************************
+*
+*       _cbGetTimestamp()
+*
+*  Function description
+*    Returns the simulated counter. When _Preempt is set, an interrupt
+*    first runs the counter to its next half wrap and counts it with
+*    SEGGER_SYSVIEW_UpdateTime64().
+*/
+static U32 _cbGetTimestamp(void) {
+  if (_Preempt) {
+    _Preempt = 0;
+    _Time    = (_Time | 0x7FFFFFFFu) + 1u;
+    SEGGER_SYSVIEW_UpdateTime64();
+  }
+  return (U32)_Time;
+}
+
+/*********************************************************************
+*
+*       _Tick()
+*
+*  Function description
+*    Runs the system tick, as traceTASK_INCREMENT_TICK(), and checks
+*    the extended time.
+*/
+static void _Tick(unsigned TickCnt) {
+  U64 Time64;
+
+  SEGGER_SYSVIEW_UpdateTime64();
+  if ((TickCnt % PREEMPT_PERIOD) == PREEMPT_PERIOD - 1u) {
+    _Preempt = 1;
+  }
+  Time64 = SEGGER_SYSVIEW_GetTime64();
+  if (Time64 != _Time && _NumErrors++ < 4) {
+    printf("Tick %u: Time 0x%llX, expected 0x%llX\n", TickCnt, (unsigned long long)Time64, (unsigned long long)_Time);
+  }
+  if (SEGGER_SYSVIEW_GetTimeUs() != _Time / 1000u && _NumErrors++ < 4) {
+    printf("Tick %u: Wrong time in micro seconds\n", TickCnt);
+  }
+}
+
+/*********************************************************************
+*
+*       _Record()
+*
+*  Function description
+*    Records bursts of test events, the payload is the event index,
+*    each followed by an idle phase and a SYSTIME_US event.
+*/
+static void _Record(void) {
+  unsigned Round;
+  unsigned TickCnt;
+  unsigned i;
+  unsigned n;
+
+  n       = 0;
+  TickCnt = 0;
+  for (Round = 0; Round < NUM_ROUNDS; Round++) {
+    for (i = 0; i < EVENTS_PER_ROUND; i++) {
+      _Time    += 200u + _GetRand(400);
+      _aTime[n] = _Time;
+      SEGGER_SYSVIEW_RecordU32(TEST_EVENT_ID, n);
+      n++;
+      if ((n & 63u) == 0u) {
+        _Drain();
+      }
+    }
+    for (i = 0; i < IDLE_TICKS; i++) {
+      _Time += TICK_PERIOD + _GetRand(1000);
+      _Tick(TickCnt++);
+      _Drain();
+    }
+    _aSystimeUs[_NumSystimeUs++] = _Time / 1000u;
+    SEGGER_SYSVIEW_RecordSystime();
+  }
+  _Drain();
+}
+
+static void _Error(CHECK* pCheck, const char* sError, unsigned Index) {
+  if (pCheck->NumErrors++ < 4) {
+    printf(sError, Index);
+  }
+}
+
+static void _cbOnEvent(void* pContext, const SYSVIEW_DECODE_EVENT* pEvent) {
+  CHECK* pCheck;
+  U32    Index;
+  U64    Time;
+
+  pCheck = (CHECK*)pContext;
+  Time   = ((U64)START_TIME >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT) + pEvent->Time;   // Recording is started at START_TIME
+  switch (pEvent->Id) {
+  case TEST_EVENT_ID:
+    SYSVIEW_DECODE_GetU32s(pEvent, &Index, 1);                // Parameters of events >= 24 are not decoded
+    if (Index != pCheck->NumEvents) {
+      _Error(pCheck, "Event %u: Wrong index\n", pCheck->NumEvents);
+    } else if (Time != _aTime[Index] >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT) {
+      _Error(pCheck, "Event %u: Wrong time\n", Index);
+    }
+    pCheck->NumEvents++;
+    break;
+  case SYSVIEW_EVTID_SYSTIME_CYCLES:
+    if (pEvent->aParam[0] != (U32)(Time & (0xFFFFFFFFu >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT))) {
+      _Error(pCheck, "SYSTIME_CYCLES %u: Wrong counter\n", pCheck->NumSystimeCycles);
+    }
+    pCheck->NumSystimeCycles++;
+    break;
+  case SYSVIEW_EVTID_SYSTIME_US:
+    if (pCheck->NumSystimeUs >= _NumSystimeUs
+     || (pEvent->aParam[0] | ((U64)pEvent->aParam[1] << 32)) != _aSystimeUs[pCheck->NumSystimeUs]) {
+      _Error(pCheck, "SYSTIME_US %u: Wrong time\n", pCheck->NumSystimeUs);
+    }
+    pCheck->NumSystimeUs++;
+    break;
+  default:
+    break;
+  }
+}
+
+/*********************************************************************
+*
+*       _Measure()
+*
+*  Function description
+*    Measures the time functions against the simulated counter.
+*/
+static void _Measure(void) {
+  volatile U64 Sum;
+  U64          t;
+  unsigned     i;
+
+  Sum = 0;
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_CALLS; i++) {
+    _Time += 1000u;
+    Sum   += SEGGER_SYSVIEW_GetTime64();
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("SEGGER_SYSVIEW_GetTime64()    %6.2f ns/call\n", (double)t / NUM_BENCH_CALLS);
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_CALLS; i++) {
+    _Time += 1000u;
+    Sum   += SEGGER_SYSVIEW_GetTimeUs();
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("SEGGER_SYSVIEW_GetTimeUs()    %6.2f ns/call\n", (double)t / NUM_BENCH_CALLS);
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs();
+  for (i = 0; i < NUM_BENCH_CALLS; i++) {
+    _Time += 1000u;
+    SEGGER_SYSVIEW_UpdateTime64();
+  }
+  t = SEGGER_SYSVIEW_POSIX_GetTimeNs() - t;
+  printf("SEGGER_SYSVIEW_UpdateTime64() %6.2f ns/call, recording stopped\n", (double)t / NUM_BENCH_CALLS);
+  (void)Sum;
+}
+#endif
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+  static SYSVIEW_DECODE_CONTEXT Decode;
+  static CHECK                  Check;
+
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Init(1000000000u, 1000000000u, &_OSAPI, NULL);
+  _aSystimeUs[_NumSystimeUs++] = _Time / 1000u;   // Sent on start
+  SEGGER_SYSVIEW_Start();
+  _Record();
+  SEGGER_SYSVIEW_Stop();
+  _Drain();
+  SYSVIEW_DECODE_Init(&Decode, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA ? SYSVIEW_DECODE_FLAG_DELTA_OF_DELTA : 0, _cbOnEvent, &Check);
+  SYSVIEW_DECODE_Feed(&Decode, _Stream.pData, (unsigned)_Stream.Size);
+  printf("Config: TIMESTAMP_SHIFT=%d USE_DELTA_OF_DELTA=%d\n", SEGGER_SYSVIEW_TIMESTAMP_SHIFT, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA);
+  printf("%u events over %u wraps, %u SYSTIME_CYCLES, %u SYSTIME_US\n",
+         Check.NumEvents, (unsigned)(_Time >> 32), Check.NumSystimeCycles, Check.NumSystimeUs);
+  _NumErrors += Check.NumErrors;
+  if (Check.NumEvents != NUM_EVENTS || Check.NumSystimeUs != _NumSystimeUs) {
+    printf("Expected %u events and %u SYSTIME_US\n", NUM_EVENTS, _NumSystimeUs);
+    _NumErrors++;
+  }
+  if (Check.NumSystimeCycles < NUM_ROUNDS) {
+    printf("Expected SYSTIME_CYCLES in each idle phase\n");
+    _NumErrors++;
+  }
+  _Measure();
+  printf("%s\n\n", _NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Stream);
+  return _NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+#else
+  printf("SEGGER_SYSVIEW_USE_TIME64 is 0\n");
+  return EXIT_SUCCESS;
+#endif
+}
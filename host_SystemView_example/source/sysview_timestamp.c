@@ -0,0 +1,234 @@
+/*
+ * Round-trip test of the timestamp encoding on the POSIX host build.
+ *
+ * Events are recorded against a simulated 1 GHz cycle counter, as on a
+ * Cortex-M7 with the DWT cycle counter: a 10 kHz loop with a few cycles of
+ * jitter, in the "mixed" workload (default) each period followed by up to
+ * 3 events a few hundred cycles apart, in the "periodic" workload not.
+ * The counter starts shortly before it wraps around.
+ * The stream is decoded, expanded first with SEGGER_SYSVIEW_USE_DELTA_OF_DELTA,
+ * and the absolute time of every event must equal the simulated time scaled
+ * by SEGGER_SYSVIEW_TIMESTAMP_SHIFT. The timestamp bytes per event are reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_SYSVIEW_POSIX.h"
+#include "SYSVIEW_Expand.h"
+#include "SYSVIEW_Packet.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_EVENTS          200000
+#define TEST_EVENT_ID       (32u + 41u)
+#define START_TIME          0xFFF00000u   // Wraps around after about 1 ms
+#define PERIOD              100000u       // 10 kHz at 1 GHz
+
+typedef SEGGER_SYSVIEW_POSIX_STREAM STREAM;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U64    _Time;
+static U64    _aTime[NUM_EVENTS];     // Time of each event since SEGGER_SYSVIEW_Conf()
+static STREAM _Raw;                   // Stream as recorded
+static STREAM _Expanded;              // Stream with plain timestamp deltas
+static U32    _Rand = 1;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static U32 _cbGetTimestamp(void) {
+  return (U32)_Time;
+}
+
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+static void _cbWrite(void* pContext, const U8* pData, unsigned NumBytes) {
+  STREAM* pStream;
+
+  pStream = (STREAM*)pContext;
+  SEGGER_SYSVIEW_POSIX_ReserveStream(pStream, NumBytes);
+  memcpy(pStream->pData + pStream->Size, pData, NumBytes);
+  pStream->Size += NumBytes;
+}
+
+static void _Drain(void) {
+  SEGGER_SYSVIEW_POSIX_DrainUp(SEGGER_SYSVIEW_GetChannelID(), &_Raw, ~0u);
+}
+
+/*********************************************************************
+*
+*       _Record()
+*
+*  Function description
+*    Records NUM_EVENTS test events, the payload is the event index.
+*/
+static void _Record(unsigned MaxEventsPerPeriod) {
+  U64 PeriodStart;
+  U32 i;
+  int n;
+
+  PeriodStart = _Time;
+  i = 0;
+  while (i < NUM_EVENTS) {
+    PeriodStart += PERIOD + _GetRand(32);
+    _Time        = PeriodStart;
+    n            = 1 + (int)_GetRand(MaxEventsPerPeriod);
+    while (n-- && i < NUM_EVENTS) {
+      _aTime[i] = _Time - START_TIME;
+      SEGGER_SYSVIEW_RecordU32(TEST_EVENT_ID, i);
+      _Drain();
+      _Time += 400 + _GetRand(64);
+      i++;
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       _CountTimestampBytes()
+*
+*  Function description
+*    Returns the number of bytes taken by the timestamps of the test
+*    events in the recorded stream.
+*/
+static U32 _CountTimestampBytes(void) {
+  const U8* p;
+  const U8* pEnd;
+  const U8* pDelta;
+  U32       Id;
+  U32       v;
+  U32       NumBytes;
+
+  NumBytes = 0;
+  p        = _Raw.pData;
+  pEnd     = _Raw.pData + _Raw.Size;
+  while (p < pEnd) {
+    if (*p == SYSVIEW_EVTID_NOP) {
+      p++;
+      continue;
+    }
+    if (SYSVIEW_PACKET_Parse(p, pEnd, &Id, &pDelta) <= 0) {
+      break;
+    }
+    p = SYSVIEW_PACKET_DecodeU32(pDelta, pEnd, &v);
+    if (p == NULL) {
+      break;
+    }
+    if (Id == TEST_EVENT_ID) {
+      NumBytes += (U32)(p - pDelta);
+    }
+  }
+  return NumBytes;
+}
+
+/*********************************************************************
+*
+*       _Check()
+*
+*  Function description
+*    Decodes the expanded stream and checks the absolute time of
+*    every test event.
+*
+*  Return value
+*    Number of errors found.
+*/
+static unsigned _Check(void) {
+  const U8* p;
+  const U8* pEnd;
+  const U8* pDelta;
+  const U8* pPayload;
+  U64       Time;
+  U32       Id;
+  U32       Len;
+  U32       Index;
+  U32       Delta;
+  U32       NumEvents;
+  unsigned  NumErrors;
+
+  Time      = 0;
+  NumEvents = 0;
+  NumErrors = 0;
+  p         = _Expanded.pData;
+  pEnd      = _Expanded.pData + _Expanded.Size;
+  while (p < pEnd) {
+    if (*p == SYSVIEW_EVTID_NOP) {
+      p++;
+      continue;
+    }
+    if (SYSVIEW_PACKET_Parse(p, pEnd, &Id, &pDelta) <= 0) {
+      goto Corrupt;
+    }
+    pPayload = SYSVIEW_PACKET_DecodeU32(p, pDelta, &Id);
+    p        = SYSVIEW_PACKET_DecodeU32(pDelta, pEnd, &Delta);
+    if (p == NULL) {
+      goto Corrupt;
+    }
+    Time += Delta;
+    if (Id == TEST_EVENT_ID) {
+      pPayload = SYSVIEW_PACKET_DecodeU32(pPayload, pDelta, &Len);
+      if (pPayload == NULL || SYSVIEW_PACKET_DecodeU32(pPayload, pDelta, &Index) == NULL || Index != NumEvents) {
+        goto Corrupt;
+      }
+      if (Time != (_aTime[Index] >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT) && NumErrors++ < 10) {
+        printf("Event %u: time %llu, expected %llu\n", Index,
+               (unsigned long long)Time, (unsigned long long)(_aTime[Index] >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT));
+      }
+      NumEvents++;
+    }
+  }
+  if (NumEvents != NUM_EVENTS) {
+    printf("%u of %u events received\n", NumEvents, NUM_EVENTS);
+    NumErrors++;
+  }
+  return NumErrors;
+Corrupt:
+  printf("Corrupt packet at offset %u\n", (unsigned)(p - _Expanded.pData));
+  return NumErrors + 1;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(int argc, char** argv) {
+  const char* sWorkload;
+  unsigned    NumErrors;
+  U32         NumTimestampBytes;
+
+  _Time = START_TIME;
+  SEGGER_SYSVIEW_POSIX_SetTimestampFunc(_cbGetTimestamp);
+  SEGGER_SYSVIEW_Conf();
+  SEGGER_SYSVIEW_Start();
+  sWorkload = (argc > 1) ? argv[1] : "mixed";
+  _Record(strcmp(sWorkload, "periodic") == 0 ? 1u : 4u);
+  SEGGER_SYSVIEW_Stop();
+  _Drain();
+  NumErrors = 0;
+  if (SEGGER_SYSVIEW_USE_DELTA_OF_DELTA) {
+    if (SYSVIEW_EXPAND_Run(_Raw.pData, (unsigned)_Raw.Size, _cbWrite, &_Expanded, NULL) < 0) {
+      printf("Expanding stream failed\n");
+      NumErrors++;
+    }
+  } else {
+    _cbWrite(&_Expanded, _Raw.pData, (unsigned)_Raw.Size);
+  }
+  NumErrors        += _Check();
+  NumTimestampBytes = _CountTimestampBytes();
+  printf("Config: TIMESTAMP_SHIFT=%d USE_DELTA_OF_DELTA=%d POST_MORTEM_MODE=%d\n",
+         SEGGER_SYSVIEW_TIMESTAMP_SHIFT, SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, SEGGER_SYSVIEW_POST_MORTEM_MODE);
+  printf("%-8s %u bytes recorded, %.2f timestamp bytes/event\n",
+         sWorkload, (unsigned)_Raw.Size, (double)NumTimestampBytes / NUM_EVENTS);
+  printf("%s\n\n", NumErrors ? "FAILED" : "OK");
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Raw);
+  SEGGER_SYSVIEW_POSIX_FreeStream(&_Expanded);
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
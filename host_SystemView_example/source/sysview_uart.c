@@ -0,0 +1,177 @@
+/*
+ * Test of the SystemView UART transport (Rec/segger_uart_core.c) against a
+ * simulated UART on the POSIX host build.
+ *
+ * Packets of pseudo-random size are written to the SystemView RTT up-channel
+ * while the simulated line sends one byte per byte time. The transport is run
+ * with the hardware models of the board layers:
+ *   char  - one interrupt per character, as the former Rec/segger_uart.c
+ *   fifo  - Tx FIFO refilled with up to 3 characters per interrupt (RT1170 LPUART)
+ *   dma   - one interrupt per transfer (F413 DMA)
+ *   busy  - as dma, but one in 8 transfers cannot be started, as when the
+ *           DMA is not ready after an error, and is retried by the next kick
+ * The bytes received on the line must be the <Hello> message followed by
+ * exactly the packets accepted by the up-buffer. Interrupts per KB are reported.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "SEGGER_SYSVIEW.h"
+#include "segger_uart_core.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_PACKETS         200000
+#define HELLO_SIZE          4
+
+typedef struct {
+  const char* sName;
+  unsigned    MaxXferSize;      // Passed to SEGGER_UART_CORE_Init()
+  unsigned    BytesPerIrq;      // Characters moved per interrupt, 0: whole transfer (DMA)
+  unsigned    FailOneIn;        // One in FailOneIn transfers cannot be started, 0: All start
+} UART_MODEL;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const UART_MODEL _aModel[] = {
+  { "char",   1, 1, 0 },
+  { "fifo",  64, 3, 0 },
+  { "dma",  256, 0, 0 },
+  { "busy", 256, 0, 8 },
+};
+
+static struct {
+  const UART_MODEL* pModel;
+  const U8*         pData;      // Transfer in progress
+  unsigned          NumBytes;
+  unsigned          NumBytesSinceIrq;
+  U32               NumIrqs;
+  U32               NumFailed;  // Transfers which could not be started
+  U8*               pRx;        // Bytes received on the line
+  size_t            NumBytesRx;
+} _Sim;
+
+static U8*    _pExpected;
+static size_t _NumBytesExpected;
+static U32    _Rand = 1;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+/*
+ * Hardware layer of the simulated UART: the transfer is sent by _RunLine().
+ * Starting it takes the first interrupt in the char and fifo models,
+ * as the Tx interrupt is pending as soon as it is enabled.
+ */
+static int _StartTx(const U8* pData, unsigned NumBytes) {
+  if (_Sim.pModel->FailOneIn && _GetRand(_Sim.pModel->FailOneIn) == 0) {
+    _Sim.NumFailed++;
+    return -1;
+  }
+  _Sim.pData            = pData;
+  _Sim.NumBytes         = NumBytes;
+  _Sim.NumBytesSinceIrq = 0;
+  return 0;
+}
+
+/*
+ * Runs the line for NumByteTimes byte times or until it is idle.
+ */
+static void _RunLine(unsigned NumByteTimes) {
+  unsigned BytesPerIrq;
+
+  BytesPerIrq = _Sim.pModel->BytesPerIrq;
+  while (NumByteTimes-- && _Sim.NumBytes) {
+    if (BytesPerIrq && (_Sim.NumBytesSinceIrq % BytesPerIrq) == 0) {
+      _Sim.NumIrqs++;                   // Refill data register or FIFO
+    }
+    _Sim.pRx[_Sim.NumBytesRx++] = *_Sim.pData++;
+    _Sim.NumBytesSinceIrq++;
+    if (--_Sim.NumBytes == 0) {
+      if (BytesPerIrq == 0) {
+        _Sim.NumIrqs++;                 // DMA transfer complete
+      }
+      SEGGER_UART_CORE_OnTxDone();
+    }
+  }
+}
+
+static int _Run(const UART_MODEL* pModel) {
+  U8       acPacket[32];
+  unsigned NumBytes;
+  unsigned NumDropped;
+  unsigned NumKicks;
+  unsigned i;
+  unsigned j;
+
+  memset(&_Sim, 0, sizeof(_Sim));
+  _Sim.pModel       = pModel;
+  _Sim.pRx          = malloc(HELLO_SIZE + (size_t)NUM_PACKETS * sizeof(acPacket));
+  _pExpected        = malloc((size_t)NUM_PACKETS * sizeof(acPacket));
+  _NumBytesExpected = 0;
+  NumDropped        = 0;
+  SEGGER_UART_CORE_Init(pModel->MaxXferSize, _StartTx);
+  for (i = 0; i < NUM_PACKETS; i++) {
+    NumBytes = 3 + _GetRand(sizeof(acPacket) - 3);
+    for (j = 0; j < NumBytes; j++) {
+      acPacket[j] = (U8)(i + j);
+    }
+    SEGGER_RTT_LOCK();
+    if (SEGGER_RTT_WriteSkipNoLock(SEGGER_SYSVIEW_GetChannelID(), acPacket, NumBytes)) {
+      memcpy(_pExpected + _NumBytesExpected, acPacket, NumBytes);
+      _NumBytesExpected += NumBytes;
+    } else {
+      NumDropped++;
+    }
+    SEGGER_UART_CORE_Kick();                      // SEGGER_SYSVIEW_ON_EVENT_RECORDED() on target
+    SEGGER_RTT_UNLOCK();
+    _RunLine(_GetRand(sizeof(acPacket)));       // Line runs slightly slower than packets are produced, so some are dropped
+  }
+  _RunLine((unsigned)-1);
+  for (NumKicks = 0; NumKicks < 1000 && _Sim.NumBytesRx < HELLO_SIZE + _NumBytesExpected; NumKicks++) {
+    SEGGER_UART_CORE_Kick();                      // Retry a transfer which could not be started
+    _RunLine((unsigned)-1);
+  }
+  printf("%-6s %8u bytes, %8u interrupts, %7.1f interrupts/KB, %u of %u packets dropped, %u transfers not started\n",
+         pModel->sName, (unsigned)_Sim.NumBytesRx, _Sim.NumIrqs, _Sim.NumIrqs * 1024.0 / _Sim.NumBytesRx,
+         NumDropped, NUM_PACKETS, _Sim.NumFailed);
+  if (_Sim.NumBytesRx != HELLO_SIZE + _NumBytesExpected
+   || memcmp(_Sim.pRx, "SV", 2) != 0
+   || memcmp(_Sim.pRx + HELLO_SIZE, _pExpected, _NumBytesExpected) != 0) {
+    printf("FAILED: received stream differs from the packets written\n");
+    return -1;
+  }
+  free(_Sim.pRx);
+  free(_pExpected);
+  return 0;
+}
+
+/*!
+ * @brief Application entry point.
+ */
+int main(void) {
+  unsigned i;
+  int      r;
+
+  SEGGER_SYSVIEW_Conf();
+  if (SEGGER_SYSVIEW_GetChannelID() != 1) {     // The transport sends RTT channel 1
+    printf("FAILED: SystemView uses RTT channel %d\n", SEGGER_SYSVIEW_GetChannelID());
+    return EXIT_FAILURE;
+  }
+  r = 0;
+  for (i = 0; i < sizeof(_aModel) / sizeof(_aModel[0]); i++) {
+    r |= _Run(&_aModel[i]);
+  }
+  printf("%s\n", r ? "FAILED" : "OK");
+  return r ? EXIT_FAILURE : EXIT_SUCCESS;
+}
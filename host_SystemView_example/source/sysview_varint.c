@@ -0,0 +1,184 @@
+/*
+ * Fuzz test of the bulk varint decoding kernels on the POSIX host build.
+ *
+ * Random buffers are decoded by every kernel the CPU supports and the
+ * result must equal the one of the bytewise reference SYSVIEW_VARINT_DecodeU32sRef():
+ * the number of values, the values and the end of the decoded data.
+ * The buffers hold values of 1 to 5 bytes in runs of equal and of mixed
+ * sizes, runs of continuation bytes as in corrupt data, and random bytes.
+ * They are cut at a random position and decoded with a random number of
+ * values, once without and once with readable bytes after their end,
+ * which must not be decoded.
+ *
+ * Usage: sysview_varint [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SYSVIEW_Packet.h"
+#include "SYSVIEW_Varint.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NUM_ITERATIONS      200000
+#define MAX_BUFFER_SIZE     256
+#define MAX_VALUES          (MAX_BUFFER_SIZE + 8)
+#define PAD_SIZE            32            // Readable bytes after the end of the data in the padded test
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static U8  _aBuffer[MAX_BUFFER_SIZE + PAD_SIZE];
+static U32 _aRef[MAX_VALUES];
+static U32 _aValue[MAX_VALUES + 1];
+static U32 _Rand = 1;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+static unsigned _GetRand(unsigned Range) {
+  _Rand = _Rand * 1103515245u + 12345u;
+  return (_Rand >> 16) % Range;
+}
+
+static U32 _GetRandValue(unsigned NumBytes) {
+  static const U32 _aMin[] = { 0, 0x80u, 0x4000u, 0x200000u, 0x10000000u };
+  U32 v;
+
+  v = ((U32)_GetRand(0x10000) << 16) | _GetRand(0x10000);
+  if (NumBytes < 5) {
+    v &= (1u << (7 * NumBytes)) - 1;
+  }
+  return v | _aMin[NumBytes - 1];
+}
+
+/*********************************************************************
+*
+*       _Fill()
+*
+*  Function description
+*    Fills the buffer with runs of values and of other bytes.
+*
+*  Return value
+*    Number of bytes in the buffer.
+*/
+static unsigned _Fill(void) {
+  U8*      p;
+  U8*      pEnd;
+  U8       aValue[5];
+  unsigned NumBytes;
+  unsigned RunSize;
+  unsigned Kind;
+  unsigned i;
+
+  p    = _aBuffer;
+  pEnd = _aBuffer + MAX_BUFFER_SIZE;
+  while (p < pEnd) {
+    Kind     = _GetRand(8);
+    RunSize  = 1 + _GetRand(24);
+    NumBytes = 1 + _GetRand(5);
+    for (i = 0; i < RunSize; i++) {
+      if (Kind == 6) {
+        if (p == pEnd) {
+          break;
+        }
+        *p++ = 0x80u | (U8)_GetRand(0x80);          // Continuation byte
+      } else if (Kind == 7) {
+        if (p == pEnd) {
+          break;
+        }
+        *p++ = (U8)_GetRand(0x100);                 // Random byte
+      } else {
+        if (Kind >= 3) {
+          NumBytes = (Kind == 5) ? 1 + _GetRand(5) : 1 + _GetRand(2);   // Mixed sizes, mostly short
+        }
+        NumBytes = (unsigned)(SYSVIEW_PACKET_EncodeU32(aValue, _GetRandValue(NumBytes)) - aValue);
+        if ((unsigned)(pEnd - p) < NumBytes) {
+          break;
+        }
+        memcpy(p, aValue, NumBytes);
+        p += NumBytes;
+      }
+    }
+    if (Kind < 6 && (unsigned)(pEnd - p) < 5) {
+      break;
+    }
+  }
+  return (unsigned)(p - _aBuffer);
+}
+
+/*********************************************************************
+*
+*       _Check()
+*
+*  Function description
+*    Decodes the data with the current kernel and compares the result
+*    with the one of the reference.
+*
+*  Return value
+*    0: Equal, 1: Not equal.
+*/
+static int _Check(const U8* pEnd, const U8* pReadEnd, unsigned NumValues, unsigned NumRef, const U8* pNextRef) {
+  const U8* pNext;
+  unsigned  n;
+
+  _aValue[NumValues] = 0xA5A5A5A5u;                 // Must not be overwritten
+  if (pReadEnd == pEnd) {
+    n = SYSVIEW_VARINT_DecodeU32s(_aBuffer, pEnd, _aValue, NumValues, &pNext);
+  } else {
+    n = SYSVIEW_VARINT_DecodeU32sPadded(_aBuffer, pEnd, pReadEnd, _aValue, NumValues, &pNext);
+  }
+  if (n != NumRef || pNext != pNextRef || memcmp(_aValue, _aRef, n * sizeof(U32)) != 0 || _aValue[NumValues] != 0xA5A5A5A5u) {
+    printf("Kernel %s, %u bytes%s, %u values: %u values, %u bytes decoded, expected %u values, %u bytes\n",
+           SYSVIEW_VARINT_GetKernelName(SYSVIEW_VARINT_GetKernel()), (unsigned)(pEnd - _aBuffer),
+           (pReadEnd == pEnd) ? "" : " padded", NumValues,
+           n, (unsigned)(pNext - _aBuffer), NumRef, (unsigned)(pNextRef - _aBuffer));
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  const U8* pEnd;
+  const U8* pNextRef;
+  unsigned  NumIterations;
+  unsigned  NumBytes;
+  unsigned  NumValues;
+  unsigned  NumRef;
+  unsigned  Kernel;
+  unsigned  NumErrors;
+  unsigned  i;
+  unsigned  j;
+
+  NumIterations = (argc > 1) ? (unsigned)strtoul(argv[1], NULL, 0) : NUM_ITERATIONS;
+  NumErrors     = 0;
+  for (i = 0; i < NumIterations && NumErrors < 10; i++) {
+    NumBytes = _Fill();
+    for (j = NumBytes; j < sizeof(_aBuffer); j++) {
+      _aBuffer[j] = (U8)_GetRand(0x100);            // Bytes after the end must not be decoded
+    }
+    NumBytes  = (_GetRand(4) == 0) ? _GetRand(NumBytes + 1) : NumBytes;
+    NumValues = (_GetRand(4) == 0) ? _GetRand(MAX_VALUES) : MAX_VALUES;
+    pEnd   = _aBuffer + NumBytes;
+    NumRef = SYSVIEW_VARINT_DecodeU32sRef(_aBuffer, pEnd, _aRef, NumValues, &pNextRef);
+    for (Kernel = SYSVIEW_VARINT_KERNEL_BYTEWISE; Kernel < SYSVIEW_VARINT_NUM_KERNELS; Kernel++) {
+      if (SYSVIEW_VARINT_SetKernel(Kernel) < 0) {
+        continue;
+      }
+      NumErrors += _Check(pEnd, pEnd,            NumValues, NumRef, pNextRef);
+      NumErrors += _Check(pEnd, pEnd + PAD_SIZE, NumValues, NumRef, pNextRef);
+    }
+  }
+  printf("Kernels:");
+  for (Kernel = SYSVIEW_VARINT_KERNEL_BYTEWISE; Kernel < SYSVIEW_VARINT_NUM_KERNELS; Kernel++) {
+    if (SYSVIEW_VARINT_SetKernel(Kernel) == 0) {
+      printf(" %s", SYSVIEW_VARINT_GetKernelName(Kernel));
+    }
+  }
+  printf("\n%u buffers decoded\n", i);
+  printf("%s\n", NumErrors ? "FAILED" : "OK");
+  return NumErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
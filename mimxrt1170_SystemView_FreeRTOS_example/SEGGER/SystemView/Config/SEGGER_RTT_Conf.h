@@ -151,7 +151,7 @@ Revision: $Rev: 24316 $
 *       RTT lock configuration for SEGGER Embedded Studio,
 *       Rowley CrossStudio and GCC
 */
-#if ((defined(__SES_ARM) || defined(__SES_RISCV) || defined(__CROSSWORKS_ARM) || defined(__GNUC__) || defined(__clang__)) && !defined (__CC_ARM) && !defined(WIN32))
+#if ((defined(__SES_ARM) || defined(__SES_RISCV) || defined(__CROSSWORKS_ARM) || defined(__GNUC__) || defined(__clang__)) && !defined (__CC_ARM) && !defined(WIN32) && !defined(SEGGER_RTT_LOCK_POSIX))
   #if (defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__))
     #define SEGGER_RTT_LOCK()   {                                                                   \
                                     unsigned int _SEGGER_RTT__LockState;                                         \
@@ -412,6 +412,23 @@ void OS_SIM_LeaveCriticalSection(void);
                                 }
 #endif
 
+/*********************************************************************
+*
+*       RTT lock configuration for POSIX hosts
+*       (Native build of the recorder core, e.g. for benchmarking)
+*/
+#if defined(SEGGER_RTT_LOCK_POSIX)
+
+void SEGGER_RTT_X_Lock(void);
+void SEGGER_RTT_X_Unlock(void);
+
+#define SEGGER_RTT_LOCK()       {                                                                   \
+                                  SEGGER_RTT_X_Lock();
+
+#define SEGGER_RTT_UNLOCK()       SEGGER_RTT_X_Unlock();                                            \
+                                }
+#endif
+
 /*********************************************************************
 *
 *       RTT lock configuration fallback
@@ -79,8 +79,8 @@ Additional information:
 **********************************************************************
 */
 extern void SEGGER_UARTX_IRQHandler(void);
-extern void HIF_UART_EnableTXEInterrupt  (void);
-#define SEGGER_SYSVIEW_ON_EVENT_RECORDED(x)  HIF_UART_EnableTXEInterrupt()
+extern void SEGGER_UART_OnEventRecorded  (void);
+#define SEGGER_SYSVIEW_ON_EVENT_RECORDED(x)  SEGGER_UART_OnEventRecorded()
 void SEGGER_UART_init(U32 instanceNum, U32 baudrate, U32 rootClkLpuart);
 
 
@@ -121,6 +121,10 @@ Additional information:
   #define SEGGER_RTT_MAX_NUM_DOWN_BUFFERS                  2    // Number of down-buffers (H->T) available on this target
 #endif
 
+#ifndef   SEGGER_RTT_MAX_NUM_RESERVATIONS
+  #define SEGGER_RTT_MAX_NUM_RESERVATIONS                  8    // Number of reservations of an up-buffer which may be pending at the same time, e.g. of nested interrupts
+#endif
+
 #ifndef SEGGER_RTT_BUFFER_SECTION
   #if defined(SEGGER_RTT_SECTION)
     #define SEGGER_RTT_BUFFER_SECTION SEGGER_RTT_SECTION
@@ -282,6 +286,30 @@ static unsigned char _aTerminalId[16] = { '0', '1', '2', '3', '4', '5', '6', '7'
 
 static unsigned char _ActiveTerminal;
 
+//
+// Reservation state of the up-buffers, see SEGGER_RTT_ReserveUpNoLock().
+// Kept outside of the control block, as its layout is fixed by the J-Link side.
+// The pending reservations are kept in the order they have been made,
+// each with its offset and a flag which is set on commit.
+// The position of the next reservation, the pending reservations and their
+// flags are packed into one word, so they can be updated by a compare-and-swap.
+//
+#if (SEGGER_RTT_MAX_NUM_RESERVATIONS > 8)
+  #error "SEGGER_RTT_MAX_NUM_RESERVATIONS must not exceed 8"
+#endif
+
+#define RESERVE_OFF_MASK          0xFFFFu   // Bits 0..15:  Position of next item to be reserved. Equal to <WrOff> when no reservation is pending.
+#define RESERVE_FIRST_SHIFT       16        // Bits 16..18: Index of the oldest pending reservation in aOff[]
+#define RESERVE_NUM_SHIFT         19        // Bits 19..22: Number of reservations from the oldest one on which has not been committed yet
+#define RESERVE_COMMITTED_SHIFT   23        // Bits 23..30: One per reservation, 1: Committed, but an older one has not
+
+#define RESERVE_STATE(ResOff, First, NumPending, Committed)  ((ResOff) | ((First) << RESERVE_FIRST_SHIFT) | ((NumPending) << RESERVE_NUM_SHIFT) | ((Committed) << RESERVE_COMMITTED_SHIFT))
+
+static struct {
+  volatile unsigned State;                                    // Packed as above
+  unsigned          aOff[SEGGER_RTT_MAX_NUM_RESERVATIONS];    // Offset of each pending reservation
+} _aUpReserve[SEGGER_RTT_MAX_NUM_UP_BUFFERS];
+
 /*********************************************************************
 *
 *       Static functions
@@ -642,6 +670,79 @@ unsigned SEGGER_RTT_ReadUpBufferNoLock(unsigned BufferIndex, void* pData, unsign
   return NumBytesRead;
 }
 
+/*********************************************************************
+*
+*       SEGGER_RTT_PeekUpBufferNoLock()
+*
+*  Function description
+*    Returns the largest contiguous span of data in an "Up"-buffer
+*    without consuming it, so that a transport (FIFO, DMA, socket)
+*    can send it directly from the buffer instead of copying it
+*    out byte by byte.
+*    Do not lock against interrupts and multiple access.
+*
+*  Parameters
+*    BufferIndex  Index of Up-buffer to be used.
+*    ppData       Pointer to a pointer which receives the start of the span.
+*
+*  Return value
+*    Number of bytes in the span, 0 if the buffer is empty.
+*    If the data wraps around, only the part up to the end of the buffer
+*    is returned. The rest is returned by the next call after the span
+*    has been consumed.
+*
+*  Additional information
+*    The span stays valid and is not overwritten by the application
+*    until it has been consumed by SEGGER_RTT_ConsumeUpBufferNoLock(),
+*    unless the buffer is in mode SEGGER_RTT_MODE_NO_BLOCK_OVERWRITE.
+*    The lock therefore does not need to be held while the span is sent.
+*    This function must not be called when J-Link might also do RTT.
+*/
+unsigned SEGGER_RTT_PeekUpBufferNoLock(unsigned BufferIndex, const void** ppData) {
+  unsigned                NumBytes;
+  unsigned                RdOff;
+  unsigned                WrOff;
+  SEGGER_RTT_BUFFER_UP*   pRing;
+
+  INIT();
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  RdOff = pRing->RdOff;
+  WrOff = pRing->WrOff;
+  if (RdOff > WrOff) {
+    NumBytes = pRing->SizeOfBuffer - RdOff;     // Up to the end of the buffer
+  } else {
+    NumBytes = WrOff - RdOff;
+  }
+  *ppData = (const void*)((pRing->pBuffer + RdOff) + SEGGER_RTT_UNCACHED_OFF);
+  return NumBytes;
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_ConsumeUpBufferNoLock()
+*
+*  Function description
+*    Frees data of an "Up"-buffer which has been returned by
+*    SEGGER_RTT_PeekUpBufferNoLock() by advancing <RdOff>.
+*    Do not lock against interrupts and multiple access.
+*
+*  Parameters
+*    BufferIndex  Index of Up-buffer to be used.
+*    NumBytes     Number of bytes to consume. Must not exceed the number
+*                 of bytes returned by SEGGER_RTT_PeekUpBufferNoLock().
+*/
+void SEGGER_RTT_ConsumeUpBufferNoLock(unsigned BufferIndex, unsigned NumBytes) {
+  SEGGER_RTT_BUFFER_UP*   pRing;
+  unsigned                RdOff;
+
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  RdOff = pRing->RdOff + NumBytes;
+  if (RdOff == pRing->SizeOfBuffer) {
+    RdOff = 0u;
+  }
+  pRing->RdOff = RdOff;
+}
+
 /*********************************************************************
 *
 *       SEGGER_RTT_ReadNoLock()
@@ -990,6 +1091,350 @@ CopyStraight:
 }
 #endif
 
+/*********************************************************************
+*
+*       _CompareAndSwap()
+*
+*  Function description
+*    Stores a new value in a word, if it still holds the expected one.
+*
+*  Parameters
+*    p    Pointer to the word.
+*    Old  Expected value.
+*    New  Value to be stored.
+*
+*  Return value
+*    1: Stored.
+*    0: Word has been changed by another context, nothing stored.
+*
+*  Notes
+*    (1) On ARMv7-M and ARMv8-M mainline, STREX also fails when the
+*        context has been interrupted since LDREX. The caller retries.
+*    (2) Without SEGGER_RTT_USE_CAS, all callers hold the lock.
+*/
+static int _CompareAndSwap(volatile unsigned* p, unsigned Old, unsigned New) {
+#if SEGGER_RTT_USE_CAS && ((defined __ARM_ARCH_7M__) || (defined __ARM_ARCH_7EM__) || (defined __ARM_ARCH_8M_MAIN__))
+  unsigned v;
+  unsigned Fail;
+
+  __asm volatile ("ldrex %0, [%1]" : "=r" (v) : "r" (p) : "memory");
+  if (v != Old) {
+    __asm volatile ("clrex" : : : "memory");
+    return 0;
+  }
+  __asm volatile ("strex %0, %2, [%1]" : "=&r" (Fail) : "r" (p), "r" (New) : "memory");
+  return (Fail == 0u) ? 1 : 0;
+#elif SEGGER_RTT_USE_CAS
+  return __atomic_compare_exchange_n(p, &Old, New, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 1 : 0;
+#else
+  if (*p != Old) {
+    return 0;
+  }
+  *p = New;
+  return 1;
+#endif
+}
+
+/*********************************************************************
+*
+*       _GetDistance()
+*
+*  Function description
+*    Returns the number of bytes from <RdOff> up to an offset in an
+*    "Up"-buffer.
+*/
+static unsigned _GetDistance(const SEGGER_RTT_BUFFER_UP* pRing, unsigned RdOff, unsigned Off) {
+  return (Off >= RdOff) ? (Off - RdOff) : (Off + pRing->SizeOfBuffer - RdOff);
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_ReserveUpNoLock
+*
+*  Function description
+*    Reserves space for a specified number of bytes in an "Up"-buffer.
+*    The reserved space is filled by SEGGER_RTT_WriteReservedNoLock()
+*    and made visible to the host by SEGGER_RTT_CommitUpNoLock().
+*    This allows multiple producers to copy their data into the buffer
+*    concurrently, while only reservation and commit need to be locked.
+*
+*  Parameters
+*    BufferIndex  Index of "Up"-buffer to be used (e.g. 0 for "Terminal").
+*    NumBytes     Number of bytes to reserve. MUST be > 0!!!
+*
+*  Return value
+*    >= 0: Offset of the reserved space in the buffer
+*     < 0: No space, nothing has been reserved
+*
+*  Notes
+*    (1) If there is not enough space in the "Up"-buffer, or if
+*        SEGGER_RTT_MAX_NUM_RESERVATIONS are pending, nothing is reserved.
+*    (2) <WrOff> is only advanced up to the oldest reservation which has not
+*        been committed, so the host never reads space which has not been
+*        filled yet, but reads committed data while later reservations are pending.
+*    (3) While reservations are pending, no other write function must be used on the buffer.
+*    (4) For performance reasons this function does not call Init()
+*        and may only be called after RTT has been initialized.
+*    (5) Must be called with the lock held, but may race with
+*        SEGGER_RTT_CommitUpNoLock() where SEGGER_RTT_USE_CAS is 1.
+*    (6) The buffer must not be larger than 64 KB.
+*/
+int SEGGER_RTT_ReserveUpNoLock(unsigned BufferIndex, unsigned NumBytes) {
+  SEGGER_RTT_BUFFER_UP* pRing;
+  unsigned              State;
+  unsigned              Avail;
+  unsigned              RdOff;
+  unsigned              WrOff;
+  unsigned              ResOff;
+  unsigned              NextOff;
+  unsigned              First;
+  unsigned              NumPending;
+  unsigned              Committed;
+  unsigned              i;
+
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  if (pRing->SizeOfBuffer > RESERVE_OFF_MASK + 1u) {
+    return -1;
+  }
+  do {
+    State      = _aUpReserve[BufferIndex].State;
+    ResOff     = State & RESERVE_OFF_MASK;
+    First      = (State >> RESERVE_FIRST_SHIFT) & 0x7u;
+    NumPending = (State >> RESERVE_NUM_SHIFT) & 0xFu;
+    Committed  = State >> RESERVE_COMMITTED_SHIFT;
+    if (NumPending == SEGGER_RTT_MAX_NUM_RESERVATIONS) {
+      return -1;
+    }
+    RdOff = pRing->RdOff;
+    if (NumPending == 0) {
+      //
+      // Pick up data written by other functions since the last commit.
+      // <WrOff> may also still be behind, while the last commit publishes it.
+      //
+      WrOff = pRing->WrOff;
+      if (_GetDistance(pRing, RdOff, WrOff) > _GetDistance(pRing, RdOff, ResOff)) {
+        ResOff = WrOff;
+      }
+    }
+    if (RdOff <= ResOff) {
+      Avail = pRing->SizeOfBuffer - 1u - ResOff + RdOff;
+    } else {
+      Avail = RdOff - ResOff - 1u;
+    }
+    if (Avail < NumBytes) {
+      return -1;
+    }
+    NextOff = ResOff + NumBytes;
+    if (NextOff >= pRing->SizeOfBuffer) {
+      NextOff -= pRing->SizeOfBuffer;
+    }
+    i = First + NumPending;
+    if (i >= SEGGER_RTT_MAX_NUM_RESERVATIONS) {
+      i -= SEGGER_RTT_MAX_NUM_RESERVATIONS;
+    }
+    _aUpReserve[BufferIndex].aOff[i] = ResOff;    // Not pending yet, so no commit reads it
+  } while (_CompareAndSwap(&_aUpReserve[BufferIndex].State, State, RESERVE_STATE(NextOff, First, NumPending + 1u, Committed)) == 0);
+  return (int)ResOff;
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_WriteReservedNoLock
+*
+*  Function description
+*    Copies data into space reserved by SEGGER_RTT_ReserveUpNoLock().
+*    Handles the wrap-around at the end of the buffer.
+*
+*  Parameters
+*    BufferIndex  Index of "Up"-buffer to be used (e.g. 0 for "Terminal").
+*    Off          Offset returned by SEGGER_RTT_ReserveUpNoLock().
+*    pBuffer      Pointer to data to be copied.
+*    NumBytes     Number of bytes to copy. Must not exceed the reserved number of bytes.
+*
+*  Notes
+*    (1) Does not need to be called with the lock held,
+*        as the reserved space is owned by the caller until it is committed.
+*/
+void SEGGER_RTT_WriteReservedNoLock(unsigned BufferIndex, unsigned Off, const void* pBuffer, unsigned NumBytes) {
+  const char*           pData;
+  SEGGER_RTT_BUFFER_UP* pRing;
+  unsigned              Rem;
+  volatile char*        pDst;
+
+  pData = (const char *)pBuffer;
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  Rem   = pRing->SizeOfBuffer - Off;
+  pDst  = (pRing->pBuffer + Off) + SEGGER_RTT_UNCACHED_OFF;
+  if (Rem >= NumBytes) {
+    SEGGER_RTT_MEMCPY((void*)pDst, pData, NumBytes);
+  } else {
+    SEGGER_RTT_MEMCPY((void*)pDst, pData, Rem);
+    pDst = pRing->pBuffer + SEGGER_RTT_UNCACHED_OFF;
+    SEGGER_RTT_MEMCPY((void*)pDst, pData + Rem, NumBytes - Rem);
+  }
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_CommitUpNoLock
+*
+*  Function description
+*    Commits a reservation made by SEGGER_RTT_ReserveUpNoLock().
+*    <WrOff> is advanced over all committed reservations up to the
+*    oldest one which is still pending, so committed data becomes
+*    visible to the host while later reservations are pending.
+*
+*  Parameters
+*    BufferIndex  Index of "Up"-buffer to be used (e.g. 0 for "Terminal").
+*    Off          Offset returned by SEGGER_RTT_ReserveUpNoLock().
+*
+*  Notes
+*    (1) Does not need to be called with the lock held where
+*        SEGGER_RTT_USE_CAS is 1. Concurrent reservations and commits
+*        retry the compare-and-swap of the reservation state.
+*    (2) <WrOff> is published from the latest state, so a commit which
+*        is interrupted never moves it back behind a later one.
+*/
+void SEGGER_RTT_CommitUpNoLock(unsigned BufferIndex, unsigned Off) {
+  SEGGER_RTT_BUFFER_UP* pRing;
+  unsigned              State;
+  unsigned              First;
+  unsigned              NumPending;
+  unsigned              Committed;
+  unsigned              WrOff;
+  unsigned              NewWrOff;
+  unsigned              i;
+  unsigned              n;
+
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  do {
+    State      = _aUpReserve[BufferIndex].State;
+    First      = (State >> RESERVE_FIRST_SHIFT) & 0x7u;
+    NumPending = (State >> RESERVE_NUM_SHIFT) & 0xFu;
+    Committed  = State >> RESERVE_COMMITTED_SHIFT;
+    //
+    // Mark the reservation as committed. Pending reservations do not
+    // overlap, so the offset identifies it.
+    //
+    i = First;
+    for (n = 0; n < NumPending; n++) {
+      if (_aUpReserve[BufferIndex].aOff[i] == Off) {
+        Committed |= 1u << i;
+        break;
+      }
+      if (++i == SEGGER_RTT_MAX_NUM_RESERVATIONS) {
+        i = 0;
+      }
+    }
+    //
+    // Remove the committed reservations from the oldest one on.
+    //
+    while ((NumPending != 0) && ((Committed & (1u << First)) != 0)) {
+      Committed &= ~(1u << First);
+      if (++First == SEGGER_RTT_MAX_NUM_RESERVATIONS) {
+        First = 0;
+      }
+      NumPending--;
+    }
+  } while (_CompareAndSwap(&_aUpReserve[BufferIndex].State, State, RESERVE_STATE(State & RESERVE_OFF_MASK, First, NumPending, Committed)) == 0);
+  //
+  // Publish the committed reservations up to the oldest pending one.
+  //
+  RTT__DMB();                       // Force data write to be complete before writing the <WrOff>, in case CPU is allowed to change the order of memory accesses
+  for (;;) {
+    WrOff      = pRing->WrOff;
+    State      = _aUpReserve[BufferIndex].State;
+    NumPending = (State >> RESERVE_NUM_SHIFT) & 0xFu;
+    if (NumPending != 0) {
+      NewWrOff = _aUpReserve[BufferIndex].aOff[(State >> RESERVE_FIRST_SHIFT) & 0x7u];
+    } else {
+      NewWrOff = State & RESERVE_OFF_MASK;
+    }
+    if (State == _aUpReserve[BufferIndex].State) {    // Slot of the oldest reservation has not been reused meanwhile
+      if (NewWrOff == WrOff) {
+        break;
+      }
+      if (_CompareAndSwap((volatile unsigned*)&pRing->WrOff, WrOff, NewWrOff) != 0) {
+        break;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_ReserveUpInPlaceNoLock
+*
+*  Function description
+*    Returns a pointer to linear free space at the write offset of an
+*    "Up"-buffer, so that data can be generated directly in the buffer
+*    instead of being generated elsewhere and copied.
+*    The data is made visible to the host by SEGGER_RTT_CommitUpInPlaceNoLock().
+*
+*  Parameters
+*    BufferIndex  Index of "Up"-buffer to be used (e.g. 0 for "Terminal").
+*    NumBytes     Number of bytes which may be written. MUST be > 0!!!
+*
+*  Return value
+*    != NULL: Pointer to NumBytes bytes of free space
+*    == NULL: Not enough linear space, because the buffer is full
+*             or the space wraps around at the end of the buffer.
+*
+*  Notes
+*    (1) Nothing is reserved. The caller must hold the lock from this
+*        call until the data has been committed and must not use any
+*        other write function on the buffer in between.
+*    (2) On wrap-around the caller is expected to fall back to generating
+*        the data elsewhere and writing it with one of the write functions.
+*    (3) For performance reasons this function does not call Init()
+*        and may only be called after RTT has been initialized.
+*/
+void* SEGGER_RTT_ReserveUpInPlaceNoLock(unsigned BufferIndex, unsigned NumBytes) {
+  SEGGER_RTT_BUFFER_UP* pRing;
+  unsigned              Avail;
+  unsigned              RdOff;
+  unsigned              WrOff;
+
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  RdOff = pRing->RdOff;
+  WrOff = pRing->WrOff;
+  if (RdOff > WrOff) {
+    Avail = RdOff - WrOff - 1u;
+  } else {
+    Avail = pRing->SizeOfBuffer - WrOff - (RdOff == 0u ? 1u : 0u);   // Linear space up to the end of the buffer, minus 1 byte if WrOff must not wrap onto RdOff
+  }
+  if (Avail < NumBytes) {
+    return NULL;
+  }
+  return (void*)((pRing->pBuffer + WrOff) + SEGGER_RTT_UNCACHED_OFF);
+}
+
+/*********************************************************************
+*
+*       SEGGER_RTT_CommitUpInPlaceNoLock
+*
+*  Function description
+*    Commits data generated in the space returned by
+*    SEGGER_RTT_ReserveUpInPlaceNoLock() by advancing <WrOff>.
+*
+*  Parameters
+*    BufferIndex  Index of "Up"-buffer to be used (e.g. 0 for "Terminal").
+*    NumBytes     Number of bytes to commit. Must not exceed the number
+*                 of bytes passed to SEGGER_RTT_ReserveUpInPlaceNoLock().
+*/
+void SEGGER_RTT_CommitUpInPlaceNoLock(unsigned BufferIndex, unsigned NumBytes) {
+  SEGGER_RTT_BUFFER_UP* pRing;
+  unsigned              WrOff;
+
+  pRing = (SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF);  // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+  WrOff = pRing->WrOff + NumBytes;
+  if (WrOff == pRing->SizeOfBuffer) {
+    WrOff = 0u;
+  }
+  RTT__DMB();                       // Force data write to be complete before writing the <WrOff>, in case CPU is allowed to change the order of memory accesses
+  pRing->WrOff = WrOff;
+}
+
 /*********************************************************************
 *
 *       SEGGER_RTT_WriteDownBufferNoLock
@@ -1629,6 +2074,7 @@ int SEGGER_RTT_AllocUpBuffer(const char* sName, void* pBuffer, unsigned BufferSi
     pRTTCB->aUp[BufferIndex].RdOff        = 0u;
     pRTTCB->aUp[BufferIndex].WrOff        = 0u;
     pRTTCB->aUp[BufferIndex].Flags        = Flags;
+    _aUpReserve[BufferIndex].State        = 0u;
     RTT__DMB();                     // Force data write to be complete before writing the <WrOff>, in case CPU is allowed to change the order of memory accesses
   } else {
     BufferIndex = -1;
@@ -1679,6 +2125,7 @@ int SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char* sName, void* pBu
       pUp->SizeOfBuffer = BufferSize;
       pUp->RdOff        = 0u;
       pUp->WrOff        = 0u;
+      _aUpReserve[BufferIndex].State = 0u;
     }
     pUp->Flags          = Flags;
     SEGGER_RTT_UNLOCK();
@@ -246,6 +246,22 @@ Revision: $Rev: 25842 $
   #endif
 #endif
 
+//
+// Reservations of the up-buffers are committed by a compare-and-swap without
+// the lock, see SEGGER_RTT_CommitUpNoLock(). ARMv7-M and ARMv8-M mainline use
+// LDREX/STREX, other targets the atomic builtins of GCC and clang where they
+// are lock-free. Without, e.g. on ARMv6-M, commits have to be locked.
+//
+#ifndef SEGGER_RTT_USE_CAS
+  #if ((defined __GNUC__) || (defined __clang__)) && ((defined __ARM_ARCH_7M__) || (defined __ARM_ARCH_7EM__) || (defined __ARM_ARCH_8M_MAIN__))
+    #define SEGGER_RTT_USE_CAS  1
+  #elif ((defined __GNUC__) || (defined __clang__)) && (defined __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+    #define SEGGER_RTT_USE_CAS  1
+  #else
+    #define SEGGER_RTT_USE_CAS  0
+  #endif
+#endif
+
 #ifndef SEGGER_RTT_CPU_CACHE_LINE_SIZE
   #define SEGGER_RTT_CPU_CACHE_LINE_SIZE (0)   // On most target systems where RTT is used, we do not have a CPU cache, therefore 0 is a good default here
 #endif
@@ -399,8 +415,15 @@ unsigned     SEGGER_RTT_GetBytesInBuffer        (unsigned BufferIndex);
 */
 unsigned     SEGGER_RTT_ReadUpBuffer            (unsigned BufferIndex, void* pBuffer, unsigned BufferSize);
 unsigned     SEGGER_RTT_ReadUpBufferNoLock      (unsigned BufferIndex, void* pData, unsigned BufferSize);
+unsigned     SEGGER_RTT_PeekUpBufferNoLock      (unsigned BufferIndex, const void** ppData);
+void         SEGGER_RTT_ConsumeUpBufferNoLock   (unsigned BufferIndex, unsigned NumBytes);
 unsigned     SEGGER_RTT_WriteDownBuffer         (unsigned BufferIndex, const void* pBuffer, unsigned NumBytes);
 unsigned     SEGGER_RTT_WriteDownBufferNoLock   (unsigned BufferIndex, const void* pBuffer, unsigned NumBytes);
+int          SEGGER_RTT_ReserveUpNoLock         (unsigned BufferIndex, unsigned NumBytes);
+void         SEGGER_RTT_WriteReservedNoLock     (unsigned BufferIndex, unsigned Off, const void* pBuffer, unsigned NumBytes);
+void         SEGGER_RTT_CommitUpNoLock          (unsigned BufferIndex, unsigned Off);
+void*        SEGGER_RTT_ReserveUpInPlaceNoLock  (unsigned BufferIndex, unsigned NumBytes);
+void         SEGGER_RTT_CommitUpInPlaceNoLock   (unsigned BufferIndex, unsigned NumBytes);
 
 #define      SEGGER_RTT_HASDATA_UP(n)    (((SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[n] + SEGGER_RTT_UNCACHED_OFF))->WrOff - ((SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[n] + SEGGER_RTT_UNCACHED_OFF))->RdOff)   // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
 
@@ -63,6 +63,9 @@ Revision: $Rev: 26226 $
 
 #include "SEGGER.h"
 #include "SEGGER_SYSVIEW_ConfDefaults.h"
+#if defined(__cplusplus) && !defined(__GNUC__) && !defined(__clang__)
+  #include <type_traits>      // SEGGER_SYSVIEW_IS_U32_ARG()
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -89,6 +92,12 @@ extern "C" {
 #define SEGGER_SYSVIEW_ERROR          (2u)
 #define SEGGER_SYSVIEW_FLAG_APPEND    (1u << 6)
 
+//
+// Modes of the RTT buffer, see SEGGER_SYSVIEW_SetBufferMode()
+//
+#define SEGGER_SYSVIEW_BUFFER_MODE_STREAM         (0u)    // Drop events while the buffer is full, then send an overflow packet
+#define SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL   (1u)    // Stop recording when the buffer is full
+
 #define SEGGER_SYSVIEW_PREPARE_PACKET(p)  (p) + 4
 //
 // SystemView events. First 32 IDs from 0 .. 31 are reserved for these
@@ -123,6 +132,7 @@ extern "C" {
 #define   SYSVIEW_EVTID_NUMMODULES        27
 #define   SYSVIEW_EVTID_END_CALL          28
 #define   SYSVIEW_EVTID_TASK_TERMINATE    29
+#define   SYSVIEW_EVTID_SHARD_SYNC        30  // <Shard> <TimeStamp>. Only sent with SEGGER_SYSVIEW_NUM_SHARDS > 1.
 
 #define   SYSVIEW_EVTID_EX                31
 //
@@ -130,6 +140,24 @@ extern "C" {
 //
 #define   SYSVIEW_EVTID_EX_MARK            0
 #define   SYSVIEW_EVTID_EX_NAME_MARKER     1
+#define   SYSVIEW_EVTID_EX_CHECKPOINT      2  // <TimeStamp> <SeqNo> <DescDist> <DescSize>. Only sent with SEGGER_SYSVIEW_USE_CHECKPOINTS.
+#define   SYSVIEW_EVTID_EX_DROP_STATS      3  // <NumClasses> <DropCnt>[NumClasses]. Only sent with SEGGER_SYSVIEW_USE_DROP_STATS, after SYSVIEW_EVTID_OVERFLOW.
+#define   SYSVIEW_EVTID_EX_PRINT_DEFERRED  4  // <FormatAddr> <Options> <NumArgs> <Arg>[NumArgs]. Only sent with SEGGER_SYSVIEW_USE_DEFERRED_PRINTF.
+#define   SYSVIEW_EVTID_EX_SAMPLING        5  // <Ratio> <NumIds> <EventId>[NumIds]. Sent when sampling is set and on start, each recorded event of the IDs stands for Ratio events.
+#define   SYSVIEW_EVTID_EX_LOAD            6  // <Period> <IdleLoad> <ISRLoad> <NumTasks> (<TaskId> <Load>)[NumTasks]. Load in 1/1000 of Period. Only sent with SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0.
+//
+// Event classes of the drop statistics
+//
+#define   SEGGER_SYSVIEW_DROP_CLASS_SYSTEM  0  // Trace start/stop, system description, resource names, modules, syncs
+#define   SEGGER_SYSVIEW_DROP_CLASS_ISR     1  // ISR enter, exit, exit to scheduler
+#define   SEGGER_SYSVIEW_DROP_CLASS_SCHED   2  // Task start/stop exec, start/stop ready, idle
+#define   SEGGER_SYSVIEW_DROP_CLASS_TASK    3  // Task create, info, stack info, terminate
+#define   SEGGER_SYSVIEW_DROP_CLASS_TIMER   4  // Timer enter, exit
+#define   SEGGER_SYSVIEW_DROP_CLASS_MARK    5  // Marks and extended events
+#define   SEGGER_SYSVIEW_DROP_CLASS_PRINT   6  // SEGGER_SYSVIEW_Print*() and Warn*() and Error*()
+#define   SEGGER_SYSVIEW_DROP_CLASS_API     7  // OS API calls and their end, user events 32 .. 511
+#define   SEGGER_SYSVIEW_DROP_CLASS_MODULE  8  // Events of registered modules
+#define   SEGGER_SYSVIEW_NUM_DROP_CLASSES   9
 //
 // Event masks to disable/enable events
 //
@@ -205,6 +233,16 @@ struct SEGGER_SYSVIEW_MODULE_STRUCT {
 
 typedef void (SEGGER_SYSVIEW_SEND_SYS_DESC_FUNC)(void);
 
+typedef struct {
+  U32          Off;      // Offset of the sync of the most recent checkpoint in the up-buffer
+  U32          SeqNo;    // Sequence number of the checkpoint packet, 0: No checkpoint sent yet
+} SEGGER_SYSVIEW_CHECKPOINT;
+
+typedef struct {
+  U16          Ratio;    // One of Ratio events is recorded, 0 or 1: All
+  U16          Cnt;      // Events since the last recorded one
+} SEGGER_SYSVIEW_SAMPLE_CLASS;
+
 
 /*********************************************************************
 *
@@ -225,6 +263,15 @@ typedef void (SEGGER_SYSVIEW_SEND_SYS_DESC_FUNC)(void);
 
 EXTERN unsigned int SEGGER_SYSVIEW_TickCnt;
 EXTERN unsigned int SEGGER_SYSVIEW_InterruptId;
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+EXTERN SEGGER_SYSVIEW_CHECKPOINT SEGGER_SYSVIEW_LastCheckpoint;   // Read from a post-mortem dump to locate the most recent checkpoint
+#endif
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+EXTERN U32 SEGGER_SYSVIEW_aDisabledEvents[SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS / 32];   // Bit n of word i set: Event 32 * i + n is not recorded
+#endif
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+EXTERN SEGGER_SYSVIEW_SAMPLE_CLASS SEGGER_SYSVIEW_aSampleClass[SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES];
+#endif
 
 #undef EXTERN
 
@@ -254,6 +301,8 @@ void SEGGER_SYSVIEW_SendTaskInfo                  (const SEGGER_SYSVIEW_TASKINFO
 void SEGGER_SYSVIEW_SendSysDesc                   (const char* sSysDesc);
 int  SEGGER_SYSVIEW_IsStarted                     (void);
 int  SEGGER_SYSVIEW_GetChannelID                  (void);
+int  SEGGER_SYSVIEW_GetShardChannelID             (unsigned Shard);
+void SEGGER_SYSVIEW_GetDropCounts                 (U32* paDropCount);
 
 /*********************************************************************
 *
@@ -270,8 +319,13 @@ void SEGGER_SYSVIEW_RecordU32x7                   (unsigned int EventId, U32 Par
 void SEGGER_SYSVIEW_RecordU32x8                   (unsigned int EventId, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6, U32 Para7);
 void SEGGER_SYSVIEW_RecordU32x9                   (unsigned int EventId, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6, U32 Para7, U32 Para8);
 void SEGGER_SYSVIEW_RecordU32x10                  (unsigned int EventId, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6, U32 Para7, U32 Para8, U32 Para9);
+void SEGGER_SYSVIEW_RecordU32s                    (unsigned int EventId, const U32* paPara, unsigned NumParas);
 void SEGGER_SYSVIEW_RecordString                  (unsigned int EventId, const char* pString);
 void SEGGER_SYSVIEW_RecordSystime                 (void);
+U64  SEGGER_SYSVIEW_GetTime64                     (void);
+U64  SEGGER_SYSVIEW_GetTimeUs                     (void);
+void SEGGER_SYSVIEW_UpdateTime64                  (void);
+void SEGGER_SYSVIEW_RecordLoad                    (void);
 void SEGGER_SYSVIEW_RecordEnterISR                (void);
 void SEGGER_SYSVIEW_RecordExitISR                 (void);
 void SEGGER_SYSVIEW_RecordExitISRToScheduler      (void);
@@ -305,7 +359,143 @@ U8*  SEGGER_SYSVIEW_EncodeData                    (U8* pPayload, const char* pSr
 U8*  SEGGER_SYSVIEW_EncodeString                  (U8* pPayload, const char* s, unsigned int MaxLen);
 U8*  SEGGER_SYSVIEW_EncodeId                      (U8* pPayload, U32 Id);
 U32  SEGGER_SYSVIEW_ShrinkId                      (U32 Id);
+U32  SEGGER_SYSVIEW_ShrinkTaskId                  (U32 TaskId);
+U32  SEGGER_SYSVIEW_FloatToU32                    (float f);
 
+/*********************************************************************
+*
+*       Variadic recording macros
+*
+*  SEGGER_SYSVIEW_RECORD(EventId, ...) records an event with up to 16
+*  parameters. The parameters are counted at compile time: up to 10
+*  parameters are recorded by SEGGER_SYSVIEW_RecordVoid(),
+*  SEGGER_SYSVIEW_RecordU32() and SEGGER_SYSVIEW_RecordU32x2() to
+*  SEGGER_SYSVIEW_RecordU32x10(), which reserve the exact packet size,
+*  more by SEGGER_SYSVIEW_RecordU32s(). Integer, enum and pointer
+*  parameters are converted to U32. Integers wider than 32 bits and,
+*  with GCC, clang and C++, floating point parameters are rejected at
+*  compile time: SEGGER_SYSVIEW_U64_ARGS() passes a 64-bit value as
+*  two parameters, low word first, and SEGGER_SYSVIEW_FLOAT_ARG()
+*  passes the bits of a float.
+*  With SEGGER_SYSVIEW_USE_EVENT_FILTER, SEGGER_SYSVIEW_RECORD() is a
+*  statement, which evaluates EventId twice and the parameters only
+*  when the event is enabled.
+*/
+#define SEGGER_SYSVIEW_CONCAT(a, b)               SEGGER_SYSVIEW_CONCAT_(a, b)
+#define SEGGER_SYSVIEW_CONCAT_(a, b)              a##b
+#define SEGGER_SYSVIEW_FIRST_ARG(...)             SEGGER_SYSVIEW_FIRST_ARG_(__VA_ARGS__, ~)
+#define SEGGER_SYSVIEW_FIRST_ARG_(x, ...)         x
+//
+// Number of arguments after the first one, 0 to 16.
+//
+#define SEGGER_SYSVIEW_NUM_VA_ARGS(...)           SEGGER_SYSVIEW_NUM_VA_ARGS_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, ~)
+#define SEGGER_SYSVIEW_NUM_VA_ARGS_(x, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16, n, ...)  n
+//
+// Compile-time check of a parameter, 1 for a pointer or an integer of
+// up to 32 bits. Type classes of GCC and clang, in C and C++: 1 integer,
+// 2 char, 3 enum, 4 bool, 5 pointer. Other C++ compilers check the type
+// by <type_traits>. Other C compilers only check the size, which allows
+// floats and, on 64-bit hosts, 64-bit integers.
+//
+#if defined(__GNUC__) || defined(__clang__)
+  #define SEGGER_SYSVIEW_IS_U32_ARG(a)            ((__builtin_classify_type(a) == 5) || ((__builtin_classify_type(a) >= 1) && (__builtin_classify_type(a) <= 4) && (sizeof(a) <= 4u)))
+#elif defined(__cplusplus)
+  #define SEGGER_SYSVIEW_ARG_TYPE(a)              std::decay<decltype(a)>::type
+  #define SEGGER_SYSVIEW_IS_U32_ARG(a)            (std::is_pointer<SEGGER_SYSVIEW_ARG_TYPE(a)>::value || ((std::is_integral<SEGGER_SYSVIEW_ARG_TYPE(a)>::value || std::is_enum<SEGGER_SYSVIEW_ARG_TYPE(a)>::value) && (sizeof(a) <= 4u)))
+#else
+  #define SEGGER_SYSVIEW_IS_U32_ARG(a)            ((sizeof(a) <= 4u) || (sizeof(a) == sizeof(void*)))
+#endif
+//
+// Arguments after the first one, converted to U32, each followed by a comma.
+// A parameter which is no U32_ARG fails with a negative array size.
+//
+#define SEGGER_SYSVIEW_U32_ARG(a)                 ((void)sizeof(char[SEGGER_SYSVIEW_IS_U32_ARG(a) ? 1 : -1]), (U32)SEGGER_PTR2ADDR(a))
+#define SEGGER_SYSVIEW_U32_ARGS(...)              SEGGER_SYSVIEW_CONCAT(SEGGER_SYSVIEW_U32_ARGS_, SEGGER_SYSVIEW_NUM_VA_ARGS(__VA_ARGS__))(__VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_0(x)
+#define SEGGER_SYSVIEW_U32_ARGS_1(x, a)   SEGGER_SYSVIEW_U32_ARG(a),
+#define SEGGER_SYSVIEW_U32_ARGS_2(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_1(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_3(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_2(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_4(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_3(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_5(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_4(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_6(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_5(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_7(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_6(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_8(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_7(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_9(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_8(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_10(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_9(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_11(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_10(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_12(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_11(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_13(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_12(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_14(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_13(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_15(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_14(x, __VA_ARGS__)
+#define SEGGER_SYSVIEW_U32_ARGS_16(x, a, ...) SEGGER_SYSVIEW_U32_ARG(a), SEGGER_SYSVIEW_U32_ARGS_15(x, __VA_ARGS__)
+//
+// Parameters which are no 32-bit scalars.
+//
+#define SEGGER_SYSVIEW_U64_ARGS(v)                (U32)(v), (U32)((U64)(v) >> 32)
+#define SEGGER_SYSVIEW_FLOAT_ARG(f)               SEGGER_SYSVIEW_FloatToU32(f)
+
+//
+// Check of the event filter, a load and a branch for a constant EventId.
+//
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  #define SEGGER_SYSVIEW_IS_EVENT_ENABLED(EventId)  (((U32)(EventId) >= (U32)SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS) || ((SEGGER_SYSVIEW_aDisabledEvents[(U32)(EventId) >> 5] & ((U32)1u << ((U32)(EventId) & 31u))) == 0u))
+#else
+  #define SEGGER_SYSVIEW_IS_EVENT_ENABLED(EventId)  (1)
+#endif
+
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+#define SEGGER_SYSVIEW_RECORD(...)             \
+  do {                                                                                                         \
+    if (SEGGER_SYSVIEW_IS_EVENT_ENABLED(SEGGER_SYSVIEW_FIRST_ARG(__VA_ARGS__))) {                              \
+      SEGGER_SYSVIEW_CONCAT(SEGGER_SYSVIEW_RECORD_, SEGGER_SYSVIEW_NUM_VA_ARGS(__VA_ARGS__))(__VA_ARGS__);     \
+    }                                                                                                          \
+  } while (0)
+#else
+#define SEGGER_SYSVIEW_RECORD(...)             SEGGER_SYSVIEW_CONCAT(SEGGER_SYSVIEW_RECORD_, SEGGER_SYSVIEW_NUM_VA_ARGS(__VA_ARGS__))(__VA_ARGS__)
+#endif
+
+//
+// Sampling by class where the event is recorded. A class which records
+// all events costs a load and a branch, the counter of a sampled class
+// is updated under SEGGER_SYSVIEW_LOCK() by SEGGER_SYSVIEW_CountSampled().
+// SEGGER_SYSVIEW_RECORD_SAMPLED(Class, EventId, ...) records one of every
+// n events of the class with SEGGER_SYSVIEW_RECORD().
+//
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+  #define SEGGER_SYSVIEW_IS_SAMPLED(Class)  ((SEGGER_SYSVIEW_aSampleClass[Class].Ratio <= 1u) || (SEGGER_SYSVIEW_CountSampled(Class) != 0))
+  #define SEGGER_SYSVIEW_RECORD_SAMPLED(Class, ...)  \
+  do {                                               \
+    if (SEGGER_SYSVIEW_IS_SAMPLED(Class)) {          \
+      SEGGER_SYSVIEW_RECORD(__VA_ARGS__);            \
+    }                                                \
+  } while (0)
+#else
+  #define SEGGER_SYSVIEW_IS_SAMPLED(Class)  (1)
+  #define SEGGER_SYSVIEW_RECORD_SAMPLED(Class, ...)  SEGGER_SYSVIEW_RECORD(__VA_ARGS__)
+#endif
+
+#define SEGGER_SYSVIEW_RECORD_0(Id)       SEGGER_SYSVIEW_RecordVoid(Id)
+#define SEGGER_SYSVIEW_RECORD_1(Id, a0)   SEGGER_SYSVIEW_RecordU32((Id), SEGGER_SYSVIEW_U32_ARG(a0))
+#define SEGGER_SYSVIEW_RECORD_2(Id, a0, a1) SEGGER_SYSVIEW_RecordU32x2((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1))
+#define SEGGER_SYSVIEW_RECORD_3(Id, a0, a1, a2) SEGGER_SYSVIEW_RecordU32x3((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2))
+#define SEGGER_SYSVIEW_RECORD_4(Id, a0, a1, a2, a3) SEGGER_SYSVIEW_RecordU32x4((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3))
+#define SEGGER_SYSVIEW_RECORD_5(Id, a0, a1, a2, a3, a4) SEGGER_SYSVIEW_RecordU32x5((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3), SEGGER_SYSVIEW_U32_ARG(a4))
+#define SEGGER_SYSVIEW_RECORD_6(Id, a0, a1, a2, a3, a4, a5) SEGGER_SYSVIEW_RecordU32x6((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3), SEGGER_SYSVIEW_U32_ARG(a4), SEGGER_SYSVIEW_U32_ARG(a5))
+#define SEGGER_SYSVIEW_RECORD_7(Id, a0, a1, a2, a3, a4, a5, a6) SEGGER_SYSVIEW_RecordU32x7((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3), SEGGER_SYSVIEW_U32_ARG(a4), SEGGER_SYSVIEW_U32_ARG(a5), SEGGER_SYSVIEW_U32_ARG(a6))
+#define SEGGER_SYSVIEW_RECORD_8(Id, a0, a1, a2, a3, a4, a5, a6, a7) SEGGER_SYSVIEW_RecordU32x8((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3), SEGGER_SYSVIEW_U32_ARG(a4), SEGGER_SYSVIEW_U32_ARG(a5), SEGGER_SYSVIEW_U32_ARG(a6), SEGGER_SYSVIEW_U32_ARG(a7))
+#define SEGGER_SYSVIEW_RECORD_9(Id, a0, a1, a2, a3, a4, a5, a6, a7, a8) SEGGER_SYSVIEW_RecordU32x9((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3), SEGGER_SYSVIEW_U32_ARG(a4), SEGGER_SYSVIEW_U32_ARG(a5), SEGGER_SYSVIEW_U32_ARG(a6), SEGGER_SYSVIEW_U32_ARG(a7), SEGGER_SYSVIEW_U32_ARG(a8))
+#define SEGGER_SYSVIEW_RECORD_10(Id, a0, a1, a2, a3, a4, a5, a6, a7, a8, a9) SEGGER_SYSVIEW_RecordU32x10((Id), SEGGER_SYSVIEW_U32_ARG(a0), SEGGER_SYSVIEW_U32_ARG(a1), SEGGER_SYSVIEW_U32_ARG(a2), SEGGER_SYSVIEW_U32_ARG(a3), SEGGER_SYSVIEW_U32_ARG(a4), SEGGER_SYSVIEW_U32_ARG(a5), SEGGER_SYSVIEW_U32_ARG(a6), SEGGER_SYSVIEW_U32_ARG(a7), SEGGER_SYSVIEW_U32_ARG(a8), SEGGER_SYSVIEW_U32_ARG(a9))
+#define SEGGER_SYSVIEW_RECORD_11(...)     SEGGER_SYSVIEW_RECORD_N(__VA_ARGS__)
+#define SEGGER_SYSVIEW_RECORD_12(...)     SEGGER_SYSVIEW_RECORD_N(__VA_ARGS__)
+#define SEGGER_SYSVIEW_RECORD_13(...)     SEGGER_SYSVIEW_RECORD_N(__VA_ARGS__)
+#define SEGGER_SYSVIEW_RECORD_14(...)     SEGGER_SYSVIEW_RECORD_N(__VA_ARGS__)
+#define SEGGER_SYSVIEW_RECORD_15(...)     SEGGER_SYSVIEW_RECORD_N(__VA_ARGS__)
+#define SEGGER_SYSVIEW_RECORD_16(...)     SEGGER_SYSVIEW_RECORD_N(__VA_ARGS__)
+#define SEGGER_SYSVIEW_RECORD_N(...)      \
+  do {                                                                                                         \
+    const U32 _aSysViewPara[] = { SEGGER_SYSVIEW_U32_ARGS(__VA_ARGS__) };                                      \
+    SEGGER_SYSVIEW_RecordU32s(SEGGER_SYSVIEW_FIRST_ARG(__VA_ARGS__), _aSysViewPara, SEGGER_SYSVIEW_NUM_VA_ARGS(__VA_ARGS__)); \
+  } while (0)
 
 /*********************************************************************
 *
@@ -330,6 +520,53 @@ void SEGGER_SYSVIEW_WarnfHost                     (const char* s, ...);
 void SEGGER_SYSVIEW_WarnfTarget                   (const char* s, ...);
 void SEGGER_SYSVIEW_ErrorfHost                    (const char* s, ...);
 void SEGGER_SYSVIEW_ErrorfTarget                  (const char* s, ...);
+
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 1)
+void SEGGER_SYSVIEW_PrintfDeferred                (const char* s, U32 Options, const U32* paArg, unsigned NumArgs);
+#endif
+
+/*********************************************************************
+*
+*       printf-Style macros
+*
+*  SEGGER_SYSVIEW_PRINTF_HOST(), SEGGER_SYSVIEW_WARNF_HOST() and
+*  SEGGER_SYSVIEW_ERRORF_HOST() take a string literal as format and up
+*  to 16 integer or pointer arguments. With GCC and clang, the format
+*  is checked against the arguments at compile time. With
+*  SEGGER_SYSVIEW_USE_DEFERRED_PRINTF, the arguments are counted and
+*  converted to U32 at compile time and SEGGER_SYSVIEW_PrintfDeferred()
+*  sends them with the address of the literal, without va_list and
+*  without parsing the format on target. Otherwise they call
+*  SEGGER_SYSVIEW_PrintfHost() and its variants.
+*  Only the conversions %d, %i, %u, %x, %X, %c, %p and %s, with flags
+*  and width, are allowed in the format, as each argument is sent as
+*  one U32. Arguments wider than 32 bits and, with GCC and clang, float
+*  arguments fail to compile, see SEGGER_SYSVIEW_U32_ARG(). Formats with
+*  %f, %e, %g, %ll or %j are not rejected at compile time; the host
+*  prints such a conversion as it is.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+int SEGGER_SYSVIEW_CheckFormat                    (const char* s, ...) __attribute__((format(printf, 1, 2)));  // Only used in sizeof(), not defined
+  #define SEGGER_SYSVIEW_CHECK_FORMAT(...)        ((void)sizeof(SEGGER_SYSVIEW_CheckFormat("" __VA_ARGS__)))
+#else
+  #define SEGGER_SYSVIEW_CHECK_FORMAT(...)        ((void)sizeof(SEGGER_SYSVIEW_FIRST_ARG("" __VA_ARGS__)))
+#endif
+
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 1)
+  #define SEGGER_SYSVIEW_PRINTF_DEFERRED(Options, ...)                                                          \
+    do {                                                                                                        \
+      const U32 _aSysViewArg[SEGGER_SYSVIEW_NUM_VA_ARGS(__VA_ARGS__) + 1] = { SEGGER_SYSVIEW_U32_ARGS(__VA_ARGS__) 0 }; \
+      SEGGER_SYSVIEW_CHECK_FORMAT(__VA_ARGS__);                                                                 \
+      SEGGER_SYSVIEW_PrintfDeferred("" SEGGER_SYSVIEW_FIRST_ARG(__VA_ARGS__), (Options), _aSysViewArg, SEGGER_SYSVIEW_NUM_VA_ARGS(__VA_ARGS__)); \
+    } while (0)
+  #define SEGGER_SYSVIEW_PRINTF_HOST(...)         SEGGER_SYSVIEW_PRINTF_DEFERRED(SEGGER_SYSVIEW_LOG,     __VA_ARGS__)
+  #define SEGGER_SYSVIEW_WARNF_HOST(...)          SEGGER_SYSVIEW_PRINTF_DEFERRED(SEGGER_SYSVIEW_WARNING, __VA_ARGS__)
+  #define SEGGER_SYSVIEW_ERRORF_HOST(...)         SEGGER_SYSVIEW_PRINTF_DEFERRED(SEGGER_SYSVIEW_ERROR,   __VA_ARGS__)
+#else
+  #define SEGGER_SYSVIEW_PRINTF_HOST(...)         do { SEGGER_SYSVIEW_CHECK_FORMAT(__VA_ARGS__); SEGGER_SYSVIEW_PrintfHost(__VA_ARGS__); } while (0)
+  #define SEGGER_SYSVIEW_WARNF_HOST(...)          do { SEGGER_SYSVIEW_CHECK_FORMAT(__VA_ARGS__); SEGGER_SYSVIEW_WarnfHost(__VA_ARGS__);  } while (0)
+  #define SEGGER_SYSVIEW_ERRORF_HOST(...)         do { SEGGER_SYSVIEW_CHECK_FORMAT(__VA_ARGS__); SEGGER_SYSVIEW_ErrorfHost(__VA_ARGS__); } while (0)
+#endif
 #endif
 
 void SEGGER_SYSVIEW_Print                         (const char* s);
@@ -342,6 +579,13 @@ void SEGGER_SYSVIEW_Error                         (const char* s);
 */
 void SEGGER_SYSVIEW_EnableEvents                  (U32 EnableMask);
 void SEGGER_SYSVIEW_DisableEvents                 (U32 DisableMask);
+void SEGGER_SYSVIEW_EnableEventRange              (U32 FirstId, U32 NumIds);
+void SEGGER_SYSVIEW_DisableEventRange             (U32 FirstId, U32 NumIds);
+int  SEGGER_SYSVIEW_SetTaskFilter                 (unsigned Index, U32 TaskId);
+int  SEGGER_SYSVIEW_SetSampling                   (U32 EventId, unsigned Ratio);
+int  SEGGER_SYSVIEW_SetClassSampling              (unsigned Class, unsigned Ratio, const U32* paEventId, unsigned NumEventIds);
+int  SEGGER_SYSVIEW_CountSampled                  (unsigned Class);
+void SEGGER_SYSVIEW_SetBufferMode                 (unsigned Mode);
 
 /*********************************************************************
 *
@@ -234,6 +234,137 @@ extern "C" {
   #define SEGGER_SYSVIEW_TIMESTAMP_BITS           32
 #endif
 
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_TIMESTAMP_SHIFT
+*
+*  Description
+*    Number of low-order timestamp bits which are not sent.
+*  Default
+*    0: Timestamps are sent with full resolution.
+*  Notes
+*    Timestamp deltas are sent in units of (1 << SEGGER_SYSVIEW_TIMESTAMP_SHIFT)
+*    timestamp ticks, which saves one byte per event for every 7 bits.
+*    The remainder is carried over to the next event, so no time is lost.
+*    The timestamp frequency reported to the host is divided accordingly,
+*    so the stream stays compatible with SystemView.
+*    E.g. 4 with a 1 GHz cycle counter gives a resolution of 16 ns.
+*    Not available with SEGGER_SYSVIEW_NUM_SHARDS > 1.
+*/
+#ifndef   SEGGER_SYSVIEW_TIMESTAMP_SHIFT
+  #define SEGGER_SYSVIEW_TIMESTAMP_SHIFT          0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_DELTA_OF_DELTA
+*
+*  Description
+*    If enabled, each packet ends with the difference of its timestamp
+*    delta to the delta of the previous packet instead of the delta.
+*  Default
+*    0: Disabled.
+*  Notes
+*    The difference is sent zig-zag encoded, so events with a regular
+*    period, e.g. tick interrupts or sampling loops, take a 1 byte
+*    timestamp instead of 3 to 4 bytes.
+*    The chain is reset to a previous delta of 0 by each sync and by each
+*    shard sync packet.
+*    The stream is not compatible with SystemView. It has to be converted
+*    with the host tool sysview_expand (Tools/SYSVIEW_Expand.c) first.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_DELTA_OF_DELTA
+  #define SEGGER_SYSVIEW_USE_DELTA_OF_DELTA       0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_TIME64
+*
+*  Description
+*    If enabled, the recorder extends the 32-bit system timestamp to
+*    64 bits by counting its wraps.
+*  Default
+*    0: Disabled.
+*  Notes
+*    The extended time is read with SEGGER_SYSVIEW_GetTime64() and
+*    SEGGER_SYSVIEW_GetTimeUs(), which are lock-free and may be called
+*    from any context.
+*    The wraps are counted on each recorded event and by
+*    SEGGER_SYSVIEW_UpdateTime64(), which has to be called at least once
+*    per half wrap period of the timestamp, e.g. from the system tick.
+*    It also records a SYSTIME_CYCLES event when nothing has been recorded
+*    for SEGGER_SYSVIEW_SYSTIME_PERIOD, so the timestamp delta of the next
+*    event does not wrap in long idle phases.
+*    Requires SEGGER_SYSVIEW_TIMESTAMP_BITS == 32.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_TIME64
+  #define SEGGER_SYSVIEW_USE_TIME64               0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SYSTIME_PERIOD
+*
+*  Description
+*    Number of timestamp ticks without a recorded event after which
+*    SEGGER_SYSVIEW_UpdateTime64() records a SYSTIME_CYCLES event.
+*  Default
+*    0x40000000: A quarter of the wrap period, 1.07 s at 1 GHz.
+*  Notes
+*    Has to be less than the wrap period minus the longest time between
+*    two calls of SEGGER_SYSVIEW_UpdateTime64().
+*/
+#ifndef   SEGGER_SYSVIEW_SYSTIME_PERIOD
+  #define SEGGER_SYSVIEW_SYSTIME_PERIOD           0x40000000u
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_NUM_LOAD_TASKS
+*
+*  Description
+*    Number of tasks of which the recorder accounts the CPU load on
+*    the target. Has to be a power of 2, the report has to fit into
+*    SEGGER_SYSVIEW_MAX_PACKET_SIZE, which allows up to 16 tasks with
+*    the default sizes.
+*  Default
+*    0: No load accounting.
+*  Notes
+*    The time between the scheduler and interrupt events is summed up
+*    per task, for the idle task and for interrupts, also when the
+*    events themselves are disabled. A SYSVIEW_EVTID_EX_LOAD report with
+*    the load of each task which has run is sent every
+*    SEGGER_SYSVIEW_LOAD_PERIOD and by SEGGER_SYSVIEW_RecordLoad(). So
+*    with the scheduler events disabled, the host still gets the load
+*    of each task at a few bytes per report. The time is accounted in
+*    the critical section of the event, with the time stamp of its
+*    packet.
+*    Tasks which do not fit into the table are reported as the rest of
+*    the period. Accounts the time of one core.
+*/
+#ifndef   SEGGER_SYSVIEW_NUM_LOAD_TASKS
+  #define SEGGER_SYSVIEW_NUM_LOAD_TASKS           0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_LOAD_PERIOD
+*
+*  Description
+*    Number of timestamp ticks after which the next scheduler or
+*    interrupt event sends the load report.
+*  Default
+*    0x40000000: 1.07 s at 1 GHz.
+*  Notes
+*    0: Reports are only sent by SEGGER_SYSVIEW_RecordLoad().
+*    The time between two events is accounted modulo the wrap period
+*    of the timestamp.
+*/
+#ifndef   SEGGER_SYSVIEW_LOAD_PERIOD
+  #define SEGGER_SYSVIEW_LOAD_PERIOD              0x40000000u
+#endif
+
 /*********************************************************************
 *
 *       Define: SEGGER_SYSVIEW_RTT_CHANNEL
@@ -404,6 +535,31 @@ extern "C" {
   #define SEGGER_SYSVIEW_PRINTF_IMPLICIT_FORMAT   0
 #endif
 
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_DEFERRED_PRINTF
+*
+*  Description
+*    If enabled, SEGGER_SYSVIEW_PrintfHost() and its variants send
+*    the address of the format string instead of the string, followed
+*    by the arguments.
+*  Default
+*    0: Disabled.
+*  Notes
+*    The format string has to be a constant, which is kept in the
+*    application's ELF file. The host tool Tools/SYSVIEW_Printf.c
+*    formats the message with the strings of the ELF file.
+*    "%s" arguments are shown when they point into the ELF file, too.
+*    With SEGGER_SYSVIEW_PRINTF_IMPLICIT_FORMAT, messages with "%s"
+*    are formatted on the target instead.
+*    Messages with 64-bit or floating-point arguments, e.g. "%lld" or
+*    "%f", are not sent.
+*    The SystemView Application does not show deferred messages.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_DEFERRED_PRINTF
+  #define SEGGER_SYSVIEW_USE_DEFERRED_PRINTF      0
+#endif
+
 /*********************************************************************
 *
 *       Define: SEGGER_SYSVIEW_USE_INTERNAL_RECORDER
@@ -472,6 +628,121 @@ extern "C" {
   #define SEGGER_SYSVIEW_USE_STATIC_BUFFER        1
 #endif
 
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_RESERVE_COMMIT
+*
+*  Description
+*    If enabled, packets are written to the RTT buffer by reserving
+*    space under lock and copying the packet after the lock has been
+*    released.
+*  Default
+*    0: Disabled.
+*  Notes
+*    SystemView is only locked to take the timestamp and reserve space,
+*    and again to commit the packet. Copying the packet into the RTT
+*    buffer does not mask interrupts, so multiple tasks, interrupts or
+*    threads can copy their packets concurrently. A committed packet is
+*    sent as soon as all packets reserved before it are committed.
+*    At most SEGGER_RTT_MAX_NUM_RESERVATIONS packets can be pending,
+*    further packets are dropped until one is committed.
+*    Requires SEGGER_SYSVIEW_USE_STATIC_BUFFER == 0.
+*    Not available in post mortem mode.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_RESERVE_COMMIT
+  #define SEGGER_SYSVIEW_USE_RESERVE_COMMIT       0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING
+*
+*  Description
+*    If enabled, fixed-size event packets are encoded directly into
+*    the RTT buffer instead of the static packet buffer.
+*  Default
+*    0: Disabled.
+*  Notes
+*    Saves copying the packet into the RTT buffer for the events
+*    recorded most often, e.g. SEGGER_SYSVIEW_RecordU32() or task and
+*    ISR events. Packets which would wrap around at the end of the RTT
+*    buffer, or do not fit, are encoded and copied as usual.
+*    Requires SEGGER_SYSVIEW_USE_STATIC_BUFFER == 1.
+*    Not available in post mortem mode.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING
+  #define SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING    0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_NUM_SHARDS
+*
+*  Description
+*    Number of RTT up-channels ("shards") SystemView records to.
+*  Default
+*    1: All events are recorded to a single channel.
+*  Notes
+*    With more than one shard, each execution context records to its
+*    own channel, selected by SEGGER_SYSVIEW_GET_SHARD(), with its own
+*    timestamp delta and overflow state. Each shard starts with, and
+*    periodically repeats, a sync packet holding the absolute timestamp,
+*    which allows the host to merge the shards into one stream.
+*    Shard 0 uses the SystemView channel and handles host commands.
+*    Shards 1 .. SEGGER_SYSVIEW_NUM_SHARDS - 1 are allocated with the
+*    name "SysViewShard" in ascending order.
+*    Not available in post mortem mode.
+*/
+#ifndef   SEGGER_SYSVIEW_NUM_SHARDS
+  #define SEGGER_SYSVIEW_NUM_SHARDS               1
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_GET_SHARD()
+*
+*  Description
+*    Function macro to get the shard the current context records to.
+*  Default
+*    0 in thread mode, 1 in interrupts.
+*  Notes
+*    Must return a value < SEGGER_SYSVIEW_NUM_SHARDS.
+*    Contexts which may preempt each other without SEGGER_SYSVIEW_LOCK()
+*    protecting them, such as the cores of a multi-core device with a
+*    core-local lock, must record to different shards.
+*    Can be defined to the core ID or the NVIC preemption group of the
+*    active interrupt.
+*/
+#ifndef   SEGGER_SYSVIEW_GET_SHARD
+  #define SEGGER_SYSVIEW_GET_SHARD()              ((SEGGER_SYSVIEW_GET_INTERRUPT_ID() != 0u) ? 1u : 0u)
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SHARD_BUFFER_SIZE
+*
+*  Description
+*    Number of bytes of the RTT buffer of each additional shard.
+*  Default
+*    SEGGER_SYSVIEW_RTT_BUFFER_SIZE
+*/
+#ifndef   SEGGER_SYSVIEW_SHARD_BUFFER_SIZE
+  #define SEGGER_SYSVIEW_SHARD_BUFFER_SIZE        SEGGER_SYSVIEW_RTT_BUFFER_SIZE
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SHARD_SYNC_PERIOD_SHIFT
+*
+*  Description
+*    Configure how frequently a shard repeats its sync packet.
+*  Default
+*    8: (1 << 8) = Every 256 Events.
+*/
+#ifndef   SEGGER_SYSVIEW_SHARD_SYNC_PERIOD_SHIFT
+  #define SEGGER_SYSVIEW_SHARD_SYNC_PERIOD_SHIFT  8
+#endif
+
 /*********************************************************************
 *
 *       Define: SEGGER_SYSVIEW_MAX_PACKET_SIZE
@@ -524,6 +795,258 @@ extern "C" {
   #define SEGGER_SYSVIEW_SYNC_PERIOD_SHIFT        8
 #endif
 
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_CHECKPOINTS
+*
+*  Description
+*    If enabled, post-mortem mode sends a checkpoint every
+*    (1 << SEGGER_SYSVIEW_SYNC_PERIOD_SHIFT) packets instead of the full
+*    system description, task list and module list.
+*  Default
+*    0: Disabled.
+*  Notes
+*    A checkpoint is a sync and a SYSVIEW_EVTID_EX_CHECKPOINT packet
+*    with the absolute time stamp, the packet sequence number and the
+*    location of the last full description. The full description is
+*    only sent when the task list or the modules change, or when it
+*    is older than half of SEGGER_SYSVIEW_RTT_BUFFER_SIZE.
+*    SEGGER_SYSVIEW_LastCheckpoint locates the most recent checkpoint
+*    in the buffer. The host tool sysview_snapshot
+*    (Tools/SYSVIEW_Snapshot.c) extracts a stream from a dump.
+*    Only available with SEGGER_SYSVIEW_POST_MORTEM_MODE.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_CHECKPOINTS
+  #define SEGGER_SYSVIEW_USE_CHECKPOINTS          0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_DROP_STATS
+*
+*  Description
+*    If enabled, packets which are dropped as the RTT buffer is full
+*    are counted per event class, see SEGGER_SYSVIEW_DROP_CLASS_*.
+*  Default
+*    0: Disabled.
+*  Notes
+*    The counts are sent in a SYSVIEW_EVTID_EX_DROP_STATS packet
+*    after each overflow packet, and can be read on target with
+*    SEGGER_SYSVIEW_GetDropCounts(). Needs 4 bytes of RAM per class
+*    and shard.
+*    Not available in post mortem mode.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_DROP_STATS
+  #define SEGGER_SYSVIEW_USE_DROP_STATS           0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_LOAD_SHEDDING
+*
+*  Description
+*    If enabled, events of low priority classes are dropped when the
+*    RTT buffer is filled above their high-water mark, to keep space
+*    for scheduler, interrupt and system events.
+*  Default
+*    0: Disabled.
+*  Notes
+*    The classes are set by SEGGER_SYSVIEW_SHED_CLASSES_LOW and
+*    SEGGER_SYSVIEW_SHED_CLASSES_NORMAL, the high-water marks by
+*    SEGGER_SYSVIEW_SHED_HEADROOM_LOW and SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL.
+*    Shed events are reported by the overflow packet and counted
+*    by SEGGER_SYSVIEW_USE_DROP_STATS like other dropped events.
+*    Not available in post mortem mode.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_LOAD_SHEDDING
+  #define SEGGER_SYSVIEW_USE_LOAD_SHEDDING        0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SHED_CLASSES_LOW
+*
+*  Description
+*    Mask of the event classes, (1 << SEGGER_SYSVIEW_DROP_CLASS_*),
+*    which are shed first.
+*  Default
+*    Print, API calls and module events.
+*/
+#ifndef   SEGGER_SYSVIEW_SHED_CLASSES_LOW
+  #define SEGGER_SYSVIEW_SHED_CLASSES_LOW         ((1u << SEGGER_SYSVIEW_DROP_CLASS_PRINT) | (1u << SEGGER_SYSVIEW_DROP_CLASS_API) | (1u << SEGGER_SYSVIEW_DROP_CLASS_MODULE))
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SHED_CLASSES_NORMAL
+*
+*  Description
+*    Mask of the event classes, (1 << SEGGER_SYSVIEW_DROP_CLASS_*),
+*    which are shed when the buffer is filled further.
+*    Classes in neither mask are only dropped when the buffer is full.
+*  Default
+*    Task information, timers and markers.
+*/
+#ifndef   SEGGER_SYSVIEW_SHED_CLASSES_NORMAL
+  #define SEGGER_SYSVIEW_SHED_CLASSES_NORMAL      ((1u << SEGGER_SYSVIEW_DROP_CLASS_TASK) | (1u << SEGGER_SYSVIEW_DROP_CLASS_TIMER) | (1u << SEGGER_SYSVIEW_DROP_CLASS_MARK))
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SHED_HEADROOM_LOW
+*
+*  Description
+*    Number of bytes which have to be free in the RTT buffer to record
+*    an event of SEGGER_SYSVIEW_SHED_CLASSES_LOW.
+*  Default
+*    A quarter of SEGGER_SYSVIEW_RTT_BUFFER_SIZE.
+*  Notes
+*    Applies to the buffer of every shard. With
+*    SEGGER_SYSVIEW_USE_RESERVE_COMMIT, space which is reserved but not
+*    committed yet is counted as free.
+*/
+#ifndef   SEGGER_SYSVIEW_SHED_HEADROOM_LOW
+  #define SEGGER_SYSVIEW_SHED_HEADROOM_LOW        (SEGGER_SYSVIEW_RTT_BUFFER_SIZE / 4)
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL
+*
+*  Description
+*    Number of bytes which have to be free in the RTT buffer to record
+*    an event of SEGGER_SYSVIEW_SHED_CLASSES_NORMAL.
+*  Default
+*    An eighth of SEGGER_SYSVIEW_RTT_BUFFER_SIZE.
+*/
+#ifndef   SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL
+  #define SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL     (SEGGER_SYSVIEW_RTT_BUFFER_SIZE / 8)
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_USE_EVENT_FILTER
+*
+*  Description
+*    If enabled, events are filtered by the bitmap
+*    SEGGER_SYSVIEW_aDisabledEvents, which covers the event IDs below
+*    SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS, including the OS API events
+*    and module events.
+*    SEGGER_SYSVIEW_RECORD() checks the bitmap before its parameters
+*    are evaluated, so a disabled event costs a load and a branch.
+*    Events recorded by other functions are checked when the packet
+*    is sent.
+*    The host sets the bitmap with the command
+*    SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER.
+*  Default
+*    0: Disabled. SEGGER_SYSVIEW_DisableEvents() filters the events
+*       with IDs below 32 only.
+*/
+#ifndef   SEGGER_SYSVIEW_USE_EVENT_FILTER
+  #define SEGGER_SYSVIEW_USE_EVENT_FILTER         0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS
+*
+*  Description
+*    Number of event IDs covered by SEGGER_SYSVIEW_USE_EVENT_FILTER.
+*    Events with higher IDs are always recorded.
+*    Has to be a multiple of 32.
+*  Default
+*    1024: Core events, OS API events and the events of the first
+*          modules, which start at 512.
+*/
+#ifndef   SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS
+  #define SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS     1024
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_NUM_TASK_FILTERS
+*
+*  Description
+*    Number of tasks which can be selected by the task filter.
+*    When at least one task is selected, API, user and module events
+*    are only recorded while a selected task or no task is running.
+*    Scheduler, interrupt and system events are always recorded.
+*    Tasks are selected by SEGGER_SYSVIEW_SetTaskFilter() or by the
+*    host with SEGGER_SYSVIEW_COMMAND_ID_SET_TASK_FILTER.
+*  Default
+*    0: No task filter.
+*  Notes
+*    Events recorded from interrupts are filtered with the task
+*    they interrupt.
+*/
+#ifndef   SEGGER_SYSVIEW_NUM_TASK_FILTERS
+  #define SEGGER_SYSVIEW_NUM_TASK_FILTERS         0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS
+*
+*  Description
+*    Number of event IDs which can be sampled. Only one of every n
+*    events of a sampled ID is recorded, starting with the first one.
+*    Sampling is set by SEGGER_SYSVIEW_SetSampling() or by the host
+*    with SEGGER_SYSVIEW_COMMAND_ID_SET_SAMPLING.
+*  Default
+*    0: No sampling.
+*/
+#ifndef   SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS
+  #define SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS       0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES
+*
+*  Description
+*    Number of event classes which are sampled where the events are
+*    recorded with SEGGER_SYSVIEW_RECORD_SAMPLED(). Only one of every
+*    n events of a class is recorded, starting with the first one,
+*    and the parameters of the others are not evaluated.
+*    The ratio of a class is set by SEGGER_SYSVIEW_SetClassSampling()
+*    or by the host with SEGGER_SYSVIEW_COMMAND_ID_SET_CLASS_SAMPLING.
+*  Default
+*    0: No sampling by class, all events are recorded.
+*  Notes
+*    The counter of a sampled class is updated under
+*    SEGGER_SYSVIEW_LOCK(), so events of a class which are recorded
+*    concurrently keep the exact ratio.
+*/
+#ifndef   SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES
+  #define SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES       0
+#endif
+
+/*********************************************************************
+*
+*       Define: SEGGER_SYSVIEW_NUM_TASK_IDS
+*
+*  Description
+*    Number of tasks which are sent to the host with a small ID of
+*    1 to SEGGER_SYSVIEW_NUM_TASK_IDS instead of the shrunk task ID.
+*    A task gets its ID in SEGGER_SYSVIEW_OnTaskCreate() or
+*    SEGGER_SYSVIEW_SendTaskInfo() and frees it in
+*    SEGGER_SYSVIEW_OnTaskTerminate(). IDs of up to 127 are encoded
+*    in one byte, so with up to 64 IDs the task ID of every scheduler
+*    event takes one byte. 128 and more take two bytes for some tasks.
+*    Must be a power of 2. Takes 8 bytes of RAM per ID.
+*  Default
+*    0: Task IDs are shrunk with SEGGER_SYSVIEW_ID_BASE and
+*       SEGGER_SYSVIEW_ID_SHIFT.
+*  Notes
+*    Tasks which do not get an ID, as all are in use, are sent with
+*    their shrunk ID plus SEGGER_SYSVIEW_NUM_TASK_IDS + 1.
+*    Task handles passed as parameters of OS API events have to be
+*    shrunk with SEGGER_SYSVIEW_ShrinkTaskId().
+*/
+#ifndef   SEGGER_SYSVIEW_NUM_TASK_IDS
+  #define SEGGER_SYSVIEW_NUM_TASK_IDS             0
+#endif
+
 /*********************************************************************
 *
 *       Define: SEGGER_SYSVIEW_ON_EVENT_RECORDED()
@@ -87,7 +87,13 @@ typedef enum {
   SEGGER_SYSVIEW_COMMAND_ID_GET_MODULEDESC,
   SEGGER_SYSVIEW_COMMAND_ID_HEARTBEAT = 127,
   // Extended commands: Commands >= 128 have a second parameter
-  SEGGER_SYSVIEW_COMMAND_ID_GET_MODULE = 128
+  SEGGER_SYSVIEW_COMMAND_ID_GET_MODULE = 128,
+  SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER,   // Parameter: Word index, followed by the U32 of disabled events, little endian
+  SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_RANGE,    // Parameter: 1 to disable, 0 to enable, followed by the U16 of the first ID and the U16 of the number of IDs
+  SEGGER_SYSVIEW_COMMAND_ID_SET_TASK_FILTER,    // Parameter: Index in the task filter, followed by the U32 of the task ID as sent to the host, 0 to clear
+  SEGGER_SYSVIEW_COMMAND_ID_SET_SAMPLING,       // Parameter: Ratio, 0 or 1 to record all events, followed by the U16 of the event ID
+  SEGGER_SYSVIEW_COMMAND_ID_SET_BUFFER_MODE,    // Parameter: SEGGER_SYSVIEW_BUFFER_MODE_*
+  SEGGER_SYSVIEW_COMMAND_ID_SET_CLASS_SAMPLING  // Parameter: Ratio, 0 or 1 to record all events, followed by the class
 } SEGGER_SYSVIEW_COMMAND_ID;
 
 #ifdef __cplusplus
@@ -175,6 +175,11 @@ void USART2_IRQHandler(void)
 {
 	SEGGER_UARTX_IRQHandler();
 }
+
+void DMA1_Stream6_IRQHandler(void)
+{
+	SEGGER_UART_DMA_IRQHandler();
+}
 /******************************************************************************/
 /* STM32F4xx Peripheral Interrupt Handlers                                    */
 /* Add here the Interrupt Handlers for the used peripherals.                  */
@@ -79,8 +79,9 @@ Additional information:
 **********************************************************************
 */
 extern void SEGGER_UARTX_IRQHandler(void);
-extern void HIF_UART_EnableTXEInterrupt  (void);
-#define SEGGER_SYSVIEW_ON_EVENT_RECORDED(x)  HIF_UART_EnableTXEInterrupt()
+extern void SEGGER_UART_DMA_IRQHandler(void);
+extern void SEGGER_UART_OnEventRecorded  (void);
+#define SEGGER_SYSVIEW_ON_EVENT_RECORDED(x)  SEGGER_UART_OnEventRecorded()
 void SEGGER_UART_init(USART_TypeDef * instance, U32 baud, U32 intNum);
 
 #endif  // SEGGER_SYSVIEW_CONF_H
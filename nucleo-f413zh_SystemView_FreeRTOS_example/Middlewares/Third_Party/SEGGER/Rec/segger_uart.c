@@ -9,77 +9,79 @@ Purpose : Terminal control for Flasher using USART1 on PA9/PA10
 
 #include "SEGGER_SYSVIEW.h"
 #include "SEGGER_RTT.h"
+#include "segger_uart_core.h"
 
 /* Adjust priority of SEGEGR UART interrupt routine to match your FreeRTOSConfig.h file */
 #define SEGGER_UART_PRIORITY_LEVEL 6
 
-static UART_HandleTypeDef seggerUart;
-
-typedef void UART_ON_RX_FUNC(uint8_t Data);
-typedef int  UART_ON_TX_FUNC(uint8_t* pChar);
-
-typedef UART_ON_TX_FUNC* UART_ON_TX_FUNC_P;
-typedef UART_ON_RX_FUNC* UART_ON_RX_FUNC_P;
-
-
-static UART_ON_RX_FUNC_P _cbOnRx;
-static UART_ON_TX_FUNC_P _cbOnTx;
-
+/* Maximum number of bytes of the RTT up-buffer sent by one DMA transfer.
+ * The span is only freed in the up-buffer when the transfer has completed. */
+#define SEGGER_UART_MAX_XFER_SIZE  256
 
-void HIF_UART_Init(USART_TypeDef * instance, uint32_t baudrate, uint32_t intNum, UART_ON_TX_FUNC_P cbOnTx, UART_ON_RX_FUNC_P cbOnRx);
+/* DMA stream and channel of the Tx request of the UART, see the DMA1 request mapping in RM0430.
+ * The defaults are for USART2. Call SEGGER_UART_DMA_IRQHandler() from the handler of SEGGER_UART_DMA_IRQn. */
+#ifndef SEGGER_UART_DMA_STREAM
+  #define SEGGER_UART_DMA_STREAM   DMA1_Stream6
+  #define SEGGER_UART_DMA_CHANNEL  DMA_CHANNEL_4
+  #define SEGGER_UART_DMA_IRQn     DMA1_Stream6_IRQn
+  #define SEGGER_UART_DMA_CLK_ENABLE()  __HAL_RCC_DMA1_CLK_ENABLE()
+#endif
 
+static UART_HandleTypeDef seggerUart;
+static DMA_HandleTypeDef  seggerUartDma;
 
-#define _SERVER_HELLO_SIZE        (4)
-#define _TARGET_HELLO_SIZE        (4)
-
-static const U8 _abHelloMsg[_TARGET_HELLO_SIZE] = { 'S', 'V', (SEGGER_SYSVIEW_VERSION / 10000), (SEGGER_SYSVIEW_VERSION / 1000) % 10 };  // "Hello" message expected by SysView: [ 'S', 'V', <PROTOCOL_MAJOR>, <PROTOCOL_MINOR> ]
-
-static struct {
-  U8         NumBytesHelloRcvd;
-  U8         NumBytesHelloSent;
-  int        ChannelID;
-} _SVInfo = {0,0,1};
-
-static void _StartSysView(void) {
-  int r;
+void HIF_UART_Init(USART_TypeDef * instance, uint32_t baudrate, uint32_t intNum);
 
-  r = SEGGER_SYSVIEW_IsStarted();
-  if (r == 0) {
-    SEGGER_SYSVIEW_Start();
+/*********************************************************************
+*
+*       _StartTx()
+*
+*  Function description
+*    Starts a DMA transfer of a span to the data register.
+*
+*  Return value
+*    == 0: Transfer started.
+*     < 0: DMA busy or in error, no completion interrupt follows.
+*/
+static int _StartTx(const U8* pData, unsigned NumBytes) {
+  if (HAL_DMA_Start_IT(&seggerUartDma, (uint32_t)pData, (uint32_t)&seggerUart.Instance->DR, NumBytes) != HAL_OK) {
+    return -1;
   }
+  return 0;
 }
 
-static void _cbOnUARTRx(U8 Data) {
-  if (_SVInfo.NumBytesHelloRcvd < _SERVER_HELLO_SIZE) {  // Not all bytes of <Hello> message received by SysView yet?
-    _SVInfo.NumBytesHelloRcvd++;
-    goto Done;
-  }
-  _StartSysView();
-  SEGGER_RTT_WriteDownBuffer(_SVInfo.ChannelID, &Data, 1);  // Write data into corresponding RTT buffer for application to read and handle accordingly
-Done:
-  return;
+/*********************************************************************
+*
+*       _cbOnTxDone()
+*
+*  Function description
+*    Called by HAL_DMA_IRQHandler() when the DMA transfer has completed.
+*/
+static void _cbOnTxDone(DMA_HandleTypeDef* hdma) {
+  (void)hdma;
+  SEGGER_UART_CORE_OnTxDone();  // Free the span, start the next one if there is more data
 }
 
-static int _cbOnUARTTx(U8* pChar) {
-  int r;
-
-  if (_SVInfo.NumBytesHelloSent < _TARGET_HELLO_SIZE) {  // Not all bytes of <Hello> message sent to SysView yet?
-    *pChar = _abHelloMsg[_SVInfo.NumBytesHelloSent];
-    _SVInfo.NumBytesHelloSent++;
-    r = 1;
-    goto Done;
-  }
-  r = SEGGER_RTT_ReadUpBufferNoLock(_SVInfo.ChannelID, pChar, 1);
-  if (r < 0) {  // Failed to read from up buffer?
-    r = 0;
+/*********************************************************************
+*
+*       _cbOnTxError()
+*
+*  Function description
+*    Called by HAL_DMA_IRQHandler() on a DMA error.
+*    If the transfer has been aborted, the span is dropped, so the
+*    stream continues. Otherwise, e.g. on a FIFO error, the transfer
+*    continues and completes as usual.
+*/
+static void _cbOnTxError(DMA_HandleTypeDef* hdma) {
+  if (HAL_DMA_GetState(hdma) == HAL_DMA_STATE_READY) {
+    SEGGER_UART_CORE_OnTxDone();
   }
-Done:
-  return r;
 }
 
 void SEGGER_UART_init(USART_TypeDef * instance, U32 baud, U32 intNum)
 {
-	HIF_UART_Init(instance,baud,intNum, _cbOnUARTTx, _cbOnUARTRx);
+	HIF_UART_Init(instance,baud,intNum);
+	SEGGER_UART_CORE_Init(SEGGER_UART_MAX_XFER_SIZE, _StartTx);
 }
 
 
@@ -91,6 +93,7 @@ void HIF_UART_WaitForTxEnd(void) {
   //
   // Wait until transmission has finished (e.g. before changing baudrate).
   //
+  while (HAL_DMA_GetState(&seggerUartDma) == HAL_DMA_STATE_BUSY);   // Wait until DMA transfer is complete
   while ((READ_REG(seggerUart.Instance->SR) & USART_SR_TXE) == 0);  // Wait until transmit buffer empty (Last byte shift from data to shift register)
   while ((READ_REG(seggerUart.Instance->SR) & USART_SR_TC) == 0);   // Wait until transmission is complete
 }
@@ -101,7 +104,7 @@ void HIF_UART_WaitForTxEnd(void) {
 *
 *  Function descriptio
 *    Interrupt handler.
-*    Handles both, Rx and Tx interrupts
+*    Handles Rx interrupts. Tx is done by DMA, see SEGGER_UART_DMA_IRQHandler().
 *
 *  Notes
 *    (1) This is a high-prio interrupt so it may NOT use embOS functions
@@ -110,44 +113,39 @@ void HIF_UART_WaitForTxEnd(void) {
 void SEGGER_UARTX_IRQHandler(void) {
   int UsartStatus;
   uint8_t v;
-  int r;
 
   UsartStatus = READ_REG(seggerUart.Instance->SR);   // Examine status register
   if ((UsartStatus & USART_SR_RXNE) != 0) {            // Data received?
     v = seggerUart.Instance->DR;                     // Read data
     if ((UsartStatus & (U32)(USART_SR_PE |
     		USART_SR_FE | USART_SR_ORE | USART_SR_NE)) == 0) {   // Only process data if no error occurred
-      (void)v;                                         // Avoid warning in BTL
-      if (_cbOnRx) {
-        _cbOnRx(v);
-      }
-    }
-  }
-  if ((UsartStatus & USART_SR_TXE) != 0) {                // Tx (data register) empty? => Send next character Note: Shift register may still hold a character that has not been sent yet.
-    //
-    // Under special circumstances, (old) BTL of Flasher does not wait until a complete string has been sent via UART,
-    // so there might be an TxE interrupt pending *before* the FW had a chance to set the callbacks accordingly which would result in a NULL-pointer call...
-    // Therefore, we need to check if the function pointer is valid.
-    //
-    if (_cbOnTx == NULL) {  // No callback set? => Nothing to do...
-      return;
-    }
-    r = _cbOnTx(&v);
-    if (r == 0) {                          // No more characters to send ?
-      __HAL_UART_DISABLE_IT(&seggerUart, UART_IT_TXE); // Disable further tx interrupts
-    } else {
-      READ_REG(seggerUart.Instance->SR);      // Makes sure that "transmission complete" flag in USART_SR is reset to 0 as soon as we write USART_DR. If USART_SR is not read before, writing USART_DR does not clear "transmission complete". See STM32F4 USART documentation for more detailed description.
-      seggerUart.Instance->DR = v;  // Start transmission by writing to data register
+      SEGGER_UART_CORE_OnRx(v);
     }
   }
 }
 
 /*********************************************************************
 *
-*       HIF_UART_EnableTXEInterrupt()
+*       SEGGER_UART_DMA_IRQHandler
+*
+*  Function description
+*    Interrupt handler of the Tx DMA stream.
+*    Takes one interrupt per transfer instead of one per character.
 */
-void HIF_UART_EnableTXEInterrupt(void) {
-  __HAL_UART_ENABLE_IT(&seggerUart, UART_IT_TXE); // enable Tx empty interrupt => Triggered as soon as data register content has been copied to shift register
+void SEGGER_UART_DMA_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&seggerUartDma);
+}
+
+/*********************************************************************
+*
+*       SEGGER_UART_OnEventRecorded()
+*
+*  Function description
+*    Starts sending, if the UART is idle.
+*    Called on every event recorded by SystemView.
+*/
+void SEGGER_UART_OnEventRecorded(void) {
+  SEGGER_UART_CORE_Kick();
 }
 
 
@@ -156,7 +154,7 @@ void HIF_UART_EnableTXEInterrupt(void) {
 *
 *       HIF_UART_Init()
 */
-void HIF_UART_Init(USART_TypeDef * instance,uint32_t baudrate, uint32_t intNum, UART_ON_TX_FUNC_P cbOnTx, UART_ON_RX_FUNC_P cbOnRx) {
+void HIF_UART_Init(USART_TypeDef * instance,uint32_t baudrate, uint32_t intNum) {
 
 	seggerUart.Instance = instance;
 	seggerUart.Init.BaudRate = baudrate;
@@ -172,14 +170,35 @@ void HIF_UART_Init(USART_TypeDef * instance,uint32_t baudrate, uint32_t intNum,
 	  return;
 	}
 	//
-	// Setup callbacks which are called by ISR handler and enable interrupt in NVIC
+	// Setup Tx DMA: memory to data register, one byte per request, one interrupt per transfer
+	//
+	SEGGER_UART_DMA_CLK_ENABLE();
+	seggerUartDma.Instance = SEGGER_UART_DMA_STREAM;
+	seggerUartDma.Init.Channel = SEGGER_UART_DMA_CHANNEL;
+	seggerUartDma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	seggerUartDma.Init.PeriphInc = DMA_PINC_DISABLE;
+	seggerUartDma.Init.MemInc = DMA_MINC_ENABLE;
+	seggerUartDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	seggerUartDma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	seggerUartDma.Init.Mode = DMA_NORMAL;
+	seggerUartDma.Init.Priority = DMA_PRIORITY_LOW;
+	seggerUartDma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+	if (HAL_DMA_Init(&seggerUartDma) != HAL_OK)
+	{
+	  __disable_irq();
+	  return;
+	}
+	seggerUartDma.XferCpltCallback  = _cbOnTxDone;
+	seggerUartDma.XferErrorCallback = _cbOnTxError;
+	SET_BIT(seggerUart.Instance->CR3, USART_CR3_DMAT);  // UART requests DMA when the data register is empty
+	//
+	// Enable Rx interrupt and Tx DMA interrupt in NVIC
 	//
-	_cbOnRx = cbOnRx;
-	_cbOnTx = cbOnTx;
 	NVIC_SetPriority(intNum, SEGGER_UART_PRIORITY_LEVEL);  // Highest prio, so it is not disabled by FreeRTOS
+	NVIC_SetPriority(SEGGER_UART_DMA_IRQn, SEGGER_UART_PRIORITY_LEVEL);
 	__HAL_UART_ENABLE_IT(&seggerUart, UART_IT_RXNE);
-	__HAL_UART_ENABLE_IT(&seggerUart, UART_IT_TXE);
 	NVIC_EnableIRQ(intNum); //USARTX_IRQn
+	NVIC_EnableIRQ(SEGGER_UART_DMA_IRQn);
 }
 
 
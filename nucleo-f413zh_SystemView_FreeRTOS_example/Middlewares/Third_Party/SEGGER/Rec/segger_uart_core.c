@@ -0,0 +1,164 @@
+/**********************************************************
+*          SEGGER MICROCONTROLLER SYSTEME GmbH
+*   Solutions for real time microcontroller applications
+***********************************************************
+File    : segger_uart_core.c
+Purpose : Hardware independent part of the SystemView UART
+          transport. Hands out contiguous spans of the RTT
+          up-buffer to a block transfer (DMA, FIFO) and
+          consumes them when the transfer has completed.
+--------- END-OF-HEADER ---------------------------------*/
+
+#include "SEGGER_SYSVIEW.h"
+#include "SEGGER_RTT.h"
+#include "segger_uart_core.h"
+
+#define _SERVER_HELLO_SIZE        (4)
+#define _TARGET_HELLO_SIZE        (4)
+
+static const U8 _abHelloMsg[_TARGET_HELLO_SIZE] = { 'S', 'V', (SEGGER_SYSVIEW_VERSION / 10000), (SEGGER_SYSVIEW_VERSION / 1000) % 10 };  // "Hello" message expected by SysView: [ 'S', 'V', <PROTOCOL_MAJOR>, <PROTOCOL_MINOR> ]
+
+static struct {
+  U8                          NumBytesHelloRcvd;
+  U8                          NumBytesHelloSent;
+  U8                          TxActive;        // 1: Transfer started, SEGGER_UART_CORE_OnTxDone() pending
+  int                         ChannelID;
+  unsigned                    NumBytesInXfer;  // Number of bytes of the up-buffer in the active transfer, 0 for the <Hello> message
+  unsigned                    MaxXferSize;
+  SEGGER_UART_START_TX_FUNC*  pfStartTx;
+} _SVInfo = {0,0,0,1,0,0,NULL};
+
+static void _StartSysView(void) {
+  int r;
+
+  r = SEGGER_SYSVIEW_IsStarted();
+  if (r == 0) {
+    SEGGER_SYSVIEW_Start();
+  }
+}
+
+/*********************************************************************
+*
+*       _StartTxNoLock()
+*
+*  Function description
+*    Starts a transfer of the <Hello> message or of the longest
+*    contiguous span of the up-buffer, if no transfer is active.
+*    Must be called with RTT locked.
+*
+*  Additional information
+*    The span is not consumed, i.e. <RdOff> is not advanced, until
+*    the transfer has completed, so the recorder cannot overwrite it.
+*    If the hardware layer cannot start the transfer, nothing is
+*    marked as sent, so the next call retries it.
+*/
+static void _StartTxNoLock(void) {
+  const void* pData;
+  unsigned    NumBytes;
+  U8          NumBytesHelloSent;
+
+  if ((_SVInfo.TxActive != 0u) || (_SVInfo.pfStartTx == NULL)) {
+    return;
+  }
+  NumBytesHelloSent = _SVInfo.NumBytesHelloSent;
+  if (_SVInfo.NumBytesHelloSent < _TARGET_HELLO_SIZE) {  // Not all bytes of <Hello> message sent to SysView yet?
+    pData    = &_abHelloMsg[_SVInfo.NumBytesHelloSent];
+    NumBytes = _TARGET_HELLO_SIZE - _SVInfo.NumBytesHelloSent;
+    _SVInfo.NumBytesHelloSent = _TARGET_HELLO_SIZE;
+    _SVInfo.NumBytesInXfer    = 0u;
+  } else {
+    NumBytes = SEGGER_RTT_PeekUpBufferNoLock(_SVInfo.ChannelID, &pData);  // Up to the end of the buffer, the rest follows in the next transfer
+    if (NumBytes == 0u) {
+      return;
+    }
+    if (NumBytes > _SVInfo.MaxXferSize) {
+      NumBytes = _SVInfo.MaxXferSize;
+    }
+    _SVInfo.NumBytesInXfer = NumBytes;
+  }
+  _SVInfo.TxActive = 1u;
+  if (_SVInfo.pfStartTx((const U8*)pData, NumBytes) < 0) {  // No SEGGER_UART_CORE_OnTxDone() follows
+    _SVInfo.NumBytesHelloSent = NumBytesHelloSent;
+    _SVInfo.NumBytesInXfer    = 0u;
+    _SVInfo.TxActive          = 0u;
+  }
+}
+
+/*********************************************************************
+*
+*       SEGGER_UART_CORE_Init()
+*
+*  Function description
+*    Initializes the transport and sends the <Hello> message.
+*
+*  Parameters
+*    MaxXferSize - Maximum number of bytes per transfer. Larger
+*                  transfers take fewer interrupts, but free space
+*                  in the up-buffer only when they have completed.
+*    pfStartTx   - Hardware layer function to start a transfer.
+*/
+void SEGGER_UART_CORE_Init(unsigned MaxXferSize, SEGGER_UART_START_TX_FUNC* pfStartTx) {
+  SEGGER_RTT_LOCK();
+  _SVInfo.NumBytesHelloRcvd = 0u;
+  _SVInfo.NumBytesHelloSent = 0u;
+  _SVInfo.TxActive          = 0u;
+  _SVInfo.MaxXferSize       = (MaxXferSize != 0u) ? MaxXferSize : 1u;
+  _SVInfo.pfStartTx         = pfStartTx;
+  _StartTxNoLock();
+  SEGGER_RTT_UNLOCK();
+}
+
+/*********************************************************************
+*
+*       SEGGER_UART_CORE_OnRx()
+*
+*  Function description
+*    Handles one byte received from SystemView.
+*    Called by the hardware layer from the Rx interrupt.
+*/
+void SEGGER_UART_CORE_OnRx(U8 Data) {
+  if (_SVInfo.NumBytesHelloRcvd < _SERVER_HELLO_SIZE) {  // Not all bytes of <Hello> message received by SysView yet?
+    _SVInfo.NumBytesHelloRcvd++;
+    goto Done;
+  }
+  SEGGER_RTT_WriteDownBuffer(_SVInfo.ChannelID, &Data, 1);  // Write data into corresponding RTT buffer for application to read and handle accordingly
+  _StartSysView();
+Done:
+  return;
+}
+
+/*********************************************************************
+*
+*       SEGGER_UART_CORE_OnTxDone()
+*
+*  Function description
+*    Consumes the span of the completed transfer from the up-buffer
+*    and starts the next transfer, if there is more data.
+*    Called by the hardware layer from the transfer complete interrupt.
+*/
+void SEGGER_UART_CORE_OnTxDone(void) {
+  SEGGER_RTT_LOCK();
+  if (_SVInfo.NumBytesInXfer != 0u) {
+    SEGGER_RTT_ConsumeUpBufferNoLock(_SVInfo.ChannelID, _SVInfo.NumBytesInXfer);
+    _SVInfo.NumBytesInXfer = 0u;
+  }
+  _SVInfo.TxActive = 0u;
+  _StartTxNoLock();
+  SEGGER_RTT_UNLOCK();
+}
+
+/*********************************************************************
+*
+*       SEGGER_UART_CORE_Kick()
+*
+*  Function description
+*    Starts a transfer if none is active and there is data to send.
+*    Called on every recorded event, see SEGGER_SYSVIEW_ON_EVENT_RECORDED().
+*/
+void SEGGER_UART_CORE_Kick(void) {
+  SEGGER_RTT_LOCK();
+  _StartTxNoLock();
+  SEGGER_RTT_UNLOCK();
+}
+
+/*************************** End of file ****************************/
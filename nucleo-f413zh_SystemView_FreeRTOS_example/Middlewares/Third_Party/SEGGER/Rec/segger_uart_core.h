@@ -0,0 +1,54 @@
+/**********************************************************
+*          SEGGER MICROCONTROLLER SYSTEME GmbH
+*   Solutions for real time microcontroller applications
+***********************************************************
+File    : segger_uart_core.h
+Purpose : Hardware independent part of the SystemView UART
+          transport. Hands out contiguous spans of the RTT
+          up-buffer to a block transfer (DMA, FIFO) and
+          consumes them when the transfer has completed.
+--------- END-OF-HEADER ---------------------------------*/
+
+#ifndef SEGGER_UART_CORE_H
+#define SEGGER_UART_CORE_H
+
+#include "SEGGER.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+*
+*       Types
+*
+**********************************************************************
+*/
+//
+// Starts the transmission of NumBytes bytes at pData. pData stays valid
+// until the hardware layer calls SEGGER_UART_CORE_OnTxDone().
+// Called with SEGGER_RTT_LOCK() held.
+// Returns 0 if the transfer has been started. Returns < 0 if it has not,
+// e.g. if the DMA is not ready after an error. SEGGER_UART_CORE_OnTxDone()
+// is not called then, and the next SEGGER_UART_CORE_Kick() retries.
+//
+typedef int SEGGER_UART_START_TX_FUNC(const U8* pData, unsigned NumBytes);
+
+/*********************************************************************
+*
+*       API functions
+*
+**********************************************************************
+*/
+void SEGGER_UART_CORE_Init    (unsigned MaxXferSize, SEGGER_UART_START_TX_FUNC* pfStartTx);
+void SEGGER_UART_CORE_OnRx    (U8 Data);
+void SEGGER_UART_CORE_OnTxDone(void);
+void SEGGER_UART_CORE_Kick    (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/*************************** End of file ****************************/
@@ -172,6 +172,84 @@ Additional information:
   #endif
 #endif
 
+#if (SEGGER_SYSVIEW_USE_RESERVE_COMMIT == 1)
+  #if (SEGGER_SYSVIEW_USE_STATIC_BUFFER == 1)
+    #error "SEGGER_SYSVIEW_USE_RESERVE_COMMIT requires SEGGER_SYSVIEW_USE_STATIC_BUFFER == 0"
+  #endif
+  #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+    #error "SEGGER_SYSVIEW_USE_RESERVE_COMMIT is not available in post mortem mode"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING == 1)
+  #if (SEGGER_SYSVIEW_USE_STATIC_BUFFER == 0)
+    #error "SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING requires SEGGER_SYSVIEW_USE_STATIC_BUFFER == 1"
+  #endif
+  #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+    #error "SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING is not available in post mortem mode"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+  #if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+    #error "SEGGER_SYSVIEW_USE_CHECKPOINTS requires SEGGER_SYSVIEW_POST_MORTEM_MODE == 1"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+  #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+    #error "SEGGER_SYSVIEW_USE_DROP_STATS is not available in post mortem mode"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+  #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+    #error "SEGGER_SYSVIEW_USE_LOAD_SHEDDING is not available in post mortem mode"
+  #endif
+  #if (SEGGER_SYSVIEW_SHED_HEADROOM_LOW < SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL)
+    #error "SEGGER_SYSVIEW_SHED_HEADROOM_LOW must not be less than SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+  #if (SEGGER_SYSVIEW_TIMESTAMP_BITS != 32)
+    #error "SEGGER_SYSVIEW_USE_TIME64 requires SEGGER_SYSVIEW_TIMESTAMP_BITS == 32"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  #if ((SEGGER_SYSVIEW_NUM_LOAD_TASKS & (SEGGER_SYSVIEW_NUM_LOAD_TASKS - 1)) != 0)
+    #error "SEGGER_SYSVIEW_NUM_LOAD_TASKS must be a power of 2"
+  #endif
+  #if (SEGGER_SYSVIEW_INFO_SIZE + (5 + 2 * SEGGER_SYSVIEW_NUM_LOAD_TASKS) * SEGGER_SYSVIEW_QUANTA_U32 > SEGGER_SYSVIEW_MAX_PACKET_SIZE)
+    #error "SEGGER_SYSVIEW_NUM_LOAD_TASKS too large for SEGGER_SYSVIEW_MAX_PACKET_SIZE"
+  #endif
+  #if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+    #error "SEGGER_SYSVIEW_NUM_LOAD_TASKS is not available with SEGGER_SYSVIEW_NUM_SHARDS > 1"
+  #endif
+#endif
+
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+  #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+    #error "SEGGER_SYSVIEW_NUM_SHARDS > 1 is not available in post mortem mode"
+  #endif
+  #if (SEGGER_SYSVIEW_NUM_SHARDS >= SEGGER_RTT_MAX_NUM_UP_BUFFERS)
+    #error "SEGGER_RTT_MAX_NUM_UP_BUFFERS in SEGGER_RTT_Conf.h has to be > SEGGER_SYSVIEW_NUM_SHARDS!"
+  #endif
+  #if (SEGGER_SYSVIEW_TIMESTAMP_SHIFT > 0)
+    #error "SEGGER_SYSVIEW_TIMESTAMP_SHIFT is not available with SEGGER_SYSVIEW_NUM_SHARDS > 1"
+  #endif
+  #define GET_SHARD()                 (&_aShard[SEGGER_SYSVIEW_GET_SHARD()])
+  #define GET_FIRST_SHARD()           (&_aShard[0])
+  #define SHARD_CHANNEL_ID_UP(pShard) ((pShard)->UpChannel)
+  #define SHARD_IS_FIRST(pShard)      ((pShard) == &_aShard[0])
+#else
+  #define GET_SHARD()                 (&_SYSVIEW_Globals)
+  #define GET_FIRST_SHARD()           (&_SYSVIEW_Globals)
+  #define SHARD_CHANNEL_ID_UP(pShard) CHANNEL_ID_UP
+  #define SHARD_IS_FIRST(pShard)      1
+#endif
+
 /*********************************************************************
 *
 *       Defines, configurable
@@ -190,6 +268,159 @@ Additional information:
   #define MAKE_DELTA_32BIT(Delta)
 #endif
 
+//
+// With SEGGER_SYSVIEW_TIMESTAMP_SHIFT, the delta is sent in units of
+// (1 << SEGGER_SYSVIEW_TIMESTAMP_SHIFT) ticks. TimeStamp is moved back by
+// the remainder, so it is carried over into the next delta.
+//
+#if (SEGGER_SYSVIEW_TIMESTAMP_SHIFT > 0)
+  #define SCALE_DELTA(Delta, TimeStamp, LastTimeStamp)  Delta     = (I32)((U32)Delta >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT);       \
+                                                        TimeStamp = (LastTimeStamp) + ((U32)Delta << SEGGER_SYSVIEW_TIMESTAMP_SHIFT);
+#else
+  #define SCALE_DELTA(Delta, TimeStamp, LastTimeStamp)
+#endif
+
+//
+// With SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, the difference to the previous
+// delta is sent zig-zag encoded instead of the delta.
+//
+#if (SEGGER_SYSVIEW_USE_DELTA_OF_DELTA == 1)
+  #define ENCODE_DELTA(pDest, Delta, PrevDelta)   {                                                                    \
+                                                    I32 DeltaOfDelta;                                                  \
+                                                    DeltaOfDelta = (I32)((U32)(Delta) - (U32)(PrevDelta));             \
+                                                    ENCODE_TIMESTAMP(pDest, ((U32)DeltaOfDelta << 1) ^ (U32)(DeltaOfDelta >> 31)); \
+                                                  }
+  #define PREV_DELTA(pShard)                      ((pShard)->LastTxDelta)
+  #define SET_PREV_DELTA(pShard, Delta)           (pShard)->LastTxDelta = (U32)(Delta)
+#else
+  #define ENCODE_DELTA(pDest, Delta, PrevDelta)   ENCODE_TIMESTAMP(pDest, Delta)
+  #define PREV_DELTA(pShard)                      0
+  #define SET_PREV_DELTA(pShard, Delta)
+#endif
+
+//
+// With SEGGER_SYSVIEW_USE_CHECKPOINTS, the recorder counts the packets
+// and bytes written to the post-mortem buffer, to locate checkpoints
+// and full descriptors, and notes changes of the task list and modules.
+//
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+  #define COUNT_PACKET(NumBytes)                  _SYSVIEW_Globals.NumPackets++;                       \
+                                                  _SYSVIEW_Globals.NumBytesWritten += (U32)(NumBytes)
+  #define COUNT_BYTES(NumBytes)                   _SYSVIEW_Globals.NumBytesWritten += (U32)(NumBytes)
+  #define MARK_DESC_CHANGED()                     _SYSVIEW_Globals.DescChanged = 1
+  #define UP_WR_OFF()                             (((SEGGER_RTT_BUFFER_UP*)((char*)&_SEGGER_RTT.aUp[CHANNEL_ID_UP] + SEGGER_RTT_UNCACHED_OFF))->WrOff)
+#else
+  #define COUNT_PACKET(NumBytes)
+  #define COUNT_BYTES(NumBytes)
+  #define MARK_DESC_CHANGED()
+#endif
+
+//
+// With SEGGER_SYSVIEW_USE_DROP_STATS, every dropped packet is counted
+// per event class, see SEGGER_SYSVIEW_DROP_CLASS_*.
+//
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+  #define COUNT_DROP(pShard, DropClass)           (pShard)->aDropCount[DropClass]++
+  #define DROP_STATS_SIZE                         (1 + 1 + 2 * SEGGER_SYSVIEW_QUANTA_U32 + SEGGER_SYSVIEW_NUM_DROP_CLASSES * SEGGER_SYSVIEW_QUANTA_U32 + 5)
+#else
+  #define COUNT_DROP(pShard, DropClass)
+  #define DROP_STATS_SIZE                         0
+#endif
+
+//
+// With SEGGER_SYSVIEW_USE_LOAD_SHEDDING, the overflow packet may be
+// deferred while core events are still sent, so a packet may be dropped
+// when packets have already been dropped before.
+//
+#if (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+  #define SET_DROPPING(pShard)                    if ((pShard)->EnableState == 2) {                    \
+                                                    (pShard)->DropCount++;                             \
+                                                  }                                                    \
+                                                  (pShard)->EnableState = 2
+#else
+  #define SET_DROPPING(pShard)                    (pShard)->EnableState++  // EnableState has been 1, will be 2. Always.
+#endif
+
+//
+// With SEGGER_SYSVIEW_NUM_TASK_IDS, task IDs are looked up in a hash
+// index of the table of the tasks, and the ID in the table is sent.
+// The hash index has twice as many slots as the table, so a lookup
+// ends at an unused slot after a few probes.
+//
+#if (SEGGER_SYSVIEW_NUM_TASK_IDS > 0)
+  #if ((SEGGER_SYSVIEW_NUM_TASK_IDS & (SEGGER_SYSVIEW_NUM_TASK_IDS - 1)) != 0)
+    #error "SEGGER_SYSVIEW_NUM_TASK_IDS must be a power of 2"
+  #endif
+  #define SHRINK_TASK_ID(Id)      _ShrinkTaskId(Id)
+  #define ADD_TASK_ID(Id)         _AddTaskId(Id)
+  #define REMOVE_TASK_ID(Id)      _RemoveTaskId(Id)
+  #define TASK_ID_HASH_SIZE       (2u * SEGGER_SYSVIEW_NUM_TASK_IDS)
+  #define TASK_ID_SLOT(Id)        ((((Id) >> 3) ^ ((Id) >> 11)) & (TASK_ID_HASH_SIZE - 1u))
+  #define TASK_ID_SLOT_NEXT(Slot) (((Slot) + 1u) & (TASK_ID_HASH_SIZE - 1u))
+#else
+  #define SHRINK_TASK_ID(Id)      SHRINK_ID(Id)
+  #define ADD_TASK_ID(Id)
+  #define REMOVE_TASK_ID(Id)
+#endif
+
+//
+// With SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL, recording stops when the
+// RTT buffer is full, instead of dropping packets until it has drained.
+//
+#define ON_BUFFER_FULL(pShard)                    if (_SYSVIEW_Globals.BufferMode == SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL) { \
+                                                    _StopOnFull();                                     \
+                                                  } else {                                             \
+                                                    SET_DROPPING(pShard);                              \
+                                                  }
+
+//
+// The host is told the ratio of all sampled events on start, so it can
+// scale their counts.
+//
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0) || (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+  #define SEND_SAMPLING_WEIGHTS()                 _SendSamplingWeights()
+#else
+  #define SEND_SAMPLING_WEIGHTS()
+#endif
+
+//
+// With SEGGER_SYSVIEW_NUM_TASK_FILTERS, the recorder notes on each task
+// switch whether the task is filtered, so sending a packet only needs
+// to check one flag.
+//
+#if (SEGGER_SYSVIEW_NUM_TASK_FILTERS > 0)
+  #define SET_TASK_FILTERED(pShard, TaskId)       (pShard)->TaskFiltered = _IsTaskFiltered(TaskId)
+  #define CLEAR_TASK_FILTERED(pShard)             (pShard)->TaskFiltered = 0
+#else
+  #define SET_TASK_FILTERED(pShard, TaskId)
+  #define CLEAR_TASK_FILTERED(pShard)
+#endif
+
+//
+// With SEGGER_SYSVIEW_USE_TIME64, the wraps of the timestamp are also
+// counted on each packet sent, see _UpdateTime64().
+//
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+  #define UPDATE_TIME64(TimeStamp)                _UpdateTime64(TimeStamp)
+#else
+  #define UPDATE_TIME64(TimeStamp)
+#endif
+
+//
+// With SEGGER_SYSVIEW_NUM_LOAD_TASKS, the scheduler and interrupt
+// events account the time since the previous one when their packet is
+// sent, in its critical section and with its time stamp, so also when
+// they are disabled.
+//
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  #define SEND_LOAD_PACKET(pStartPacket, pEndPacket, EventId, LoadEvent, TaskId)   _SendPacketEx(pStartPacket, pEndPacket, EventId, LoadEvent, TaskId)
+  #define LOAD_SLOT(TaskId)                       ((((TaskId) >> 3) ^ ((TaskId) >> 11)) & (SEGGER_SYSVIEW_NUM_LOAD_TASKS - 1u))
+  #define LOAD_CUR_IDLE                           (SEGGER_SYSVIEW_NUM_LOAD_TASKS)        // LoadCur while idle
+  #define LOAD_CUR_OTHER                          (SEGGER_SYSVIEW_NUM_LOAD_TASKS + 1u)   // LoadCur while no task or a task without slot runs
+#else
+  #define SEND_LOAD_PACKET(pStartPacket, pEndPacket, EventId, LoadEvent, TaskId)   _SendPacket(pStartPacket, pEndPacket, EventId)
+#endif
+
 #if SEGGER_SYSVIEW_SUPPORT_LONG_ID
   #define _MAX_ID_BYTES       5u
 #else
@@ -212,6 +443,14 @@ Additional information:
 #define ENABLE_STATE_ON         1
 #define ENABLE_STATE_DROPPING   2
 
+#define LOAD_EVENT_ENTER_ISR    0
+#define LOAD_EVENT_EXIT_ISR     1
+#define LOAD_EVENT_TASK         2
+#define LOAD_EVENT_IDLE         3
+#define LOAD_EVENT_STOP         4
+#define LOAD_EVENT_REPORT       5
+#define LOAD_EVENT_NONE         6
+
 #define FORMAT_FLAG_LEFT_JUSTIFY   (1u << 0)
 #define FORMAT_FLAG_PAD_ZERO       (1u << 1)
 #define FORMAT_FLAG_PRINT_SIGN     (1u << 2)
@@ -233,6 +472,21 @@ typedef struct {
   unsigned  Cnt;
 } SEGGER_SYSVIEW_PRINTF_DESC;
 
+//
+// Sampling of one event ID. Cnt counts the events since the last
+// recorded one.
+//
+typedef struct {
+  U32 EventId;
+  U16 Ratio;
+  U16 Cnt;
+} SEGGER_SYSVIEW_SAMPLING;
+
+typedef struct {
+  U32 TaskId;                     // 0: Unused
+  U32 Time;                       // Timestamp ticks run in the current period
+} SEGGER_SYSVIEW_LOAD_TASK;
+
 typedef struct {
         U8                      EnableState;   // 0: Disabled, 1: Enabled, (2: Dropping)
         U8                      UpChannel;
@@ -240,18 +494,89 @@ typedef struct {
         U32                     SysFreq;
         U32                     CPUFreq;
         U32                     LastTxTimeStamp;
+#if (SEGGER_SYSVIEW_USE_DELTA_OF_DELTA == 1)
+        U32                     LastTxDelta;
+#endif
         U32                     RAMBaseAddress;
 #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
         U32                     PacketCount;
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+        U8                      DescChanged;       // 1: Task list or modules changed since the last full descriptor
+        U32                     NumPackets;        // Packets written, sequence number of the next packet
+        U32                     NumBytesWritten;   // Bytes written, wraps around
+        U32                     DescPos;           // NumBytesWritten at the sync of the last full descriptor
+        U32                     DescSize;          // Size of the last full descriptor
+#endif
 #else
         U32                     DropCount;
         U8                      DownChannel;
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+        U32                     aDropCount[SEGGER_SYSVIEW_NUM_DROP_CLASSES];   // Dropped packets per event class
 #endif
+        U8                      BufferMode;        // SEGGER_SYSVIEW_BUFFER_MODE_*
+#endif
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 0)
         U32                     DisabledEvents;
+#endif
+#if (SEGGER_SYSVIEW_NUM_TASK_FILTERS > 0)
+        U8                      TaskFiltered;      // 1: The running task is not selected by the task filter
+        U32                     aTaskFilter[SEGGER_SYSVIEW_NUM_TASK_FILTERS];   // Shrunk IDs of the selected tasks, 0: Unused
+#endif
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0)
+        unsigned                NumSampledEvents;
+        SEGGER_SYSVIEW_SAMPLING aSampling[SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS];
+#endif
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+  const U32*                    apSampleClassId[SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES];      // Event IDs of the class, for the host
+        U8                      aNumSampleClassIds[SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES];
+#endif
+#if (SEGGER_SYSVIEW_NUM_TASK_IDS > 0)
+        U32                     aTaskId[SEGGER_SYSVIEW_NUM_TASK_IDS];   // Task of each ID - 1, 0: Unused
+        U16                     aTaskIdSlot[TASK_ID_HASH_SIZE];         // Hash index of aTaskId[], ID of the task, 0: Unused
+#endif
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+        volatile U32            TimeHalfWraps; // Half wrap periods of the timestamp, bit 0 is its MSB when last seen
+#endif
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+        U32                     LoadPeriodStart;
+        U32                     LoadLastTime;      // Timestamp of the last scheduler or interrupt event
+        U32                     LoadIdleTime;
+        U32                     LoadISRTime;
+        U32                     LoadCurTaskId;     // Task running, 0: None or idle
+        U8                      LoadCur;           // Slot of the task running, LOAD_CUR_IDLE or LOAD_CUR_OTHER
+        U8                      LoadISRNesting;
+        SEGGER_SYSVIEW_LOAD_TASK aLoadTask[SEGGER_SYSVIEW_NUM_LOAD_TASKS];   // Tasks which have run in the current period
+#endif
   const SEGGER_SYSVIEW_OS_API*  pOSAPI;
         SEGGER_SYSVIEW_SEND_SYS_DESC_FUNC*   pfSendSysDesc;
 } SEGGER_SYSVIEW_GLOBALS;
 
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+//
+// Recording state of one shard.
+// Member names match SEGGER_SYSVIEW_GLOBALS, so the send path works on either.
+//
+typedef struct {
+        U8                      EnableState;   // 0: Disabled, 1: Enabled, (2: Dropping)
+        U8                      UpChannel;
+        U8                      SyncPending;   // 1: Send sync packet before next event
+        U32                     LastTxTimeStamp;
+#if (SEGGER_SYSVIEW_USE_DELTA_OF_DELTA == 1)
+        U32                     LastTxDelta;
+#endif
+        U32                     DropCount;
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+        U32                     aDropCount[SEGGER_SYSVIEW_NUM_DROP_CLASSES];   // Dropped packets per event class
+#endif
+        U32                     PacketCount;   // Events since last sync packet
+#if (SEGGER_SYSVIEW_NUM_TASK_FILTERS > 0)
+        U8                      TaskFiltered;  // 1: The task running on this shard is not selected by the task filter
+#endif
+} SEGGER_SYSVIEW_SHARD;
+#else
+typedef SEGGER_SYSVIEW_GLOBALS SEGGER_SYSVIEW_SHARD;
+#endif
+
 /*********************************************************************
 *
 *       Function prototypes, required
@@ -259,6 +584,13 @@ typedef struct {
 **********************************************************************
 */
 static void _SendPacket(U8* pStartPacket, U8* pEndPacket, unsigned int EventId);
+static void _ChangeEventRange(U32 FirstId, U32 NumIds, int Disable);
+static int  _SetTaskFilter(unsigned Index, U32 TaskId);
+static int  _SetSampling(U32 EventId, unsigned Ratio);
+static int  _SetClassSampling(unsigned Class, unsigned Ratio);
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0) || (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+static void _SendSamplingWeights(void);
+#endif
 
 /*********************************************************************
 *
@@ -358,9 +690,55 @@ static const U8 _abSync[10] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 
 static SEGGER_SYSVIEW_GLOBALS _SYSVIEW_Globals;
 
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+static char                   _aShardBuffer[SEGGER_SYSVIEW_NUM_SHARDS - 1][SEGGER_SYSVIEW_SHARD_BUFFER_SIZE];  // Shard 0 uses _UpBuffer
+static SEGGER_SYSVIEW_SHARD   _aShard[SEGGER_SYSVIEW_NUM_SHARDS];
+#endif
+
 static SEGGER_SYSVIEW_MODULE* _pFirstModule;
 static U8                     _NumModules;
 
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1) || (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+//
+// Event class of the events with ID < 32, for the drop statistics
+// and load shedding.
+//
+static const U8 _aDropClass[32] = {
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_NOP
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_OVERFLOW
+  SEGGER_SYSVIEW_DROP_CLASS_ISR,      // SYSVIEW_EVTID_ISR_ENTER
+  SEGGER_SYSVIEW_DROP_CLASS_ISR,      // SYSVIEW_EVTID_ISR_EXIT
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_START_EXEC
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_STOP_EXEC
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_START_READY
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_TASK_STOP_READY
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_TASK_CREATE
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_TASK_INFO
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_TRACE_START
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_TRACE_STOP
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SYSTIME_CYCLES
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SYSTIME_US
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SYSDESC
+  SEGGER_SYSVIEW_DROP_CLASS_MARK,     // SYSVIEW_EVTID_MARK_START
+  SEGGER_SYSVIEW_DROP_CLASS_MARK,     // SYSVIEW_EVTID_MARK_STOP
+  SEGGER_SYSVIEW_DROP_CLASS_SCHED,    // SYSVIEW_EVTID_IDLE
+  SEGGER_SYSVIEW_DROP_CLASS_ISR,      // SYSVIEW_EVTID_ISR_TO_SCHEDULER
+  SEGGER_SYSVIEW_DROP_CLASS_TIMER,    // SYSVIEW_EVTID_TIMER_ENTER
+  SEGGER_SYSVIEW_DROP_CLASS_TIMER,    // SYSVIEW_EVTID_TIMER_EXIT
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_STACK_INFO
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_MODULEDESC
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // 23, unused
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_INIT
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_NAME_RESOURCE
+  SEGGER_SYSVIEW_DROP_CLASS_PRINT,    // SYSVIEW_EVTID_PRINT_FORMATTED
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_NUMMODULES
+  SEGGER_SYSVIEW_DROP_CLASS_API,      // SYSVIEW_EVTID_END_CALL
+  SEGGER_SYSVIEW_DROP_CLASS_TASK,     // SYSVIEW_EVTID_TASK_TERMINATE
+  SEGGER_SYSVIEW_DROP_CLASS_SYSTEM,   // SYSVIEW_EVTID_SHARD_SYNC
+  SEGGER_SYSVIEW_DROP_CLASS_MARK      // SYSVIEW_EVTID_EX
+};
+#endif
+
 /*********************************************************************
 *
 *       Static code
@@ -381,6 +759,20 @@ static U8                     _NumModules;
                                    pDest = pSysviewPointer;                         \
                                  };
 
+//
+// Time stamp deltas are mostly small with SEGGER_SYSVIEW_TIMESTAMP_SHIFT
+// or SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, so the 1 byte case is handled first.
+//
+#define ENCODE_TIMESTAMP(pDest, Value) {                                            \
+                                   U32 SysViewTimeStamp;                            \
+                                   SysViewTimeStamp = Value;                        \
+                                   if (SysViewTimeStamp < 0x80u) {                  \
+                                     *pDest++ = (U8)SysViewTimeStamp;               \
+                                   } else {                                         \
+                                     ENCODE_U32(pDest, SysViewTimeStamp);           \
+                                   }                                                \
+                                 };
+
 
 
 #if (SEGGER_SYSVIEW_USE_STATIC_BUFFER == 1)
@@ -391,6 +783,13 @@ static U8 _aPacket[SEGGER_SYSVIEW_MAX_PACKET_SIZE];
 
 #define RECORD_END()              SEGGER_SYSVIEW_UNLOCK()
 
+#if (SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING == 1)
+static U8* _pInPlacePacket;       // Start of the packet prepared in the RTT buffer by _PreparePacketInPlace(), NULL if none
+
+#define RECORD_START_EVENT(EventId, PacketSize)  SEGGER_SYSVIEW_LOCK();                                      \
+                                                 pPayloadStart = _PreparePacketInPlace(EventId, PacketSize);
+#endif
+
 #else
 
 #define RECORD_START(PacketSize)  U8 aPacket[(PacketSize)];                         \
@@ -400,6 +799,14 @@ static U8 _aPacket[SEGGER_SYSVIEW_MAX_PACKET_SIZE];
 
 #endif
 
+//
+// Start recording a packet of fixed size with an Id known in advance.
+// Such packets can be encoded in place, see _PreparePacketInPlace().
+//
+#ifndef RECORD_START_EVENT
+  #define RECORD_START_EVENT(EventId, PacketSize)  RECORD_START(PacketSize)
+#endif
+
 /*********************************************************************
 *
 *       _EncodeData()
@@ -525,6 +932,166 @@ static U8* _PreparePacket(U8* pPacket) {
   return pPacket + _MAX_ID_BYTES + _MAX_DATA_BYTES;
 }
 
+/*********************************************************************
+*
+*       _PreparePacketInPlace()
+*
+*  Function description
+*    Prepare a SystemView event packet directly in the RTT buffer.
+*    Must be called with SystemView locked.
+*
+*  Parameters
+*    EventId    - Id of the event to be recorded.
+*    PacketSize - Maximum size of the packet, including Id, length and timestamp.
+*
+*  Return value
+*    Pointer to first byte of packet payload.
+*
+*  Additional information
+*    If the RTT buffer has PacketSize bytes of linear free space, the
+*    payload is placed there, behind exactly as many bytes as
+*    _SendPacket() prepends for EventId, so _SendPacket() only has to
+*    commit it.
+*    Otherwise, i.e. on wrap-around, when the buffer is full, when an
+*    overflow or sync packet has to be sent first or when the header
+*    size is not known in advance, the packet is prepared in _aPacket
+*    and copied into the RTT buffer as usual.
+*/
+#if (SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING == 1)
+static U8* _PreparePacketInPlace(unsigned int EventId, unsigned int PacketSize) {
+  SEGGER_SYSVIEW_SHARD* pShard;
+  unsigned int          NumBytesHeader;
+  U8*                   pPacket;
+
+  _pInPlacePacket = NULL;
+  pShard          = GET_SHARD();
+  if (EventId < 24u) {
+    NumBytesHeader = 1u;    // Id only
+  } else if ((EventId < 127u) && (PacketSize < SEGGER_SYSVIEW_INFO_SIZE + 127u)) {
+    NumBytesHeader = 2u;    // 1 byte Id and 1 byte payload length
+  } else {
+    NumBytesHeader = 0u;    // Encoding of Id or length not known in advance
+  }
+  if ((NumBytesHeader != 0u) && (pShard->EnableState == 1u)) {
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+    if ((pShard->SyncPending == 0u) && (((pShard->PacketCount + 1u) >> SEGGER_SYSVIEW_SHARD_SYNC_PERIOD_SHIFT) == 0u))
+#endif
+    {
+      pPacket = (U8*)SEGGER_RTT_ReserveUpInPlaceNoLock(SHARD_CHANNEL_ID_UP(pShard), PacketSize);
+      if (pPacket != NULL) {
+        _pInPlacePacket = pPacket;
+        return pPacket + NumBytesHeader;
+      }
+    }
+  }
+  return _PreparePacket(_aPacket);
+}
+#endif
+
+/*********************************************************************
+*
+*       _WriteUpNoLock()
+*
+*  Function description
+*    Store a complete packet in a SystemView RTT buffer.
+*    Must be called with SystemView locked.
+*
+*  Parameters
+*    Channel  - RTT up-channel of the shard to write to.
+*    pData    - Pointer to the packet.
+*    NumBytes - Number of bytes in the packet.
+*
+*  Return value
+*    !=0:  Success, packet stored in RTT buffer.
+*    ==0:  Buffer full, packet *NOT* stored.
+*
+*  Additional information
+*    When SEGGER_SYSVIEW_USE_RESERVE_COMMIT is enabled, other packets
+*    might be reserved but not committed yet. The packet is then
+*    reserved and committed behind them instead of written directly.
+*/
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+static unsigned int _WriteUpNoLock(unsigned Channel, const U8* pData, unsigned int NumBytes) {
+#if (SEGGER_SYSVIEW_USE_RESERVE_COMMIT == 1)
+  int Off;
+
+  Off = SEGGER_RTT_ReserveUpNoLock(Channel, NumBytes);
+  if (Off < 0) {
+    return 0;
+  }
+  SEGGER_RTT_WriteReservedNoLock(Channel, (unsigned)Off, pData, NumBytes);
+  SEGGER_RTT_CommitUpNoLock(Channel, (unsigned)Off);
+  return 1;
+#else
+  return SEGGER_RTT_WriteSkipNoLock(Channel, pData, NumBytes);
+#endif
+}
+#endif // (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+
+/*********************************************************************
+*
+*       _SetDisabledEvents()
+*
+*  Function description
+*    Sets the disabled events with IDs 32 * WordIndex to
+*    32 * WordIndex + 31.
+*
+*  Parameters
+*    WordIndex    - Index of the word in the event filter.
+*    DisableMask  - Bit n set: Event 32 * WordIndex + n is disabled.
+*
+*  Additional information
+*    Words beyond the event filter are ignored.
+*    Without SEGGER_SYSVIEW_USE_EVENT_FILTER, only word 0 exists.
+*/
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+static void _SetDisabledEvents(unsigned WordIndex, U32 DisableMask) {
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  if (WordIndex < SEGGER_COUNTOF(SEGGER_SYSVIEW_aDisabledEvents)) {
+    SEGGER_SYSVIEW_aDisabledEvents[WordIndex] = DisableMask;
+  }
+#else
+  if (WordIndex == 0u) {
+    _SYSVIEW_Globals.DisabledEvents = DisableMask;
+  }
+#endif
+}
+
+/*********************************************************************
+*
+*       _ReadCommandPara()
+*
+*  Function description
+*    Reads the parameters of a command from the down channel.
+*
+*  Parameters
+*    pPara    - Buffer for the parameters.
+*    NumBytes - Number of bytes of the parameters.
+*
+*  Return value
+*    1: All parameters read.
+*    0: Command incomplete, to be ignored.
+*/
+static int _ReadCommandPara(U8* pPara, unsigned NumBytes) {
+  return (SEGGER_RTT_ReadNoLock(CHANNEL_ID_DOWN, pPara, NumBytes) == NumBytes) ? 1 : 0;
+}
+
+/*********************************************************************
+*
+*       _LoadU16LE(), _LoadU32LE()
+*
+*  Function description
+*    Loads a little endian value of a command parameter.
+*/
+static U32 _LoadU16LE(const U8* p) {
+  return (U32)p[0] | ((U32)p[1] << 8);
+}
+
+static U32 _LoadU32LE(const U8* p) {
+  return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+}
+#endif // (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+
 /*********************************************************************
 *
 *       _HandleIncomingPacket()
@@ -540,6 +1107,7 @@ static U8* _PreparePacket(U8* pPacket) {
 #if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
 static void _HandleIncomingPacket(void) {
   U8  Cmd;
+  U8  aPara[5];
   unsigned int Status;
   //
   Status = SEGGER_RTT_ReadNoLock(CHANNEL_ID_DOWN, &Cmd, 1);
@@ -572,6 +1140,36 @@ static void _HandleIncomingPacket(void) {
         SEGGER_SYSVIEW_SendModule(Cmd);
       }
       break;
+    case SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_FILTER:
+      if (_ReadCommandPara(aPara, 5)) {
+        _SetDisabledEvents(aPara[0], _LoadU32LE(&aPara[1]));
+      }
+      break;
+    case SEGGER_SYSVIEW_COMMAND_ID_SET_EVENT_RANGE:
+      if (_ReadCommandPara(aPara, 5)) {
+        _ChangeEventRange(_LoadU16LE(&aPara[1]), _LoadU16LE(&aPara[3]), aPara[0] != 0u);
+      }
+      break;
+    case SEGGER_SYSVIEW_COMMAND_ID_SET_TASK_FILTER:
+      if (_ReadCommandPara(aPara, 5)) {
+        _SetTaskFilter(aPara[0], _LoadU32LE(&aPara[1]));
+      }
+      break;
+    case SEGGER_SYSVIEW_COMMAND_ID_SET_SAMPLING:
+      if (_ReadCommandPara(aPara, 3)) {
+        _SetSampling(_LoadU16LE(&aPara[1]), aPara[0]);
+      }
+      break;
+    case SEGGER_SYSVIEW_COMMAND_ID_SET_BUFFER_MODE:
+      if (_ReadCommandPara(aPara, 1)) {
+        SEGGER_SYSVIEW_SetBufferMode(aPara[0]);
+      }
+      break;
+    case SEGGER_SYSVIEW_COMMAND_ID_SET_CLASS_SAMPLING:
+      if (_ReadCommandPara(aPara, 2)) {
+        _SetClassSampling(aPara[1], aPara[0]);
+      }
+      break;
     case SEGGER_SYSVIEW_COMMAND_ID_HEARTBEAT:
       break;
     default:
@@ -586,81 +1184,675 @@ static void _HandleIncomingPacket(void) {
 
 /*********************************************************************
 *
-*       _TrySendOverflowPacket()
+*       _GetDropClass()
 *
 *  Function description
-*    Try to transmit an SystemView Overflow packet containing the
-*    number of dropped packets.
+*    Returns the event class of an event for the drop statistics
+*    and load shedding.
+*
+*  Parameters
+*    EventId  - ID of the event.
+*    pPayload - Payload of the event, after ID and length.
+*
+*  Return value
+*    One of SEGGER_SYSVIEW_DROP_CLASS_*.
 *
 *  Additional information
-*    Format as follows:
-*      01 <DropCnt><TimeStamp>  Max. packet len is 1 + 5 + 5 = 11
+*    Deferred prints are sent as SYSVIEW_EVTID_EX, but are prints.
+*/
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1) || (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+static unsigned _GetDropClass(unsigned int EventId, const U8* pPayload) {
+  if (EventId < 32) {
+    if ((EventId == SYSVIEW_EVTID_EX) && (*pPayload == SYSVIEW_EVTID_EX_PRINT_DEFERRED)) {
+      return SEGGER_SYSVIEW_DROP_CLASS_PRINT;
+    }
+    return _aDropClass[EventId];
+  }
+  if (EventId < MODULE_EVENT_OFFSET) {
+    return SEGGER_SYSVIEW_DROP_CLASS_API;
+  }
+  return SEGGER_SYSVIEW_DROP_CLASS_MODULE;
+}
+#endif
+
+/*********************************************************************
 *
-*    Example packets sent
-*      01 20 40
+*       _GetShedHeadroom()
 *
-*  Return value
-*    !=0:  Success, Message sent (stored in RTT-Buffer)
-*    ==0:  Buffer full, Message *NOT* stored
+*  Function description
+*    Returns the number of bytes which have to be free in the RTT
+*    buffer to record an event.
+*
+*  Parameters
+*    DropClass - Class of the event, see _GetDropClass().
 *
+*  Return value
+*    SEGGER_SYSVIEW_SHED_HEADROOM_LOW for the classes in
+*    SEGGER_SYSVIEW_SHED_CLASSES_LOW, SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL
+*    for the classes in SEGGER_SYSVIEW_SHED_CLASSES_NORMAL, 0 otherwise.
 */
-#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
-static int _TrySendOverflowPacket(void) {
-  U32 TimeStamp;
-  I32 Delta;
-  int Status;
-  U8  aPacket[11];
-  U8* pPayload;
+#if (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+static unsigned _GetShedHeadroom(unsigned int DropClass) {
+  U32 ClassMask;
 
-  aPacket[0] = SYSVIEW_EVTID_OVERFLOW;      // 1
-  pPayload   = &aPacket[1];
-  ENCODE_U32(pPayload, _SYSVIEW_Globals.DropCount);
-  //
-  // Compute time stamp delta and append it to packet.
-  //
-  TimeStamp  = SEGGER_SYSVIEW_GET_TIMESTAMP();
-  Delta = TimeStamp - _SYSVIEW_Globals.LastTxTimeStamp;
-  MAKE_DELTA_32BIT(Delta);
-  ENCODE_U32(pPayload, Delta);
-  //
-  // Try to store packet in RTT buffer and update time stamp when this was successful
-  //
-  Status = (int)SEGGER_RTT_WriteSkipNoLock(CHANNEL_ID_UP, aPacket, (unsigned int)(pPayload - aPacket));
-  SEGGER_SYSVIEW_ON_EVENT_RECORDED(pPayload - aPacket);
-  if (Status) {
-    _SYSVIEW_Globals.LastTxTimeStamp = TimeStamp;
-    _SYSVIEW_Globals.EnableState--; // EnableState has been 2, will be 1. Always.
-  } else {
-    _SYSVIEW_Globals.DropCount++;
+  ClassMask = (U32)1u << DropClass;
+  if (ClassMask & (U32)(SEGGER_SYSVIEW_SHED_CLASSES_LOW)) {
+    return SEGGER_SYSVIEW_SHED_HEADROOM_LOW;
   }
-  //
-  return Status;
+  if (ClassMask & (U32)(SEGGER_SYSVIEW_SHED_CLASSES_NORMAL)) {
+    return SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL;
+  }
+  return 0;
 }
-#endif  // (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+#endif
 
+#if (SEGGER_SYSVIEW_NUM_TASK_IDS > 0)
 /*********************************************************************
 *
-*       _SendSyncInfo()
+*       _FindTaskIdSlot()
 *
 *  Function description
-*    Send SystemView sync packet and system information in
-*    post mortem mode.
+*    Returns the slot of the hash index which holds the ID of a task
+*    or, if the task has no ID, the unused slot where it is added.
 *
 *  Additional information
-*    Sync is 10 * 0x00 without timestamp
+*    Tasks are stored at the slot of their hash or, if it is in use,
+*    at one of the next slots, and slots are freed by
+*    _FreeTaskIdSlot(), so the search ends at the first unused slot.
+*    At most half of the slots are used.
 */
-#if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
-static void _SendSyncInfo(void) {
-  //
-  // Add sync packet ( 10 * 0x00)
-  // Send system description
-  // Send system time
-  // Send task list
-  // Send module description
-  // Send module information
-  //
+static unsigned _FindTaskIdSlot(U32 TaskId) {
+  unsigned Slot;
+  unsigned Id;
+
+  Slot = TASK_ID_SLOT(TaskId);
+  for (;;) {
+    Id = _SYSVIEW_Globals.aTaskIdSlot[Slot];
+    if (Id == 0u || _SYSVIEW_Globals.aTaskId[Id - 1u] == TaskId) {
+      return Slot;
+    }
+    Slot = TASK_ID_SLOT_NEXT(Slot);
+  }
+}
+
+/*********************************************************************
+*
+*       _FreeTaskIdSlot()
+*
+*  Function description
+*    Frees a slot of the hash index. The following slots up to the next
+*    unused one are moved back, where possible, so every task can still
+*    be found from the slot of its hash without passing an unused slot.
+*    The IDs of the tasks do not change.
+*/
+static void _FreeTaskIdSlot(unsigned Slot) {
+  unsigned Next;
+  unsigned Home;
+
+  Next = Slot;
+  for (;;) {
+    _SYSVIEW_Globals.aTaskIdSlot[Slot] = 0u;
+    do {
+      Next = TASK_ID_SLOT_NEXT(Next);
+      if (_SYSVIEW_Globals.aTaskIdSlot[Next] == 0u) {
+        return;
+      }
+      Home = TASK_ID_SLOT(_SYSVIEW_Globals.aTaskId[_SYSVIEW_Globals.aTaskIdSlot[Next] - 1u]);
+      //
+      // The task at Next may move to Slot unless its hash is after Slot,
+      // i.e. closer to Next.
+      //
+    } while (((Next - Home) & (TASK_ID_HASH_SIZE - 1u)) < ((Next - Slot) & (TASK_ID_HASH_SIZE - 1u)));
+    _SYSVIEW_Globals.aTaskIdSlot[Slot] = _SYSVIEW_Globals.aTaskIdSlot[Next];
+    Slot = Next;
+  }
+}
+#endif
+
+/*********************************************************************
+*
+*       _ShrinkTaskId()
+*
+*  Function description
+*    Returns the ID of a task as it is sent to the host.
+*
+*  Parameters
+*    TaskId - ID of the task, as passed to
+*             SEGGER_SYSVIEW_OnTaskStartExec().
+*
+*  Return value
+*    1 to SEGGER_SYSVIEW_NUM_TASK_IDS: ID of the task in the table.
+*    Otherwise: Shrunk ID + SEGGER_SYSVIEW_NUM_TASK_IDS + 1, for tasks
+*               which are not in the table.
+*/
+#if (SEGGER_SYSVIEW_NUM_TASK_IDS > 0)
+static U32 _ShrinkTaskId(U32 TaskId) {
+  unsigned Id;
+
+  if (TaskId != 0u) {
+    Id = _SYSVIEW_Globals.aTaskIdSlot[_FindTaskIdSlot(TaskId)];
+    if (Id != 0u) {
+      return Id;
+    }
+  }
+  return SHRINK_ID(TaskId) + SEGGER_SYSVIEW_NUM_TASK_IDS + 1u;
+}
+
+/*********************************************************************
+*
+*       _AddTaskId()
+*
+*  Function description
+*    Assigns an ID to a task, unless it has one or all are in use.
+*/
+static void _AddTaskId(U32 TaskId) {
+  unsigned Slot;
+  unsigned i;
+
+  if (TaskId == 0u) {
+    return;
+  }
+  SEGGER_SYSVIEW_LOCK();
+  Slot = _FindTaskIdSlot(TaskId);
+  if (_SYSVIEW_Globals.aTaskIdSlot[Slot] == 0u) {
+    for (i = 0; i < SEGGER_SYSVIEW_NUM_TASK_IDS; i++) {
+      if (_SYSVIEW_Globals.aTaskId[i] == 0u) {
+        _SYSVIEW_Globals.aTaskId[i]        = TaskId;
+        _SYSVIEW_Globals.aTaskIdSlot[Slot] = (U16)(i + 1u);
+        break;
+      }
+    }
+  }
+  SEGGER_SYSVIEW_UNLOCK();
+}
+
+/*********************************************************************
+*
+*       _RemoveTaskId()
+*
+*  Function description
+*    Frees the ID of a task.
+*/
+static void _RemoveTaskId(U32 TaskId) {
+  unsigned Slot;
+  unsigned Id;
+
+  SEGGER_SYSVIEW_LOCK();
+  Slot = _FindTaskIdSlot(TaskId);
+  Id   = _SYSVIEW_Globals.aTaskIdSlot[Slot];
+  if (Id != 0u) {
+    _SYSVIEW_Globals.aTaskId[Id - 1u] = 0u;
+    _FreeTaskIdSlot(Slot);
+  }
+  SEGGER_SYSVIEW_UNLOCK();
+}
+#endif
+
+/*********************************************************************
+*
+*       _IsTaskFiltered()
+*
+*  Function description
+*    Checks if the events of a task are filtered.
+*
+*  Parameters
+*    TaskId - ID of the task, as sent to the host.
+*
+*  Return value
+*    1: Tasks are selected by the task filter, but not this one.
+*    0: The task is selected or the task filter is empty.
+*/
+#if (SEGGER_SYSVIEW_NUM_TASK_FILTERS > 0)
+static U8 _IsTaskFiltered(U32 TaskId) {
+  unsigned i;
+  U8       r;
+
+  r = 0;
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_TASK_FILTERS; i++) {
+    if (_SYSVIEW_Globals.aTaskFilter[i] != 0u) {
+      if (_SYSVIEW_Globals.aTaskFilter[i] == TaskId) {
+        return 0;
+      }
+      r = 1;
+    }
+  }
+  return r;
+}
+#endif
+
+/*********************************************************************
+*
+*       _IsSampledOut()
+*
+*  Function description
+*    Counts an event of a sampled ID and checks if it is to be
+*    skipped.
+*
+*  Parameters
+*    EventId - ID of the event.
+*
+*  Return value
+*    1: The event is skipped.
+*    0: The event is recorded, it is not sampled or it is the
+*       first of the next Ratio events.
+*/
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0)
+static int _IsSampledOut(unsigned int EventId) {
+  SEGGER_SYSVIEW_SAMPLING* pSampling;
+  unsigned                 i;
+
+  for (i = 0; i < _SYSVIEW_Globals.NumSampledEvents; i++) {
+    pSampling = &_SYSVIEW_Globals.aSampling[i];
+    if (pSampling->EventId == EventId) {
+      if (++pSampling->Cnt < pSampling->Ratio) {
+        return 1;
+      }
+      pSampling->Cnt = 0;
+      return 0;
+    }
+  }
+  return 0;
+}
+#endif
+
+/*********************************************************************
+*
+*       _UpdateTime64()
+*
+*  Function description
+*    Counts a half wrap period of the timestamp when its MSB has
+*    changed since it was last seen.
+*
+*  Parameters
+*    TimeStamp - Current system timestamp.
+*
+*  Additional information
+*    Called with SystemView locked. The new count only depends on
+*    the MSB, so concurrent calls from contexts with separate locks
+*    store the same value.
+*/
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+static void _UpdateTime64(U32 TimeStamp) {
+  U32 HalfWraps;
+
+  HalfWraps = _SYSVIEW_Globals.TimeHalfWraps;
+  if (((HalfWraps ^ (TimeStamp >> 31)) & 1u) != 0u) {
+    _SYSVIEW_Globals.TimeHalfWraps = HalfWraps + 1u;
+  }
+}
+#endif
+
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+/*********************************************************************
+*
+*       _GetLoadSlot()
+*
+*  Function description
+*    Returns the slot of a task in the load table, adding the task
+*    if it has not run in the current period.
+*
+*  Return value
+*    Slot of the task, LOAD_CUR_OTHER if the table is full.
+*/
+static unsigned _GetLoadSlot(U32 TaskId) {
+  SEGGER_SYSVIEW_LOAD_TASK* pTask;
+  unsigned                  Slot;
+  unsigned                  i;
+
+  if (TaskId == 0u) {
+    return LOAD_CUR_OTHER;
+  }
+  Slot = LOAD_SLOT(TaskId);
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_LOAD_TASKS; i++) {
+    pTask = &_SYSVIEW_Globals.aLoadTask[Slot];
+    if (pTask->TaskId == TaskId) {
+      return Slot;
+    }
+    if (pTask->TaskId == 0u) {
+      pTask->TaskId = TaskId;
+      pTask->Time   = 0;
+      return Slot;
+    }
+    Slot = (Slot + 1u) & (SEGGER_SYSVIEW_NUM_LOAD_TASKS - 1u);
+  }
+  return LOAD_CUR_OTHER;
+}
+
+/*********************************************************************
+*
+*       _GetLoad()
+*
+*  Function description
+*    Returns a time in 1/1000 of a period, rounded.
+*/
+static U32 _GetLoad(U32 Time, U32 Period) {
+  if (Period == 0u) {
+    return 0;
+  }
+  return (U32)(((U64)Time * 1000u + Period / 2u) / Period);
+}
+
+/*********************************************************************
+*
+*       _SendLoad()
+*
+*  Function description
+*    Sends the load of the current period and starts the next one.
+*
+*  Parameters
+*    TimeStamp - End of the period.
+*
+*  Additional information
+*    Called with SystemView locked. Sent as SYSVIEW_EVTID_EX packet
+*    with sub-ID SYSVIEW_EVTID_EX_LOAD:
+*      <Period> <IdleLoad> <ISRLoad> <NumTasks> (<TaskId> <Load>)[NumTasks]
+*    Period is in the timestamp units sent, the loads are in 1/1000
+*    of the period. The rest of the period has been spent in tasks
+*    without a slot or outside of any task.
+*/
+static void _SendLoad(U32 TimeStamp) {
+  SEGGER_SYSVIEW_LOAD_TASK* pTask;
+  U32                       Period;
+  unsigned                  NumTasks;
+  unsigned                  i;
+  U8*                       pPayload;
+  U8*                       pPayloadStart;
+
+  Period   = TimeStamp - _SYSVIEW_Globals.LoadPeriodStart;
+  NumTasks = 0;
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_LOAD_TASKS; i++) {
+    NumTasks += (_SYSVIEW_Globals.aLoadTask[i].TaskId != 0u) ? 1u : 0u;
+  }
+  {
+    RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + (5 + 2 * SEGGER_SYSVIEW_NUM_LOAD_TASKS) * SEGGER_SYSVIEW_QUANTA_U32);
+    //
+    pPayload = pPayloadStart;
+    ENCODE_U32(pPayload, SYSVIEW_EVTID_EX_LOAD);
+    ENCODE_U32(pPayload, Period >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT);
+    ENCODE_U32(pPayload, _GetLoad(_SYSVIEW_Globals.LoadIdleTime, Period));
+    ENCODE_U32(pPayload, _GetLoad(_SYSVIEW_Globals.LoadISRTime, Period));
+    ENCODE_U32(pPayload, NumTasks);
+    for (i = 0; i < SEGGER_SYSVIEW_NUM_LOAD_TASKS; i++) {
+      pTask = &_SYSVIEW_Globals.aLoadTask[i];
+      if (pTask->TaskId != 0u) {
+        ENCODE_U32(pPayload, SHRINK_TASK_ID(pTask->TaskId));
+        ENCODE_U32(pPayload, _GetLoad(pTask->Time, Period));
+      }
+    }
+    _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_EX);
+    RECORD_END();
+  }
+  //
+  // Start the next period with the task which is running.
+  //
+  _SYSVIEW_Globals.LoadPeriodStart = TimeStamp;
+  _SYSVIEW_Globals.LoadIdleTime    = 0;
+  _SYSVIEW_Globals.LoadISRTime     = 0;
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_LOAD_TASKS; i++) {
+    _SYSVIEW_Globals.aLoadTask[i].TaskId = 0;
+  }
+  if (_SYSVIEW_Globals.LoadCur < SEGGER_SYSVIEW_NUM_LOAD_TASKS) {
+    _SYSVIEW_Globals.LoadCur = (U8)_GetLoadSlot(_SYSVIEW_Globals.LoadCurTaskId);
+  }
+}
+
+/*********************************************************************
+*
+*       _AccountLoad()
+*
+*  Function description
+*    Accounts the time since the previous scheduler or interrupt
+*    event to the context which has run and switches the context.
+*
+*  Parameters
+*    Event     - LOAD_EVENT_*.
+*    TaskId    - LOAD_EVENT_TASK: ID of the task which starts to run.
+*    TimeStamp - Time of the event.
+*
+*  Additional information
+*    Called with SystemView locked. Time in interrupts is accounted to
+*    interrupts, also when a task is switched in an interrupt. Sends
+*    the load report when the period is over or with LOAD_EVENT_REPORT.
+*/
+static void _AccountLoad(unsigned Event, U32 TaskId, U32 TimeStamp) {
+  U32 Delta;
+  U8  Cur;
+
+  Delta     = TimeStamp - _SYSVIEW_Globals.LoadLastTime;
+  _SYSVIEW_Globals.LoadLastTime = TimeStamp;
+  Cur       = _SYSVIEW_Globals.LoadCur;
+  if (_SYSVIEW_Globals.LoadISRNesting != 0u) {
+    _SYSVIEW_Globals.LoadISRTime += Delta;
+  } else if (Cur < SEGGER_SYSVIEW_NUM_LOAD_TASKS) {
+    _SYSVIEW_Globals.aLoadTask[Cur].Time += Delta;
+  } else if (Cur == LOAD_CUR_IDLE) {
+    _SYSVIEW_Globals.LoadIdleTime += Delta;
+  }
+  switch (Event) {
+  case LOAD_EVENT_ENTER_ISR:
+    _SYSVIEW_Globals.LoadISRNesting++;
+    break;
+  case LOAD_EVENT_EXIT_ISR:
+    if (_SYSVIEW_Globals.LoadISRNesting != 0u) {
+      _SYSVIEW_Globals.LoadISRNesting--;
+    }
+    break;
+  case LOAD_EVENT_TASK:
+    _SYSVIEW_Globals.LoadCurTaskId = TaskId;
+    _SYSVIEW_Globals.LoadCur       = (U8)_GetLoadSlot(TaskId);
+    break;
+  case LOAD_EVENT_IDLE:
+    _SYSVIEW_Globals.LoadCurTaskId = 0;
+    _SYSVIEW_Globals.LoadCur       = LOAD_CUR_IDLE;
+    break;
+  case LOAD_EVENT_STOP:
+    _SYSVIEW_Globals.LoadCurTaskId = 0;
+    _SYSVIEW_Globals.LoadCur       = LOAD_CUR_OTHER;
+    break;
+  default:
+    break;
+  }
+#if (SEGGER_SYSVIEW_LOAD_PERIOD > 0)
+  if (TimeStamp - _SYSVIEW_Globals.LoadPeriodStart >= SEGGER_SYSVIEW_LOAD_PERIOD) {
+    Event = LOAD_EVENT_REPORT;
+  }
+#endif
+  if (Event == LOAD_EVENT_REPORT) {
+    _SendLoad(TimeStamp);
+  }
+}
+#endif
+
+/*********************************************************************
+*
+*       _StopOnFull()
+*
+*  Function description
+*    Stops recording on all shards, because the RTT buffer is full
+*    in SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL.
+*
+*  Additional information
+*    No stop packet is sent, as there is no space for it. The host
+*    sees the recording stopped and may restart it.
+*/
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+static void _StopOnFull(void) {
+  _SYSVIEW_Globals.EnableState = ENABLE_STATE_OFF;
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+  {
+    unsigned n;
+
+    for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+      _aShard[n].EnableState = ENABLE_STATE_OFF;
+    }
+  }
+#endif
+}
+#endif
+
+/*********************************************************************
+*
+*       _TrySendOverflowPacket()
+*
+*  Function description
+*    Try to transmit an SystemView Overflow packet containing the
+*    number of dropped packets.
+*
+*  Parameters
+*    pShard - Shard to transmit the packet on.
+*
+*  Additional information
+*    Format as follows:
+*      01 <DropCnt><TimeStamp>  Max. packet len is 1 + 5 + 5 = 11
+*
+*    Example packets sent
+*      01 20 40
+*
+*    With SEGGER_SYSVIEW_USE_DROP_STATS, the packet is followed by
+*    a SYSVIEW_EVTID_EX packet with the same time stamp:
+*      1F <Len> 03 <NumClasses> <DropCnt class 0> ... <TimeStamp>
+*    Both are written at once, so the drop counts of all classes
+*    since SEGGER_SYSVIEW_Init() are sent whenever the overflow
+*    packet is.
+*
+*  Return value
+*    !=0:  Success, Message sent (stored in RTT-Buffer)
+*    ==0:  Buffer full, Message *NOT* stored
+*
+*/
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+static int _TrySendOverflowPacket(SEGGER_SYSVIEW_SHARD* pShard) {
+  U32 TimeStamp;
+  I32 Delta;
+  int Status;
+  U8  aPacket[11 + DROP_STATS_SIZE];
+  U8* pPayload;
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+  U8* pLen;
+  unsigned n;
+#endif
+
+  aPacket[0] = SYSVIEW_EVTID_OVERFLOW;      // 1
+  pPayload   = &aPacket[1];
+  ENCODE_U32(pPayload, pShard->DropCount);
+  //
+  // Compute time stamp delta and append it to packet.
+  //
+  TimeStamp  = SEGGER_SYSVIEW_GET_TIMESTAMP();
+  Delta = TimeStamp - pShard->LastTxTimeStamp;
+  MAKE_DELTA_32BIT(Delta);
+  SCALE_DELTA(Delta, TimeStamp, pShard->LastTxTimeStamp);
+  ENCODE_DELTA(pPayload, Delta, PREV_DELTA(pShard));
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+  //
+  // Append drop statistics packet. Its payload is always < 128 bytes.
+  //
+  *pPayload++ = SYSVIEW_EVTID_EX;
+  pLen        = pPayload++;
+  ENCODE_U32(pPayload, SYSVIEW_EVTID_EX_DROP_STATS);
+  ENCODE_U32(pPayload, SEGGER_SYSVIEW_NUM_DROP_CLASSES);
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_DROP_CLASSES; n++) {
+    ENCODE_U32(pPayload, pShard->aDropCount[n]);
+  }
+  *pLen = (U8)(pPayload - pLen - 1);
+  ENCODE_DELTA(pPayload, 0, Delta);
+#endif
+  //
+  // Try to store packet in RTT buffer and update time stamp when this was successful
+  //
+  Status = (int)_WriteUpNoLock(SHARD_CHANNEL_ID_UP(pShard), aPacket, (unsigned int)(pPayload - aPacket));
+  SEGGER_SYSVIEW_ON_EVENT_RECORDED(pPayload - aPacket);
+  if (Status) {
+    pShard->LastTxTimeStamp = TimeStamp;
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+    SET_PREV_DELTA(pShard, 0);
+#else
+    SET_PREV_DELTA(pShard, Delta);
+#endif
+    pShard->EnableState--; // EnableState has been 2, will be 1. Always.
+  } else {
+    pShard->DropCount++;
+  }
+  //
+  return Status;
+}
+#endif  // (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+
+/*********************************************************************
+*
+*       _TrySendShardSync()
+*
+*  Function description
+*    Try to transmit a sync packet containing the absolute time stamp
+*    on a shard, so the host can align the shards when merging them.
+*
+*  Parameters
+*    pShard - Shard to transmit the packet on.
+*
+*  Additional information
+*    Format as follows:
+*      1E <Len><Shard><AbsTimeStamp><TimeStamp>  Max. packet len is 1 + 1 + 5 + 5 + 5 = 17
+*
+*    The packet carries its length and the usual time stamp delta,
+*    so hosts which do not merge shards can skip it.
+*    With SEGGER_SYSVIEW_USE_DELTA_OF_DELTA, the delta is sent relative
+*    to a previous delta of 0, so the host can start decoding a shard
+*    at any sync packet.
+*/
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+static void _TrySendShardSync(SEGGER_SYSVIEW_SHARD* pShard) {
+  U32 TimeStamp;
+  I32 Delta;
+  U8  aPacket[17];
+  U8* pPayload;
+
+  aPacket[0] = SYSVIEW_EVTID_SHARD_SYNC;    // 30
+  pPayload   = &aPacket[2];
+  ENCODE_U32(pPayload, (U32)(pShard - &_aShard[0]));
+  TimeStamp  = SEGGER_SYSVIEW_GET_TIMESTAMP();
+  ENCODE_U32(pPayload, TimeStamp);
+  aPacket[1] = (U8)(pPayload - &aPacket[2]);
+  Delta = TimeStamp - pShard->LastTxTimeStamp;
+  MAKE_DELTA_32BIT(Delta);
+  ENCODE_DELTA(pPayload, Delta, 0);
+  if (_WriteUpNoLock(SHARD_CHANNEL_ID_UP(pShard), aPacket, (unsigned int)(pPayload - aPacket))) {
+    SEGGER_SYSVIEW_ON_EVENT_RECORDED(pPayload - aPacket);
+    pShard->LastTxTimeStamp = TimeStamp;
+    SET_PREV_DELTA(pShard, Delta);
+    pShard->SyncPending     = 0;
+    pShard->PacketCount     = 0;
+  }
+}
+#endif  // (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+
+/*********************************************************************
+*
+*       _SendSyncInfo()
+*
+*  Function description
+*    Send SystemView sync packet and system information in
+*    post mortem mode.
+*
+*  Additional information
+*    Sync is 10 * 0x00 without timestamp
+*/
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+static void _SendSyncInfo(void) {
+  //
+  // Add sync packet ( 10 * 0x00)
+  // Send system description
+  // Send system time
+  // Send task list
+  // Send module description
+  // Send module information
+  //
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+  _SYSVIEW_Globals.DescPos = _SYSVIEW_Globals.NumBytesWritten;
+#endif
   SEGGER_RTT_WriteWithOverwriteNoLock(CHANNEL_ID_UP, _abSync, 10);
+  SET_PREV_DELTA(&_SYSVIEW_Globals, 0);    // Sync resets delta-of-delta chain
   SEGGER_SYSVIEW_ON_EVENT_RECORDED(10);
+  COUNT_BYTES(10);
   SEGGER_SYSVIEW_RecordVoid(SYSVIEW_EVTID_TRACE_START);
   {
     U8* pPayload;
@@ -688,9 +1880,70 @@ static void _SendSyncInfo(void) {
     }
     SEGGER_SYSVIEW_SendModuleDescription();
   }
+  SEND_SAMPLING_WEIGHTS();
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+  _SYSVIEW_Globals.DescSize    = _SYSVIEW_Globals.NumBytesWritten - _SYSVIEW_Globals.DescPos;
+  _SYSVIEW_Globals.DescChanged = 0;
+#endif
 }
 #endif  // (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
 
+/*********************************************************************
+*
+*       _SendCheckpoint()
+*
+*  Function description
+*    Send a sync and a checkpoint packet in post mortem mode.
+*    The full system description is sent before, if the task list or
+*    the modules have changed since it was sent last, or if it might
+*    soon be overwritten in the buffer.
+*
+*  Additional information
+*    Checkpoint is SYSVIEW_EVTID_EX with:
+*      SYSVIEW_EVTID_EX_CHECKPOINT
+*      Time stamp of the previous packet, in units of the deltas
+*      Sequence number of the checkpoint packet
+*      Distance in bytes from the sync of the last full description to the sync of the checkpoint
+*      Size in bytes of the last full description
+*    After the packet, SEGGER_SYSVIEW_LastCheckpoint is set to the
+*    location of the sync of the checkpoint in the buffer, so a host
+*    can find the most recent checkpoint in a dump without a search.
+*/
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+static void _SendCheckpoint(void) {
+  U8* pPayload;
+  U8* pPayloadStart;
+  U32 Off;
+  U32 SeqNo;
+  U32 DescDist;
+
+  if (_SYSVIEW_Globals.DescChanged || (_SYSVIEW_Globals.NumBytesWritten - _SYSVIEW_Globals.DescPos) > SEGGER_SYSVIEW_RTT_BUFFER_SIZE / 2) {
+    _SendSyncInfo();
+  }
+  Off      = UP_WR_OFF();
+  DescDist = _SYSVIEW_Globals.NumBytesWritten - _SYSVIEW_Globals.DescPos;
+  SEGGER_RTT_WriteWithOverwriteNoLock(CHANNEL_ID_UP, _abSync, 10);
+  SET_PREV_DELTA(&_SYSVIEW_Globals, 0);    // Sync resets delta-of-delta chain
+  SEGGER_SYSVIEW_ON_EVENT_RECORDED(10);
+  COUNT_BYTES(10);
+  SeqNo = _SYSVIEW_Globals.NumPackets;
+  {
+    RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 5 * SEGGER_SYSVIEW_QUANTA_U32);
+    //
+    pPayload = pPayloadStart;
+    ENCODE_U32(pPayload, SYSVIEW_EVTID_EX_CHECKPOINT);
+    ENCODE_U32(pPayload, _SYSVIEW_Globals.LastTxTimeStamp >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT);
+    ENCODE_U32(pPayload, SeqNo);
+    ENCODE_U32(pPayload, DescDist);
+    ENCODE_U32(pPayload, _SYSVIEW_Globals.DescSize);
+    _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_EX);
+    RECORD_END();
+  }
+  SEGGER_SYSVIEW_LastCheckpoint.Off   = Off;
+  SEGGER_SYSVIEW_LastCheckpoint.SeqNo = SeqNo;
+}
+#endif  // (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+
 /*********************************************************************
 *
 *       _SendPacket()
@@ -702,60 +1955,61 @@ static void _SendSyncInfo(void) {
 *    and sending overflow packets when necessary.
 *    The packet must be passed without Id and Length because this
 *    function prepends it to the packet before transmission.
+*    With SEGGER_SYSVIEW_USE_LOAD_SHEDDING, events of low priority
+*    classes are dropped when the RTT buffer is filled above their
+*    high-water mark, which keeps the remaining space for scheduler,
+*    interrupt and system events. While low priority events are being
+*    shed, the overflow packet is deferred until at least
+*    SEGGER_SYSVIEW_SHED_HEADROOM_LOW + SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL
+*    bytes are free, and the other events are still sent.
 *
 *  Parameters
 *    pStartPacket - Pointer to start of packet payload.
 *                   There must be at least 4 bytes free to prepend Id and Length.
 *    pEndPacket   - Pointer to end of packet payload.
 *    EventId      - Id of the event to send.
+*    LoadEvent    - With SEGGER_SYSVIEW_NUM_LOAD_TASKS: LOAD_EVENT_* to be
+*                   accounted, LOAD_EVENT_NONE for other events.
+*    TaskId       - LOAD_EVENT_TASK: ID of the task which starts to run.
 *
 */
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+static void _SendPacketEx(U8* pStartPacket, U8* pEndPacket, unsigned int EventId, unsigned LoadEvent, U32 TaskId) {
+#else
 static void _SendPacket(U8* pStartPacket, U8* pEndPacket, unsigned int EventId) {
+#endif
+  SEGGER_SYSVIEW_SHARD* pShard;
   unsigned int  NumBytes;
   U32           TimeStamp;
   U32           Delta;
-#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  U32           LoadTime;
+  int           HasLoadTime;
+#endif
+#if (SEGGER_SYSVIEW_USE_RESERVE_COMMIT == 1)
+  int           ReservedOff;
+#elif (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
   unsigned int  Status;
 #endif
-
-#if (SEGGER_SYSVIEW_USE_STATIC_BUFFER == 0)
-  SEGGER_SYSVIEW_LOCK();
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1) || (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+  unsigned int  DropClass;
+#endif
+#if (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+  unsigned int  NumBytesFree;
 #endif
 
-#if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
-  if (_SYSVIEW_Globals.EnableState == 0) {
-    goto SendDone;
-  }
-#else
-  if (_SYSVIEW_Globals.EnableState == 1) {  // Enabled, no dropped packets remaining
-    goto Send;
-  }
-  if (_SYSVIEW_Globals.EnableState == 0) {
-    goto SendDone;
-  }
-  //
-  // Handle buffer full situations:
-  // Have packets been dropped before because buffer was full?
-  // In this case try to send and overflow packet.
-  //
-  if (_SYSVIEW_Globals.EnableState == 2) {
-    _TrySendOverflowPacket();
-    if (_SYSVIEW_Globals.EnableState != 1) {
-      goto SendDone;
-    }
-  }
-Send:
+#if (SEGGER_SYSVIEW_USE_RESERVE_COMMIT == 1)
+  ReservedOff = -1;
+#endif
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  LoadTime    = 0;
+  HasLoadTime = 0;
+#endif
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1) || (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+  DropClass = _GetDropClass(EventId, pStartPacket);
 #endif
   //
-  // Check if event is disabled from being recorded.
-  //
-  if (EventId < 32) {
-    if (_SYSVIEW_Globals.DisabledEvents & ((U32)1u << EventId)) {
-      goto SendDone;
-    }
-  }
-  //
-  // Prepare actual packet.
+  // Prepare actual packet, before SystemView is locked.
   // If it is a known packet, prepend eventId only,
   // otherwise prepend packet length and eventId.
   //
@@ -840,30 +2094,155 @@ Send:
     }
 #endif
   }
+#if (SEGGER_SYSVIEW_USE_STATIC_BUFFER == 0)
+  SEGGER_SYSVIEW_LOCK();
+#endif
+  pShard = GET_SHARD();
+  //
+  // Check if event is disabled from being recorded.
+  // Disabled events are neither shed nor counted as dropped.
+  //
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  if (!SEGGER_SYSVIEW_IS_EVENT_ENABLED(EventId)) {
+    goto SendDone;
+  }
+#else
+  if (EventId < 32) {
+    if (_SYSVIEW_Globals.DisabledEvents & ((U32)1u << EventId)) {
+      goto SendDone;
+    }
+  }
+#endif
+#if (SEGGER_SYSVIEW_NUM_TASK_FILTERS > 0)
+  //
+  // Check if the running task is filtered.
+  // Scheduler, interrupt and system events are always recorded.
+  //
+  if ((pShard->TaskFiltered != 0u) && (EventId >= 32u)) {
+    goto SendDone;
+  }
+#endif
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0)
+  if ((_SYSVIEW_Globals.NumSampledEvents != 0u) && _IsSampledOut(EventId)) {
+    goto SendDone;
+  }
+#endif
+
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+  if (pShard->EnableState == 0) {
+    goto SendDone;
+  }
+#else
+#if (SEGGER_SYSVIEW_USE_LOAD_SHEDDING == 1)
+  if (pShard->EnableState == 0) {
+    goto SendDone;
+  }
+  //
+  // Shed the event when the buffer is filled above the high-water mark of its class.
+  // Defer the overflow packet until the buffer has drained well below the
+  // high-water marks, so it does not take the space of the events shed for.
+  //
+  NumBytesFree = SEGGER_RTT_GetAvailWriteSpace(SHARD_CHANNEL_ID_UP(pShard));
+  if (NumBytesFree < _GetShedHeadroom(DropClass)) {
+    if (pShard->EnableState == 1) {
+      pShard->EnableState = 2;
+    }
+    pShard->DropCount++;
+    COUNT_DROP(pShard, DropClass);
+    goto SendDone;
+  }
+  if (NumBytesFree < SEGGER_SYSVIEW_SHED_HEADROOM_LOW + SEGGER_SYSVIEW_SHED_HEADROOM_NORMAL) {
+    goto Send;
+  }
+#endif
+  if (pShard->EnableState == 1) {  // Enabled, no dropped packets remaining
+    goto Send;
+  }
+  if (pShard->EnableState == 0) {
+    goto SendDone;
+  }
+  //
+  // Handle buffer full situations:
+  // Have packets been dropped before because buffer was full?
+  // In this case try to send and overflow packet.
+  //
+  if (pShard->EnableState == 2) {
+    _TrySendOverflowPacket(pShard);
+    if (pShard->EnableState != 1) {
+      COUNT_DROP(pShard, DropClass);
+      goto SendDone;
+    }
+  }
+Send:
+#endif
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+  //
+  // Send the absolute time stamp on start and periodically,
+  // so the host can align this shard with the others.
+  //
+  if (pShard->SyncPending || (++pShard->PacketCount >> SEGGER_SYSVIEW_SHARD_SYNC_PERIOD_SHIFT)) {
+    _TrySendShardSync(pShard);
+  }
+#endif
   //
   // Compute time stamp delta and append it to packet.
   //
   TimeStamp  = SEGGER_SYSVIEW_GET_TIMESTAMP();
-  Delta = TimeStamp - _SYSVIEW_Globals.LastTxTimeStamp;
+  UPDATE_TIME64(TimeStamp);
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  LoadTime    = TimeStamp;          // Before it is rounded by SCALE_DELTA()
+  HasLoadTime = 1;
+#endif
+  Delta = TimeStamp - pShard->LastTxTimeStamp;
   MAKE_DELTA_32BIT(Delta);
-  ENCODE_U32(pEndPacket, Delta);
+  SCALE_DELTA(Delta, TimeStamp, pShard->LastTxTimeStamp);
+  ENCODE_DELTA(pEndPacket, Delta, PREV_DELTA(pShard));
 #if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
   //
   // Store packet in RTT buffer by overwriting old data and update time stamp
   //
   SEGGER_RTT_WriteWithOverwriteNoLock(CHANNEL_ID_UP, pStartPacket, pEndPacket - pStartPacket);
   SEGGER_SYSVIEW_ON_EVENT_RECORDED(pEndPacket - pStartPacket);
-  _SYSVIEW_Globals.LastTxTimeStamp = TimeStamp;
+  COUNT_PACKET(pEndPacket - pStartPacket);
+  pShard->LastTxTimeStamp = TimeStamp;
+  SET_PREV_DELTA(pShard, Delta);
+#elif (SEGGER_SYSVIEW_USE_RESERVE_COMMIT == 1)
+  //
+  // Try to reserve space in RTT buffer and update time stamp when this was successful.
+  // The packet is copied and committed after SystemView has been unlocked.
+  //
+  NumBytes    = (unsigned int)(pEndPacket - pStartPacket);
+  ReservedOff = SEGGER_RTT_ReserveUpNoLock(SHARD_CHANNEL_ID_UP(pShard), NumBytes);
+  if (ReservedOff >= 0) {
+    pShard->LastTxTimeStamp = TimeStamp;
+    SET_PREV_DELTA(pShard, Delta);
+  } else {
+    ON_BUFFER_FULL(pShard);
+    COUNT_DROP(pShard, DropClass);
+  }
 #else
   //
-  // Try to store packet in RTT buffer and update time stamp when this was successful
+  // Try to store packet in RTT buffer and update time stamp when this was successful.
+  // A packet which has been prepared in the RTT buffer only needs to be committed.
   //
-  Status = SEGGER_RTT_WriteSkipNoLock(CHANNEL_ID_UP, pStartPacket, (unsigned int)(pEndPacket - pStartPacket));
+#if (SEGGER_SYSVIEW_USE_IN_PLACE_ENCODING == 1)
+  if (pStartPacket == _pInPlacePacket) {
+    _pInPlacePacket = NULL;
+    SEGGER_RTT_CommitUpInPlaceNoLock(SHARD_CHANNEL_ID_UP(pShard), (unsigned int)(pEndPacket - pStartPacket));
+    Status = 1u;
+  } else {
+    Status = SEGGER_RTT_WriteSkipNoLock(SHARD_CHANNEL_ID_UP(pShard), pStartPacket, (unsigned int)(pEndPacket - pStartPacket));
+  }
+#else
+  Status = SEGGER_RTT_WriteSkipNoLock(SHARD_CHANNEL_ID_UP(pShard), pStartPacket, (unsigned int)(pEndPacket - pStartPacket));
+#endif
   SEGGER_SYSVIEW_ON_EVENT_RECORDED(pEndPacket - pStartPacket);
   if (Status) {
-    _SYSVIEW_Globals.LastTxTimeStamp = TimeStamp;
+    pShard->LastTxTimeStamp = TimeStamp;
+    SET_PREV_DELTA(pShard, Delta);
   } else {
-    _SYSVIEW_Globals.EnableState++; // EnableState has been 1, will be 2. Always.
+    ON_BUFFER_FULL(pShard);
+    COUNT_DROP(pShard, DropClass);
   }
 #endif
 
@@ -874,7 +2253,11 @@ Send:
   if (_SYSVIEW_Globals.RecursionCnt == 0) {   // Avoid uncontrolled nesting. This way, this routine can call itself once, but no more often than that.
     _SYSVIEW_Globals.RecursionCnt = 1;
     if (_SYSVIEW_Globals.PacketCount++ & (1 << SEGGER_SYSVIEW_SYNC_PERIOD_SHIFT)) {
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+      _SendCheckpoint();
+#else
       _SendSyncInfo();
+#endif
       _SYSVIEW_Globals.PacketCount = 0;
     }
     _SYSVIEW_Globals.RecursionCnt = 0;
@@ -886,21 +2269,59 @@ SendDone:
   //
   // Check if host is sending data which needs to be processed.
   // Note that since this code is called for every packet, it is very time critical, so we do
-  // only what is really needed here, which is checking if there is any data
+  // only what is really needed here, which is checking if there is any data.
+  // Host commands are only handled on the first shard.
   //
-  if (SEGGER_RTT_HASDATA(CHANNEL_ID_DOWN)) {
+  if (SHARD_IS_FIRST(pShard) && SEGGER_RTT_HASDATA(CHANNEL_ID_DOWN)) {
     if (_SYSVIEW_Globals.RecursionCnt == 0) {   // Avoid uncontrolled nesting. This way, this routine can call itself once, but no more often than that.
       _SYSVIEW_Globals.RecursionCnt = 1;
       _HandleIncomingPacket();
       _SYSVIEW_Globals.RecursionCnt = 0;
     }
   }
+#endif
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  //
+  // Account the load of a scheduler or interrupt event, with the time
+  // stamp of its packet, if it has been taken. The load report, if due,
+  // follows the packet.
+  //
+  if (LoadEvent != LOAD_EVENT_NONE) {
+    _AccountLoad(LoadEvent, TaskId, HasLoadTime ? LoadTime : SEGGER_SYSVIEW_GET_TIMESTAMP());
+  }
 #endif
   //
 #if (SEGGER_SYSVIEW_USE_STATIC_BUFFER == 0)
   SEGGER_SYSVIEW_UNLOCK();  // We are done. Unlock and return
 #endif
+#if (SEGGER_SYSVIEW_USE_RESERVE_COMMIT == 1)
+  if (ReservedOff >= 0) {
+    SEGGER_RTT_WriteReservedNoLock(SHARD_CHANNEL_ID_UP(pShard), (unsigned)ReservedOff, pStartPacket, NumBytes);
+#if SEGGER_RTT_USE_CAS
+    SEGGER_RTT_CommitUpNoLock(SHARD_CHANNEL_ID_UP(pShard), (unsigned)ReservedOff);    // Compare-and-swap, e.g. LDREX/STREX on ARMv7-M
+#else
+    SEGGER_SYSVIEW_LOCK();
+    SEGGER_RTT_CommitUpNoLock(SHARD_CHANNEL_ID_UP(pShard), (unsigned)ReservedOff);
+    SEGGER_SYSVIEW_UNLOCK();
+#endif
+    SEGGER_SYSVIEW_ON_EVENT_RECORDED(NumBytes);
+  }
+#endif
+}
+
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+/*********************************************************************
+*
+*       _SendPacket()
+*
+*  Function description
+*    Sends a packet of an event which is not accounted in the load,
+*    see _SendPacketEx().
+*/
+static void _SendPacket(U8* pStartPacket, U8* pEndPacket, unsigned int EventId) {
+  _SendPacketEx(pStartPacket, pEndPacket, EventId, LOAD_EVENT_NONE, 0);
 }
+#endif
 
 #ifndef SEGGER_SYSVIEW_EXCLUDE_PRINTF // Define in project to avoid warnings about variable parameter list
 /*********************************************************************
@@ -915,6 +2336,7 @@ SendDone:
 *    Options      Options to be sent to the host.
 *    pParamList   Pointer to the list of arguments for the format string.
 */
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 0)
 static int _VPrintHost(const char* s, U32 Options, va_list* pParamList) {
   U32         aParas[SEGGER_SYSVIEW_MAX_ARGUMENTS];
   U32*        pParas;
@@ -983,6 +2405,101 @@ static int _VPrintHost(const char* s, U32 Options, va_list* pParamList) {
   }
   return 0;
 }
+#else
+/*********************************************************************
+*
+*       _VPrintHost()
+*
+*  Function description
+*    Send the address of a format string and its parameters to the host.
+*
+*  Parameters
+*    s            Pointer to format string.
+*    Options      Options to be sent to the host.
+*    pParamList   Pointer to the list of arguments for the format string.
+*
+*  Return value
+*    == 0: O.K.
+*    ==-1: Format string contains a conversion which takes a 64-bit
+*          or floating-point argument, or "%s" and
+*          SEGGER_SYSVIEW_PRINTF_IMPLICIT_FORMAT is enabled, nothing sent.
+*
+*  Additional information
+*    Sent by SEGGER_SYSVIEW_PrintfDeferred().
+*    Every conversion, but "%%", is sent as one 32-bit argument. Each
+*    argument is read with the type of its conversion, "l" and "z"
+*    arguments and pointers are truncated to 32 bits. Flags, field
+*    width and precision are skipped. "%e", "%f", "%g", "%a" and the
+*    length modifiers "ll", "j", "t", "q" and "L" are not supported.
+*/
+static int _VPrintHost(const char* s, U32 Options, va_list* pParamList) {
+  U32         aParas[SEGGER_SYSVIEW_MAX_ARGUMENTS];
+  unsigned    NumArguments;
+  const char* p;
+  char        c;
+  char        Length;
+
+  p = s;
+  NumArguments = 0;
+  for (;;) {
+    c = *p++;
+    if (c == 0) {
+      break;
+    }
+    if (c == '%') {
+      Length = 0;
+      for (;;) {
+        c = *p++;
+        if ((c == 'l') || (c == 'z') || (c == 'j') || (c == 't') || (c == 'q') || (c == 'L')) {
+          if (Length != 0) {
+            return -1;                    // "ll"
+          }
+          Length = c;
+        } else if (!(((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == ' ') || (c == '#') || (c == '.') || (c == 'h'))) {
+          break;
+        }
+      }
+      if (c == 0) {
+        break;
+      }
+      if (c == '%') {
+        continue;
+      }
+      switch (c) {
+      case 'e': case 'E':
+      case 'f': case 'F':
+      case 'g': case 'G':
+      case 'a': case 'A':
+        return -1;
+      case 's':
+#if SEGGER_SYSVIEW_PRINTF_IMPLICIT_FORMAT
+        return -1;
+#endif
+      case 'p':
+      case 'n':
+        aParas[NumArguments++] = (U32)SEGGER_PTR2ADDR(va_arg(*pParamList, void*));
+        break;
+      default:
+        if (Length == 'l') {
+          aParas[NumArguments++] = (U32)va_arg(*pParamList, long);
+        } else if (Length == 'z') {
+          aParas[NumArguments++] = (U32)va_arg(*pParamList, size_t);
+        } else if (Length != 0) {
+          return -1;
+        } else {
+          aParas[NumArguments++] = (U32)va_arg(*pParamList, int);
+        }
+        break;
+      }
+      if (NumArguments == SEGGER_SYSVIEW_MAX_ARGUMENTS) {
+        break;
+      }
+    }
+  }
+  SEGGER_SYSVIEW_PrintfDeferred(s, Options, aParas, NumArguments);
+  return 0;
+}
+#endif
 
 /*********************************************************************
 *
@@ -1394,11 +2911,12 @@ void SEGGER_SYSVIEW_Init(U32 SysFreq, U32 CPUFreq, const SEGGER_SYSVIEW_OS_API *
   _SYSVIEW_Globals.RAMBaseAddress   = SEGGER_SYSVIEW_ID_BASE;
   _SYSVIEW_Globals.LastTxTimeStamp  = SEGGER_SYSVIEW_GET_TIMESTAMP();
   _SYSVIEW_Globals.pOSAPI           = pOSAPI;
-  _SYSVIEW_Globals.SysFreq          = SysFreq;
+  _SYSVIEW_Globals.SysFreq          = SysFreq >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT;  // Frequency of the timestamp units sent
   _SYSVIEW_Globals.CPUFreq          = CPUFreq;
   _SYSVIEW_Globals.pfSendSysDesc    = pfSendSysDesc;
   _SYSVIEW_Globals.EnableState      = 0;
   _SYSVIEW_Globals.PacketCount      = 0;
+  MARK_DESC_CHANGED();
 #else // (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
 #if SEGGER_SYSVIEW_RTT_CHANNEL > 0
   SEGGER_RTT_ConfigUpBuffer   (SEGGER_SYSVIEW_RTT_CHANNEL, "SysView", &_UpBuffer[0],   sizeof(_UpBuffer),   SEGGER_RTT_MODE_NO_BLOCK_SKIP);
@@ -1411,11 +2929,34 @@ void SEGGER_SYSVIEW_Init(U32 SysFreq, U32 CPUFreq, const SEGGER_SYSVIEW_OS_API *
   _SYSVIEW_Globals.RAMBaseAddress   = SEGGER_SYSVIEW_ID_BASE;
   _SYSVIEW_Globals.LastTxTimeStamp  = SEGGER_SYSVIEW_GET_TIMESTAMP();
   _SYSVIEW_Globals.pOSAPI           = pOSAPI;
-  _SYSVIEW_Globals.SysFreq          = SysFreq;
+  _SYSVIEW_Globals.SysFreq          = SysFreq >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT;  // Frequency of the timestamp units sent
   _SYSVIEW_Globals.CPUFreq          = CPUFreq;
   _SYSVIEW_Globals.pfSendSysDesc    = pfSendSysDesc;
   _SYSVIEW_Globals.EnableState      = 0;
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+  {
+    unsigned n;
+
+    for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+      if (n == 0) {
+        _aShard[n].UpChannel = (U8)CHANNEL_ID_UP;
+      } else {
+        _aShard[n].UpChannel = (U8)SEGGER_RTT_AllocUpBuffer("SysViewShard", &_aShardBuffer[n - 1][0], sizeof(_aShardBuffer[0]), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+      }
+      _aShard[n].LastTxTimeStamp = _SYSVIEW_Globals.LastTxTimeStamp;
+      _aShard[n].EnableState     = 0;
+    }
+  }
+#endif
 #endif  // (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+  _SYSVIEW_Globals.TimeHalfWraps    = SEGGER_SYSVIEW_GET_TIMESTAMP() >> 31;
+#endif
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+  _SYSVIEW_Globals.LoadLastTime     = SEGGER_SYSVIEW_GET_TIMESTAMP();
+  _SYSVIEW_Globals.LoadPeriodStart  = _SYSVIEW_Globals.LoadLastTime;
+  _SYSVIEW_Globals.LoadCur          = LOAD_CUR_OTHER;
+#endif
 }
 
 /*********************************************************************
@@ -1445,7 +2986,7 @@ void SEGGER_SYSVIEW_SetRAMBase(U32 RAMBaseAddress) {
 */
 void SEGGER_SYSVIEW_RecordVoid(unsigned int EventID) {
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE);
   //
   _SendPacket(pPayloadStart, pPayloadStart, EventID);
   RECORD_END();
@@ -1466,7 +3007,7 @@ void SEGGER_SYSVIEW_RecordVoid(unsigned int EventID) {
 void SEGGER_SYSVIEW_RecordU32(unsigned int EventID, U32 Value) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Value);
@@ -1489,7 +3030,7 @@ void SEGGER_SYSVIEW_RecordU32(unsigned int EventID, U32 Value) {
 void SEGGER_SYSVIEW_RecordU32x2(unsigned int EventID, U32 Para0, U32 Para1) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1514,7 +3055,7 @@ void SEGGER_SYSVIEW_RecordU32x2(unsigned int EventID, U32 Para0, U32 Para1) {
 void SEGGER_SYSVIEW_RecordU32x3(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 3 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 3 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1541,7 +3082,7 @@ void SEGGER_SYSVIEW_RecordU32x3(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x4(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 4 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 4 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1570,7 +3111,7 @@ void SEGGER_SYSVIEW_RecordU32x4(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x5(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 5 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 5 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1601,7 +3142,7 @@ void SEGGER_SYSVIEW_RecordU32x5(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x6(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 6 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 6 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1634,7 +3175,7 @@ void SEGGER_SYSVIEW_RecordU32x6(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x7(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 7 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 7 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1669,7 +3210,7 @@ void SEGGER_SYSVIEW_RecordU32x7(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x8(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6, U32 Para7) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 8 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 8 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1706,7 +3247,7 @@ void SEGGER_SYSVIEW_RecordU32x8(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x9(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6, U32 Para7, U32 Para8) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 9 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 9 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1745,7 +3286,7 @@ void SEGGER_SYSVIEW_RecordU32x9(unsigned int EventID, U32 Para0, U32 Para1, U32
 void SEGGER_SYSVIEW_RecordU32x10(unsigned int EventID, U32 Para0, U32 Para1, U32 Para2, U32 Para3, U32 Para4, U32 Para5, U32 Para6, U32 Para7, U32 Para8, U32 Para9) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 10 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(EventID, SEGGER_SYSVIEW_INFO_SIZE + 10 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, Para0);
@@ -1761,6 +3302,41 @@ void SEGGER_SYSVIEW_RecordU32x10(unsigned int EventID, U32 Para0, U32 Para1, U32
   _SendPacket(pPayloadStart, pPayload, EventID);
   RECORD_END();
 }
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_RecordU32s()
+*
+*  Function description
+*    Formats and sends a SystemView packet containing an array of
+*    U32 parameters as payload.
+*
+*  Parameters
+*    EventID  - SystemView event ID.
+*    paPara   - The 32-bit parameters encoded to SystemView packet payload.
+*    NumParas - Number of parameters, at most SEGGER_SYSVIEW_MAX_ARGUMENTS.
+*
+*  Additional information
+*    Used by SEGGER_SYSVIEW_RECORD() for events with more than 10
+*    parameters.
+*/
+void SEGGER_SYSVIEW_RecordU32s(unsigned int EventID, const U32* paPara, unsigned NumParas) {
+  U8* pPayload;
+  U8* pPayloadStart;
+
+  if (NumParas > SEGGER_SYSVIEW_MAX_ARGUMENTS) {
+    NumParas = SEGGER_SYSVIEW_MAX_ARGUMENTS;
+  }
+  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_MAX_ARGUMENTS * SEGGER_SYSVIEW_QUANTA_U32);
+  //
+  pPayload = pPayloadStart;
+  while (NumParas--) {
+    ENCODE_U32(pPayload, *paPara);
+    paPara++;
+  }
+  _SendPacket(pPayloadStart, pPayload, EventID);
+  RECORD_END();
+}
 /*********************************************************************
 *
 *       SEGGER_SYSVIEW_RecordString()
@@ -1818,11 +3394,32 @@ void SEGGER_SYSVIEW_Start(void) {
   if (_SYSVIEW_Globals.EnableState == 0) {
 #endif
     _SYSVIEW_Globals.EnableState = 1;
-#if (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
+#if (SEGGER_SYSVIEW_USE_CHECKPOINTS == 1)
+    SEGGER_SYSVIEW_LOCK();
+    MARK_DESC_CHANGED();
+    _SendCheckpoint();
+    SEGGER_SYSVIEW_UNLOCK();
+#elif (SEGGER_SYSVIEW_POST_MORTEM_MODE == 1)
     _SendSyncInfo();
 #else
     SEGGER_SYSVIEW_LOCK();
-    SEGGER_RTT_WriteSkipNoLock(CHANNEL_ID_UP, _abSync, 10);
+    if (_WriteUpNoLock(CHANNEL_ID_UP, _abSync, 10)) {
+      SET_PREV_DELTA(GET_FIRST_SHARD(), 0);    // Sync resets delta-of-delta chain
+    }
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+    {
+      unsigned n;
+      //
+      // Sync all shards now, so they share a common time base
+      // even if some of them record their first event much later.
+      //
+      for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+        _aShard[n].EnableState = 1;
+        _aShard[n].SyncPending = 1;
+        _TrySendShardSync(&_aShard[n]);
+      }
+    }
+#endif
     SEGGER_SYSVIEW_UNLOCK();
     SEGGER_SYSVIEW_ON_EVENT_RECORDED(10);
     SEGGER_SYSVIEW_RecordVoid(SYSVIEW_EVTID_TRACE_START);
@@ -1845,6 +3442,7 @@ void SEGGER_SYSVIEW_Start(void) {
     SEGGER_SYSVIEW_RecordSystime();
     SEGGER_SYSVIEW_SendTaskList();
     SEGGER_SYSVIEW_SendNumModules();
+    SEND_SAMPLING_WEIGHTS();
 #endif
 #if (SEGGER_SYSVIEW_CAN_RESTART == 0)
   }
@@ -1875,6 +3473,15 @@ void SEGGER_SYSVIEW_Stop(void) {
   if (_SYSVIEW_Globals.EnableState) {
     _SendPacket(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_TRACE_STOP);
     _SYSVIEW_Globals.EnableState = 0;
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+    {
+      unsigned n;
+
+      for (n = 0; n < SEGGER_SYSVIEW_NUM_SHARDS; n++) {
+        _aShard[n].EnableState = 0;
+      }
+    }
+#endif
   }
   RECORD_END();
 }
@@ -1890,6 +3497,73 @@ int SEGGER_SYSVIEW_GetChannelID(void) {
   return CHANNEL_ID_UP;
 }
 
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_GetShardChannelID()
+*
+*  Function description
+*    Returns the RTT <Up> channel ID used by a SystemView shard.
+*
+*  Parameters
+*    Shard - Index of the shard, 0 .. SEGGER_SYSVIEW_NUM_SHARDS - 1.
+*
+*  Return value
+*    >= 0: Channel ID.
+*     < 0: Invalid shard.
+*
+*  Additional information
+*    Shard 0 is the SystemView channel, which is always used.
+*/
+int SEGGER_SYSVIEW_GetShardChannelID(unsigned Shard) {
+  if (Shard >= SEGGER_SYSVIEW_NUM_SHARDS) {
+    return -1;
+  }
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+  return _aShard[Shard].UpChannel;
+#else
+  return CHANNEL_ID_UP;
+#endif
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_GetDropCounts()
+*
+*  Function description
+*    Returns the number of packets dropped per event class since
+*    SEGGER_SYSVIEW_Init(), summed over all shards.
+*
+*  Parameters
+*    paDropCount - Receives SEGGER_SYSVIEW_NUM_DROP_CLASSES counts,
+*                  indexed by SEGGER_SYSVIEW_DROP_CLASS_*.
+*
+*  Additional information
+*    All counts are 0 unless SEGGER_SYSVIEW_USE_DROP_STATS is 1.
+*/
+void SEGGER_SYSVIEW_GetDropCounts(U32* paDropCount) {
+  unsigned n;
+#if (SEGGER_SYSVIEW_USE_DROP_STATS == 1)
+  SEGGER_SYSVIEW_LOCK();
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_DROP_CLASSES; n++) {
+#if (SEGGER_SYSVIEW_NUM_SHARDS > 1)
+    unsigned Shard;
+
+    paDropCount[n] = 0;
+    for (Shard = 0; Shard < SEGGER_SYSVIEW_NUM_SHARDS; Shard++) {
+      paDropCount[n] += _aShard[Shard].aDropCount[n];
+    }
+#else
+    paDropCount[n] = _SYSVIEW_Globals.aDropCount[n];
+#endif
+  }
+  SEGGER_SYSVIEW_UNLOCK();
+#else
+  for (n = 0; n < SEGGER_SYSVIEW_NUM_DROP_CLASSES; n++) {
+    paDropCount[n] = 0;
+  }
+#endif
+}
+
 /*********************************************************************
 *
 *       SEGGER_SYSVIEW_GetSysDesc()
@@ -1929,20 +3603,22 @@ void SEGGER_SYSVIEW_GetSysDesc(void) {
 void SEGGER_SYSVIEW_SendTaskInfo(const SEGGER_SYSVIEW_TASKINFO *pInfo) {
   U8* pPayload;
   U8* pPayloadStart;
+  ADD_TASK_ID(pInfo->TaskID);
   RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32 + 1 + 32);
   //
   pPayload = pPayloadStart;
-  ENCODE_U32(pPayload, SHRINK_ID(pInfo->TaskID));
+  ENCODE_U32(pPayload, SHRINK_TASK_ID(pInfo->TaskID));
   ENCODE_U32(pPayload, pInfo->Prio);
   pPayload = _EncodeStr(pPayload, pInfo->sName, 32);
   _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_INFO);
   //
   pPayload = pPayloadStart;
-  ENCODE_U32(pPayload, SHRINK_ID(pInfo->TaskID));
+  ENCODE_U32(pPayload, SHRINK_TASK_ID(pInfo->TaskID));
   ENCODE_U32(pPayload, pInfo->StackBase);
   ENCODE_U32(pPayload, pInfo->StackSize);
   ENCODE_U32(pPayload, 0); // Stack End, future use
   _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_STACK_INFO);
+  MARK_DESC_CHANGED();
   RECORD_END();
 }
 
@@ -2010,9 +3686,117 @@ void SEGGER_SYSVIEW_RecordSystime(void) {
                                (U32)(Systime),
                                (U32)(Systime >> 32));
   } else {
-    SEGGER_SYSVIEW_RecordU32(SYSVIEW_EVTID_SYSTIME_CYCLES, SEGGER_SYSVIEW_GET_TIMESTAMP());
+    SEGGER_SYSVIEW_RecordU32(SYSVIEW_EVTID_SYSTIME_CYCLES, SEGGER_SYSVIEW_GET_TIMESTAMP() >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT);
+  }
+}
+
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_GetTime64()
+*
+*  Function description
+*    Returns the system timestamp extended to 64 bits.
+*
+*  Return value
+*    Timestamp ticks since the timestamp was 0 before SEGGER_SYSVIEW_Init().
+*
+*  Additional information
+*    Lock-free, may be called from any context. The count of half wrap
+*    periods is read before the timestamp, so a wrap counted in between
+*    by an interrupt is corrected by the MSB of the timestamp read.
+*    Valid as long as SEGGER_SYSVIEW_UpdateTime64() is called at least
+*    once per half wrap period.
+*/
+U64 SEGGER_SYSVIEW_GetTime64(void) {
+  U32 HalfWraps;
+  U32 TimeStamp;
+
+  HalfWraps = _SYSVIEW_Globals.TimeHalfWraps;
+  TimeStamp = SEGGER_SYSVIEW_GET_TIMESTAMP();
+  if (((HalfWraps ^ (TimeStamp >> 31)) & 1u) != 0u) {
+    HalfWraps++;
+  }
+  return ((U64)(HalfWraps >> 1) << 32) | TimeStamp;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_GetTimeUs()
+*
+*  Function description
+*    Returns the extended system timestamp in micro seconds.
+*
+*  Return value
+*    Micro seconds since the timestamp was 0 before SEGGER_SYSVIEW_Init().
+*
+*  Additional information
+*    Lock-free, may be called from any context. Can be returned by
+*    SEGGER_SYSVIEW_OS_API.pfGetTime, which gives SYSTIME_US events
+*    the resolution of the timestamp.
+*/
+U64 SEGGER_SYSVIEW_GetTimeUs(void) {
+  U64 Time;
+  U32 Freq;
+
+  Time = SEGGER_SYSVIEW_GetTime64();
+  Freq = _SYSVIEW_Globals.SysFreq << SEGGER_SYSVIEW_TIMESTAMP_SHIFT;   // Frequency of the timestamp
+  if (Freq == 0u) {
+    return 0;
+  }
+  return (Time / Freq) * 1000000u + ((Time % Freq) * 1000000u) / Freq;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_UpdateTime64()
+*
+*  Function description
+*    Counts the wraps of the system timestamp and records a
+*    SYSTIME_CYCLES event when nothing has been recorded for
+*    SEGGER_SYSVIEW_SYSTIME_PERIOD.
+*
+*  Additional information
+*    Has to be called at least once per half wrap period of the
+*    timestamp, e.g. from the system tick, also when not recording.
+*    The SYSTIME_CYCLES event keeps the timestamp delta of the next
+*    event from wrapping in long idle phases.
+*/
+void SEGGER_SYSVIEW_UpdateTime64(void) {
+  U32 TimeStamp;
+  U32 Idle;
+
+  SEGGER_SYSVIEW_LOCK();
+  TimeStamp = SEGGER_SYSVIEW_GET_TIMESTAMP();
+  _UpdateTime64(TimeStamp);
+  Idle      = TimeStamp - GET_SHARD()->LastTxTimeStamp;
+  SEGGER_SYSVIEW_UNLOCK();
+  if (Idle >= SEGGER_SYSVIEW_SYSTIME_PERIOD && GET_SHARD()->EnableState != ENABLE_STATE_OFF) {
+    SEGGER_SYSVIEW_RecordU32(SYSVIEW_EVTID_SYSTIME_CYCLES, TimeStamp >> SEGGER_SYSVIEW_TIMESTAMP_SHIFT);
   }
 }
+#endif
+
+#if (SEGGER_SYSVIEW_NUM_LOAD_TASKS > 0)
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_RecordLoad()
+*
+*  Function description
+*    Sends the CPU load of the tasks since the previous report and
+*    starts the next period.
+*
+*  Additional information
+*    Sent as SYSVIEW_EVTID_EX packet with sub-ID SYSVIEW_EVTID_EX_LOAD,
+*    see _SendLoad(). With SEGGER_SYSVIEW_LOAD_PERIOD, reports are
+*    also sent periodically.
+*/
+void SEGGER_SYSVIEW_RecordLoad(void) {
+  SEGGER_SYSVIEW_LOCK();
+  _AccountLoad(LOAD_EVENT_REPORT, 0, SEGGER_SYSVIEW_GET_TIMESTAMP());
+  SEGGER_SYSVIEW_UNLOCK();
+}
+#endif
 
 /*********************************************************************
 *
@@ -2029,12 +3813,12 @@ void SEGGER_SYSVIEW_RecordEnterISR(void) {
   unsigned v;
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_ISR_ENTER, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   v = SEGGER_SYSVIEW_GET_INTERRUPT_ID();
   ENCODE_U32(pPayload, v);
-  _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_ISR_ENTER);
+  SEND_LOAD_PACKET(pPayloadStart, pPayload, SYSVIEW_EVTID_ISR_ENTER, LOAD_EVENT_ENTER_ISR, 0);
   RECORD_END();
 }
 
@@ -2054,9 +3838,9 @@ void SEGGER_SYSVIEW_RecordEnterISR(void) {
 */
 void SEGGER_SYSVIEW_RecordExitISR(void) {
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE);
+  RECORD_START_EVENT(SYSVIEW_EVTID_ISR_EXIT, SEGGER_SYSVIEW_INFO_SIZE);
   //
-  _SendPacket(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_ISR_EXIT);
+  SEND_LOAD_PACKET(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_ISR_EXIT, LOAD_EVENT_EXIT_ISR, 0);
   RECORD_END();
 }
 
@@ -2076,9 +3860,9 @@ void SEGGER_SYSVIEW_RecordExitISR(void) {
 */
 void SEGGER_SYSVIEW_RecordExitISRToScheduler(void) {
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE);
+  RECORD_START_EVENT(SYSVIEW_EVTID_ISR_TO_SCHEDULER, SEGGER_SYSVIEW_INFO_SIZE);
   //
-  _SendPacket(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_ISR_TO_SCHEDULER);
+  SEND_LOAD_PACKET(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_ISR_TO_SCHEDULER, LOAD_EVENT_EXIT_ISR, 0);
   RECORD_END();
 }
 
@@ -2095,7 +3879,7 @@ void SEGGER_SYSVIEW_RecordExitISRToScheduler(void) {
 void SEGGER_SYSVIEW_RecordEnterTimer(U32 TimerId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_TIMER_ENTER, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, SHRINK_ID(TimerId));
@@ -2112,7 +3896,7 @@ void SEGGER_SYSVIEW_RecordEnterTimer(U32 TimerId) {
 */
 void SEGGER_SYSVIEW_RecordExitTimer(void) {
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE);
+  RECORD_START_EVENT(SYSVIEW_EVTID_TIMER_EXIT, SEGGER_SYSVIEW_INFO_SIZE);
   //
   _SendPacket(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_TIMER_EXIT);
   RECORD_END();
@@ -2131,7 +3915,7 @@ void SEGGER_SYSVIEW_RecordExitTimer(void) {
 void SEGGER_SYSVIEW_RecordEndCall(unsigned int EventID) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_END_CALL, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, EventID);
@@ -2153,7 +3937,7 @@ void SEGGER_SYSVIEW_RecordEndCall(unsigned int EventID) {
 void SEGGER_SYSVIEW_RecordEndCallU32(unsigned int EventID, U32 Para0) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_END_CALL, SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, EventID);
@@ -2171,9 +3955,10 @@ void SEGGER_SYSVIEW_RecordEndCallU32(unsigned int EventID, U32 Para0) {
 */
 void SEGGER_SYSVIEW_OnIdle(void) {
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE);
+  CLEAR_TASK_FILTERED(GET_SHARD());
+  RECORD_START_EVENT(SYSVIEW_EVTID_IDLE, SEGGER_SYSVIEW_INFO_SIZE);
   //
-  _SendPacket(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_IDLE);
+  SEND_LOAD_PACKET(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_IDLE, LOAD_EVENT_IDLE, 0);
   RECORD_END();
 }
 
@@ -2191,10 +3976,11 @@ void SEGGER_SYSVIEW_OnIdle(void) {
 void SEGGER_SYSVIEW_OnTaskCreate(U32 TaskId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  ADD_TASK_ID(TaskId);
+  RECORD_START_EVENT(SYSVIEW_EVTID_TASK_CREATE, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
-  TaskId = SHRINK_ID(TaskId);
+  TaskId = SHRINK_TASK_ID(TaskId);
   ENCODE_U32(pPayload, TaskId);
   _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_CREATE);
   RECORD_END();
@@ -2209,6 +3995,8 @@ void SEGGER_SYSVIEW_OnTaskCreate(U32 TaskId) {
 *    The Task termination event corresponds to terminating a task in
 *    the OS. If the TaskId is the currently active task,
 *    SEGGER_SYSVIEW_OnTaskStopExec may be used, either.
+*    With SEGGER_SYSVIEW_NUM_TASK_IDS, the ID sent for the task is
+*    free for the next created task afterwards.
 *
 *  Parameters
 *    TaskId        - Task ID of terminated task.
@@ -2216,13 +4004,14 @@ void SEGGER_SYSVIEW_OnTaskCreate(U32 TaskId) {
 void SEGGER_SYSVIEW_OnTaskTerminate(U32 TaskId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_TASK_TERMINATE, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
-  TaskId = SHRINK_ID(TaskId);
-  ENCODE_U32(pPayload, TaskId);
+  ENCODE_U32(pPayload, SHRINK_TASK_ID(TaskId));
   _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_TERMINATE);
+  MARK_DESC_CHANGED();
   RECORD_END();
+  REMOVE_TASK_ID(TaskId);
 }
 
 /*********************************************************************
@@ -2240,12 +4029,14 @@ void SEGGER_SYSVIEW_OnTaskTerminate(U32 TaskId) {
 void SEGGER_SYSVIEW_OnTaskStartExec(U32 TaskId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  U32 Id;
+  RECORD_START_EVENT(SYSVIEW_EVTID_TASK_START_EXEC, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
-  TaskId = SHRINK_ID(TaskId);
-  ENCODE_U32(pPayload, TaskId);
-  _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_START_EXEC);
+  Id = SHRINK_TASK_ID(TaskId);
+  SET_TASK_FILTERED(GET_SHARD(), Id);
+  ENCODE_U32(pPayload, Id);
+  SEND_LOAD_PACKET(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_START_EXEC, LOAD_EVENT_TASK, TaskId);
   RECORD_END();
 }
 
@@ -2259,9 +4050,10 @@ void SEGGER_SYSVIEW_OnTaskStartExec(U32 TaskId) {
 */
 void SEGGER_SYSVIEW_OnTaskStopExec(void) {
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE);
+  CLEAR_TASK_FILTERED(GET_SHARD());
+  RECORD_START_EVENT(SYSVIEW_EVTID_TASK_STOP_EXEC, SEGGER_SYSVIEW_INFO_SIZE);
   //
-  _SendPacket(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_TASK_STOP_EXEC);
+  SEND_LOAD_PACKET(pPayloadStart, pPayloadStart, SYSVIEW_EVTID_TASK_STOP_EXEC, LOAD_EVENT_STOP, 0);
   RECORD_END();
 }
 
@@ -2278,10 +4070,10 @@ void SEGGER_SYSVIEW_OnTaskStopExec(void) {
 void SEGGER_SYSVIEW_OnTaskStartReady(U32 TaskId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_TASK_START_READY, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
-  TaskId = SHRINK_ID(TaskId);
+  TaskId = SHRINK_TASK_ID(TaskId);
   ENCODE_U32(pPayload, TaskId);
   _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_START_READY);
   RECORD_END();
@@ -2301,10 +4093,10 @@ void SEGGER_SYSVIEW_OnTaskStartReady(U32 TaskId) {
 void SEGGER_SYSVIEW_OnTaskStopReady(U32 TaskId, unsigned int Cause) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_TASK_STOP_READY, SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
-  TaskId = SHRINK_ID(TaskId);
+  TaskId = SHRINK_TASK_ID(TaskId);
   ENCODE_U32(pPayload, TaskId);
   ENCODE_U32(pPayload, Cause);
   _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_TASK_STOP_READY);
@@ -2324,7 +4116,7 @@ void SEGGER_SYSVIEW_OnTaskStopReady(U32 TaskId, unsigned int Cause) {
 void SEGGER_SYSVIEW_MarkStart(unsigned MarkerId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_MARK_START, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, MarkerId);
@@ -2345,7 +4137,7 @@ void SEGGER_SYSVIEW_MarkStart(unsigned MarkerId) {
 void SEGGER_SYSVIEW_MarkStop(unsigned MarkerId) {
   U8 * pPayload;
   U8 * pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_MARK_STOP, SEGGER_SYSVIEW_INFO_SIZE + SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, MarkerId);
@@ -2366,7 +4158,7 @@ void SEGGER_SYSVIEW_MarkStop(unsigned MarkerId) {
 void SEGGER_SYSVIEW_Mark(unsigned int MarkerId) {
   U8* pPayload;
   U8* pPayloadStart;
-  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
+  RECORD_START_EVENT(SYSVIEW_EVTID_EX, SEGGER_SYSVIEW_INFO_SIZE + 2 * SEGGER_SYSVIEW_QUANTA_U32);
   //
   pPayload = pPayloadStart;
   ENCODE_U32(pPayload, SYSVIEW_EVTID_EX_MARK);
@@ -2583,8 +4375,52 @@ U8* SEGGER_SYSVIEW_EncodeId(U8* pPayload, U32 Id) {
 *     SEGGER_SYSVIEW_ID_SHIFT: Number of bits to shift the Id to
 *       save bandwidth. (i.e. 2 when Ids are 4 byte aligned)
 */
-U32 SEGGER_SYSVIEW_ShrinkId(U32 Id) {
-  return SHRINK_ID(Id);
+U32 SEGGER_SYSVIEW_ShrinkId(U32 Id) {
+  return SHRINK_ID(Id);
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_ShrinkTaskId()
+*
+*  Function description
+*    Get the value of a task ID as it is sent to the host, e.g. for
+*    a task handle which is a parameter of an OS API event.
+*
+*  Parameters
+*    TaskId   - ID of the task, as passed to
+*               SEGGER_SYSVIEW_OnTaskStartExec().
+*
+*  Return value
+*    Task ID as sent to the host.
+*
+*  Additional information
+*    Without SEGGER_SYSVIEW_NUM_TASK_IDS this is the same as
+*    SEGGER_SYSVIEW_ShrinkId().
+*/
+U32 SEGGER_SYSVIEW_ShrinkTaskId(U32 TaskId) {
+  return SHRINK_TASK_ID(TaskId);
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_FloatToU32()
+*
+*  Function description
+*    Get the bits of a float as an event parameter, see
+*    SEGGER_SYSVIEW_FLOAT_ARG().
+*
+*  Parameters
+*    f        - Value to be recorded.
+*
+*  Return value
+*    IEEE 754 single precision bits of f.
+*/
+U32 SEGGER_SYSVIEW_FloatToU32(float f) {
+  U32 v;
+
+  memcpy(&v, &f, sizeof(v));
+  return v;
 }
 
 /*********************************************************************
@@ -2628,6 +4464,7 @@ void SEGGER_SYSVIEW_RegisterModule(SEGGER_SYSVIEW_MODULE* pModule) {
     _pFirstModule = pModule;
     _NumModules++;
   }
+  MARK_DESC_CHANGED();
   SEGGER_SYSVIEW_SendModule(0);
   if (pModule->pfSendModuleDesc) {
     pModule->pfSendModuleDesc();
@@ -2899,6 +4736,51 @@ void SEGGER_SYSVIEW_ErrorfHost(const char* s, ...) {
 #endif
 }
 
+#if (SEGGER_SYSVIEW_USE_DEFERRED_PRINTF == 1)
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_PrintfDeferred()
+*
+*  Function description
+*    Send the address of a format string and its arguments, already
+*    converted to 32-bit values, to the host.
+*
+*  Parameters
+*    s        - Format string. Has to be a constant of the application.
+*    Options  - Options for the string. i.e. Log level.
+*    paArg    - Arguments of the format string.
+*    NumArgs  - Number of arguments, at most SEGGER_SYSVIEW_MAX_ARGUMENTS.
+*
+*  Additional information
+*    Sent as SYSVIEW_EVTID_EX packet with sub-ID SYSVIEW_EVTID_EX_PRINT_DEFERRED:
+*      <FormatAddr> <Options> <NumArguments> <Argument>...
+*    The host reads the format string from the application's ELF file.
+*    Called by SEGGER_SYSVIEW_PrintfHost() and its variants, and by
+*    SEGGER_SYSVIEW_PRINTF_HOST() and its variants, which check the
+*    format string and count the arguments at compile time.
+*/
+void SEGGER_SYSVIEW_PrintfDeferred(const char* s, U32 Options, const U32* paArg, unsigned NumArgs) {
+  U8* pPayload;
+  U8* pPayloadStart;
+
+  if (NumArgs > SEGGER_SYSVIEW_MAX_ARGUMENTS) {
+    NumArgs = SEGGER_SYSVIEW_MAX_ARGUMENTS;
+  }
+  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + 4 * SEGGER_SYSVIEW_QUANTA_U32 + SEGGER_SYSVIEW_MAX_ARGUMENTS * SEGGER_SYSVIEW_QUANTA_U32);
+  pPayload = pPayloadStart;
+  ENCODE_U32(pPayload, SYSVIEW_EVTID_EX_PRINT_DEFERRED);
+  ENCODE_U32(pPayload, (U32)SEGGER_PTR2ADDR(s));
+  ENCODE_U32(pPayload, Options);
+  ENCODE_U32(pPayload, NumArgs);
+  while (NumArgs--) {
+    ENCODE_U32(pPayload, *paArg);
+    paArg++;
+  }
+  _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_EX);
+  RECORD_END();
+}
+#endif
+
 /*********************************************************************
 *
 *       SEGGER_SYSVIEW_PrintfTargetEx()
@@ -3054,7 +4936,11 @@ void SEGGER_SYSVIEW_Error(const char* s) {
 *    EnableMask   - Events to be enabled.
 */
 void SEGGER_SYSVIEW_EnableEvents(U32 EnableMask) {
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  SEGGER_SYSVIEW_aDisabledEvents[0] &= ~EnableMask;
+#else
   _SYSVIEW_Globals.DisabledEvents &= ~EnableMask;
+#endif
 }
 
 /*********************************************************************
@@ -3068,7 +4954,460 @@ void SEGGER_SYSVIEW_EnableEvents(U32 EnableMask) {
 *    DisableMask  - Events to be disabled.
 */
 void SEGGER_SYSVIEW_DisableEvents(U32 DisableMask) {
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  SEGGER_SYSVIEW_aDisabledEvents[0] |= DisableMask;
+#else
   _SYSVIEW_Globals.DisabledEvents |= DisableMask;
+#endif
+}
+
+/*********************************************************************
+*
+*       _ChangeEventRange()
+*
+*  Function description
+*    Enables or disables a range of events.
+*
+*  Parameters
+*    FirstId  - ID of the first event.
+*    NumIds   - Number of events.
+*    Disable  - 1: Disable the events, 0: Enable the events.
+*
+*  Additional information
+*    Events which are not covered by the event filter are ignored.
+*/
+static void _ChangeEventRange(U32 FirstId, U32 NumIds, int Disable) {
+  U32* pWord;
+  U32  Id;
+  U32  EndId;
+  U32  Mask;
+
+#if (SEGGER_SYSVIEW_USE_EVENT_FILTER == 1)
+  pWord = &SEGGER_SYSVIEW_aDisabledEvents[0];
+  EndId = SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS;
+#else
+  pWord = &_SYSVIEW_Globals.DisabledEvents;
+  EndId = 32u;
+#endif
+  if (NumIds < EndId - SEGGER_MIN(FirstId, EndId)) {
+    EndId = FirstId + NumIds;
+  }
+  SEGGER_SYSVIEW_LOCK();
+  for (Id = FirstId; Id < EndId; Id = (Id | 31u) + 1u) {
+    Mask = 0xFFFFFFFFu << (Id & 31u);
+    if (EndId - (Id & ~31u) < 32u) {
+      Mask &= ((U32)1u << (EndId & 31u)) - 1u;
+    }
+    if (Disable) {
+      pWord[Id >> 5] |= Mask;
+    } else {
+      pWord[Id >> 5] &= ~Mask;
+    }
+  }
+  SEGGER_SYSVIEW_UNLOCK();
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_EnableEventRange()
+*
+*  Function description
+*    Enable the events with IDs FirstId to FirstId + NumIds - 1.
+*
+*  Parameters
+*    FirstId  - ID of the first event, e.g. apiID_OFFSET + apiID_* or
+*               the EventOffset of a module.
+*    NumIds   - Number of events.
+*/
+void SEGGER_SYSVIEW_EnableEventRange(U32 FirstId, U32 NumIds) {
+  _ChangeEventRange(FirstId, NumIds, 0);
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_DisableEventRange()
+*
+*  Function description
+*    Disable the events with IDs FirstId to FirstId + NumIds - 1.
+*
+*  Parameters
+*    FirstId  - ID of the first event.
+*    NumIds   - Number of events.
+*
+*  Additional information
+*    Without SEGGER_SYSVIEW_USE_EVENT_FILTER, only events with IDs
+*    below 32 can be disabled. With it, the events with IDs below
+*    SEGGER_SYSVIEW_EVENT_FILTER_NUM_IDS.
+*/
+void SEGGER_SYSVIEW_DisableEventRange(U32 FirstId, U32 NumIds) {
+  _ChangeEventRange(FirstId, NumIds, 1);
+}
+
+/*********************************************************************
+*
+*       _SetTaskFilter()
+*
+*  Function description
+*    Selects a task in the task filter.
+*
+*  Parameters
+*    Index  - Index in the task filter.
+*    TaskId - Shrunk ID of the task, as sent to the host.
+*             0 to clear the entry.
+*
+*  Return value
+*     0: O.K.
+*    -1: Index out of range or no task filter.
+*/
+static int _SetTaskFilter(unsigned Index, U32 TaskId) {
+#if (SEGGER_SYSVIEW_NUM_TASK_FILTERS > 0)
+  if (Index < SEGGER_SYSVIEW_NUM_TASK_FILTERS) {
+    _SYSVIEW_Globals.aTaskFilter[Index] = TaskId;
+    return 0;
+  }
+#else
+  (void)Index;
+  (void)TaskId;
+#endif
+  return -1;
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_SetTaskFilter()
+*
+*  Function description
+*    Selects a task of which API, user and module events are recorded.
+*
+*  Parameters
+*    Index  - Index in the task filter,
+*             0 to SEGGER_SYSVIEW_NUM_TASK_FILTERS - 1.
+*    TaskId - ID of the task, as passed to
+*             SEGGER_SYSVIEW_OnTaskStartExec(). 0 to clear the entry.
+*
+*  Return value
+*     0: O.K.
+*    -1: Index out of range or no task filter.
+*
+*  Additional information
+*    When no entry is set, the events of all tasks are recorded.
+*    A change applies from the next task switch on.
+*/
+int SEGGER_SYSVIEW_SetTaskFilter(unsigned Index, U32 TaskId) {
+  int r;
+
+  SEGGER_SYSVIEW_LOCK();
+  r = _SetTaskFilter(Index, (TaskId != 0u) ? SHRINK_TASK_ID(TaskId) : 0u);
+  SEGGER_SYSVIEW_UNLOCK();
+  return r;
+}
+
+/*********************************************************************
+*
+*       _SendSamplingWeight()
+*
+*  Function description
+*    Tells the host the sampling ratio of event IDs.
+*
+*  Parameters
+*    Ratio       - One of Ratio events of the IDs is recorded from now on.
+*    paEventId   - IDs of the events.
+*    NumEventIds - Number of IDs, at most SEGGER_SYSVIEW_MAX_ARGUMENTS.
+*
+*  Additional information
+*    Sent as SYSVIEW_EVTID_EX packet with sub-ID SYSVIEW_EVTID_EX_SAMPLING:
+*      <Ratio> <NumIds> <EventId>[NumIds]
+*    Each recorded event of the IDs stands for Ratio events.
+*/
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0) || (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+static void _SendSamplingWeight(U32 Ratio, const U32* paEventId, unsigned NumEventIds) {
+  U8* pPayload;
+  U8* pPayloadStart;
+
+  if (NumEventIds > SEGGER_SYSVIEW_MAX_ARGUMENTS) {
+    NumEventIds = SEGGER_SYSVIEW_MAX_ARGUMENTS;
+  }
+  RECORD_START(SEGGER_SYSVIEW_INFO_SIZE + (3 + SEGGER_SYSVIEW_MAX_ARGUMENTS) * SEGGER_SYSVIEW_QUANTA_U32);
+  //
+  pPayload = pPayloadStart;
+  ENCODE_U32(pPayload, SYSVIEW_EVTID_EX_SAMPLING);
+  ENCODE_U32(pPayload, (Ratio > 1u) ? Ratio : 1u);
+  ENCODE_U32(pPayload, NumEventIds);
+  while (NumEventIds--) {
+    ENCODE_U32(pPayload, *paEventId);
+    paEventId++;
+  }
+  _SendPacket(pPayloadStart, pPayload, SYSVIEW_EVTID_EX);
+  RECORD_END();
+}
+
+/*********************************************************************
+*
+*       _SendSamplingWeights()
+*
+*  Function description
+*    Tells the host the ratio of all sampled events and event classes,
+*    after the start of the recording.
+*/
+static void _SendSamplingWeights(void) {
+  unsigned i;
+
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0)
+  for (i = 0; i < _SYSVIEW_Globals.NumSampledEvents; i++) {
+    _SendSamplingWeight(_SYSVIEW_Globals.aSampling[i].Ratio, &_SYSVIEW_Globals.aSampling[i].EventId, 1);
+  }
+#endif
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+  for (i = 0; i < SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES; i++) {
+    if (SEGGER_SYSVIEW_aSampleClass[i].Ratio > 1u) {
+      _SendSamplingWeight(SEGGER_SYSVIEW_aSampleClass[i].Ratio, _SYSVIEW_Globals.apSampleClassId[i], _SYSVIEW_Globals.aNumSampleClassIds[i]);
+    }
+  }
+#endif
+  (void)i;
+}
+#endif
+
+/*********************************************************************
+*
+*       _SetSampling()
+*
+*  Function description
+*    Sets the sampling ratio of an event ID.
+*
+*  Parameters
+*    EventId - ID of the event.
+*    Ratio   - One of Ratio events is recorded. 0 or 1 to record all.
+*
+*  Return value
+*     0: O.K.
+*    -1: No free entry or no sampling.
+*/
+static int _SetSampling(U32 EventId, unsigned Ratio) {
+#if (SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS > 0)
+  SEGGER_SYSVIEW_SAMPLING* pSampling;
+  unsigned                 i;
+
+  if (Ratio > 0xFFFFu) {
+    Ratio = 0xFFFFu;
+  }
+  for (i = 0; i < _SYSVIEW_Globals.NumSampledEvents; i++) {
+    if (_SYSVIEW_Globals.aSampling[i].EventId == EventId) {
+      break;
+    }
+  }
+  if (Ratio <= 1u) {
+    //
+    // Remove the entry, if any, by moving the last one into its place.
+    //
+    if (i < _SYSVIEW_Globals.NumSampledEvents) {
+      _SYSVIEW_Globals.aSampling[i] = _SYSVIEW_Globals.aSampling[--_SYSVIEW_Globals.NumSampledEvents];
+      _SendSamplingWeight(1u, &EventId, 1);
+    }
+    return 0;
+  }
+  if (i == _SYSVIEW_Globals.NumSampledEvents) {
+    if (i == SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS) {
+      return -1;
+    }
+    _SYSVIEW_Globals.NumSampledEvents++;
+  }
+  pSampling          = &_SYSVIEW_Globals.aSampling[i];
+  pSampling->EventId = EventId;
+  pSampling->Ratio   = (U16)Ratio;
+  pSampling->Cnt     = (U16)(Ratio - 1u);   // Record the next event
+  _SendSamplingWeight(Ratio, &EventId, 1);
+  return 0;
+#else
+  (void)EventId;
+  return (Ratio <= 1u) ? 0 : -1;
+#endif
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_SetSampling()
+*
+*  Function description
+*    Records only one of every Ratio events of an ID, for events
+*    which are too frequent to be recorded completely.
+*
+*  Parameters
+*    EventId - ID of the event.
+*    Ratio   - One of Ratio events is recorded, starting with the
+*              next one. 0 or 1 to record all events of the ID.
+*
+*  Return value
+*     0: O.K.
+*    -1: SEGGER_SYSVIEW_NUM_SAMPLED_EVENTS IDs are sampled already.
+*
+*  Additional information
+*    The ratio is sent to the host in a SYSVIEW_EVTID_EX_SAMPLING
+*    packet, so it can scale the number of recorded events.
+*    Events are counted after they are encoded. To save the time to
+*    record the skipped events, use SEGGER_SYSVIEW_RECORD_SAMPLED().
+*/
+int SEGGER_SYSVIEW_SetSampling(U32 EventId, unsigned Ratio) {
+  int r;
+
+  SEGGER_SYSVIEW_LOCK();
+  r = _SetSampling(EventId, Ratio);
+  SEGGER_SYSVIEW_UNLOCK();
+  return r;
+}
+
+/*********************************************************************
+*
+*       _SetClassSampling()
+*
+*  Function description
+*    Sets the sampling ratio of an event class.
+*
+*  Parameters
+*    Class - Index of the class.
+*    Ratio - One of Ratio events is recorded. 0 or 1 to record all.
+*
+*  Return value
+*     0: O.K.
+*    -1: Class out of range.
+*/
+static int _SetClassSampling(unsigned Class, unsigned Ratio) {
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+  SEGGER_SYSVIEW_SAMPLE_CLASS* pClass;
+
+  if (Class >= SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES) {
+    return -1;
+  }
+  if (Ratio > 0xFFFFu) {
+    Ratio = 0xFFFFu;
+  }
+  if (Ratio == 0u) {
+    Ratio = 1u;
+  }
+  pClass        = &SEGGER_SYSVIEW_aSampleClass[Class];
+  pClass->Ratio = (U16)Ratio;
+  pClass->Cnt   = (U16)(Ratio - 1u);     // Record the next event
+  _SendSamplingWeight(Ratio, _SYSVIEW_Globals.apSampleClassId[Class], _SYSVIEW_Globals.aNumSampleClassIds[Class]);
+  return 0;
+#else
+  (void)Class;
+  return (Ratio <= 1u) ? 0 : -1;
+#endif
+}
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_SetClassSampling()
+*
+*  Function description
+*    Records only one of every Ratio events of a class which are
+*    recorded with SEGGER_SYSVIEW_RECORD_SAMPLED().
+*
+*  Parameters
+*    Class       - Index of the class,
+*                  0 to SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES - 1.
+*    Ratio       - One of Ratio events is recorded, starting with the
+*                  next one. 0 or 1 to record all events of the class.
+*    paEventId   - IDs of the events of the class, which are sent to
+*                  the host with the ratio. Must stay valid.
+*                  NULL to keep the IDs set before.
+*    NumEventIds - Number of IDs, at most SEGGER_SYSVIEW_MAX_ARGUMENTS.
+*
+*  Return value
+*     0: O.K.
+*    -1: Class or NumEventIds out of range.
+*
+*  Additional information
+*    The ratio is sent to the host in a SYSVIEW_EVTID_EX_SAMPLING
+*    packet with the IDs of the class, so it can scale the number of
+*    recorded events of each ID. The host can change the ratio with
+*    SEGGER_SYSVIEW_COMMAND_ID_SET_CLASS_SAMPLING once the IDs are set.
+*/
+int SEGGER_SYSVIEW_SetClassSampling(unsigned Class, unsigned Ratio, const U32* paEventId, unsigned NumEventIds) {
+  int r;
+
+  if (NumEventIds > SEGGER_SYSVIEW_MAX_ARGUMENTS) {
+    return -1;
+  }
+  SEGGER_SYSVIEW_LOCK();
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+  if ((paEventId != NULL) && (Class < SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES)) {
+    _SYSVIEW_Globals.apSampleClassId[Class]    = paEventId;
+    _SYSVIEW_Globals.aNumSampleClassIds[Class] = (U8)NumEventIds;
+  }
+#else
+  (void)paEventId;
+#endif
+  r = _SetClassSampling(Class, Ratio);
+  SEGGER_SYSVIEW_UNLOCK();
+  return r;
+}
+
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES > 0)
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_CountSampled()
+*
+*  Function description
+*    Counts an event of a sampled class and tells whether it is
+*    recorded. Called by SEGGER_SYSVIEW_IS_SAMPLED() for classes
+*    with a ratio greater than 1.
+*
+*  Parameters
+*    Class - Index of the class,
+*            0 to SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES - 1.
+*
+*  Return value
+*    1: Record the event.
+*    0: Skip the event.
+*
+*  Additional information
+*    The counter is updated under SEGGER_SYSVIEW_LOCK(), so events of
+*    a class which are recorded concurrently keep the exact ratio.
+*/
+int SEGGER_SYSVIEW_CountSampled(unsigned Class) {
+  SEGGER_SYSVIEW_SAMPLE_CLASS* pClass;
+  int r;
+
+  r = 0;
+  SEGGER_SYSVIEW_LOCK();
+  pClass = &SEGGER_SYSVIEW_aSampleClass[Class];
+  pClass->Cnt++;
+  if (pClass->Cnt >= pClass->Ratio) {
+    pClass->Cnt = 0u;
+    r = 1;
+  }
+  SEGGER_SYSVIEW_UNLOCK();
+  return r;
+}
+#endif
+
+/*********************************************************************
+*
+*       SEGGER_SYSVIEW_SetBufferMode()
+*
+*  Function description
+*    Sets what happens when the RTT buffer is full.
+*
+*  Parameters
+*    Mode - SEGGER_SYSVIEW_BUFFER_MODE_STREAM: Drop events until the
+*           buffer has drained, then send an overflow packet (default).
+*           SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL: Stop recording,
+*           so the capture holds the events since the start without
+*           gaps.
+*
+*  Additional information
+*    Not available in post mortem mode, where old events are
+*    overwritten.
+*/
+void SEGGER_SYSVIEW_SetBufferMode(unsigned Mode) {
+#if (SEGGER_SYSVIEW_POST_MORTEM_MODE != 1)
+  if (Mode <= SEGGER_SYSVIEW_BUFFER_MODE_STOP_ON_FULL) {
+    _SYSVIEW_Globals.BufferMode = (U8)Mode;
+  }
+#else
+  (void)Mode;
+#endif
 }
 
 /*********************************************************************
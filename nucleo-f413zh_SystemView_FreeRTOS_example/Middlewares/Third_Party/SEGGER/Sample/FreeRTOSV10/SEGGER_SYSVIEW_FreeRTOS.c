@@ -57,7 +57,22 @@ Revision: $Rev: 7947 $
 #include "SEGGER_SYSVIEW_FreeRTOS.h"
 #include "string.h" // Required for memset
 
+#ifndef   configIDLE_TASK_NAME
+  #define configIDLE_TASK_NAME            "IDLE"      // Default of tasks.c
+#endif
+#ifndef   configTIMER_SERVICE_TASK_NAME
+  #define configTIMER_SERVICE_TASK_NAME   "Tmr Svc"   // Default of timers.c
+#endif
+
+#if ((SYSVIEW_FREERTOS_TASK_HASH_SIZE & (SYSVIEW_FREERTOS_TASK_HASH_SIZE - 1)) != 0)
+  #error "SYSVIEW_FREERTOS_TASK_HASH_SIZE must be a power of 2"
+#endif
+#if (SYSVIEW_FREERTOS_TASK_HASH_SIZE <= SYSVIEW_FREERTOS_MAX_NOF_TASKS)
+  #error "SYSVIEW_FREERTOS_TASK_HASH_SIZE must be greater than SYSVIEW_FREERTOS_MAX_NOF_TASKS"
+#endif
 
+#define TASK_HASH(xHandle)      ((((xHandle) >> 3) ^ ((xHandle) >> 11)) & (SYSVIEW_FREERTOS_TASK_HASH_SIZE - 1u))
+#define TASK_HASH_NEXT(Slot)    (((Slot) + 1u) & (SYSVIEW_FREERTOS_TASK_HASH_SIZE - 1u))
 
 typedef struct SYSVIEW_FREERTOS_TASK_STATUS SYSVIEW_FREERTOS_TASK_STATUS;
 
@@ -69,9 +84,25 @@ struct SYSVIEW_FREERTOS_TASK_STATUS {
   unsigned    uStackHighWaterMark;
 };
 
+//
+// The tasks are kept in _aTasks[0] to _aTasks[_NumTasks - 1], in no
+// particular order. _aTaskIndex[] finds a task by its handle: it is
+// a hash table with linear probing which holds the index in _aTasks[]
+// + 1 at the slot of the hash of the handle or, if that is in use, at
+// one of the next slots. 0 is an unused slot.
+//
 static SYSVIEW_FREERTOS_TASK_STATUS _aTasks[SYSVIEW_FREERTOS_MAX_NOF_TASKS];
+static U16      _aTaskIndex[SYSVIEW_FREERTOS_TASK_HASH_SIZE];
 static unsigned _NumTasks;
 
+//
+// Event IDs of the sample classes, sent to the host with the ratio.
+//
+static const U32 _aQueueSendId[]    = { apiID_OFFSET + apiID_XQUEUEGENERICSEND,    apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR };
+static const U32 _aQueueReceiveId[] = { apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, apiID_OFFSET + apiID_XQUEUERECEIVEFROMISR, apiID_OFFSET + apiID_XQUEUEPEEKFROMISR };
+static const U32 _aNotifyId[]       = { apiID_OFFSET + apiID_XTASKGENERICNOTIFY,   apiID_OFFSET + apiID_XTASKGENERICNOTIFYFROMISR, apiID_OFFSET + apiID_VTASKNOTIFYGIVEFROMISR,
+                                        apiID_OFFSET + apiID_XTASKNOTIFYWAIT,      apiID_OFFSET + apiID_ULTASKNOTIFYTAKE };
+
 /*********************************************************************
 *
 *       _cbSendTaskList()
@@ -100,14 +131,88 @@ static void _cbSendTaskList(void) {
 *    This function is part of the link between FreeRTOS and SYSVIEW.
 *    Called from SystemView when asked by the host, returns the
 *    current system time in micro seconds.
+*    With SEGGER_SYSVIEW_USE_TIME64, the time has the resolution of
+*    the timestamp instead of the tick.
 */
 static U64 _cbGetTime(void) {
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+  return SEGGER_SYSVIEW_GetTimeUs();
+#else
   U64 Time;
 
   Time = xTaskGetTickCountFromISR();
   Time *= portTICK_PERIOD_MS;
   Time *= 1000;
   return Time;
+#endif
+}
+
+/*********************************************************************
+*
+*       _FindSlot()
+*
+*  Function description
+*    Returns the slot of the hash index which refers to a task or,
+*    if the task is not in the list, the unused slot where it is added.
+*/
+static unsigned _FindSlot(U32 xHandle) {
+  unsigned Slot;
+
+  Slot = TASK_HASH(xHandle);
+  while (_aTaskIndex[Slot] != 0u) {
+    if (_aTasks[_aTaskIndex[Slot] - 1u].xHandle == xHandle) {
+      break;
+    }
+    Slot = TASK_HASH_NEXT(Slot);
+  }
+  return Slot;
+}
+
+/*********************************************************************
+*
+*       _FreeSlot()
+*
+*  Function description
+*    Frees a slot of the hash index. The following slots up to the next
+*    unused one are moved back, where possible, so every task can still
+*    be found from the slot of its hash without passing an unused slot.
+*/
+static void _FreeSlot(unsigned Slot) {
+  unsigned Next;
+  unsigned Home;
+
+  Next = Slot;
+  for (;;) {
+    _aTaskIndex[Slot] = 0u;
+    do {
+      Next = TASK_HASH_NEXT(Next);
+      if (_aTaskIndex[Next] == 0u) {
+        return;
+      }
+      Home = TASK_HASH(_aTasks[_aTaskIndex[Next] - 1u].xHandle);
+      //
+      // The task at Next may move to Slot unless its hash is after Slot,
+      // i.e. closer to Next.
+      //
+    } while (((Next - Home) & (SYSVIEW_FREERTOS_TASK_HASH_SIZE - 1u)) < ((Next - Slot) & (SYSVIEW_FREERTOS_TASK_HASH_SIZE - 1u)));
+    _aTaskIndex[Slot] = _aTaskIndex[Next];
+    Slot = Next;
+  }
+}
+
+/*********************************************************************
+*
+*       _SetTask()
+*
+*  Function description
+*    Stores the information of a task.
+*/
+static void _SetTask(SYSVIEW_FREERTOS_TASK_STATUS* pTask, U32 xHandle, const char* pcTaskName, unsigned uxCurrentPriority, U32 pxStack, unsigned uStackHighWaterMark) {
+  pTask->xHandle             = xHandle;
+  pTask->pcTaskName          = pcTaskName;
+  pTask->uxCurrentPriority   = uxCurrentPriority;
+  pTask->pxStack             = pxStack;
+  pTask->uStackHighWaterMark = uStackHighWaterMark;
 }
 
 /*********************************************************************
@@ -116,34 +221,73 @@ static U64 _cbGetTime(void) {
 *
 **********************************************************************
 */
+/*********************************************************************
+*
+*       SYSVIEW_GetTaskFlags()
+*
+*  Function description
+*    Classifies a task by its name, as the idle task, the timer
+*    service task or a task of the application.
+*
+*  Return value
+*    SYSVIEW_FREERTOS_TASK_FLAG_IDLE, SYSVIEW_FREERTOS_TASK_FLAG_TIMER
+*    or 0 for a task of the application.
+*
+*  Additional information
+*    With SYSVIEW_FREERTOS_USE_TASK_FLAGS, this is called once per
+*    task by traceTASK_CREATE(), which keeps the flags in the TCB.
+*/
+unsigned SYSVIEW_GetTaskFlags(const char* pcTaskName) {
+  if (strcmp(pcTaskName, configIDLE_TASK_NAME) == 0) {
+    return SYSVIEW_FREERTOS_TASK_FLAG_IDLE;
+  }
+  if (strcmp(pcTaskName, configTIMER_SERVICE_TASK_NAME) == 0) {
+    return SYSVIEW_FREERTOS_TASK_FLAG_TIMER;
+  }
+  return 0u;
+}
+
 /*********************************************************************
 *
 *       SYSVIEW_AddTask()
 *
 *  Function description
 *    Add a task to the internal list and record its information.
+*    If the task is in the list already, its information is updated.
 */
 void SYSVIEW_AddTask(U32 xHandle, const char* pcTaskName, unsigned uxCurrentPriority, U32  pxStack, unsigned uStackHighWaterMark) {
-  
-  if (memcmp(pcTaskName, "IDLE", 5) == 0) {
+  SYSVIEW_AddTaskEx(xHandle, SYSVIEW_GetTaskFlags(pcTaskName), pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
+}
+
+/*********************************************************************
+*
+*       SYSVIEW_AddTaskEx()
+*
+*  Function description
+*    Add a task to the internal list and record its information, as
+*    SYSVIEW_AddTask(), with the flags of the task as returned by
+*    SYSVIEW_GetTaskFlags(). The idle task is not added.
+*/
+void SYSVIEW_AddTaskEx(U32 xHandle, unsigned Flags, const char* pcTaskName, unsigned uxCurrentPriority, U32 pxStack, unsigned uStackHighWaterMark) {
+  unsigned Slot;
+
+  if (Flags & SYSVIEW_FREERTOS_TASK_FLAG_IDLE) {
     return;
   }
-  
-  if (_NumTasks >= SYSVIEW_FREERTOS_MAX_NOF_TASKS) {
+  Slot = _FindSlot(xHandle);
+  if (_aTaskIndex[Slot] != 0u) {
+    _SetTask(&_aTasks[_aTaskIndex[Slot] - 1u], xHandle, pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
+  } else if (_NumTasks < SYSVIEW_FREERTOS_MAX_NOF_TASKS) {
+    _SetTask(&_aTasks[_NumTasks], xHandle, pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
+    _NumTasks++;
+    _aTaskIndex[Slot] = (U16)_NumTasks;
+  } else {
+    //
+    // The task is still named on the host, but it is not sent with the task list.
+    //
     SEGGER_SYSVIEW_Warn("SYSTEMVIEW: Could not record task information. Maximum number of tasks reached.");
-    return;
   }
-
-  _aTasks[_NumTasks].xHandle = xHandle;
-  _aTasks[_NumTasks].pcTaskName = pcTaskName;
-  _aTasks[_NumTasks].uxCurrentPriority = uxCurrentPriority;
-  _aTasks[_NumTasks].pxStack = pxStack;
-  _aTasks[_NumTasks].uStackHighWaterMark = uStackHighWaterMark;
-
-  _NumTasks++;
-
-  SYSVIEW_SendTaskInfo(xHandle, pcTaskName,uxCurrentPriority, pxStack, uStackHighWaterMark);
-
+  SYSVIEW_SendTaskInfo(xHandle, pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
 }
 
 /*********************************************************************
@@ -154,27 +298,7 @@ void SYSVIEW_AddTask(U32 xHandle, const char* pcTaskName, unsigned uxCurrentPrio
 *    Update a task in the internal list and record its information.
 */
 void SYSVIEW_UpdateTask(U32 xHandle, const char* pcTaskName, unsigned uxCurrentPriority, U32 pxStack, unsigned uStackHighWaterMark) {
-  unsigned n;
-  
-  if (memcmp(pcTaskName, "IDLE", 5) == 0) {
-    return;
-  }
-
-  for (n = 0; n < _NumTasks; n++) {
-    if (_aTasks[n].xHandle == xHandle) {
-      break;
-    }
-  }
-  if (n < _NumTasks) {
-    _aTasks[n].pcTaskName = pcTaskName;
-    _aTasks[n].uxCurrentPriority = uxCurrentPriority;
-    _aTasks[n].pxStack = pxStack;
-    _aTasks[n].uStackHighWaterMark = uStackHighWaterMark;
-
-    SYSVIEW_SendTaskInfo(xHandle, pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
-  } else {
-    SYSVIEW_AddTask(xHandle, pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
-  }
+  SYSVIEW_AddTask(xHandle, pcTaskName, uxCurrentPriority, pxStack, uStackHighWaterMark);
 }
 
 /*********************************************************************
@@ -185,37 +309,26 @@ void SYSVIEW_UpdateTask(U32 xHandle, const char* pcTaskName, unsigned uxCurrentP
 *    Delete a task from the internal list.
 */
 void SYSVIEW_DeleteTask(U32 xHandle) {
+  unsigned Slot;
   unsigned n;
-  
-  if (_NumTasks == 0) {
-    return; // Early out
-  }  
-  for (n = 0; n < _NumTasks; n++) {
-    if (_aTasks[n].xHandle == xHandle) {
-      break;
-    }
+
+  Slot = _FindSlot(xHandle);
+  if (_aTaskIndex[Slot] == 0u) {
+    return; // Not in the list
   }
-  if (n == (_NumTasks - 1)) {  
-    //
-    // Task is last item in list.
-    // Simply zero the item and decrement number of tasks.
-    //
-    memset(&_aTasks[n], 0, sizeof(_aTasks[n]));
-    _NumTasks--;
-  } else if (n < _NumTasks) {
+  n = _aTaskIndex[Slot] - 1u;
+  _FreeSlot(Slot);
+  _NumTasks--;
+  if (n != _NumTasks) {
     //
     // Task is in the middle of the list.
-    // Move last item to current position and decrement number of tasks.
+    // Move last item to current position.
     // Order of tasks does not really matter, so no need to move all following items.
     //
-    _aTasks[n].xHandle             = _aTasks[_NumTasks - 1].xHandle;
-    _aTasks[n].pcTaskName          = _aTasks[_NumTasks - 1].pcTaskName;
-    _aTasks[n].uxCurrentPriority   = _aTasks[_NumTasks - 1].uxCurrentPriority;
-    _aTasks[n].pxStack             = _aTasks[_NumTasks - 1].pxStack;
-    _aTasks[n].uStackHighWaterMark = _aTasks[_NumTasks - 1].uStackHighWaterMark;
-    memset(&_aTasks[_NumTasks - 1], 0, sizeof(_aTasks[_NumTasks - 1]));
-    _NumTasks--;
+    _aTasks[n] = _aTasks[_NumTasks];
+    _aTaskIndex[_FindSlot(_aTasks[n].xHandle)] = (U16)(n + 1u);
   }
+  memset(&_aTasks[_NumTasks], 0, sizeof(_aTasks[_NumTasks]));
 }
 
 /*********************************************************************
@@ -237,6 +350,41 @@ void SYSVIEW_SendTaskInfo(U32 TaskID, const char* sName, unsigned Prio, U32 Stac
   SEGGER_SYSVIEW_SendTaskInfo(&TaskInfo);
 }
 
+/*********************************************************************
+*
+*       SYSVIEW_SetSampling()
+*
+*  Function description
+*    Records only one of every Ratio events of a class of frequent
+*    API events, e.g. 1 of 16 queue sends.
+*
+*  Parameters
+*    Class - SYSVIEW_FREERTOS_CLASS_QUEUE_SEND, _QUEUE_RECEIVE or _NOTIFY.
+*    Ratio - One of Ratio events is recorded. 0 or 1 to record all.
+*
+*  Return value
+*     0: O.K.
+*    -1: Class out of range or not sampled, as
+*        SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES is too small.
+*
+*  Additional information
+*    The ratio is sent to the host, which scales the number of
+*    recorded events. To let the host change the ratio, call this
+*    function with Ratio 1 after SEGGER_SYSVIEW_Conf().
+*/
+int SYSVIEW_SetSampling(unsigned Class, unsigned Ratio) {
+  switch (Class) {
+  case SYSVIEW_FREERTOS_CLASS_QUEUE_SEND:
+    return SEGGER_SYSVIEW_SetClassSampling(Class, Ratio, _aQueueSendId, SEGGER_COUNTOF(_aQueueSendId));
+  case SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE:
+    return SEGGER_SYSVIEW_SetClassSampling(Class, Ratio, _aQueueReceiveId, SEGGER_COUNTOF(_aQueueReceiveId));
+  case SYSVIEW_FREERTOS_CLASS_NOTIFY:
+    return SEGGER_SYSVIEW_SetClassSampling(Class, Ratio, _aNotifyId, SEGGER_COUNTOF(_aNotifyId));
+  default:
+    return -1;
+  }
+}
+
 /*********************************************************************
 *
 *       Public API structures
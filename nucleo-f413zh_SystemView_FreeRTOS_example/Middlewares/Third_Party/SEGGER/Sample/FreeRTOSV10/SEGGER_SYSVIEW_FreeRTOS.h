@@ -71,7 +71,37 @@ Notes:
   #define portSTACK_GROWTH              ( -1 )
 #endif
 
-#define SYSVIEW_FREERTOS_MAX_NOF_TASKS  8
+//
+// Number of tasks of which the information is kept to be sent with
+// the task list. Can be set in FreeRTOSConfig.h.
+//
+#ifndef   SYSVIEW_FREERTOS_MAX_NOF_TASKS
+  #define SYSVIEW_FREERTOS_MAX_NOF_TASKS    64
+#endif
+
+//
+// Size of the hash index of the tasks by handle.
+// Must be a power of 2 and greater than SYSVIEW_FREERTOS_MAX_NOF_TASKS.
+//
+#ifndef   SYSVIEW_FREERTOS_TASK_HASH_SIZE
+  #define SYSVIEW_FREERTOS_TASK_HASH_SIZE   (2 * SYSVIEW_FREERTOS_MAX_NOF_TASKS)
+#endif
+
+//
+// 1: Classify each task once when it is created and keep its
+// SYSVIEW_FREERTOS_TASK_FLAG_* in uxTaskNumber of its TCB, which
+// FreeRTOS keeps for trace code, so traceTASK_SWITCHED_IN() does no
+// string compare. Requires configUSE_TRACE_FACILITY. Overwrites the
+// task number, so only to be enabled when neither the application
+// nor other trace code uses vTaskSetTaskNumber() or uxTaskGetTaskNumber().
+// 0: The idle task is found by xIdleTaskHandle or by its name.
+//
+#ifndef   SYSVIEW_FREERTOS_USE_TASK_FLAGS
+  #define SYSVIEW_FREERTOS_USE_TASK_FLAGS   0
+#endif
+#if (SYSVIEW_FREERTOS_USE_TASK_FLAGS == 1) && !(defined(configUSE_TRACE_FACILITY) && (configUSE_TRACE_FACILITY == 1))
+  #error "SYSVIEW_FREERTOS_USE_TASK_FLAGS requires configUSE_TRACE_FACILITY == 1"
+#endif
 
 /*********************************************************************
 *
@@ -193,61 +223,94 @@ Notes:
 #define apiID_XSTREAMBUFFERRECEIVE                (110u)
 #define apiID_XSTREAMBUFFERRECEIVEFROMISR         (111u)
 
-#define traceTASK_NOTIFY_TAKE()                                                 SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_ULTASKNOTIFYTAKE, xClearCountOnExit, xTicksToWait)
-#define traceTASK_DELAY()                                                       SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VTASKDELAY, xTicksToDelay)
-#define traceTASK_DELAY_UNTIL(xTimeToWake)                                      SEGGER_SYSVIEW_RecordVoid (apiID_OFFSET + apiID_VTASKDELAYUNTIL)
-#define traceTASK_NOTIFY_GIVE_FROM_ISR()                                        SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_VTASKNOTIFYGIVEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB), (U32)pxHigherPriorityTaskWoken)
-#define traceTASK_PRIORITY_INHERIT( pxTCB, uxPriority )                         SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VTASKPRIORITYINHERIT, (U32)pxMutexHolder)
-#define traceTASK_RESUME( pxTCB )                                               SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VTASKRESUME, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB))
-#define traceINCREASE_TICK_COUNT( xTicksToJump )                                SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VTASKSTEPTICK, xTicksToJump)
-#define traceTASK_SUSPEND( pxTCB )                                              SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VTASKSUSPEND, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB))
-#define traceTASK_PRIORITY_DISINHERIT( pxTCB, uxBasePriority )                  SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_XTASKPRIORITYDISINHERIT, (U32)pxMutexHolder)
-#define traceTASK_RESUME_FROM_ISR( pxTCB )                                      SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_XTASKRESUMEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB))
-#define traceTASK_NOTIFY()                                                      SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XTASKGENERICNOTIFY, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB), ulValue, eAction, (U32)pulPreviousNotificationValue)
-#define traceTASK_NOTIFY_FROM_ISR()                                             SEGGER_SYSVIEW_RecordU32x5(apiID_OFFSET + apiID_XTASKGENERICNOTIFYFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB), ulValue, eAction, (U32)pulPreviousNotificationValue, (U32)pxHigherPriorityTaskWoken)
-#define traceTASK_NOTIFY_WAIT()                                                 SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XTASKNOTIFYWAIT, ulBitsToClearOnEntry, ulBitsToClearOnExit, (U32)pulNotificationValue, xTicksToWait)
+//
+// Classes of frequent API events, which are sampled by SYSVIEW_SetSampling()
+// when SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES is at least SYSVIEW_FREERTOS_NUM_SAMPLE_CLASSES.
+// Classes of the application start at SYSVIEW_FREERTOS_NUM_SAMPLE_CLASSES.
+//
+#define SYSVIEW_FREERTOS_CLASS_QUEUE_SEND         (0u)
+#define SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE      (1u)
+#define SYSVIEW_FREERTOS_CLASS_NOTIFY             (2u)
+#define SYSVIEW_FREERTOS_NUM_SAMPLE_CLASSES       (3u)
+
+//
+// Flags of a task, as returned by SYSVIEW_GetTaskFlags(). 0 for tasks of the application.
+//
+#define SYSVIEW_FREERTOS_TASK_FLAG_IDLE           (1u << 0)
+#define SYSVIEW_FREERTOS_TASK_FLAG_TIMER          (1u << 1)
+
+#if SYSVIEW_FREERTOS_USE_TASK_FLAGS
+  #define SYSVIEW_SET_TASK_FLAGS(pxTCB)           (pxTCB)->uxTaskNumber = SYSVIEW_GetTaskFlags(&((pxTCB)->pcTaskName[0]))
+  #define SYSVIEW_GET_TASK_FLAGS(pxTCB)           ((unsigned)(pxTCB)->uxTaskNumber)
+#else
+  #define SYSVIEW_SET_TASK_FLAGS(pxTCB)
+  #define SYSVIEW_GET_TASK_FLAGS(pxTCB)           SYSVIEW_GetTaskFlags(&((pxTCB)->pcTaskName[0]))
+#endif
+
+#if (SEGGER_SYSVIEW_NUM_SAMPLE_CLASSES >= SYSVIEW_FREERTOS_NUM_SAMPLE_CLASSES)
+  #define SYSVIEW_RECORD_SAMPLED(Class, ...)      SEGGER_SYSVIEW_RECORD_SAMPLED(Class, __VA_ARGS__)
+#else
+  #define SYSVIEW_RECORD_SAMPLED(Class, ...)      SEGGER_SYSVIEW_RECORD(__VA_ARGS__)
+#endif
+
+#define traceTASK_NOTIFY_TAKE()                                                 SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_NOTIFY, apiID_OFFSET + apiID_ULTASKNOTIFYTAKE, xClearCountOnExit, xTicksToWait)
+#define traceTASK_DELAY()                                                       SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKDELAY, xTicksToDelay)
+#define traceTASK_DELAY_UNTIL(xTimeToWake)                                      SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKDELAYUNTIL)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR()                                        SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_NOTIFY, apiID_OFFSET + apiID_VTASKNOTIFYGIVEFROMISR, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB), (U32)pxHigherPriorityTaskWoken)
+#define traceTASK_PRIORITY_INHERIT( pxTCB, uxPriority )                         SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKPRIORITYINHERIT, (U32)pxMutexHolder)
+#define traceTASK_RESUME( pxTCB )                                               SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKRESUME, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB))
+#define traceINCREASE_TICK_COUNT( xTicksToJump )                                SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKSTEPTICK, xTicksToJump)
+#define traceTASK_SUSPEND( pxTCB )                                              SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKSUSPEND, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB))
+#define traceTASK_PRIORITY_DISINHERIT( pxTCB, uxBasePriority )                  SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XTASKPRIORITYDISINHERIT, (U32)pxMutexHolder)
+#define traceTASK_RESUME_FROM_ISR( pxTCB )                                      SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XTASKRESUMEFROMISR, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB))
+#define traceTASK_NOTIFY()                                                      SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_NOTIFY, apiID_OFFSET + apiID_XTASKGENERICNOTIFY, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB), ulValue, eAction, (U32)pulPreviousNotificationValue)
+#define traceTASK_NOTIFY_FROM_ISR()                                             SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_NOTIFY, apiID_OFFSET + apiID_XTASKGENERICNOTIFYFROMISR, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB), ulValue, eAction, (U32)pulPreviousNotificationValue, (U32)pxHigherPriorityTaskWoken)
+#define traceTASK_NOTIFY_WAIT()                                                 SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_NOTIFY, apiID_OFFSET + apiID_XTASKNOTIFYWAIT, ulBitsToClearOnEntry, ulBitsToClearOnExit, (U32)pulNotificationValue, xTicksToWait)
 
-#define traceQUEUE_CREATE( pxNewQueue )                                         SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_XQUEUEGENERICCREATE, uxQueueLength, uxItemSize, ucQueueType)
-#define traceQUEUE_DELETE( pxQueue )                                            SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VQUEUEDELETE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue))
-#define traceQUEUE_PEEK( pxQueue )                                              SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer), xTicksToWait, 1)
-#define traceQUEUE_PEEK_FROM_ISR( pxQueue )                                     SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XQUEUEPEEKFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer))
-#define traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue )                              SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XQUEUEPEEKFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer))
-#define traceQUEUE_RECEIVE( pxQueue )                                           SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait, 1)
-#define traceQUEUE_RECEIVE_FAILED( pxQueue )                                    SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait, 1)
-#define traceQUEUE_SEMAPHORE_RECEIVE( pxQueue )                                 SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait, 0)
-#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )                                  SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_XQUEUERECEIVEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer), (U32)pxHigherPriorityTaskWoken)
-#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )                           SEGGER_SYSVIEW_RecordU32x3(apiID_OFFSET + apiID_XQUEUERECEIVEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer), (U32)pxHigherPriorityTaskWoken)
-#define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName )                          SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_VQUEUEADDTOREGISTRY, SEGGER_SYSVIEW_ShrinkId((U32)xQueue), (U32)pcQueueName)
+#define traceQUEUE_CREATE( pxNewQueue )                                         SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XQUEUEGENERICCREATE, uxQueueLength, uxItemSize, ucQueueType)
+#define traceQUEUE_DELETE( pxQueue )                                            SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VQUEUEDELETE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue))
+#define traceQUEUE_PEEK( pxQueue )                                              SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer), xTicksToWait, 1)
+#define traceQUEUE_PEEK_FROM_ISR( pxQueue )                                     SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUEPEEKFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer))
+#define traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue )                              SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUEPEEKFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer))
+#define traceQUEUE_RECEIVE( pxQueue )                                           SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait, 1)
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )                                    SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait, 1)
+#define traceQUEUE_SEMAPHORE_RECEIVE( pxQueue )                                 SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUEGENERICRECEIVE, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)0), xTicksToWait, 0)
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )                                  SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUERECEIVEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer), (U32)pxHigherPriorityTaskWoken)
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue )                           SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_RECEIVE, apiID_OFFSET + apiID_XQUEUERECEIVEFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), SEGGER_SYSVIEW_ShrinkId((U32)pvBuffer), (U32)pxHigherPriorityTaskWoken)
+#define traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName )                          SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VQUEUEADDTOREGISTRY, SEGGER_SYSVIEW_ShrinkId((U32)xQueue), (U32)pcQueueName)
 #if ( configUSE_QUEUE_SETS != 1 )
-  #define traceQUEUE_SEND( pxQueue )                                            SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pvItemToQueue, xTicksToWait, xCopyPosition)
+  #define traceQUEUE_SEND( pxQueue )                                            SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_SEND, apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pvItemToQueue, xTicksToWait, xCopyPosition)
 #else
-  #define traceQUEUE_SEND( pxQueue )                                            SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), 0u, 0u, xCopyPosition)
+  #define traceQUEUE_SEND( pxQueue )                                            SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_SEND, apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), 0u, 0u, xCopyPosition)
 #endif
-#define traceQUEUE_SEND_FAILED( pxQueue )                                       SEGGER_SYSVIEW_RecordU32x4(apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pvItemToQueue, xTicksToWait, xCopyPosition)
-#define traceQUEUE_SEND_FROM_ISR( pxQueue )                                     SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pxHigherPriorityTaskWoken)
-#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )                              SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pxHigherPriorityTaskWoken)
-#define traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer )           SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERCREATE, (U32)xIsMessageBuffer, (U32)pxStreamBuffer)
-#define traceSTREAM_BUFFER_CREATE_FAILED( xIsMessageBuffer )                    SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERCREATE, (U32)xIsMessageBuffer, 0u)
-#define traceSTREAM_BUFFER_DELETE( xStreamBuffer )                              SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_VSTREAMBUFFERDELETE, (U32)xStreamBuffer)
-#define traceSTREAM_BUFFER_RESET( xStreamBuffer )                               SEGGER_SYSVIEW_RecordU32  (apiID_OFFSET + apiID_XSTREAMBUFFERRESET, (U32)xStreamBuffer)
-#define traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesSent )                    SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERSEND, (U32)xStreamBuffer, (U32)xBytesSent)
-#define traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer )                         SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERSEND, (U32)xStreamBuffer, 0u)
-#define traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent )           SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERSENDFROMISR, (U32)xStreamBuffer, (U32)xBytesSent)
-#define traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength )            SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVE, (U32)xStreamBuffer, (U32)xReceivedLength)
-#define traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer )                      SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVE, (U32)xStreamBuffer, 0u)
-#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )   SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVEFROMISR, (U32)xStreamBuffer, (U32)xReceivedLength)
+#define traceQUEUE_SEND_FAILED( pxQueue )                                       SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_SEND, apiID_OFFSET + apiID_XQUEUEGENERICSEND, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pvItemToQueue, xTicksToWait, xCopyPosition)
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )                                     SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_SEND, apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pxHigherPriorityTaskWoken)
+#define traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue )                              SYSVIEW_RECORD_SAMPLED(SYSVIEW_FREERTOS_CLASS_QUEUE_SEND, apiID_OFFSET + apiID_XQUEUEGENERICSENDFROMISR, SEGGER_SYSVIEW_ShrinkId((U32)pxQueue), (U32)pxHigherPriorityTaskWoken)
+#define traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer )           SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERCREATE, (U32)xIsMessageBuffer, (U32)pxStreamBuffer)
+#define traceSTREAM_BUFFER_CREATE_FAILED( xIsMessageBuffer )                    SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERCREATE, (U32)xIsMessageBuffer, 0u)
+#define traceSTREAM_BUFFER_DELETE( xStreamBuffer )                              SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VSTREAMBUFFERDELETE, (U32)xStreamBuffer)
+#define traceSTREAM_BUFFER_RESET( xStreamBuffer )                               SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERRESET, (U32)xStreamBuffer)
+#define traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesSent )                    SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERSEND, (U32)xStreamBuffer, (U32)xBytesSent)
+#define traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer )                         SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERSEND, (U32)xStreamBuffer, 0u)
+#define traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent )           SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERSENDFROMISR, (U32)xStreamBuffer, (U32)xBytesSent)
+#define traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength )            SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVE, (U32)xStreamBuffer, (U32)xReceivedLength)
+#define traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer )                      SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVE, (U32)xStreamBuffer, 0u)
+#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )   SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_XSTREAMBUFFERRECEIVEFROMISR, (U32)xStreamBuffer, (U32)xReceivedLength)
 
 
 #define traceTASK_DELETE( pxTCB )                   {                                                                                                   \
-                                                      SEGGER_SYSVIEW_RecordU32(apiID_OFFSET + apiID_VTASKDELETE, SEGGER_SYSVIEW_ShrinkId((U32)pxTCB));  \
+                                                      SEGGER_SYSVIEW_RECORD(apiID_OFFSET + apiID_VTASKDELETE, SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB)); \
+                                                      SEGGER_SYSVIEW_OnTaskTerminate((U32)pxTCB);                                                       \
                                                       SYSVIEW_DeleteTask((U32)pxTCB);                                                                   \
                                                     }
 
 
 #if( portSTACK_GROWTH < 0 )
 #define traceTASK_CREATE(pxNewTCB)                  if (pxNewTCB != NULL) {                                             \
+                                                      SYSVIEW_SET_TASK_FLAGS(pxNewTCB);                                 \
                                                       SEGGER_SYSVIEW_OnTaskCreate((U32)pxNewTCB);                       \
-                                                      SYSVIEW_AddTask((U32)pxNewTCB,                                    \
+                                                      SYSVIEW_AddTaskEx((U32)pxNewTCB,                                  \
+                                                                      SYSVIEW_GET_TASK_FLAGS(pxNewTCB),                 \
                                                                       &(pxNewTCB->pcTaskName[0]),                       \
                                                                       pxNewTCB->uxPriority,                             \
                                                                       (U32)pxNewTCB->pxStack,                           \
@@ -256,8 +319,10 @@ Notes:
                                                     }
 #else
 #define traceTASK_CREATE(pxNewTCB)                  if (pxNewTCB != NULL) {                                             \
+                                                      SYSVIEW_SET_TASK_FLAGS(pxNewTCB);                                 \
                                                       SEGGER_SYSVIEW_OnTaskCreate((U32)pxNewTCB);                       \
-                                                      SYSVIEW_AddTask((U32)pxNewTCB,                                    \
+                                                      SYSVIEW_AddTaskEx((U32)pxNewTCB,                                  \
+                                                                      SYSVIEW_GET_TASK_FLAGS(pxNewTCB),                 \
                                                                       &(pxNewTCB->pcTaskName[0]),                       \
                                                                       pxNewTCB->uxPriority,                             \
                                                                       (U32)pxNewTCB->pxStack,                           \
@@ -266,11 +331,12 @@ Notes:
                                                     }
 #endif
 #define traceTASK_PRIORITY_SET(pxTask, uxNewPriority) {                                                                 \
-                                                        SEGGER_SYSVIEW_RecordU32x2(apiID_OFFSET+apiID_VTASKPRIORITYSET, \
-                                                                                   SEGGER_SYSVIEW_ShrinkId((U32)pxTCB), \
-                                                                                   uxNewPriority                        \
-                                                                                  );                                    \
-                                                        SYSVIEW_UpdateTask((U32)pxTask,                                 \
+                                                        SEGGER_SYSVIEW_RECORD(apiID_OFFSET+apiID_VTASKPRIORITYSET,      \
+                                                                              SEGGER_SYSVIEW_ShrinkTaskId((U32)pxTCB),  \
+                                                                              uxNewPriority                             \
+                                                                             );                                         \
+                                                        SYSVIEW_AddTaskEx((U32)pxTask,                                  \
+                                                                           SYSVIEW_GET_TASK_FLAGS(pxTask),              \
                                                                            &(pxTask->pcTaskName[0]),                    \
                                                                            uxNewPriority,                               \
                                                                            (U32)pxTask->pxStack,                        \
@@ -278,9 +344,16 @@ Notes:
                                                                           );                                            \
                                                       }
 //
-// Define INCLUDE_xTaskGetIdleTaskHandle as 1 in FreeRTOSConfig.h to allow identification of Idle state.
+// Define INCLUDE_xTaskGetIdleTaskHandle as 1 in FreeRTOSConfig.h to allow identification of Idle state
+// without task flags.
 //
-#if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+#if SYSVIEW_FREERTOS_USE_TASK_FLAGS
+  #define traceTASK_SWITCHED_IN()                   if (pxCurrentTCB->uxTaskNumber & SYSVIEW_FREERTOS_TASK_FLAG_IDLE) { \
+                                                      SEGGER_SYSVIEW_OnIdle();                                          \
+                                                    } else {                                                            \
+                                                      SEGGER_SYSVIEW_OnTaskStartExec((U32)pxCurrentTCB);                \
+                                                    }
+#elif ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
   #define traceTASK_SWITCHED_IN()                   if(prvGetTCBFromHandle(NULL) == xIdleTaskHandle) {                  \
                                                       SEGGER_SYSVIEW_OnIdle();                                          \
                                                     } else {                                                            \
@@ -308,6 +381,26 @@ Notes:
 #define traceISR_EXIT()                             SEGGER_SYSVIEW_RecordExitISR()
 #define traceISR_ENTER()                            SEGGER_SYSVIEW_RecordEnterISR()
 
+//
+// With SEGGER_SYSVIEW_USE_TIME64, count the wraps of the timestamp on each tick.
+// An application which defines its own traceTASK_INCREMENT_TICK() before
+// including this file has to call SEGGER_SYSVIEW_UpdateTime64() from it.
+// The wraps have to be counted at least once per half wrap period of the
+// timestamp, 2.1 s at 1 GHz. With configUSE_TICKLESS_IDLE == 1 the tick
+// is suppressed for at most one SysTick period. With a custom
+// portSUPPRESS_TICKS_AND_SLEEP() (configUSE_TICKLESS_IDLE == 2), which may
+// sleep longer, the application has to call SEGGER_SYSVIEW_UpdateTime64()
+// often enough and confirm this by SYSVIEW_FREERTOS_TICKLESS_TIME64 = 1.
+//
+#if (SEGGER_SYSVIEW_USE_TIME64 == 1)
+  #ifndef   traceTASK_INCREMENT_TICK
+    #define traceTASK_INCREMENT_TICK(xTickCount)    SEGGER_SYSVIEW_UpdateTime64()
+  #endif
+  #if (defined(configUSE_TICKLESS_IDLE) && (configUSE_TICKLESS_IDLE == 2)) && !(defined(SYSVIEW_FREERTOS_TICKLESS_TIME64) && (SYSVIEW_FREERTOS_TICKLESS_TIME64 == 1))
+    #error "SEGGER_SYSVIEW_USE_TIME64 may miss a wrap of the timestamp in a long tickless sleep, see SYSVIEW_FREERTOS_TICKLESS_TIME64"
+  #endif
+#endif
+
 /*********************************************************************
 *
 *       API functions
@@ -318,9 +411,12 @@ Notes:
 extern "C" {
 #endif
 void SYSVIEW_AddTask      (U32 xHandle, const char* pcTaskName, unsigned uxCurrentPriority, U32  pxStack, unsigned uStackHighWaterMark);
+void SYSVIEW_AddTaskEx    (U32 xHandle, unsigned Flags, const char* pcTaskName, unsigned uxCurrentPriority, U32 pxStack, unsigned uStackHighWaterMark);
 void SYSVIEW_UpdateTask   (U32 xHandle, const char* pcTaskName, unsigned uxCurrentPriority, U32 pxStack, unsigned uStackHighWaterMark);
 void SYSVIEW_DeleteTask   (U32 xHandle);
 void SYSVIEW_SendTaskInfo (U32 TaskID, const char* sName, unsigned Prio, U32 StackBase, unsigned StackSize);
+int  SYSVIEW_SetSampling  (unsigned Class, unsigned Ratio);
+unsigned SYSVIEW_GetTaskFlags(const char* pcTaskName);
 
 #ifdef __cplusplus
 }